@@ -1,8 +1,14 @@
 #include "AppManager.h"
 
+#include <cstdlib>
+#include <string>
+
+#include "hal/HAL_Manager.h"
 #include "hal/ISensorDevice.h"
 #include "processing/ProcessingManager.h"
+#include "processing/ProcessingWorker.h"
 #include "transport/ITransportServer.h"
+#include "common/WorldFrameSlot.h"
 
 namespace caldera::backend {
 
@@ -16,20 +22,66 @@ AppManager::AppManager(std::shared_ptr<spdlog::logger> lifecycleLogger,
 	  transport_(std::move(transport))
 {
 	// Wire callbacks: Device frames -> Processing -> Transport
-	// ISensorDevice delivers both depth & color; current pipeline only uses depth
-	device_->setFrameCallback([proc = processing_](const caldera::backend::common::RawDepthFrame& depth,
-						    const caldera::backend::common::RawColorFrame& /*color*/) {
-		proc->processRawDepthFrame(depth);
-	});
-	processing_->setWorldFrameCallback([srv = transport_](const caldera::backend::common::WorldFrame& frame){ srv->sendWorldFrame(frame); });
+	// ISensorDevice delivers both depth & color; current pipeline only uses depth.
+	// Capture threads hand frames to the processing thread through a per-sensor mailbox and return
+	// immediately; CALDERA_PROCESSING_INLINE=1 keeps processing on the capture thread.
+	// A lock-step replay clock waits for each frame to be fully processed before emitting the next.
+	std::shared_ptr<hal::ReplayClock> lockStep = device_->replayClock();
+	if (lockStep && lockStep->mode() != hal::ReplayClock::Mode::LockStep) lockStep.reset();
+	const char* inl = std::getenv("CALDERA_PROCESSING_INLINE");
+	if (inl && std::string(inl) == "1") {
+		device_->setFrameCallback([proc = processing_, lockStep](const caldera::backend::common::RawDepthFrame& depth,
+							    const caldera::backend::common::RawColorFrame& /*color*/) {
+			proc->processRawDepthFrame(depth);
+			if (lockStep) lockStep->frameDone();
+		});
+	} else {
+		worker_ = std::make_unique<processing::ProcessingWorker>(processing_, processing::ProcessingWorker::Config::fromEnv(), lifecycleLogger_);
+		if (lockStep) worker_->setFrameProcessedCallback([lockStep] { lockStep->frameDone(); });
+		auto* lane = worker_->addLane(device_->getDeviceID());
+		device_->setFrameHandleCallback([worker = worker_.get(), lane](const hal::RawDepthFrameHandle& depth,
+								  const hal::RawColorFrameHandle& /*color*/) {
+			worker->submit(lane, depth); // shares the pooled device buffer, no copy
+		});
+	}
+	wireTransport();
 	lifecycleLogger_->info("AppManager pipeline wired (Device -> Processing -> Transport)");
 }
 
+AppManager::AppManager(std::shared_ptr<spdlog::logger> lifecycleLogger,
+	   std::unique_ptr<hal::HAL_Manager> hal,
+	   std::shared_ptr<processing::ProcessingManager> processing,
+	   std::shared_ptr<transport::ITransportServer> transport)
+	: lifecycleLogger_(std::move(lifecycleLogger)),
+	  hal_(std::move(hal)),
+	  processing_(std::move(processing)),
+	  transport_(std::move(transport))
+{
+	// Sets are delivered on the HAL grouping thread (never a capture thread), which processes them directly.
+	hal_->setFrameSetCallback([proc = processing_](const hal::FrameSet& set) { proc->processFrameSet(set); });
+	wireTransport();
+	lifecycleLogger_->info("AppManager pipeline wired (HAL {} devices -> Processing -> Transport)", hal_->deviceCount());
+}
+
+void AppManager::wireTransport() {
+	// Transports exposing a writable slot (shared memory) receive the fused map in place; others get pooled handles.
+	if (auto sink = std::dynamic_pointer_cast<caldera::backend::common::IWorldFrameSlotSink>(transport_)) {
+		processing_->setDirectPublishSink(std::move(sink));
+	} else {
+		processing_->setWorldFrameHandleCallback([srv = transport_](const caldera::backend::common::WorldFrameHandle& frame){ srv->sendWorldFrame(frame); });
+	}
+}
+
+AppManager::~AppManager() { stop(); }
+
 void AppManager::start() {
 	if (running_) return;
 	lifecycleLogger_->info("Starting backend subsystems");
 	transport_->start();
-	if (!device_->open()) {
+	if (worker_) worker_->start();
+	if (hal_) {
+		if (!hal_->start()) lifecycleLogger_->error("No sensor device opened; pipeline will not produce frames");
+	} else if (!device_->open()) {
 		lifecycleLogger_->error("Failed to open sensor device; pipeline will not produce frames");
 	}
 	running_ = true;
@@ -38,7 +90,8 @@ void AppManager::start() {
 void AppManager::stop() {
 	if (!running_) return;
 	lifecycleLogger_->info("Stopping backend subsystems");
-	device_->close();
+	if (hal_) hal_->stop(); else device_->close();
+	if (worker_) worker_->stop(); // after close: no producer left to submit
 	transport_->stop();
 	running_ = false;
 }
@@ -9,8 +9,8 @@
 
 #include "common/DataTypes.h"
 
-namespace caldera::backend::hal { class ISensorDevice; }
-namespace caldera::backend::processing { class ProcessingManager; }
+namespace caldera::backend::hal { class ISensorDevice; class HAL_Manager; }
+namespace caldera::backend::processing { class ProcessingManager; class ProcessingWorker; }
 namespace caldera::backend::transport { class ITransportServer; }
 
 namespace caldera::backend {
@@ -21,13 +21,25 @@ public:
 		   std::unique_ptr<hal::ISensorDevice> device,
 		   std::shared_ptr<processing::ProcessingManager> processing,
 		   std::shared_ptr<transport::ITransportServer> transport);
+	// Multi-sensor: the HAL groups its devices' frames into synchronized sets, each processed as one batch.
+	AppManager(std::shared_ptr<spdlog::logger> lifecycleLogger,
+		   std::unique_ptr<hal::HAL_Manager> hal,
+		   std::shared_ptr<processing::ProcessingManager> processing,
+		   std::shared_ptr<transport::ITransportServer> transport);
+	~AppManager();
 
 	void start();
 	void stop();
 
 private:
+	void wireTransport();
+
 	std::shared_ptr<spdlog::logger> lifecycleLogger_;
+	// Declared before device_ so the device (and its capture thread) is destroyed first.
+	// Null when CALDERA_PROCESSING_INLINE=1 (process on the capture thread, legacy behavior).
+	std::unique_ptr<processing::ProcessingWorker> worker_;
 	std::unique_ptr<hal::ISensorDevice> device_;
+	std::unique_ptr<hal::HAL_Manager> hal_; // set instead of device_ in multi-sensor mode
 	std::shared_ptr<processing::ProcessingManager> processing_;
 	std::shared_ptr<transport::ITransportServer> transport_;
 	bool running_ = false;
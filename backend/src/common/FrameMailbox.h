@@ -0,0 +1,123 @@
+// Lock-free single-producer / single-consumer frame mailbox.
+//
+// One mailbox per sensor (producer = capture thread, consumer = processing thread); a consumer
+// draining several mailboxes gives MPSC fan-in without any shared producer state. Slots are
+// preallocated and filled in place, so once their payload vectors reached steady-state capacity
+// a push performs no allocation and never waits on the consumer.
+//
+// Policies:
+//  - LatestWins   : triple buffer. The producer always publishes; an unconsumed frame is replaced
+//                   (counted as coalesced). The consumer always sees the newest frame.
+//  - BoundedQueue : ring of `capacity` slots. When full the new frame is dropped (counted).
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace caldera::backend::common {
+
+enum class MailboxPolicy { LatestWins, BoundedQueue };
+
+template <typename T>
+class SpscFrameMailbox {
+public:
+    struct Stats {
+        uint64_t pushed = 0;    // frames offered by the producer
+        uint64_t consumed = 0;  // frames handed to the consumer
+        uint64_t coalesced = 0; // LatestWins: frames overwritten before being consumed
+        uint64_t dropped = 0;   // BoundedQueue: frames rejected because the ring was full
+    };
+
+    explicit SpscFrameMailbox(MailboxPolicy policy = MailboxPolicy::LatestWins, size_t capacity = 4)
+        : policy_(policy), slots_(policy == MailboxPolicy::LatestWins ? 3 : (capacity ? capacity : 1)) {}
+
+    SpscFrameMailbox(const SpscFrameMailbox&) = delete;
+    SpscFrameMailbox& operator=(const SpscFrameMailbox&) = delete;
+
+    MailboxPolicy policy() const { return policy_; }
+    size_t capacity() const { return policy_ == MailboxPolicy::LatestWins ? 1 : slots_.size(); }
+
+    // Producer side. fill(T& slot) writes the frame into a reusable slot. Returns false if dropped.
+    template <typename Fill>
+    bool push(Fill&& fill) {
+        pushed_.fetch_add(1, std::memory_order_relaxed);
+        if (policy_ == MailboxPolicy::LatestWins) {
+            fill(slots_[back_]);
+            uint8_t prev = middle_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel);
+            if (prev & kFresh) coalesced_.fetch_add(1, std::memory_order_relaxed);
+            back_ = prev & kIndexMask;
+            return true;
+        }
+        const size_t t = tail_.load(std::memory_order_relaxed);
+        if (t - head_.load(std::memory_order_acquire) >= slots_.size()) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        fill(slots_[t % slots_.size()]);
+        tail_.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    bool push(const T& value) { return push([&](T& slot) { slot = value; }); }
+
+    // Consumer side. fn(T& frame) processes the oldest pending frame in place (the newest for
+    // LatestWins). The slot is not reused by the producer until fn returns. Returns false if empty.
+    template <typename Fn>
+    bool consume(Fn&& fn) {
+        if (policy_ == MailboxPolicy::LatestWins) {
+            if (!(middle_.load(std::memory_order_acquire) & kFresh)) return false;
+            uint8_t prev = middle_.exchange(front_, std::memory_order_acq_rel);
+            front_ = prev & kIndexMask;
+            fn(slots_[front_]);
+        } else {
+            const size_t h = head_.load(std::memory_order_relaxed);
+            if (h == tail_.load(std::memory_order_acquire)) return false;
+            fn(slots_[h % slots_.size()]);
+            head_.store(h + 1, std::memory_order_release);
+        }
+        consumed_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Approximate (racy by nature) – for diagnostics and idle checks only.
+    bool empty() const {
+        if (policy_ == MailboxPolicy::LatestWins) return !(middle_.load(std::memory_order_acquire) & kFresh);
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+    // Frames waiting (BoundedQueue; LatestWins: 0 or 1). Exact from the producer's side, whose
+    // pushes are the only way it grows; from any other thread a snapshot. head_ is loaded first
+    // (it never passes tail_), so a concurrent consume cannot make the difference negative.
+    size_t size() const {
+        if (policy_ == MailboxPolicy::LatestWins) return empty() ? 0 : 1;
+        const size_t h = head_.load(std::memory_order_acquire);
+        const size_t t = tail_.load(std::memory_order_acquire);
+        return t > h ? t - h : 0;
+    }
+
+    Stats stats() const {
+        return Stats{pushed_.load(std::memory_order_relaxed), consumed_.load(std::memory_order_relaxed),
+                     coalesced_.load(std::memory_order_relaxed), dropped_.load(std::memory_order_relaxed)};
+    }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;
+
+    const MailboxPolicy policy_;
+    std::vector<T> slots_;
+    // LatestWins triple-buffer indices: back_ (producer only), front_ (consumer only), middle_ shared.
+    uint8_t back_ = 0;
+    uint8_t front_ = 1;
+    alignas(64) std::atomic<uint8_t> middle_{2};
+    // BoundedQueue monotonic positions (slot = pos % capacity).
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> coalesced_{0};
+    std::atomic<uint64_t> dropped_{0};
+    alignas(64) std::atomic<uint64_t> consumed_{0};
+};
+
+} // namespace caldera::backend::common
@@ -0,0 +1,76 @@
+// Generic recycling object pool handing out shared_ptr ownership.
+//
+// acquire() returns an object from the idle list (or a new one); when the last shared_ptr
+// drops, the object goes back to the idle list (up to maxIdle) instead of being destroyed,
+// so owned heap buffers (vector capacity) survive across uses. Handles may outlive the pool:
+// the deleter only holds a weak reference to the pool state and frees the object if it is gone.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace caldera::backend::common {
+
+template <typename T>
+class RecyclingPool {
+public:
+    struct Stats {
+        uint64_t acquired = 0;   // total acquire() calls
+        uint64_t allocated = 0;  // acquires that had to create a new object
+        uint64_t recycled = 0;   // objects returned to the free list
+        uint64_t discarded = 0;  // objects freed because the free list was full / pool gone
+    };
+
+    explicit RecyclingPool(size_t maxIdle = 4) : state_(std::make_shared<State>()) { state_->maxIdle = maxIdle; }
+    ~RecyclingPool() { clear(); }
+
+    RecyclingPool(const RecyclingPool&) = delete;
+    RecyclingPool& operator=(const RecyclingPool&) = delete;
+
+    // `fresh` (optional) reports whether the object was newly constructed.
+    std::shared_ptr<T> acquire(bool* fresh = nullptr) {
+        T* obj = nullptr;
+        {
+            std::lock_guard<std::mutex> lk(state_->mtx);
+            ++state_->stats.acquired;
+            if (!state_->idle.empty()) { obj = state_->idle.back().release(); state_->idle.pop_back(); }
+            else ++state_->stats.allocated;
+        }
+        if (fresh) *fresh = (obj == nullptr);
+        if (!obj) obj = new T();
+        std::weak_ptr<State> weak = state_;
+        return std::shared_ptr<T>(obj, [weak](T* p) {
+            std::unique_ptr<T> owned(p);
+            if (auto st = weak.lock()) {
+                std::lock_guard<std::mutex> lk(st->mtx);
+                if (st->idle.size() < st->maxIdle) { st->idle.push_back(std::move(owned)); ++st->stats.recycled; return; }
+                ++st->stats.discarded;
+            }
+        });
+    }
+
+    // Drop all idle objects (outstanding handles still return here if the pool is alive).
+    void clear() {
+        std::vector<std::unique_ptr<T>> drop;
+        std::lock_guard<std::mutex> lk(state_->mtx);
+        drop.swap(state_->idle);
+    }
+
+    Stats stats() const { std::lock_guard<std::mutex> lk(state_->mtx); return state_->stats; }
+    size_t idleCount() const { std::lock_guard<std::mutex> lk(state_->mtx); return state_->idle.size(); }
+
+private:
+    struct State {
+        std::mutex mtx;
+        std::vector<std::unique_ptr<T>> idle;
+        size_t maxIdle = 4;
+        Stats stats;
+    };
+    std::shared_ptr<State> state_;
+};
+
+} // namespace caldera::backend::common
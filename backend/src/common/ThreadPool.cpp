@@ -0,0 +1,211 @@
+#include "common/ThreadPool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace caldera::backend::common {
+
+namespace {
+constexpr uint64_t pack(uint32_t lo, uint32_t hi) { return (static_cast<uint64_t>(lo) << 32) | hi; }
+constexpr uint32_t lowOf(uint64_t r) { return static_cast<uint32_t>(r >> 32); }
+constexpr uint32_t highOf(uint64_t r) { return static_cast<uint32_t>(r); }
+
+thread_local bool t_inBody = false; // nested calls run inline (std::mutex is not recursive)
+
+int hardwareThreads() { return static_cast<int>(std::max(1u, std::thread::hardware_concurrency())); }
+
+void pinCurrentThread(int cpu) {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set); // best effort: an offline CPU leaves the thread unpinned
+#else
+    (void)cpu;
+#endif
+}
+} // namespace
+
+ThreadPool::Config ThreadPool::Config::fromEnv() {
+    Config cfg;
+    if (const char* v = std::getenv("CALDERA_POOL_THREADS")) {
+        try { int n = std::stoi(v); if (n > 0) cfg.threads = n; } catch (...) {}
+    }
+    if (const char* v = std::getenv("CALDERA_POOL_AFFINITY")) {
+        std::stringstream ss(v);
+        std::string tok;
+        while (std::getline(ss, tok, ',')) {
+            try { int cpu = std::stoi(tok); if (cpu >= 0) cfg.cpus.push_back(cpu); } catch (...) {}
+        }
+    }
+    return cfg;
+}
+
+ThreadPool::ThreadPool() : ThreadPool(Config{}) {}
+
+ThreadPool::ThreadPool(const Config& cfg) { startWorkers(cfg); }
+
+ThreadPool::~ThreadPool() { stopWorkers(); }
+
+int ThreadPool::bandsFromEnv(const char* env) {
+    if (const char* v = env ? std::getenv(env) : nullptr) {
+        try { int n = std::stoi(v); if (n > 0) return n; } catch (...) {}
+    }
+    return shared().concurrency();
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(Config::fromEnv());
+    return pool;
+}
+
+void ThreadPool::configure(const Config& cfg) {
+    std::lock_guard<std::mutex> job(jobMutex_);
+    stopWorkers();
+    startWorkers(cfg);
+}
+
+ThreadPool::Stats ThreadPool::stats() const {
+    Stats s;
+    s.jobs = jobs_.load(std::memory_order_relaxed);
+    s.serialJobs = serialJobs_.load(std::memory_order_relaxed);
+    s.steals = steals_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void ThreadPool::startWorkers(const Config& cfg) {
+    threads_ = cfg.threads > 0 ? cfg.threads : hardwareThreads();
+    slots_.reset(new Slot[static_cast<size_t>(threads_)]);
+    stop_ = false;
+    for (int i = 1; i < threads_; ++i) {
+        const int cpu = cfg.cpus.empty() ? -1 : cfg.cpus[static_cast<size_t>(i - 1) % cfg.cpus.size()];
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i, cpu, generation_);
+    }
+}
+
+void ThreadPool::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        stop_ = true;
+    }
+    startCv_.notify_all();
+    for (auto& t : workers_) t.join();
+    workers_.clear();
+}
+
+void ThreadPool::run(int begin, int end, int grain, RangeFn fn, void* ctx) {
+    if (end <= begin) return;
+    grain = std::max(1, grain);
+    const int64_t chunks = (static_cast<int64_t>(end) - begin + grain - 1) / grain;
+    std::unique_lock<std::mutex> job(jobMutex_, std::defer_lock);
+    if (t_inBody || workers_.empty() || chunks == 1 || !job.try_lock()) {
+        serialJobs_.fetch_add(1, std::memory_order_relaxed);
+        fn(ctx, begin, end);
+        return;
+    }
+    jobs_.fetch_add(1, std::memory_order_relaxed);
+    fn_ = fn; ctx_ = ctx; begin_ = begin; end_ = end; grain_ = grain;
+    const int64_t parts = std::min<int64_t>(threads_, chunks);
+    for (int p = 0; p < threads_; ++p) {
+        const uint32_t lo = static_cast<uint32_t>(chunks * std::min<int64_t>(p, parts) / parts);
+        const uint32_t hi = static_cast<uint32_t>(chunks * std::min<int64_t>(p + 1, parts) / parts);
+        slots_[p].run.store(pack(lo, std::max(lo, hi)), std::memory_order_relaxed);
+    }
+    remaining_.store(static_cast<int>(chunks), std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        active_ = true;
+        ++generation_;
+    }
+    startCv_.notify_all();
+    participate(0);
+    std::unique_lock<std::mutex> lk(mutex_);
+    doneCv_.wait(lk, [this] { return remaining_.load(std::memory_order_acquire) == 0 && busy_ == 0; });
+    active_ = false; // late wakers see a closed job and go back to sleep
+}
+
+void ThreadPool::participate(int self) {
+    t_inBody = true;
+    for (;;) {
+        uint32_t chunk;
+        if (takeOwn(self, chunk)) { execute(chunk); continue; }
+        if (!steal(self)) break;
+    }
+    t_inBody = false;
+}
+
+bool ThreadPool::takeOwn(int self, uint32_t& chunk) {
+    std::atomic<uint64_t>& run = slots_[self].run;
+    uint64_t r = run.load(std::memory_order_acquire);
+    while (lowOf(r) < highOf(r)) {
+        if (run.compare_exchange_weak(r, pack(lowOf(r) + 1, highOf(r)), std::memory_order_acq_rel)) {
+            chunk = lowOf(r);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Take the back half of the largest run (rounded up, so a single chunk can be stolen) into our own
+// slot, which is empty at this point and so never contended by other thieves.
+bool ThreadPool::steal(int self) {
+    for (;;) {
+        int victim = -1;
+        uint64_t best = 0;
+        uint32_t bestSize = 0;
+        for (int p = 0; p < threads_; ++p) {
+            if (p == self) continue;
+            const uint64_t r = slots_[p].run.load(std::memory_order_acquire);
+            const uint32_t size = highOf(r) > lowOf(r) ? highOf(r) - lowOf(r) : 0;
+            if (size > bestSize) { bestSize = size; best = r; victim = p; }
+        }
+        if (victim < 0) return false;
+        const uint32_t take = (bestSize + 1) / 2;
+        const uint32_t cut = highOf(best) - take;
+        if (slots_[victim].run.compare_exchange_strong(best, pack(lowOf(best), cut), std::memory_order_acq_rel)) {
+            slots_[self].run.store(pack(cut, highOf(best)), std::memory_order_release);
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+}
+
+void ThreadPool::execute(uint32_t chunk) {
+    const int b = begin_ + static_cast<int>(chunk) * grain_;
+    const int e = static_cast<int>(std::min<int64_t>(end_, static_cast<int64_t>(b) + grain_));
+    fn_(ctx_, b, e);
+    if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lk(mutex_); // pairs with the caller's predicate check
+        doneCv_.notify_all();
+    }
+}
+
+void ThreadPool::workerLoop(int self, int cpu, uint64_t seen) {
+    pinCurrentThread(cpu);
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(mutex_);
+            startCv_.wait(lk, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+            if (!active_) continue;
+            ++busy_;
+        }
+        participate(self);
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+            --busy_;
+        }
+        doneCv_.notify_all();
+    }
+}
+
+} // namespace caldera::backend::common
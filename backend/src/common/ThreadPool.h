@@ -0,0 +1,107 @@
+// Shared work-stealing thread pool for data-parallel processing kernels.
+//
+// parallel_for(begin, end, grain, body) cuts [begin, end) into chunks of `grain` indices and gives
+// every participant (the calling thread plus the workers) a contiguous run of chunks. Participants
+// take chunks from the front of their own run; a participant that runs dry steals the back half of
+// the largest run left. Each run is a packed (lo, hi) pair in one atomic word, chunks are claimed by
+// CAS, and the body is passed by reference, so a call allocates nothing.
+//
+// One parallel_for runs at a time. A call made while the pool is busy (another sensor lane, or a
+// nested call from inside a body) runs serially on the caller instead of blocking. Kernels keep
+// their output independent of which thread runs which chunk.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace caldera::backend::common {
+
+class ThreadPool {
+public:
+    struct Config {
+        int threads = 0;       // participants including the caller; <= 0: hardware threads
+        std::vector<int> cpus; // optional affinity: the n-th worker is pinned to cpus[n % size] (caller untouched)
+
+        // CALDERA_POOL_THREADS and CALDERA_POOL_AFFINITY (comma-separated CPU ids, e.g. "2,3,4,5").
+        static Config fromEnv();
+    };
+
+    struct Stats {
+        uint64_t jobs = 0;       // parallel_for calls split across the pool
+        uint64_t serialJobs = 0; // calls run inline (single chunk, no workers, or pool busy)
+        uint64_t steals = 0;     // successful steals
+    };
+
+    ThreadPool();
+    explicit ThreadPool(const Config& cfg);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Process-wide pool used by the processing kernels; Config::fromEnv() on first use.
+    static ThreadPool& shared();
+
+    // Restart the workers with a new configuration; waits for a running parallel_for to finish.
+    void configure(const Config& cfg);
+    int concurrency() const { return threads_; }
+    Stats stats() const;
+
+    // Default band count of a banded kernel: the per-component override in `env` (e.g.
+    // CALDERA_FUSION_THREADS) when set and > 0, otherwise shared().concurrency().
+    static int bandsFromEnv(const char* env);
+
+    // body(int chunkBegin, int chunkEnd) for consecutive, disjoint ranges covering [begin, end).
+    template <typename Body>
+    void parallel_for(int begin, int end, int grain, Body&& body) {
+        using B = std::remove_reference_t<Body>;
+        run(begin, end, grain, &invoke<B>, const_cast<void*>(static_cast<const void*>(std::addressof(body))));
+    }
+
+private:
+    using RangeFn = void (*)(void* ctx, int begin, int end);
+    template <typename B>
+    static void invoke(void* ctx, int begin, int end) { (*static_cast<B*>(ctx))(begin, end); }
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> run{0}; // chunk range [lo, hi): lo in the high word
+    };
+
+    void run(int begin, int end, int grain, RangeFn fn, void* ctx);
+    void participate(int self);
+    bool takeOwn(int self, uint32_t& chunk);
+    bool steal(int self);
+    void execute(uint32_t chunk);
+    void startWorkers(const Config& cfg);
+    void stopWorkers();
+    void workerLoop(int self, int cpu, uint64_t seen);
+
+    int threads_ = 1;
+    std::unique_ptr<Slot[]> slots_; // one per participant; slot 0 is the caller
+
+    // Current job (written before the generation bump, read by workers after it).
+    RangeFn fn_ = nullptr;
+    void* ctx_ = nullptr;
+    int begin_ = 0, end_ = 0, grain_ = 1;
+    std::atomic<int> remaining_{0};   // chunks not yet finished
+
+    std::mutex jobMutex_;             // held by the caller for the whole parallel_for
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable startCv_;
+    std::condition_variable doneCv_;
+    uint64_t generation_ = 0;
+    bool active_ = false;             // a job is open for workers to join
+    int busy_ = 0;                    // workers inside participate()
+    bool stop_ = false;
+
+    std::atomic<uint64_t> jobs_{0}, serialJobs_{0}, steals_{0};
+};
+
+} // namespace caldera::backend::common
@@ -0,0 +1,48 @@
+// Recycled, ref-counted WorldFrame payloads.
+//
+// Processing acquires a frame, fills heightMap.data in place and hands consumers a
+// WorldFrameHandle (shared_ptr<const WorldFrame>). When the last handle drops, the frame
+// (and its vector capacity) returns to the pool instead of being freed, so the steady state
+// performs no per-frame malloc and no payload copy between processing and transport.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "common/DataTypes.h"
+#include "common/RecyclingPool.h"
+
+namespace caldera::backend::common {
+
+using WorldFrameHandle = std::shared_ptr<const WorldFrame>;
+
+class WorldFramePool {
+public:
+    using Stats = RecyclingPool<WorldFrame>::Stats;
+
+    // maxIdle bounds how many released frames are kept for reuse (consumers retaining more
+    // handles than this simply cause fresh allocations, never unbounded growth).
+    explicit WorldFramePool(size_t maxIdle = 4) : pool_(maxIdle) {}
+
+    // Returns a writable frame whose heightMap.data has at least `pixels` capacity (size is
+    // left to the caller). Metadata fields are reset. The frame is recycled on last release.
+    std::shared_ptr<WorldFrame> acquire(size_t pixels) {
+        std::shared_ptr<WorldFrame> f = pool_.acquire();
+        f->timestamp_ns = 0; f->frame_id = 0; f->checksum = 0;
+        f->heightMap.width = 0; f->heightMap.height = 0;
+        if (f->heightMap.data.capacity() < pixels) f->heightMap.data.reserve(pixels);
+        return f;
+    }
+
+    // Drop all idle frames (outstanding handles still return here if the pool is alive).
+    void clear() { pool_.clear(); }
+
+    Stats stats() const { return pool_.stats(); }
+    size_t idleCount() const { return pool_.idleCount(); }
+
+private:
+    RecyclingPool<WorldFrame> pool_;
+};
+
+} // namespace caldera::backend::common
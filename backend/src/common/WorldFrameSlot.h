@@ -0,0 +1,40 @@
+// Writable publication slot: lets a producer write a height map straight into the
+// transport's back buffer (e.g. shared memory) instead of building it in a private vector
+// and having the transport memcpy it. Acquire -> write up to `capacity` floats -> commit.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace caldera::backend::common {
+
+struct WorldFrameSlot {
+    float* data = nullptr;  // writable payload (valid until commit/abandon)
+    size_t capacity = 0;    // floats available at data
+    uint32_t index = 0;     // sink-specific buffer index
+    explicit operator bool() const { return data != nullptr && capacity > 0; }
+};
+
+// Metadata published alongside a committed slot.
+struct WorldFrameSlotMeta {
+    uint64_t frame_id = 0;
+    uint64_t timestamp_ns = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t float_count = 0; // floats actually written into the slot
+    uint32_t checksum = 0;    // 0 = let the sink decide (may auto-compute / leave unset)
+};
+
+class IWorldFrameSlotSink {
+public:
+    virtual ~IWorldFrameSlotSink() = default;
+    // Returns an empty slot when the sink is not ready or width x height exceeds its capacity.
+    virtual WorldFrameSlot acquireWritableSlot(uint32_t width, uint32_t height) = 0;
+    // Publishes the slot contents; returns false if the slot is stale or the meta is invalid.
+    virtual bool commitWritableSlot(const WorldFrameSlot& slot, const WorldFrameSlotMeta& meta) = 0;
+    // Releases an acquired slot without publishing (producer failed mid-frame).
+    virtual void abandonWritableSlot(const WorldFrameSlot& slot) = 0;
+};
+
+} // namespace caldera::backend::common
@@ -0,0 +1,90 @@
+#include "hal/DepthCodec.h"
+
+#include <algorithm>
+
+namespace caldera::backend::hal {
+
+namespace {
+
+constexpr size_t kBlock = 16;
+
+inline uint16_t predict(const uint16_t* img, size_t i, size_t width) {
+    const size_t x = i % width;
+    if (i < width) return x ? img[i - 1] : 0;        // first row: left neighbour
+    if (x == 0) return img[i - width];               // first column: pixel above
+    return static_cast<uint16_t>((uint32_t(img[i - 1]) + img[i - width]) >> 1);
+}
+
+inline uint16_t zigzag(uint16_t residual) {
+    const int32_t r = static_cast<int16_t>(residual);
+    return static_cast<uint16_t>((r << 1) ^ (r >> 31));
+}
+
+inline uint16_t unzigzag(uint16_t z) {
+    return static_cast<uint16_t>((z >> 1) ^ (0u - (z & 1u)));
+}
+
+inline unsigned bitWidth(uint16_t v) {
+    unsigned b = 0;
+    while (v) { ++b; v >>= 1; }
+    return b;
+}
+
+} // namespace
+
+size_t encodeDepthDelta(const uint16_t* src, size_t count, uint32_t width, std::vector<uint8_t>& out) {
+    const size_t start = out.size();
+    const size_t w = width ? width : (count ? count : 1);
+    uint16_t z[kBlock];
+    for (size_t base = 0; base < count; base += kBlock) {
+        const size_t n = std::min(kBlock, count - base);
+        uint16_t all = 0;
+        for (size_t k = 0; k < n; ++k) {
+            const size_t i = base + k;
+            z[k] = zigzag(static_cast<uint16_t>(src[i] - predict(src, i, w)));
+            all |= z[k];
+        }
+        const unsigned bits = bitWidth(all);
+        out.push_back(static_cast<uint8_t>(bits));
+        uint32_t acc = 0;
+        unsigned filled = 0;
+        for (size_t k = 0; k < n && bits; ++k) {
+            acc |= uint32_t(z[k]) << filled;
+            filled += bits;
+            while (filled >= 8) { out.push_back(static_cast<uint8_t>(acc)); acc >>= 8; filled -= 8; }
+        }
+        if (filled) out.push_back(static_cast<uint8_t>(acc));
+    }
+    return out.size() - start;
+}
+
+bool decodeDepthDelta(const uint8_t* src, size_t bytes, size_t count, uint32_t width, uint16_t* dst) {
+    const uint8_t* p = src;
+    const uint8_t* end = src + bytes;
+    const size_t w = width ? width : (count ? count : 1);
+    for (size_t base = 0; base < count; base += kBlock) {
+        const size_t n = std::min(kBlock, count - base);
+        if (p == end) return false;
+        const unsigned bits = *p++;
+        if (bits > 16) return false;
+        const size_t payload = (n * bits + 7) / 8;
+        if (static_cast<size_t>(end - p) < payload) return false;
+        const uint32_t mask = (1u << bits) - 1u;
+        uint32_t acc = 0;
+        unsigned filled = 0;
+        for (size_t k = 0; k < n; ++k) {
+            uint16_t zz = 0;
+            if (bits) {
+                while (filled < bits) { acc |= uint32_t(*p++) << filled; filled += 8; }
+                zz = static_cast<uint16_t>(acc & mask);
+                acc >>= bits;
+                filled -= bits;
+            }
+            const size_t i = base + k;
+            dst[i] = static_cast<uint16_t>(predict(dst, i, w) + unzigzag(zz));
+        }
+    }
+    return p == end;
+}
+
+} // namespace caldera::backend::hal
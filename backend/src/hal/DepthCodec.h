@@ -0,0 +1,29 @@
+#ifndef CALDERA_BACKEND_HAL_DEPTH_CODEC_H
+#define CALDERA_BACKEND_HAL_DEPTH_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace caldera::backend::hal {
+
+// Lossless depth codec used by SensorRecorder ("delta-bitpack").
+//
+// Each sample is predicted from its neighbours (mean of left and above inside the frame, left
+// on the first row, above in the first column); the residual, taken modulo 2^16, is zigzag
+// mapped. Residuals are stored in blocks of 16: one byte with the bit width of the largest
+// residual in the block (0..16) followed by 16 residuals packed LSB-first at that width. Flat
+// areas and runs of invalid (0) pixels cost one byte per block; sensor noise of a few mm costs
+// 2-3 bits per pixel.
+enum class DepthCodec : uint32_t { Raw = 0, DeltaBitpack = 1 };
+
+// Appends the encoding of `count` samples (rows of `width`; width 0 = a single row) to out.
+// Returns the number of bytes appended.
+size_t encodeDepthDelta(const uint16_t* src, size_t count, uint32_t width, std::vector<uint8_t>& out);
+
+// Decodes exactly `count` samples; returns false on truncated or malformed input.
+bool decodeDepthDelta(const uint8_t* src, size_t bytes, size_t count, uint32_t width, uint16_t* dst);
+
+} // namespace caldera::backend::hal
+
+#endif // CALDERA_BACKEND_HAL_DEPTH_CODEC_H
@@ -0,0 +1,227 @@
+#include "DepthConversion.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define CALDERA_DEPTH_CONV_X86 1
+#else
+#define CALDERA_DEPTH_CONV_X86 0
+#endif
+
+#if CALDERA_DEPTH_CONV_X86 && (defined(__GNUC__) || defined(__clang__))
+#define CALDERA_DEPTH_CONV_AVX2 1
+#else
+#define CALDERA_DEPTH_CONV_AVX2 0
+#endif
+
+namespace caldera::backend::hal {
+
+namespace {
+
+inline uint16_t convertOne(float v) {
+    // Written so NaN fails both comparisons and lands on 0, matching the SIMD max/min order below.
+    const float c = (v > 0.0f) ? (v < 65535.0f ? v : 65535.0f) : 0.0f;
+    return static_cast<uint16_t>(static_cast<uint32_t>(c));
+}
+
+void convertScalar(const float* src, uint16_t* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) dst[i] = convertOne(src[i]);
+}
+
+#if CALDERA_DEPTH_CONV_X86
+// SSE2 (x86-64 baseline). There is no unsigned 32->16 pack before SSE4.1, so values are
+// biased into int16 range, packed with signed saturation and un-biased with an xor.
+void convertSse2(const float* src, uint16_t* dst, size_t count) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 maxv = _mm_set1_ps(65535.0f);
+    const __m128i bias = _mm_set1_epi32(32768);
+    const __m128i flip = _mm_set1_epi16(static_cast<short>(0x8000));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // max(x, 0) returns the second operand for NaN -> NaN becomes 0.
+        __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), zero), maxv);
+        __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), zero), maxv);
+        __m128i ia = _mm_sub_epi32(_mm_cvttps_epi32(a), bias);
+        __m128i ib = _mm_sub_epi32(_mm_cvttps_epi32(b), bias);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(_mm_packs_epi32(ia, ib), flip));
+    }
+    convertScalar(src + i, dst + i, count - i);
+}
+#endif
+
+#if CALDERA_DEPTH_CONV_AVX2
+__attribute__((target("avx2")))
+void convertAvx2(const float* src, uint16_t* dst, size_t count) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 maxv = _mm256_set1_ps(65535.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i), zero), maxv);
+        __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i + 8), zero), maxv);
+        // packus works per 128-bit lane: [a0 b0 a1 b1] -> reorder qwords to [a0 a1 b0 b1].
+        __m256i packed = _mm256_packus_epi32(_mm256_cvttps_epi32(a), _mm256_cvttps_epi32(b));
+        packed = _mm256_permute4x64_epi64(packed, 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+    }
+    convertSse2(src + i, dst + i, count - i);
+}
+#endif
+
+// Generic big-endian bit reader (same bit order as libfreenect's convert_packed_to_16bit).
+void unpackScalar(const uint8_t* packed, unsigned bits, const uint32_t* lut, uint16_t* dst, size_t pixels) {
+    const uint32_t mask = (1u << bits) - 1u;
+    uint32_t buffer = 0;
+    unsigned bitsIn = 0;
+    for (size_t i = 0; i < pixels; ++i) {
+        while (bitsIn < bits) { buffer = (buffer << 8) | *packed++; bitsIn += 8; }
+        bitsIn -= bits;
+        const uint32_t raw = (buffer >> bitsIn) & mask;
+        dst[i] = static_cast<uint16_t>(lut ? lut[raw] : raw);
+    }
+}
+
+#if CALDERA_DEPTH_CONV_AVX2
+// Per-pixel shuffle/shift for one 8-pixel group: pixel k starts at bit bits*k; its three covering
+// bytes are gathered big-endian into a 32-bit lane (low 128-bit lane: pixels 0-3, high: 4-7), then
+// shifted right so the sample ends at bit 0. A third byte past the group is never needed (the
+// shift discards it), so it maps to 0x80 (zero) and the load never reaches into the next group.
+struct PackedGroupLayout {
+    alignas(32) int8_t shuffle[32];
+    alignas(32) int32_t shift[8];
+};
+
+PackedGroupLayout makePackedGroupLayout(unsigned bits) {
+    PackedGroupLayout l{};
+    for (unsigned k = 0; k < 8; ++k) {
+        const unsigned bit = bits * k, b0 = bit / 8, rem = bit % 8;
+        const unsigned lane = (k / 4) * 16 + (k % 4) * 4;
+        const unsigned shift = 24 - bits - rem;
+        l.shuffle[lane + 0] = static_cast<int8_t>(b0 + 2 < bits ? b0 + 2 : 0x80);
+        l.shuffle[lane + 1] = static_cast<int8_t>(b0 + 1);
+        l.shuffle[lane + 2] = static_cast<int8_t>(b0);
+        l.shuffle[lane + 3] = static_cast<int8_t>(0x80);
+        l.shift[k] = static_cast<int32_t>(shift);
+    }
+    return l;
+}
+
+__attribute__((target("avx2")))
+inline __m256i unpackGroupAvx2(const uint8_t* group, const PackedGroupLayout& l, __m256i mask, const uint32_t* lut) {
+    // 16-byte load of an 8-pixel group of `bits` (<= 11) bytes; callers guarantee 16 readable bytes.
+    const __m256i bytes = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group)));
+    __m256i v = _mm256_shuffle_epi8(bytes, _mm256_load_si256(reinterpret_cast<const __m256i*>(l.shuffle)));
+    v = _mm256_and_si256(_mm256_srlv_epi32(v, _mm256_load_si256(reinterpret_cast<const __m256i*>(l.shift))), mask);
+    if (lut) v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(lut), v, 4);
+    return v;
+}
+
+__attribute__((target("avx2")))
+void unpackAvx2(const uint8_t* packed, unsigned bits, const uint32_t* lut, uint16_t* dst, size_t pixels) {
+    const PackedGroupLayout l = makePackedGroupLayout(bits);
+    const __m256i mask = _mm256_set1_epi32(static_cast<int>((1u << bits) - 1u));
+    const size_t packedBytes = (pixels * bits + 7) / 8;
+    size_t i = 0;
+    const uint8_t* p = packed;
+    // Two groups per iteration; the second group's 16-byte load must stay inside the input.
+    for (; i + 16 <= pixels && static_cast<size_t>(p - packed) + bits + 16 <= packedBytes; i += 16, p += 2 * bits) {
+        const __m256i a = unpackGroupAvx2(p, l, mask, lut);
+        const __m256i b = unpackGroupAvx2(p + bits, l, mask, lut);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                            _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xD8));
+    }
+    unpackScalar(p, bits, lut, dst + i, pixels - i);
+}
+#endif
+
+using KernelFn = void (*)(const float*, uint16_t*, size_t);
+
+DepthConversionKernel resolve(DepthConversionKernel want) {
+    if (want == DepthConversionKernel::AVX2 && !depthConversionKernelSupported(want)) want = DepthConversionKernel::SSE2;
+    if (want == DepthConversionKernel::SSE2 && !depthConversionKernelSupported(want)) want = DepthConversionKernel::Scalar;
+    return want;
+}
+
+KernelFn kernelFn(DepthConversionKernel k) {
+    switch (resolve(k)) {
+#if CALDERA_DEPTH_CONV_AVX2
+        case DepthConversionKernel::AVX2: return &convertAvx2;
+#endif
+#if CALDERA_DEPTH_CONV_X86
+        case DepthConversionKernel::SSE2: return &convertSse2;
+#endif
+        default: return &convertScalar;
+    }
+}
+
+DepthConversionKernel selectActive() {
+    DepthConversionKernel want = DepthConversionKernel::AVX2;
+    if (const char* v = std::getenv("CALDERA_HAL_SIMD")) {
+        if (std::strcmp(v, "scalar") == 0) want = DepthConversionKernel::Scalar;
+        else if (std::strcmp(v, "sse2") == 0) want = DepthConversionKernel::SSE2;
+    }
+    return resolve(want);
+}
+
+const DepthConversionKernel& active() {
+    static const DepthConversionKernel k = selectActive();
+    return k;
+}
+
+} // namespace
+
+bool depthConversionKernelSupported(DepthConversionKernel kernel) {
+    switch (kernel) {
+        case DepthConversionKernel::Scalar: return true;
+        case DepthConversionKernel::SSE2: return CALDERA_DEPTH_CONV_X86 != 0;
+        case DepthConversionKernel::AVX2:
+#if CALDERA_DEPTH_CONV_AVX2
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+DepthConversionKernel activeDepthConversionKernel() { return active(); }
+
+const char* depthConversionKernelName(DepthConversionKernel kernel) {
+    switch (kernel) {
+        case DepthConversionKernel::Scalar: return "scalar";
+        case DepthConversionKernel::SSE2: return "sse2";
+        case DepthConversionKernel::AVX2: return "avx2";
+    }
+    return "unknown";
+}
+
+void convertDepthFloatToU16(const float* src, uint16_t* dst, size_t count) {
+    static const KernelFn fn = kernelFn(active());
+    fn(src, dst, count);
+}
+
+void convertDepthFloatToU16(DepthConversionKernel kernel, const float* src, uint16_t* dst, size_t count) {
+    kernelFn(kernel)(src, dst, count);
+}
+
+PackedDepthUnpacker::PackedDepthUnpacker(unsigned bitsPerPixel, const uint16_t* lut)
+    : bits_(bitsPerPixel < 10 ? 10 : bitsPerPixel > 11 ? 11 : bitsPerPixel) {
+    if (lut) lut_.assign(lut, lut + (size_t(1) << bits_));
+}
+
+void PackedDepthUnpacker::unpack(const uint8_t* packed, uint16_t* dst, size_t pixels) const {
+    unpack(active(), packed, dst, pixels);
+}
+
+void PackedDepthUnpacker::unpack(DepthConversionKernel kernel, const uint8_t* packed, uint16_t* dst, size_t pixels) const {
+    const uint32_t* lut = lut_.empty() ? nullptr : lut_.data();
+#if CALDERA_DEPTH_CONV_AVX2
+    if (resolve(kernel) == DepthConversionKernel::AVX2) { unpackAvx2(packed, bits_, lut, dst, pixels); return; }
+#else
+    (void)kernel;
+#endif
+    unpackScalar(packed, bits_, lut, dst, pixels);
+}
+
+} // namespace caldera::backend::hal
@@ -0,0 +1,54 @@
+#ifndef CALDERA_BACKEND_HAL_DEPTH_CONVERSION_H
+#define CALDERA_BACKEND_HAL_DEPTH_CONVERSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace caldera::backend::hal {
+
+// Float depth (millimetres, e.g. libfreenect2 Frame::Depth) -> uint16 RawDepthFrame samples.
+//
+// For every i < count:
+//   dst[i] = truncate(clamp(src[i], 0, 65535)),  NaN -> 0
+// i.e. the former `static_cast<uint16_t>(std::min(v, 65535.0f))` for in-range values, with the
+// negative / NaN cases (undefined for the plain cast) pinned to 0 so every variant agrees bit for bit.
+enum class DepthConversionKernel { Scalar, SSE2, AVX2 };
+
+// Dispatched entry point: picks the widest kernel the CPU supports once, on first use.
+// CALDERA_HAL_SIMD=scalar|sse2|avx2 caps the choice (diagnostics / A-B benchmarking).
+void convertDepthFloatToU16(const float* src, uint16_t* dst, size_t count);
+
+// Explicit variants (benchmarks / tests). Falls back to the next narrower kernel when
+// the requested one is not compiled in or not supported by the running CPU.
+void convertDepthFloatToU16(DepthConversionKernel kernel, const float* src, uint16_t* dst, size_t count);
+
+DepthConversionKernel activeDepthConversionKernel();
+bool depthConversionKernelSupported(DepthConversionKernel kernel);
+const char* depthConversionKernelName(DepthConversionKernel kernel);
+
+// Packed big-endian N-bit depth (libfreenect FREENECT_DEPTH_11BIT_PACKED / 10BIT_PACKED) -> uint16,
+// optionally mapped through a (1 << bits)-entry lookup table (e.g. raw disparity -> millimetres).
+// Eight pixels always occupy exactly `bits` bytes, so the AVX2 kernel unpacks 8-pixel groups with a
+// byte shuffle + per-lane shift and applies the table with a gather; SSE2 has no byte shuffle and
+// uses the scalar path.
+class PackedDepthUnpacker {
+public:
+    explicit PackedDepthUnpacker(unsigned bitsPerPixel = 11, const uint16_t* lut = nullptr);
+
+    unsigned bitsPerPixel() const { return bits_; }
+    bool hasLut() const { return !lut_.empty(); }
+    size_t packedBytes(size_t pixels) const { return (pixels * bits_ + 7) / 8; }
+
+    // Reads packedBytes(pixels) bytes from `packed` and writes `pixels` samples to dst.
+    void unpack(const uint8_t* packed, uint16_t* dst, size_t pixels) const;
+    void unpack(DepthConversionKernel kernel, const uint8_t* packed, uint16_t* dst, size_t pixels) const;
+
+private:
+    unsigned bits_;
+    std::vector<uint32_t> lut_; // widened to 32 bit for the gather; empty = raw values
+};
+
+} // namespace caldera::backend::hal
+
+#endif // CALDERA_BACKEND_HAL_DEPTH_CONVERSION_H
@@ -0,0 +1,85 @@
+// HAL-wide pool of recycled, ref-counted raw depth/color frames.
+//
+// Devices acquire a frame sized for the current mode, fill its data in place (or let the
+// driver write into it directly) and pass the handle downstream. When the last holder releases
+// it, the frame returns to the pool with its vector capacity intact, so steady-state capture
+// performs no heap allocation. `allocations` counts both new frame objects and buffer growths;
+// tests assert it stops increasing once the pipeline is warm.
+
+#ifndef CALDERA_BACKEND_HAL_FRAME_BUFFER_POOL_H
+#define CALDERA_BACKEND_HAL_FRAME_BUFFER_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "common/DataTypes.h"
+#include "common/RecyclingPool.h"
+
+namespace caldera::backend::hal {
+
+using RawDepthFrameHandle = std::shared_ptr<const common::RawDepthFrame>;
+using RawColorFrameHandle = std::shared_ptr<const common::RawColorFrame>;
+
+// Shared empty color frame for depth-only devices (never null on the handle path).
+inline const RawColorFrameHandle& emptyColorFrame() {
+    static const RawColorFrameHandle kEmpty = std::make_shared<const common::RawColorFrame>();
+    return kEmpty;
+}
+
+class FrameBufferPool {
+public:
+    struct Stats {
+        uint64_t acquired = 0;     // depth + color acquires
+        uint64_t allocations = 0;  // new frame objects + data buffer growths
+        uint64_t recycled = 0;     // frames returned for reuse
+        uint64_t discarded = 0;    // frames freed because the idle list was full
+    };
+
+    // maxIdle per frame kind: size it to the number of frames that can be in flight
+    // (mailbox slots + frame being processed) to keep the steady state allocation free.
+    explicit FrameBufferPool(size_t maxIdle = 6) : depth_(maxIdle), color_(maxIdle) {}
+
+    // Frame with data.size() == pixels; contents are stale and must be fully overwritten.
+    std::shared_ptr<common::RawDepthFrame> acquireDepth(size_t pixels) {
+        bool fresh = false;
+        auto f = depth_.acquire(&fresh);
+        prepare(*f, pixels, fresh);
+        return f;
+    }
+
+    std::shared_ptr<common::RawColorFrame> acquireColor(size_t bytes) {
+        bool fresh = false;
+        auto f = color_.acquire(&fresh);
+        prepare(*f, bytes, fresh);
+        return f;
+    }
+
+    void clear() { depth_.clear(); color_.clear(); }
+
+    Stats stats() const {
+        const auto d = depth_.stats();
+        const auto c = color_.stats();
+        return Stats{d.acquired + c.acquired, d.allocated + c.allocated + growths_.load(std::memory_order_relaxed),
+                     d.recycled + c.recycled, d.discarded + c.discarded};
+    }
+    uint64_t allocationCount() const { return stats().allocations; }
+
+private:
+    template <typename Frame>
+    void prepare(Frame& f, size_t n, bool fresh) {
+        // A fresh object is already counted by the pool; only count growth of a recycled buffer.
+        if (f.data.capacity() < n && !fresh) growths_.fetch_add(1, std::memory_order_relaxed);
+        f.data.resize(n);
+        f.timestamp_ns = 0;
+    }
+
+    common::RecyclingPool<common::RawDepthFrame> depth_;
+    common::RecyclingPool<common::RawColorFrame> color_;
+    std::atomic<uint64_t> growths_{0};
+};
+
+} // namespace caldera::backend::hal
+
+#endif // CALDERA_BACKEND_HAL_FRAME_BUFFER_POOL_H
@@ -0,0 +1,30 @@
+// Synchronized group of frames from several sensors (one slot per HAL_Manager device).
+
+#ifndef CALDERA_BACKEND_HAL_FRAME_SET_H
+#define CALDERA_BACKEND_HAL_FRAME_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "hal/FrameBufferPool.h"
+
+namespace caldera::backend::hal {
+
+struct FrameSet {
+    uint64_t id = 0;            // monotonically increasing per HAL_Manager
+    uint64_t timestamp_ns = 0;  // anchor time the members were matched against
+    // Indexed by device slot (HAL_Manager::addDevice order). Null depth = sensor missing from this set.
+    std::vector<RawDepthFrameHandle> depth;
+    std::vector<RawColorFrameHandle> color;
+    size_t present = 0;         // non-null depth entries
+
+    bool complete() const { return present == depth.size(); }
+};
+
+using FrameSetCallback = std::function<void(const FrameSet&)>;
+
+} // namespace caldera::backend::hal
+
+#endif // CALDERA_BACKEND_HAL_FRAME_SET_H
@@ -1,58 +1,239 @@
 #include "HAL_Manager.h"
 
 #include <spdlog/logger.h>
+#include <algorithm>
 #include <chrono>
-#include <thread>
-#include <random>
-
-using namespace std::chrono_literals;
+#include <cstdint>
+#include <cstdlib>
+#include <string>
 
 namespace caldera::backend::hal {
 
+namespace {
+uint64_t steadyNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool envMs(const char* name, uint64_t& outNs) {
+    const char* v = std::getenv(name);
+    if (!v) return false;
+    try {
+        const double ms = std::stod(v);
+        if (ms < 0.0) return false;
+        outNs = static_cast<uint64_t>(ms * 1e6);
+        return true;
+    } catch (...) { return false; }
+}
+} // namespace
+
+HAL_Manager::Config HAL_Manager::Config::fromEnv() {
+    Config c;
+    envMs("CALDERA_HAL_SYNC_TOLERANCE_MS", c.syncToleranceNs);
+    envMs("CALDERA_HAL_SYNC_TIMEOUT_MS", c.maxWaitNs);
+    envMs("CALDERA_HAL_DEVICE_TIMEOUT_MS", c.deviceTimeoutNs);
+    if (const char* d = std::getenv("CALDERA_HAL_QUEUE_DEPTH")) {
+        try { int n = std::stoi(d); if (n > 0) c.queueDepth = static_cast<size_t>(n); } catch (...) {}
+    }
+    if (const char* clk = std::getenv("CALDERA_HAL_SYNC_CLOCK")) {
+        std::string v(clk);
+        if (v == "device") c.clock = SyncClock::Device;
+        else if (v == "arrival") c.clock = SyncClock::Arrival;
+    }
+    return c;
+}
+
 HAL_Manager::HAL_Manager(std::shared_ptr<spdlog::logger> mainLogger,
              std::shared_ptr<spdlog::logger> udpLogger)
-    : logger_(std::move(mainLogger)), udp_logger_(std::move(udpLogger)) {}
+    : HAL_Manager(std::move(mainLogger), std::move(udpLogger), Config{}) {}
+
+HAL_Manager::HAL_Manager(std::shared_ptr<spdlog::logger> mainLogger,
+             std::shared_ptr<spdlog::logger> udpLogger,
+             Config cfg)
+    : logger_(std::move(mainLogger)), udp_logger_(std::move(udpLogger)), cfg_(cfg) {}
 
 HAL_Manager::~HAL_Manager() { stop(); }
 
-void HAL_Manager::setDepthFrameCallback(RawDepthFrameCallback cb) { on_depth_frame_ = std::move(cb); }
+size_t HAL_Manager::addDevice(std::unique_ptr<ISensorDevice> device) {
+    if (!device || is_running_.load()) return static_cast<size_t>(-1);
+    auto lane = std::make_unique<Lane>();
+    lane->id = device->getDeviceID();
+    lane->device = std::move(device);
+    lane->mailbox = std::make_unique<common::SpscFrameMailbox<Pending>>(common::MailboxPolicy::BoundedQueue, cfg_.queueDepth);
+    lanes_.push_back(std::move(lane));
+    return lanes_.size() - 1;
+}
+
+void HAL_Manager::setFrameSetCallback(FrameSetCallback cb) { on_frame_set_ = std::move(cb); }
 
-void HAL_Manager::start() {
-    if (is_running_.exchange(true)) return;
-    logger_->info("[HAL] Started worker thread.");
-    worker_thread_ = std::thread(&HAL_Manager::workerLoop, this);
+bool HAL_Manager::start() {
+    if (is_running_.exchange(true)) return true;
+    startNs_ = steadyNowNs();
+    set_.depth.assign(lanes_.size(), nullptr);
+    take_.assign(lanes_.size(), 0);
+    set_.color.assign(lanes_.size(), nullptr);
+    worker_thread_ = std::thread(&HAL_Manager::groupLoop, this);
+    size_t opened = 0;
+    for (auto& lanePtr : lanes_) {
+        Lane* lane = lanePtr.get();
+        lane->device->setFrameHandleCallback([this, lane](const RawDepthFrameHandle& depth, const RawColorFrameHandle& color) {
+            onFrame(*lane, depth, color);
+        });
+        if (lane->device->open()) {
+            ++opened;
+        } else if (logger_) {
+            logger_->error("[HAL] Failed to open device {}", lane->id);
+        }
+    }
+    if (logger_) {
+        logger_->info("[HAL] Started {} of {} devices (tolerance={}ms timeout={}ms clock={})", opened, lanes_.size(),
+                      cfg_.syncToleranceNs / 1e6, cfg_.maxWaitNs / 1e6, cfg_.clock == SyncClock::Arrival ? "arrival" : "device");
+    }
+    return opened > 0;
 }
 
 void HAL_Manager::stop() {
     if (!is_running_.exchange(false)) return;
+    for (auto& lane : lanes_) lane->device->close(); // no producer left once the devices are closed
+    wakeCv_.notify_all();
     if (worker_thread_.joinable()) worker_thread_.join();
-    logger_->info("[HAL] Stopped worker thread.");
-}
-
-void HAL_Manager::workerLoop() {
-    std::mt19937 rng{std::random_device{}()};
-    std::uniform_int_distribution<uint16_t> depthDist(0, 1500); // arbitrary depth range
-
-    uint64_t counter = 0;
-    while (is_running_) {
-        RawDepthFrame frame;
-        frame.sensorId = "FakeKinect_1";
-        frame.timestamp_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
-        frame.width = 640;
-        frame.height = 480;
-        frame.data.resize(static_cast<size_t>(frame.width) * frame.height);
-        for (auto &px : frame.data) {
-            px = depthDist(rng);
+    for (auto& lane : lanes_) {
+        lane->pending.clear();
+        while (lane->mailbox->consume([](Pending& p) { p = Pending{}; })) {}
+        lane->device->setFrameHandleCallback(nullptr);
+    }
+    if (logger_) {
+        const Stats s = stats();
+        logger_->info("[HAL] Stopped. sets={} complete={} partial={}", s.sets, s.completeSets, s.partialSets);
+        for (const auto& d : s.devices) {
+            logger_->info("[HAL]   {} frames={} fps={:.1f} jitter={:.2f}ms dropped={} missing={}",
+                          d.id, d.frames, d.fps, d.jitterMs, d.dropped, d.missing);
         }
-        if (udp_logger_ && (counter % 90 == 0)) {
-            udp_logger_->debug("[HAL] Heartbeat depth frame {}", counter);
+    }
+}
+
+void HAL_Manager::onFrame(Lane& lane, const RawDepthFrameHandle& depth, const RawColorFrameHandle& color) {
+    if (!depth) return;
+    const uint64_t now = steadyNowNs();
+    // Rate / jitter: exponential moving averages (1/8) of the inter-arrival interval.
+    const uint64_t prev = lane.lastArrivalNs.exchange(now, std::memory_order_relaxed);
+    if (prev != 0 && now > prev) {
+        const int64_t interval = static_cast<int64_t>(now - prev);
+        int64_t mean = static_cast<int64_t>(lane.meanIntervalNs.load(std::memory_order_relaxed));
+        mean = mean == 0 ? interval : mean + (interval - mean) / 8;
+        int64_t jitter = static_cast<int64_t>(lane.jitterNs.load(std::memory_order_relaxed));
+        const int64_t dev = interval > mean ? interval - mean : mean - interval;
+        jitter += (dev - jitter) / 8;
+        lane.meanIntervalNs.store(static_cast<uint64_t>(mean), std::memory_order_relaxed);
+        lane.jitterNs.store(static_cast<uint64_t>(std::max<int64_t>(0, jitter)), std::memory_order_relaxed);
+    }
+    lane.frames.fetch_add(1, std::memory_order_relaxed);
+    const uint64_t syncNs = cfg_.clock == SyncClock::Device ? depth->timestamp_ns : now;
+    lane.mailbox->push([&](Pending& slot) {
+        slot.depth = depth;
+        slot.color = color ? color : emptyColorFrame();
+        slot.arrivalNs = now;
+        slot.syncNs = syncNs;
+    });
+    pending_.fetch_add(1, std::memory_order_release);
+    wakeCv_.notify_one();
+}
+
+bool HAL_Manager::isLive(const Lane& lane, uint64_t nowNs) const {
+    uint64_t last = lane.lastArrivalNs.load(std::memory_order_relaxed);
+    if (last == 0) last = startNs_;
+    return nowNs < last + cfg_.deviceTimeoutNs;
+}
+
+void HAL_Manager::groupLoop() {
+    const auto idleWait = std::chrono::microseconds(cfg_.idleWaitUs > 0 ? cfg_.idleWaitUs : 1);
+    while (is_running_.load(std::memory_order_acquire)) {
+        pending_.store(0, std::memory_order_relaxed);
+        for (auto& lane : lanes_) {
+            while (lane->mailbox->consume([&](Pending& p) { lane->pending.push_back(std::move(p)); p = Pending{}; })) {}
+        }
+        const uint64_t now = steadyNowNs();
+        while (tryEmit(now)) {}
+        std::unique_lock<std::mutex> lk(wakeMutex_);
+        wakeCv_.wait_for(lk, idleWait, [this] { return pending_.load(std::memory_order_acquire) != 0 || !is_running_.load(std::memory_order_acquire); });
+    }
+}
+
+bool HAL_Manager::tryEmit(uint64_t nowNs) {
+    const size_t n = lanes_.size();
+    bool anyPending = false, allReady = true;
+    uint64_t oldest = UINT64_MAX, newest = 0, oldestArrival = UINT64_MAX;
+    for (size_t i = 0; i < n; ++i) {
+        const Lane& lane = *lanes_[i];
+        if (lane.pending.empty()) {
+            if (isLive(lane, nowNs)) allReady = false; // may still deliver a matching frame
+            continue;
         }
-        if (on_depth_frame_) {
-            on_depth_frame_(frame);
+        anyPending = true;
+        const Pending& head = lane.pending.front();
+        oldest = std::min(oldest, head.syncNs);
+        newest = std::max(newest, head.syncNs);
+        oldestArrival = std::min(oldestArrival, head.arrivalNs);
+    }
+    if (!anyPending) return false;
+
+    // Complete: every live device has a head and all heads lie within tolerance of the oldest.
+    // Otherwise the group around the oldest frame is emitted as soon as it cannot grow any more:
+    // every live device already moved past it, or the missing ones are later than maxWaitNs.
+    const bool matched = newest <= oldest + cfg_.syncToleranceNs;
+    if (!allReady && nowNs < oldestArrival + cfg_.maxWaitNs) return false;
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const Lane& lane = *lanes_[i];
+        take_[i] = !lane.pending.empty() && lane.pending.front().syncNs <= oldest + cfg_.syncToleranceNs;
+        count += take_[i] ? 1 : 0;
+    }
+    emit(oldest, allReady && matched && count == n);
+    return true;
+}
+
+void HAL_Manager::emit(uint64_t anchorNs, bool complete) {
+    set_.present = 0;
+    for (size_t i = 0; i < lanes_.size(); ++i) {
+        Lane& lane = *lanes_[i];
+        if (take_[i]) {
+            set_.depth[i] = std::move(lane.pending.front().depth);
+            set_.color[i] = std::move(lane.pending.front().color);
+            lane.pending.pop_front();
+            ++set_.present;
+        } else {
+            lane.missing.fetch_add(1, std::memory_order_relaxed);
         }
-        ++counter;
-        std::this_thread::sleep_for(33ms); // ~30 FPS
     }
+    set_.id = sets_.fetch_add(1, std::memory_order_relaxed) + 1;
+    set_.timestamp_ns = anchorNs;
+    if (complete) completeSets_.fetch_add(1, std::memory_order_relaxed);
+    if (on_frame_set_) on_frame_set_(set_);
+    if (udp_logger_ && (set_.id % 90 == 0)) udp_logger_->debug("[HAL] FrameSet {} ({}/{} sensors)", set_.id, set_.present, lanes_.size());
+    // Release the handles so the device pools can recycle the buffers.
+    std::fill(set_.depth.begin(), set_.depth.end(), nullptr);
+    std::fill(set_.color.begin(), set_.color.end(), nullptr);
+}
+
+HAL_Manager::Stats HAL_Manager::stats() const {
+    Stats s;
+    s.sets = sets_.load(std::memory_order_relaxed);
+    s.completeSets = completeSets_.load(std::memory_order_relaxed);
+    s.partialSets = s.sets - s.completeSets;
+    const uint64_t now = steadyNowNs();
+    for (const auto& lane : lanes_) {
+        DeviceStats d;
+        d.id = lane->id;
+        d.frames = lane->frames.load(std::memory_order_relaxed);
+        d.dropped = lane->mailbox->stats().dropped;
+        d.missing = lane->missing.load(std::memory_order_relaxed);
+        const uint64_t mean = lane->meanIntervalNs.load(std::memory_order_relaxed);
+        d.fps = mean ? 1e9 / static_cast<double>(mean) : 0.0;
+        d.jitterMs = static_cast<double>(lane->jitterNs.load(std::memory_order_relaxed)) / 1e6;
+        d.live = is_running_.load(std::memory_order_relaxed) && lane->lastArrivalNs.load(std::memory_order_relaxed) != 0 && isLive(*lane, now);
+        s.devices.push_back(std::move(d));
+    }
+    return s;
 }
 
 } // namespace caldera::backend::hal
@@ -1,40 +1,142 @@
 #ifndef CALDERA_BACKEND_HAL_MANAGER_H
 #define CALDERA_BACKEND_HAL_MANAGER_H
 
-#include <functional>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
-#include <atomic>
+#include <vector>
 
-#include "common/DataTypes.h"
+#include "common/FrameMailbox.h"
+#include "hal/FrameSet.h"
+#include "hal/ISensorDevice.h"
 
 namespace spdlog { class logger; }
 
 namespace caldera::backend::hal {
 
+// Owns N sensor devices and groups their frames into synchronized FrameSets.
+//
+// Every device keeps capturing on its own thread; its frame callback only parks the pooled handles
+// in a per-device SPSC mailbox (BoundedQueue, drop when full), so no sensor ever waits on another
+// or on processing. A single grouping thread drains the mailboxes and matches frames whose
+// timestamps lie within `syncToleranceNs` of the oldest pending frame:
+//  - when every live device has a frame pending and all of them match, a complete set is emitted;
+//  - otherwise the frames matching the oldest one are emitted as a partial set as soon as the group
+//    cannot grow any more (every live device already moved past it, or a device is late by more
+//    than `maxWaitNs`); absent devices count a miss;
+//  - a device silent for `deviceTimeoutNs` is considered dropped out and no longer waited for.
+// Nothing is discarded: with free-running sensors pick a tolerance of at least half a frame period
+// so each frame finds its partner.
+// FrameSets are delivered on the grouping thread, one callback per set.
 class HAL_Manager {
 public:
-    using RawDepthFrame = caldera::backend::common::RawDepthFrame;
-    using RawDepthFrameCallback = std::function<void(const RawDepthFrame&)>;
+    enum class SyncClock { Arrival, Device }; // which timestamp frames are matched on
+
+    struct Config {
+        uint64_t syncToleranceNs = 17'000'000;   // max ts - anchor to belong to a set (half a 30 fps period)
+        uint64_t maxWaitNs = 50'000'000;         // emit a partial set once the oldest frame waited this long
+        uint64_t deviceTimeoutNs = 500'000'000;  // silent devices stop being waited for
+        size_t queueDepth = 8;                   // per-device mailbox capacity
+        int idleWaitUs = 2000;
+        // Device clocks are not shared (Kinect v1 reports ms since stream start, recordings replay
+        // old times), so matching on arrival time is the default.
+        SyncClock clock = SyncClock::Arrival;
+        // CALDERA_HAL_SYNC_TOLERANCE_MS, CALDERA_HAL_SYNC_TIMEOUT_MS, CALDERA_HAL_DEVICE_TIMEOUT_MS,
+        // CALDERA_HAL_QUEUE_DEPTH, CALDERA_HAL_SYNC_CLOCK=arrival|device
+        static Config fromEnv();
+    };
+
+    struct DeviceStats {
+        std::string id;
+        uint64_t frames = 0;     // frames delivered by the device
+        uint64_t dropped = 0;    // rejected because the device mailbox was full
+        uint64_t missing = 0;    // sets emitted without this device
+        double fps = 0.0;        // from the smoothed inter-arrival interval
+        double jitterMs = 0.0;   // smoothed |interval - mean interval|
+        bool live = false;       // delivered a frame within deviceTimeoutNs
+    };
+
+    struct Stats {
+        uint64_t sets = 0;
+        uint64_t completeSets = 0;
+        uint64_t partialSets = 0;
+        std::vector<DeviceStats> devices;
+    };
 
     explicit HAL_Manager(std::shared_ptr<spdlog::logger> mainLogger,
              std::shared_ptr<spdlog::logger> udpLogger = nullptr);
+    HAL_Manager(std::shared_ptr<spdlog::logger> mainLogger,
+             std::shared_ptr<spdlog::logger> udpLogger,
+             Config cfg);
     ~HAL_Manager();
 
-    void setDepthFrameCallback(RawDepthFrameCallback cb);
+    HAL_Manager(const HAL_Manager&) = delete;
+    HAL_Manager& operator=(const HAL_Manager&) = delete;
 
-    void start();
-    void stop();
+    // Devices must be added before start(); returns the device slot used in FrameSets.
+    size_t addDevice(std::unique_ptr<ISensorDevice> device);
+    size_t deviceCount() const { return lanes_.size(); }
+    ISensorDevice* device(size_t slot) const { return slot < lanes_.size() ? lanes_[slot]->device.get() : nullptr; }
+
+    void setFrameSetCallback(FrameSetCallback cb);
+
+    // Opens every device and starts grouping; true if at least one device opened.
+    bool start();
+    void stop(); // closes devices first, then joins the grouping thread
+    bool isRunning() const { return is_running_.load(std::memory_order_acquire); }
+
+    Stats stats() const;
+    const Config& config() const { return cfg_; }
 
 private:
-    void workerLoop();
+    struct Pending {
+        RawDepthFrameHandle depth;
+        RawColorFrameHandle color;
+        uint64_t arrivalNs = 0;
+        uint64_t syncNs = 0; // arrival or device timestamp per cfg_.clock
+    };
+
+    struct Lane {
+        std::unique_ptr<ISensorDevice> device;
+        std::string id;
+        std::unique_ptr<common::SpscFrameMailbox<Pending>> mailbox;
+        std::deque<Pending> pending; // grouping thread only
+        // Written by the capture thread, read by stats().
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> lastArrivalNs{0};
+        std::atomic<uint64_t> meanIntervalNs{0};
+        std::atomic<uint64_t> jitterNs{0};
+        // Written by the grouping thread.
+        std::atomic<uint64_t> missing{0};
+    };
+
+    void onFrame(Lane& lane, const RawDepthFrameHandle& depth, const RawColorFrameHandle& color);
+    void groupLoop();
+    bool tryEmit(uint64_t nowNs); // true if a set was emitted (call again)
+    void emit(uint64_t anchorNs, bool complete); // moves the heads of the take_ lanes into set_
+    bool isLive(const Lane& lane, uint64_t nowNs) const;
 
     std::shared_ptr<spdlog::logger> logger_;
     std::shared_ptr<spdlog::logger> udp_logger_;
-    RawDepthFrameCallback on_depth_frame_;
+    Config cfg_;
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    FrameSetCallback on_frame_set_;
+    FrameSet set_;              // reused delivery buffer
+    std::vector<uint8_t> take_; // lanes contributing to the set being emitted
+    uint64_t startNs_ = 0;
 
     std::thread worker_thread_;
     std::atomic<bool> is_running_{false};
+    std::atomic<uint32_t> pending_{0}; // doorbell: bumped by capture threads, cleared by the grouper
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCv_;
+    std::atomic<uint64_t> sets_{0};
+    std::atomic<uint64_t> completeSets_{0};
 };
 
 } // namespace caldera::backend::hal
@@ -4,7 +4,10 @@
 #include <functional>
 #include <string>
 #include <vector>
+#include <memory>
 #include "common/DataTypes.h"
+#include "hal/FrameBufferPool.h"
+#include "hal/ReplayClock.h"
 
 namespace caldera::backend::hal {
 
@@ -12,6 +15,9 @@ using caldera::backend::common::RawDepthFrame;
 using caldera::backend::common::RawColorFrame;
 
 using RawFrameCallback = std::function<void(const RawDepthFrame&, const RawColorFrame&)>;
+// Ref-counted delivery: frames come from the device's FrameBufferPool and may be retained past the
+// callback without copying (they are recycled when the last handle drops). Handles are never null.
+using RawFrameHandleCallback = std::function<void(const RawDepthFrameHandle&, const RawColorFrameHandle&)>;
 
 class ISensorDevice {
 public:
@@ -23,6 +29,18 @@ public:
 	virtual std::string getDeviceID() const = 0;
 
 	virtual void setFrameCallback(RawFrameCallback callback) = 0;
+	// Pooled devices override this to hand out their buffers directly. The default adapts the
+	// by-reference callback and copies each frame once (devices without a pool).
+	virtual void setFrameHandleCallback(RawFrameHandleCallback callback) {
+		if (!callback) { setFrameCallback(nullptr); return; }
+		setFrameCallback([cb = std::move(callback)](const RawDepthFrame& depth, const RawColorFrame& color) {
+			cb(std::make_shared<const RawDepthFrame>(depth), std::make_shared<const RawColorFrame>(color));
+		});
+	}
+
+	// Pacing clock of playback / synthetic devices; null for live sensors (paced by hardware).
+	// Consumers call frameDone() on it after each frame when it runs in LockStep mode.
+	virtual std::shared_ptr<ReplayClock> replayClock() const { return nullptr; }
 };
 
 } // namespace caldera::backend::hal
@@ -2,6 +2,7 @@
 #include "common/LoggingNames.h"
 #include "common/SensorResolutions.h"
 #include <cstring>
+#include <algorithm>
 #include <chrono>
 
 #if !CALDERA_HAVE_KINECT_V1
@@ -14,17 +15,40 @@ void KinectV1_Device::close(){}
 bool KinectV1_Device::isRunning() const { return false; }
 std::string KinectV1_Device::getDeviceID() const { return {}; }
 void KinectV1_Device::setFrameCallback(RawFrameCallback cb){ frame_callback_ = std::move(cb); }
+void KinectV1_Device::setFrameHandleCallback(RawFrameHandleCallback cb){ handle_callback_ = std::move(cb); }
 void KinectV1_Device::captureLoop(){}
 void KinectV1_Device::depth_callback(freenect_device*, void*, uint32_t){}
 void KinectV1_Device::video_callback(freenect_device*, void*, uint32_t){}
 void KinectV1_Device::processDepthFrame(void*, uint32_t){}
 void KinectV1_Device::processColorFrame(void*, uint32_t){}
+void KinectV1_Device::armDepthBuffer(){}
+void KinectV1_Device::armVideoBuffer(){}
+void KinectV1_Device::emitIfComplete(){}
+void KinectV1_Device::buildDisparityTable(){}
 } // namespace caldera::backend::hal
 #else
 
+#if defined(__has_include)
+#  if __has_include(<libfreenect/libfreenect_registration.h>)
+#    include <libfreenect/libfreenect_registration.h>
+#    define CALDERA_HAVE_FREENECT_REGISTRATION 1
+#  elif __has_include(<libfreenect_registration.h>)
+#    include <libfreenect_registration.h>
+#    define CALDERA_HAVE_FREENECT_REGISTRATION 1
+#  endif
+#endif
+#include <cmath>
+#include <cstdlib>
+
 namespace caldera::backend::hal {
 
-KinectV1_Device::KinectV1_Device() { logger_ = common::Logger::instance().get("HAL.KinectV1"); }
+KinectV1_Device::KinectV1_Device() {
+    logger_ = common::Logger::instance().get("HAL.KinectV1");
+    if (const char* f = std::getenv("CALDERA_KINECT1_DEPTH_FORMAT")) {
+        if (std::strcmp(f, "packed11") == 0 || std::strcmp(f, "packed") == 0) depth_format_ = DepthFormat::Packed11;
+        else if (std::strcmp(f, "mm") != 0) logger_->warn("Unknown CALDERA_KINECT1_DEPTH_FORMAT='{}' (expected mm|packed11); using mm", f);
+    }
+}
 
 KinectV1_Device::~KinectV1_Device() { close(); }
 
@@ -86,7 +110,8 @@ bool KinectV1_Device::open() {
 
     // Configure frame modes (RGB + Depth in mm @ VGA resolution)
     freenect_frame_mode vmode = freenect_find_video_mode(FREENECT_RESOLUTION_MEDIUM, FREENECT_VIDEO_RGB);
-    freenect_frame_mode dmode = freenect_find_depth_mode(FREENECT_RESOLUTION_MEDIUM, FREENECT_DEPTH_MM);
+    const bool packed = depth_format_ == DepthFormat::Packed11;
+    freenect_frame_mode dmode = freenect_find_depth_mode(FREENECT_RESOLUTION_MEDIUM, packed ? FREENECT_DEPTH_11BIT_PACKED : FREENECT_DEPTH_MM);
     if (!vmode.is_valid || !dmode.is_valid) {
         logger_->critical("Requested video/depth modes not supported");
         freenect_close_device(freenect_device_); freenect_device_ = nullptr; freenect_shutdown(freenect_context_); freenect_context_ = nullptr; return false;
@@ -96,9 +121,19 @@ bool KinectV1_Device::open() {
         freenect_close_device(freenect_device_); freenect_device_ = nullptr; freenect_shutdown(freenect_context_); freenect_context_ = nullptr; return false;
     }
     if (freenect_set_depth_mode(freenect_device_, dmode) < 0) {
-        logger_->critical("Failed to set depth mode MM {}x{}", common::KinectV1::WIDTH, common::KinectV1::HEIGHT);
+        logger_->critical("Failed to set depth mode {} {}x{}", packed ? "11BIT_PACKED" : "MM", common::KinectV1::WIDTH, common::KinectV1::HEIGHT);
         freenect_close_device(freenect_device_); freenect_device_ = nullptr; freenect_shutdown(freenect_context_); freenect_context_ = nullptr; return false;
     }
+    if (packed) {
+        buildDisparityTable();
+        packed_depth_.resize(static_cast<size_t>(dmode.bytes));
+        logger_->info("KinectV1 depth format: 11-bit packed ({} bytes/frame, kernel={})", dmode.bytes,
+                      depthConversionKernelName(activeDepthConversionKernel()));
+    }
+
+    // Let libfreenect write frames directly into pooled buffers (no per-callback copy).
+    armDepthBuffer();
+    armVideoBuffer();
 
     if (freenect_start_depth(freenect_device_) < 0) {
         logger_->critical("Failed to start depth stream");
@@ -131,6 +166,10 @@ void KinectV1_Device::close() {
         freenect_shutdown(freenect_context_);
         freenect_context_ = nullptr;
     }
+    depth_target_.reset(); color_target_.reset();
+    pending_depth_.reset(); pending_color_.reset();
+    pool_.clear();
+    packed_depth_.clear(); packed_depth_.shrink_to_fit();
     logger_->info("KinectV1 shutdown complete");
 }
 
@@ -140,6 +179,57 @@ std::string KinectV1_Device::getDeviceID() const { return device_serial_; }
 
 void KinectV1_Device::setFrameCallback(RawFrameCallback cb) { frame_callback_ = std::move(cb); }
 
+void KinectV1_Device::setFrameHandleCallback(RawFrameHandleCallback cb) { handle_callback_ = std::move(cb); }
+
+void KinectV1_Device::armDepthBuffer() {
+    if (depth_format_ == DepthFormat::Packed11) {
+        // The packed staging buffer is consumed inside the callback, so it is armed once and reused.
+        freenect_set_depth_buffer(freenect_device_, packed_depth_.data());
+        return;
+    }
+    depth_target_ = pool_.acquireDepth(common::KinectV1::PIXEL_COUNT);
+    freenect_set_depth_buffer(freenect_device_, depth_target_->data.data());
+}
+
+// Raw 11-bit disparity -> millimetres (0 = no reading). Prefers the device's own calibration
+// (the table libfreenect uses for FREENECT_DEPTH_MM); falls back to the common OpenKinect fit.
+void KinectV1_Device::buildDisparityTable() {
+    constexpr size_t kRawValues = 2048;
+    std::vector<uint16_t> lut(kRawValues, 0);
+    bool fromDevice = false;
+#ifdef CALDERA_HAVE_FREENECT_REGISTRATION
+    freenect_registration reg = freenect_copy_registration(freenect_device_);
+    if (reg.raw_to_mm_shift) {
+        std::copy(reg.raw_to_mm_shift, reg.raw_to_mm_shift + kRawValues, lut.begin());
+        fromDevice = true;
+    }
+    freenect_destroy_registration(&reg);
+#endif
+    if (!fromDevice) {
+        for (size_t raw = 0; raw + 1 < kRawValues; ++raw) { // 2047 = no reading
+            const double denom = static_cast<double>(raw) * -0.0030711016 + 3.3309495161;
+            const double mm = denom > 0.0 ? 1000.0 / denom : 0.0;
+            lut[raw] = (mm > 0.0 && mm < 65535.0) ? static_cast<uint16_t>(std::lround(mm)) : 0;
+        }
+    }
+    lut[kRawValues - 1] = 0;
+    depth_unpacker_ = PackedDepthUnpacker(11, lut.data());
+    logger_->info("KinectV1 disparity table: {}", fromDevice ? "device registration" : "approximate fit");
+}
+
+void KinectV1_Device::armVideoBuffer() {
+    color_target_ = pool_.acquireColor(common::KinectV1::COLOR_FRAME_SIZE_BYTES);
+    freenect_set_video_buffer(freenect_device_, color_target_->data.data());
+}
+
+void KinectV1_Device::emitIfComplete() {
+    if (!(depth_ready_.load(std::memory_order_acquire) && color_ready_.load(std::memory_order_acquire))) return;
+    if (handle_callback_) handle_callback_(pending_depth_, pending_color_);
+    else if (frame_callback_) frame_callback_(*pending_depth_, *pending_color_);
+    depth_ready_.store(false, std::memory_order_release);
+    color_ready_.store(false, std::memory_order_release);
+}
+
 void KinectV1_Device::captureLoop() {
     while (is_running_.load() && freenect_context_) {
         if (freenect_process_events(freenect_context_) < 0) {
@@ -160,10 +250,22 @@ void KinectV1_Device::video_callback(freenect_device* dev, void* video, uint32_t
 }
 
 void KinectV1_Device::processDepthFrame(void* depth, uint32_t timestamp) {
-    if (!frame_callback_) return;
-    uint16_t* depthData = static_cast<uint16_t*>(depth);
+    if (!frame_callback_ && !handle_callback_) return;
+    std::shared_ptr<common::RawDepthFrame> frame;
+    if (depth_format_ == DepthFormat::Packed11) {
+        // Unpack + disparity->mm in one pass straight into the pooled frame.
+        frame = pool_.acquireDepth(common::KinectV1::PIXEL_COUNT);
+        depth_unpacker_.unpack(static_cast<const uint8_t*>(depth), frame->data.data(), common::KinectV1::PIXEL_COUNT);
+    } else if (depth_target_ && depth == depth_target_->data.data()) {
+        frame = std::move(depth_target_); // libfreenect wrote straight into the pooled buffer
+    } else {
+        frame = pool_.acquireDepth(common::KinectV1::PIXEL_COUNT);
+        const uint16_t* depthData = static_cast<const uint16_t*>(depth);
+        std::copy(depthData, depthData + common::KinectV1::PIXEL_COUNT, frame->data.begin());
+    }
+    if (depth_format_ == DepthFormat::Millimeters) armDepthBuffer(); // next frame lands in a fresh pooled buffer
     // Kinect v1 depth resolution: VGA (see SensorResolutions.h)
-    pending_depth_.sensorId = "KinectV1";
+    frame->sensorId = "KinectV1";
     // Convert provided device timestamp (in ms) to ns if plausible; else use steady clock
     uint64_t ts_ns = 0;
     if (timestamp > 0 && timestamp < (3600u * 1000u)) { // within an hour
@@ -172,41 +274,39 @@ void KinectV1_Device::processDepthFrame(void* depth, uint32_t timestamp) {
         ts_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
             std::chrono::steady_clock::now().time_since_epoch()).count();
     }
-    pending_depth_.timestamp_ns = ts_ns;
-    pending_depth_.width = common::KinectV1::WIDTH;
-    pending_depth_.height = common::KinectV1::HEIGHT;
-    pending_depth_.data.assign(depthData, depthData + common::KinectV1::PIXEL_COUNT);
+    frame->timestamp_ns = ts_ns;
+    frame->width = common::KinectV1::WIDTH;
+    frame->height = common::KinectV1::HEIGHT;
+    pending_depth_ = std::move(frame);
     depth_ready_.store(true, std::memory_order_release);
-
-    if (depth_ready_.load(std::memory_order_acquire) && color_ready_.load(std::memory_order_acquire)) {
-        frame_callback_(pending_depth_, pending_color_);
-        depth_ready_.store(false, std::memory_order_release);
-        color_ready_.store(false, std::memory_order_release);
-    }
+    emitIfComplete();
 }
 
 void KinectV1_Device::processColorFrame(void* video, uint32_t timestamp) {
-    if (!frame_callback_) return;
-    uint8_t* rgb = static_cast<uint8_t*>(video);
-    pending_color_.sensorId = "KinectV1";
+    if (!frame_callback_ && !handle_callback_) return;
+    std::shared_ptr<common::RawColorFrame> frame;
+    if (color_target_ && video == color_target_->data.data()) {
+        frame = std::move(color_target_);
+    } else {
+        frame = pool_.acquireColor(common::KinectV1::COLOR_FRAME_SIZE_BYTES);
+        const uint8_t* rgb = static_cast<const uint8_t*>(video);
+        std::copy(rgb, rgb + common::KinectV1::COLOR_FRAME_SIZE_BYTES, frame->data.begin()); // RGB format
+    }
+    armVideoBuffer();
+    frame->sensorId = "KinectV1";
     // Align to last depth if available, else synthesize from this callback's timestamp
-    uint64_t ts_ns = pending_depth_.timestamp_ns;
+    uint64_t ts_ns = pending_depth_ ? pending_depth_->timestamp_ns : 0;
     if (ts_ns == 0) {
         if (timestamp > 0 && timestamp < (3600u * 1000u)) ts_ns = static_cast<uint64_t>(timestamp) * 1000000ull;
         else ts_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
                 std::chrono::steady_clock::now().time_since_epoch()).count();
     }
-    pending_color_.timestamp_ns = ts_ns;
-    pending_color_.width = common::KinectV1::WIDTH;
-    pending_color_.height = common::KinectV1::HEIGHT;
-    pending_color_.data.assign(rgb, rgb + common::KinectV1::COLOR_FRAME_SIZE_BYTES); // RGB format
+    frame->timestamp_ns = ts_ns;
+    frame->width = common::KinectV1::WIDTH;
+    frame->height = common::KinectV1::HEIGHT;
+    pending_color_ = std::move(frame);
     color_ready_.store(true, std::memory_order_release);
-
-    if (depth_ready_.load(std::memory_order_acquire) && color_ready_.load(std::memory_order_acquire)) {
-        frame_callback_(pending_depth_, pending_color_);
-        depth_ready_.store(false, std::memory_order_release);
-        color_ready_.store(false, std::memory_order_release);
-    }
+    emitIfComplete();
 }
 
 } // namespace caldera::backend::hal
@@ -2,6 +2,7 @@
 #define CALDERA_BACKEND_HAL_KINECTV1_DEVICE_H
 
 #include "hal/ISensorDevice.h"
+#include "hal/DepthConversion.h"
 #include "common/DataTypes.h"
 #include "common/Logger.h"
 #ifdef __has_include
@@ -13,7 +14,7 @@
 #    warning "libfreenect headers not found; KinectV1_Device will be stubbed"
 typedef struct freenect_context freenect_context; // fallback minimal forward decls
 typedef struct freenect_device freenect_device;
-extern "C" { int freenect_init(freenect_context**, void*); int freenect_num_devices(freenect_context*); int freenect_open_device(freenect_context*, freenect_device**, int); int freenect_start_depth(freenect_device*); int freenect_start_video(freenect_device*); int freenect_process_events(freenect_context*); void freenect_stop_depth(freenect_device*); void freenect_stop_video(freenect_device*); void freenect_close_device(freenect_device*); void freenect_shutdown(freenect_context*); void freenect_set_log_level(freenect_context*, int); void freenect_set_depth_callback(freenect_device*, void(*)(freenect_device*, void*, uint32_t)); void freenect_set_video_callback(freenect_device*, void(*)(freenect_device*, void*, uint32_t)); void freenect_set_user(freenect_device*, void*); void* freenect_get_user(freenect_device*); int freenect_set_depth_format(freenect_device*, int); int freenect_set_video_format(freenect_device*, int); }
+extern "C" { int freenect_init(freenect_context**, void*); int freenect_num_devices(freenect_context*); int freenect_open_device(freenect_context*, freenect_device**, int); int freenect_start_depth(freenect_device*); int freenect_start_video(freenect_device*); int freenect_process_events(freenect_context*); void freenect_stop_depth(freenect_device*); void freenect_stop_video(freenect_device*); void freenect_close_device(freenect_device*); void freenect_shutdown(freenect_context*); void freenect_set_log_level(freenect_context*, int); void freenect_set_depth_callback(freenect_device*, void(*)(freenect_device*, void*, uint32_t)); void freenect_set_video_callback(freenect_device*, void(*)(freenect_device*, void*, uint32_t)); void freenect_set_user(freenect_device*, void*); void* freenect_get_user(freenect_device*); int freenect_set_depth_format(freenect_device*, int); int freenect_set_video_format(freenect_device*, int); int freenect_set_depth_buffer(freenect_device*, void*); int freenect_set_video_buffer(freenect_device*, void*); }
 #  endif
 #else
 #  include <libfreenect/libfreenect.h>
@@ -36,6 +37,14 @@ public:
     bool isRunning() const override;
     std::string getDeviceID() const override;
     void setFrameCallback(RawFrameCallback callback) override;
+    void setFrameHandleCallback(RawFrameHandleCallback callback) override;
+    FrameBufferPool::Stats bufferStats() const { return pool_.stats(); }
+
+    // Depth stream format requested from libfreenect (CALDERA_KINECT1_DEPTH_FORMAT=mm|packed11).
+    // Packed11 receives the sensor's raw 11-bit disparity bit-packed (1.375 bytes/pixel) and
+    // unpacks + converts it to millimetres in one SIMD pass straight into the pooled frame.
+    enum class DepthFormat { Millimeters, Packed11 };
+    DepthFormat depthFormat() const { return depth_format_; }
 
 private:
     // C-style callback trampolines
@@ -45,6 +54,10 @@ private:
     // Internal processing functions
     void processDepthFrame(void* depth, uint32_t timestamp);
     void processColorFrame(void* video, uint32_t timestamp);
+    void armDepthBuffer();
+    void armVideoBuffer();
+    void buildDisparityTable();
+    void emitIfComplete();
 
     void captureLoop();
 
@@ -57,13 +70,23 @@ private:
     std::atomic<bool> is_running_{false};
 
     RawFrameCallback frame_callback_;
+    RawFrameHandleCallback handle_callback_;
 
-    // Frame assembly buffers (reused to avoid realloc each callback)
-    common::RawDepthFrame  pending_depth_;
-    common::RawColorFrame  pending_color_;
+    // Pooled frames: libfreenect writes the next depth/video frame straight into *_target_
+    // (freenect_set_*_buffer); completed frames wait in pending_* for their partner stream.
+    FrameBufferPool pool_;
+    std::shared_ptr<common::RawDepthFrame> depth_target_;
+    std::shared_ptr<common::RawColorFrame> color_target_;
+    std::shared_ptr<common::RawDepthFrame> pending_depth_;
+    std::shared_ptr<common::RawColorFrame> pending_color_;
     std::atomic<bool> depth_ready_{false};
     std::atomic<bool> color_ready_{false};
 
+    // Packed11: libfreenect fills packed_depth_ (unpacked inside the callback, so one buffer suffices).
+    DepthFormat depth_format_ = DepthFormat::Millimeters;
+    std::vector<uint8_t> packed_depth_;
+    PackedDepthUnpacker depth_unpacker_;
+
     std::string device_serial_;
 };
 
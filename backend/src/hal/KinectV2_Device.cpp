@@ -1,4 +1,5 @@
 #include "KinectV2_Device.h"
+#include "DepthConversion.h"
 #include "common/LoggingNames.h"
 #include <chrono>
 #include <cstring>
@@ -147,44 +148,35 @@ void KinectV2_Device::captureLoop() {
     libfreenect2::Frame *colorFrame = frames.count(libfreenect2::Frame::Color) ? frames[libfreenect2::Frame::Color] : nullptr;
         libfreenect2::Frame *depthFrame = frames[libfreenect2::Frame::Depth];
         
-        // If we have a callback, create our frame structures
-        if (frame_callback_) {
-            // Create RawDepthFrame
-            RawDepthFrame rawDepth;
-            rawDepth.sensorId = serial_;
-            rawDepth.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        // If we have a callback, fill pooled frame structures in place (recycled on release)
+        if (frame_callback_ || handle_callback_) {
+            const uint64_t ts = std::chrono::duration_cast<std::chrono::nanoseconds>(
                 std::chrono::steady_clock::now().time_since_epoch()).count();
-            
+            const size_t depthSize = depthFrame ? depthFrame->width * depthFrame->height : 0;
+            std::shared_ptr<RawDepthFrame> rawDepth = pool_.acquireDepth(depthSize);
+            rawDepth->sensorId = serial_;
+            rawDepth->timestamp_ns = ts;
+            rawDepth->width = depthFrame ? static_cast<int>(depthFrame->width) : 0;
+            rawDepth->height = depthFrame ? static_cast<int>(depthFrame->height) : 0;
             if (depthFrame) {
-                rawDepth.width = static_cast<int>(depthFrame->width);
-                rawDepth.height = static_cast<int>(depthFrame->height);
-                size_t dataSize = rawDepth.width * rawDepth.height;
-                rawDepth.data.resize(dataSize);
-                
-                // Copy depth data (libfreenect2 depth is usually float, but we need uint16_t)
+                // libfreenect2 depth is float millimetres; convert to uint16_t with the SIMD kernel
                 const float* depthData = reinterpret_cast<const float*>(depthFrame->data);
-                for (size_t i = 0; i < dataSize; ++i) {
-                    rawDepth.data[i] = static_cast<uint16_t>(std::min(depthData[i], 65535.0f));
-                }
+                convertDepthFloatToU16(depthData, rawDepth->data.data(), depthSize);
             }
             
-            // Create RawColorFrame
-            RawColorFrame rawColor;
-            rawColor.sensorId = serial_;
-            rawColor.timestamp_ns = rawDepth.timestamp_ns;
-            
+            const size_t colorSize = colorFrame ? colorFrame->width * colorFrame->height * colorFrame->bytes_per_pixel : 0;
+            std::shared_ptr<RawColorFrame> rawColor = pool_.acquireColor(colorSize);
+            rawColor->sensorId = serial_;
+            rawColor->timestamp_ns = ts;
+            rawColor->width = colorFrame ? static_cast<int>(colorFrame->width) : 0;
+            rawColor->height = colorFrame ? static_cast<int>(colorFrame->height) : 0;
             if (colorFrame) {
-                rawColor.width = static_cast<int>(colorFrame->width);
-                rawColor.height = static_cast<int>(colorFrame->height);
-                size_t dataSize = rawColor.width * rawColor.height * colorFrame->bytes_per_pixel;
-                rawColor.data.resize(dataSize);
-                
-                // Copy color data
-                std::memcpy(rawColor.data.data(), colorFrame->data, dataSize);
+                std::memcpy(rawColor->data.data(), colorFrame->data, colorSize);
             }
             
             // Call the callback with both frames
-            frame_callback_(rawDepth, rawColor);
+            if (handle_callback_) handle_callback_(rawDepth, rawColor);
+            else frame_callback_(*rawDepth, *rawColor);
         }
         
         // Crucial: release frames to prevent memory leaks
@@ -206,4 +198,8 @@ void KinectV2_Device::setFrameCallback(RawFrameCallback callback) {
     frame_callback_ = std::move(callback);
 }
 
+void KinectV2_Device::setFrameHandleCallback(RawFrameHandleCallback callback) {
+    handle_callback_ = std::move(callback);
+}
+
 } // namespace caldera::backend::hal
\ No newline at end of file
@@ -25,6 +25,8 @@ public:
     bool isRunning() const override;
     std::string getDeviceID() const override;
     void setFrameCallback(RawFrameCallback callback) override;
+    void setFrameHandleCallback(RawFrameHandleCallback callback) override;
+    FrameBufferPool::Stats bufferStats() const { return pool_.stats(); }
 
 private:
     void captureLoop();
@@ -44,6 +46,8 @@ private:
     std::atomic<bool> is_running_ = {false};
     std::thread capture_thread_;
     RawFrameCallback frame_callback_ = nullptr;
+    RawFrameHandleCallback handle_callback_ = nullptr;
+    FrameBufferPool pool_; // recycled depth/color frames filled in place by captureLoop
 };
 
 } // namespace caldera::backend::hal
@@ -7,13 +7,14 @@
 namespace caldera::backend::hal {
 
 MockSensorDevice::MockSensorDevice(const std::string& dataFile) 
-    : data_file_(dataFile) {
+    : data_file_(dataFile), reader_(common::Logger::instance().get("HAL.MockSensorDevice")) {
     logger_ = common::Logger::instance().get("HAL.MockSensorDevice");
 }
 
 MockSensorDevice::~MockSensorDevice() noexcept {
     try {
         is_running_.store(false);
+        if (clock_) clock_->cancel();
         if (playback_thread_.joinable()) {
             playback_thread_.join();
         }
@@ -41,6 +42,7 @@ void MockSensorDevice::close() {
     try {
         if (is_running_.load()) {
             is_running_.store(false);
+            if (clock_) clock_->cancel();
             if (playback_thread_.joinable()) {
                 playback_thread_.join();
             }
@@ -64,116 +66,88 @@ void MockSensorDevice::setFrameCallback(RawFrameCallback callback) {
     }
 }
 
+void MockSensorDevice::setFrameHandleCallback(RawFrameHandleCallback callback) {
+    handle_callback_ = callback;
+
+    if (callback && data_loaded_ && !is_running_.load()) {
+        is_running_.store(true);
+        playback_thread_ = std::thread(&MockSensorDevice::playbackLoop, this);
+    }
+}
+
+bool MockSensorDevice::seekFrame(size_t index) {
+    if (!data_loaded_ || index >= frame_count_) {
+        return false;
+    }
+    seek_request_.store(index, std::memory_order_release);
+    return true;
+}
+
 bool MockSensorDevice::loadDataFile() {
     if (!std::filesystem::exists(data_file_)) {
         logger_->error("Data file does not exist: " + data_file_);
         return false;
     }
 
-    std::ifstream file(data_file_, std::ios::binary);
-    if (!file.is_open()) {
+    // Maps the file and loads (v2) or rebuilds (v1) the frame index; payloads stay on disk.
+    if (!reader_.open(data_file_)) {
         logger_->error("Cannot open data file: " + data_file_);
         return false;
     }
 
-    try {
-        // Read header
-        uint32_t magic, version, frame_count;
-        file.read(reinterpret_cast<char*>(&magic), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&version), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&frame_count), sizeof(uint32_t));
-
-        if (magic != MAGIC_NUMBER) {
-            logger_->error("Invalid file format (bad magic number)");
-            return false;
-        }
-
-        if (version != FILE_VERSION) {
-            logger_->error("Unsupported file version: " + std::to_string(version));
-            return false;
-        }
-
-        // Skip reserved space
-        file.seekg(sizeof(uint32_t) * 5, std::ios::cur);
-
-        frame_count_ = frame_count;
-        frames_.resize(frame_count_);
-
-        logger_->debug("Loading " + std::to_string(frame_count_) + " frames from file");
-
-        // Read all frames
-        for (size_t i = 0; i < frame_count_; ++i) {
-            auto& frame_data = frames_[i];
-            
-            // Read timestamp
-            file.read(reinterpret_cast<char*>(&frame_data.timestamp_ns), sizeof(uint64_t));
-            
-            // Read depth frame
-            uint32_t depth_width, depth_height, depth_size;
-            file.read(reinterpret_cast<char*>(&depth_width), sizeof(uint32_t));
-            file.read(reinterpret_cast<char*>(&depth_height), sizeof(uint32_t));
-            file.read(reinterpret_cast<char*>(&depth_size), sizeof(uint32_t));
-            
-            frame_data.depth.sensorId = getDeviceID();
-            frame_data.depth.timestamp_ns = frame_data.timestamp_ns;
-            frame_data.depth.width = depth_width;
-            frame_data.depth.height = depth_height;
-            frame_data.depth.data.resize(depth_size);
-            
-            file.read(reinterpret_cast<char*>(frame_data.depth.data.data()), 
-                     depth_size * sizeof(uint16_t));
-            
-            // Read color frame
-            uint32_t color_width, color_height, color_size;
-            file.read(reinterpret_cast<char*>(&color_width), sizeof(uint32_t));
-            file.read(reinterpret_cast<char*>(&color_height), sizeof(uint32_t));
-            file.read(reinterpret_cast<char*>(&color_size), sizeof(uint32_t));
-            
-            frame_data.color.sensorId = getDeviceID();
-            frame_data.color.timestamp_ns = frame_data.timestamp_ns;
-            frame_data.color.width = color_width;
-            frame_data.color.height = color_height;
-            frame_data.color.data.resize(color_size);
-            
-            file.read(reinterpret_cast<char*>(frame_data.color.data.data()), color_size);
-        }
-
-        data_loaded_ = true;
-        logger_->info("Successfully loaded " + std::to_string(frame_count_) + " frames");
-        return true;
+    frame_count_ = reader_.frameCount();
+    data_loaded_ = true;
+    logger_->info("Successfully indexed " + std::to_string(frame_count_) + " frames (format v" +
+                  std::to_string(reader_.version()) + (reader_.hasStoredIndex() ? ", stored index)" : ", scanned)"));
+    return true;
+}
 
-    } catch (const std::exception& e) {
-        logger_->error("Error reading data file: " + std::string(e.what()));
+bool MockSensorDevice::emitFrame(size_t index) {
+    const auto view = reader_.frame(index);
+    if (!view) {
+        return false;
+    }
+    std::shared_ptr<common::RawDepthFrame> depth = pool_.acquireDepth(view->depth_count);
+    std::shared_ptr<common::RawColorFrame> color = pool_.acquireColor(view->color_bytes);
+    reader_.copyFrame(index, *depth, *color);
+    depth->sensorId = getDeviceID();
+    color->sensorId = depth->sensorId;
+    if (handle_callback_) {
+        handle_callback_(depth, color);
+    } else if (frame_callback_) {
+        frame_callback_(*depth, *color);
+    } else {
         return false;
     }
+    return true;
 }
 
 void MockSensorDevice::playbackLoop() {
-    if (!frame_callback_ || frames_.empty()) {
+    if ((!frame_callback_ && !handle_callback_) || frame_count_ == 0) {
         is_running_.store(false);
         return;
     }
 
-    auto frame_duration = std::chrono::duration<double>(1.0 / playback_fps_);
+    std::shared_ptr<ReplayClock> clock = clock_ ? clock_ : std::make_shared<ReplayClock>();
+    clock->start(playback_fps_);
     size_t current_frame = 0;
     int loops_played = 0;
 
     logger_->debug("Starting playback at " + std::to_string(playback_fps_) + " FPS");
 
     while (is_running_.load()) {
-        auto start_time = std::chrono::steady_clock::now();
-
-        // Send current frame
-        const auto& frame_data = frames_[current_frame];
-        if (frame_callback_) {
-            frame_callback_(frame_data.depth, frame_data.color);
+        // Apply a pending seek, then send current frame
+        const size_t seek = seek_request_.exchange(kNoSeek, std::memory_order_acq_rel);
+        if (seek != kNoSeek) {
+            current_frame = seek;
         }
+        const bool emitted = emitFrame(current_frame);
 
         // Advance to next frame
         current_frame++;
         
         // Handle different playback modes
-        if (current_frame >= frames_.size()) {
+        if (current_frame >= frame_count_) {
             current_frame = 0;
             loops_played++;
 
@@ -191,12 +165,8 @@ void MockSensorDevice::playbackLoop() {
             }
         }
 
-        // Maintain target FPS
-        auto elapsed = std::chrono::steady_clock::now() - start_time;
-        auto sleep_time = frame_duration - elapsed;
-        if (sleep_time > std::chrono::microseconds(0)) {
-            std::this_thread::sleep_for(sleep_time);
-        }
+        // Maintain target FPS (or run back-to-back / lock-step, per the replay clock)
+        clock->pace(emitted);
     }
 
     is_running_.store(false);
@@ -3,6 +3,8 @@
 
 #include "hal/ISensorDevice.h"
 #include "common/DataTypes.h"
+#include "hal/FrameBufferPool.h"
+#include "hal/RecordingReader.h"
 #include <string>
 #include <fstream>
 #include <vector>
@@ -16,10 +18,14 @@ namespace caldera::backend::hal {
 /**
  * MockSensorDevice plays back recorded sensor data from files.
  * 
+ * The recording is memory-mapped (RecordingReader): open() only loads the frame index, each
+ * played frame is copied from the mapping into a pooled frame, so startup time and memory stay
+ * constant regardless of recording length. Reads SensorRecorder v1 and v2 files.
+ *
  * Supports:
  * - Single frame playback (for static tests)
  * - Loop playback (continuous cycling through frames)
- * - Controlled timing (real FPS or custom speed)
+ * - Controlled timing (real FPS or custom speed, max-rate / lock-step via ReplayClock)
  * 
  * Usage:
  *   MockSensorDevice mock("recorded_data.dat");
@@ -44,29 +50,35 @@ public:
     bool isRunning() const override { return is_running_.load(); }
     std::string getDeviceID() const override { return "MockSensor_" + data_file_; }
     void setFrameCallback(RawFrameCallback callback) override;
+    // Frames are handed out as pooled handles (recycled once the consumer releases them).
+    void setFrameHandleCallback(RawFrameHandleCallback callback) override;
 
     // Mock-specific configuration
     void setPlaybackMode(PlaybackMode mode) { playback_mode_ = mode; }
     void setPlaybackFPS(double fps) { playback_fps_ = fps; }
     void setLoopCount(int count) { loop_count_ = count; } // -1 = infinite
+    // Pacing (set before playback starts): RealTime honours playback FPS, MaxRate plays back-to-back,
+    // LockStep waits for the consumer's frameDone() after each frame. Recorded timestamps are kept.
+    void setReplayClock(std::shared_ptr<ReplayClock> clock) { clock_ = std::move(clock); }
+    std::shared_ptr<ReplayClock> replayClock() const override { return clock_; }
+    // O(1) seek: the next emitted frame is `index` (ignored if out of range). Safe during playback.
+    bool seekFrame(size_t index);
 
     // Data info
     size_t getFrameCount() const { return frame_count_; }
     bool isDataLoaded() const { return data_loaded_; }
+    const RecordingReader& recording() const { return reader_; }
+    FrameBufferPool::Stats bufferStats() const { return pool_.stats(); }
 
 private:
-    struct FrameData {
-        uint64_t timestamp_ns;
-        common::RawDepthFrame depth;
-        common::RawColorFrame color;
-    };
-
     bool loadDataFile();
     void playbackLoop();
-    bool readFrame(size_t index);
+    bool emitFrame(size_t index);
 
     std::string data_file_;
-    std::vector<FrameData> frames_;
+    RecordingReader reader_;
+    FrameBufferPool pool_;
+    std::atomic<size_t> seek_request_{kNoSeek};
     size_t frame_count_ = 0;
     bool data_loaded_ = false;
 
@@ -76,13 +88,13 @@ private:
 
     std::atomic<bool> is_running_{false};
     std::thread playback_thread_;
+    std::shared_ptr<ReplayClock> clock_;
     RawFrameCallback frame_callback_ = nullptr;
+    RawFrameHandleCallback handle_callback_ = nullptr;
     
     std::shared_ptr<spdlog::logger> logger_;
 
-    // File format constants (must match SensorRecorder)
-    static constexpr uint32_t MAGIC_NUMBER = 0x4B494E54; // "KINT"
-    static constexpr uint32_t FILE_VERSION = 1;
+    static constexpr size_t kNoSeek = static_cast<size_t>(-1);
 };
 
 } // namespace caldera::backend::hal
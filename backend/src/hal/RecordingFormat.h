@@ -0,0 +1,59 @@
+#ifndef CALDERA_BACKEND_HAL_RECORDING_FORMAT_H
+#define CALDERA_BACKEND_HAL_RECORDING_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace caldera::backend::hal::recording {
+
+// On-disk layout shared by SensorRecorder (writer) and RecordingReader / MockSensorDevice.
+//
+// Header (32 bytes): magic, version, frame_count, reserved[5]
+//   v2: reserved[0..1] = index offset (uint64, little endian), 0 if the recording was not finalized.
+//       reserved[2]    = depth codec (DepthCodec; 0 = raw)
+// Frame record:
+//   timestamp_ns (u64)
+//   depth_width, depth_height, depth_count (u32) + depth payload:
+//       raw:         depth_count * u16
+//       DeltaBitpack: encoded_bytes (u32) + encoded_bytes
+//   color_width, color_height, color_bytes (u32) + color_bytes
+//   v2: zero padding to the next 8-byte boundary (keeps every depth payload 4-byte aligned)
+// v2 trailing index (at index offset): frame_count * IndexEntry, written by stopRecording().
+// v1 files (no padding, no index) and unfinalized v2 files are indexed by scanning record headers.
+
+constexpr uint32_t MAGIC_NUMBER = 0x4B494E54; // "KINT"
+constexpr uint32_t VERSION_V1 = 1;
+constexpr uint32_t VERSION_V2 = 2;
+constexpr uint32_t CURRENT_VERSION = VERSION_V2;
+
+constexpr size_t HEADER_BYTES = 32;
+constexpr size_t FRAME_COUNT_OFFSET = 8;
+constexpr size_t INDEX_OFFSET_OFFSET = 12;
+constexpr size_t DEPTH_CODEC_OFFSET = 20;
+constexpr size_t DEPTH_PAYLOAD_OFFSET = 20; // within a frame record
+constexpr size_t RECORD_ALIGNMENT = 8;
+
+struct IndexEntry {
+    uint64_t offset = 0;       // file offset of the frame record
+    uint64_t timestamp_ns = 0;
+    uint32_t depth_width = 0;
+    uint32_t depth_height = 0;
+    uint32_t depth_count = 0;  // uint16 samples
+    uint32_t color_width = 0;
+    uint32_t color_height = 0;
+    uint32_t color_bytes = 0;
+};
+static_assert(sizeof(IndexEntry) == 40, "IndexEntry is written verbatim to disk");
+
+// Bytes of a frame record before padding (depthPayloadBytes as laid out above).
+constexpr size_t recordBytes(size_t depthPayloadBytes, uint32_t colorBytes) {
+    return DEPTH_PAYLOAD_OFFSET + depthPayloadBytes + 3 * sizeof(uint32_t) + colorBytes;
+}
+
+constexpr size_t paddingFor(size_t bytes, uint32_t version) {
+    return version >= VERSION_V2 ? (RECORD_ALIGNMENT - bytes % RECORD_ALIGNMENT) % RECORD_ALIGNMENT : 0;
+}
+
+} // namespace caldera::backend::hal::recording
+
+#endif // CALDERA_BACKEND_HAL_RECORDING_FORMAT_H
@@ -0,0 +1,195 @@
+#include "hal/RecordingReader.h"
+#include <spdlog/spdlog.h>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace caldera::backend::hal {
+
+using recording::IndexEntry;
+
+namespace {
+template <typename T>
+T readAt(const uint8_t* base, size_t offset) {
+    T v;
+    std::memcpy(&v, base + offset, sizeof(T));
+    return v;
+}
+} // namespace
+
+RecordingReader::~RecordingReader() { close(); }
+
+bool RecordingReader::open(const std::string& path) {
+    close();
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) { if (logger_) logger_->error("RecordingReader: cannot open {}", path); return false; }
+    struct stat st{};
+    if (fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < recording::HEADER_BYTES) {
+        if (logger_) logger_->error("RecordingReader: {} is too small for a recording header", path);
+        close(); return false;
+    }
+    mapped_size_ = static_cast<size_t>(st.st_size);
+    void* m = mmap(nullptr, mapped_size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (m == MAP_FAILED) {
+        if (logger_) logger_->error("RecordingReader: mmap failed for {}", path);
+        mapped_size_ = 0; close(); return false;
+    }
+    mapped_ = static_cast<const uint8_t*>(m);
+    // Playback walks frames in order; let the kernel read ahead aggressively.
+    madvise(m, mapped_size_, MADV_SEQUENTIAL);
+
+    const uint32_t magic = readAt<uint32_t>(mapped_, 0);
+    version_ = readAt<uint32_t>(mapped_, 4);
+    const uint32_t headerFrames = readAt<uint32_t>(mapped_, recording::FRAME_COUNT_OFFSET);
+    if (magic != recording::MAGIC_NUMBER) {
+        if (logger_) logger_->error("RecordingReader: invalid file format (bad magic number) in {}", path);
+        close(); return false;
+    }
+    if (version_ != recording::VERSION_V1 && version_ != recording::VERSION_V2) {
+        if (logger_) logger_->error("RecordingReader: unsupported file version {} in {}", version_, path);
+        close(); return false;
+    }
+    if (version_ >= recording::VERSION_V2) {
+        const uint32_t codec = readAt<uint32_t>(mapped_, recording::DEPTH_CODEC_OFFSET);
+        if (codec > static_cast<uint32_t>(DepthCodec::DeltaBitpack)) {
+            if (logger_) logger_->error("RecordingReader: unsupported depth codec {} in {}", codec, path);
+            close(); return false;
+        }
+        codec_ = static_cast<DepthCodec>(codec);
+    }
+    const uint64_t indexOffset = version_ >= recording::VERSION_V2 ? readAt<uint64_t>(mapped_, recording::INDEX_OFFSET_OFFSET) : 0;
+    if (indexOffset != 0 && loadStoredIndex(indexOffset, headerFrames)) {
+        stored_index_ = true;
+    } else if (!scanIndex(headerFrames)) {
+        close(); return false;
+    }
+    if (logger_) logger_->debug("RecordingReader: {} v{} frames={} index={}", path, version_, index_.size(),
+                                stored_index_ ? "stored" : "scanned");
+    return true;
+}
+
+void RecordingReader::close() {
+    if (mapped_) { munmap(const_cast<uint8_t*>(mapped_), mapped_size_); mapped_ = nullptr; }
+    if (fd_ >= 0) { ::close(fd_); fd_ = -1; }
+    mapped_size_ = 0;
+    version_ = 0;
+    codec_ = DepthCodec::Raw;
+    stored_index_ = false;
+    index_.clear();
+    index_.shrink_to_fit();
+}
+
+bool RecordingReader::loadStoredIndex(uint64_t indexOffset, uint32_t frameCount) {
+    const uint64_t bytes = uint64_t(frameCount) * sizeof(IndexEntry);
+    if (indexOffset < recording::HEADER_BYTES || indexOffset + bytes > mapped_size_) {
+        if (logger_) logger_->warn("RecordingReader: stored index out of bounds; rebuilding by scan");
+        return false;
+    }
+    index_.resize(frameCount);
+    if (frameCount) std::memcpy(index_.data(), mapped_ + indexOffset, bytes);
+    for (const IndexEntry& e : index_) {
+        const size_t depthBytes = e.offset < indexOffset ? depthPayloadBytes(e.offset, e.depth_count) : 0;
+        if (e.offset < recording::HEADER_BYTES || (depthBytes == 0 && e.depth_count != 0) ||
+            e.offset + recording::recordBytes(depthBytes, e.color_bytes) > indexOffset) {
+            if (logger_) logger_->warn("RecordingReader: stored index entry out of bounds; rebuilding by scan");
+            index_.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RecordingReader::scanIndex(uint32_t headerFrameCount) {
+    // An unfinalized recording (count still 0) is scanned up to its last complete record.
+    const bool trustCount = headerFrameCount != 0;
+    index_.clear();
+    if (trustCount) index_.reserve(headerFrameCount);
+    size_t pos = recording::HEADER_BYTES;
+    constexpr size_t kFixed = recording::recordBytes(0, 0);
+    while ((!trustCount || index_.size() < headerFrameCount) && pos + kFixed <= mapped_size_) {
+        IndexEntry e;
+        e.offset = pos;
+        e.timestamp_ns = readAt<uint64_t>(mapped_, pos);
+        e.depth_width = readAt<uint32_t>(mapped_, pos + 8);
+        e.depth_height = readAt<uint32_t>(mapped_, pos + 12);
+        e.depth_count = readAt<uint32_t>(mapped_, pos + 16);
+        const size_t depthBytes = depthPayloadBytes(pos, e.depth_count);
+        if (depthBytes == 0 && e.depth_count != 0) break;
+        const size_t colorHdr = pos + recording::DEPTH_PAYLOAD_OFFSET + depthBytes;
+        if (colorHdr + 12 > mapped_size_) break;
+        e.color_width = readAt<uint32_t>(mapped_, colorHdr);
+        e.color_height = readAt<uint32_t>(mapped_, colorHdr + 4);
+        e.color_bytes = readAt<uint32_t>(mapped_, colorHdr + 8);
+        const size_t bytes = recording::recordBytes(depthBytes, e.color_bytes);
+        if (pos + bytes > mapped_size_) break;
+        index_.push_back(e);
+        pos += bytes + recording::paddingFor(bytes, version_);
+    }
+    if (trustCount && index_.size() < headerFrameCount) {
+        if (logger_) logger_->error("RecordingReader: file truncated ({} of {} frames present)", index_.size(), headerFrameCount);
+        return false;
+    }
+    return true;
+}
+
+size_t RecordingReader::depthPayloadBytes(size_t offset, uint32_t depthCount) const {
+    const size_t payload = offset + recording::DEPTH_PAYLOAD_OFFSET;
+    size_t bytes = size_t(depthCount) * sizeof(uint16_t);
+    if (codec_ != DepthCodec::Raw) {
+        if (payload + sizeof(uint32_t) > mapped_size_) return 0;
+        bytes = sizeof(uint32_t) + readAt<uint32_t>(mapped_, payload);
+    }
+    return payload + bytes <= mapped_size_ ? bytes : 0;
+}
+
+std::optional<RecordingReader::FrameView> RecordingReader::frame(size_t index) const {
+    if (index >= index_.size()) return std::nullopt;
+    const IndexEntry& e = index_[index];
+    const uint8_t* payload = mapped_ + e.offset + recording::DEPTH_PAYLOAD_OFFSET;
+    FrameView v;
+    v.timestamp_ns = e.timestamp_ns;
+    v.depth_width = e.depth_width;
+    v.depth_height = e.depth_height;
+    v.depth_count = e.depth_count;
+    v.depth_codec = codec_;
+    size_t depthBytes = size_t(e.depth_count) * sizeof(uint16_t);
+    if (codec_ == DepthCodec::Raw) {
+        v.depth = reinterpret_cast<const uint16_t*>(payload);
+    } else {
+        v.depth_encoded_bytes = readAt<uint32_t>(payload, 0);
+        v.depth_encoded = payload + sizeof(uint32_t);
+        depthBytes = sizeof(uint32_t) + v.depth_encoded_bytes;
+    }
+    v.color_width = e.color_width;
+    v.color_height = e.color_height;
+    v.color_bytes = e.color_bytes;
+    v.color = payload + depthBytes + 3 * sizeof(uint32_t);
+    return v;
+}
+
+bool RecordingReader::copyFrame(size_t index, common::RawDepthFrame& depth, common::RawColorFrame& color) const {
+    auto v = frame(index);
+    if (!v) return false;
+    depth.timestamp_ns = v->timestamp_ns;
+    depth.width = static_cast<int>(v->depth_width);
+    depth.height = static_cast<int>(v->depth_height);
+    depth.data.resize(v->depth_count);
+    if (v->depth_codec == DepthCodec::DeltaBitpack) {
+        if (!decodeDepthDelta(v->depth_encoded, v->depth_encoded_bytes, v->depth_count, v->depth_width, depth.data.data())) {
+            if (logger_) logger_->error("RecordingReader: corrupt depth payload in frame {}", index);
+            return false;
+        }
+    } else if (v->depth_count) {
+        std::memcpy(depth.data.data(), v->depth, size_t(v->depth_count) * sizeof(uint16_t));
+    }
+    color.timestamp_ns = v->timestamp_ns;
+    color.width = static_cast<int>(v->color_width);
+    color.height = static_cast<int>(v->color_height);
+    color.data.resize(v->color_bytes);
+    if (v->color_bytes) std::memcpy(color.data.data(), v->color, v->color_bytes);
+    return true;
+}
+
+} // namespace caldera::backend::hal
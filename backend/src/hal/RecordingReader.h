@@ -0,0 +1,80 @@
+#ifndef CALDERA_BACKEND_HAL_RECORDING_READER_H
+#define CALDERA_BACKEND_HAL_RECORDING_READER_H
+
+#include "hal/RecordingFormat.h"
+#include "hal/DepthCodec.h"
+#include "common/DataTypes.h"
+#include <cstdint>
+#include <optional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace spdlog { class logger; }
+
+namespace caldera::backend::hal {
+
+// Memory-mapped random access to a SensorRecorder file (v1 or v2).
+//
+// open() maps the file and loads (v2) or builds (v1 / unfinalized v2, header scan only) the frame
+// index; payloads are never read up front, so open time and resident memory do not grow with the
+// recording length beyond the 40-byte index entry per frame. Pages are faulted in by the kernel
+// as frames are viewed.
+class RecordingReader {
+public:
+    struct FrameView {
+        uint64_t timestamp_ns = 0;
+        uint32_t depth_width = 0;
+        uint32_t depth_height = 0;
+        uint32_t depth_count = 0;
+        const uint16_t* depth = nullptr; // points into mapped memory (invalidated by close()); null if encoded
+        const uint8_t* depth_encoded = nullptr; // DeltaBitpack payload (depth_codec != Raw)
+        uint32_t depth_encoded_bytes = 0;
+        DepthCodec depth_codec = DepthCodec::Raw;
+        uint32_t color_width = 0;
+        uint32_t color_height = 0;
+        uint32_t color_bytes = 0;
+        const uint8_t* color = nullptr;
+    };
+
+    explicit RecordingReader(std::shared_ptr<spdlog::logger> logger = nullptr) : logger_(std::move(logger)) {}
+    ~RecordingReader();
+    RecordingReader(const RecordingReader&) = delete;
+    RecordingReader& operator=(const RecordingReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return mapped_ != nullptr; }
+
+    uint32_t version() const { return version_; }
+    DepthCodec depthCodec() const { return codec_; }
+    size_t frameCount() const { return index_.size(); }
+    // True when the index came from the v2 trailer (no scan was needed).
+    bool hasStoredIndex() const { return stored_index_; }
+
+    // O(1) lookup; nullopt if out of range. v1 depth payloads are only 2-byte aligned.
+    std::optional<FrameView> frame(size_t index) const;
+
+    // Copies (decoding if needed) frame `index` into caller-owned (e.g. pooled) frames; returns
+    // false if out of range or the depth payload fails to decode.
+    bool copyFrame(size_t index, common::RawDepthFrame& depth, common::RawColorFrame& color) const;
+
+private:
+    bool loadStoredIndex(uint64_t indexOffset, uint32_t frameCount);
+    bool scanIndex(uint32_t headerFrameCount);
+    // Size of the depth payload of the record at `offset` (0 if it does not fit in the file).
+    size_t depthPayloadBytes(size_t offset, uint32_t depthCount) const;
+
+    std::shared_ptr<spdlog::logger> logger_;
+    int fd_ = -1;
+    const uint8_t* mapped_ = nullptr;
+    size_t mapped_size_ = 0;
+    uint32_t version_ = 0;
+    DepthCodec codec_ = DepthCodec::Raw;
+    bool stored_index_ = false;
+    std::vector<recording::IndexEntry> index_;
+};
+
+} // namespace caldera::backend::hal
+
+#endif // CALDERA_BACKEND_HAL_RECORDING_READER_H
@@ -0,0 +1,98 @@
+#include "hal/ReplayClock.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace caldera::backend::hal {
+
+ReplayClock::ReplayClock(Mode mode, std::chrono::milliseconds lockStepTimeout)
+    : mode_(mode), lock_step_timeout_(lockStepTimeout) {}
+
+std::shared_ptr<ReplayClock> ReplayClock::fromEnv() {
+    const char* v = std::getenv("CALDERA_REPLAY_CLOCK");
+    if (!v || !*v) return nullptr;
+    if (std::strcmp(v, "max") == 0 || std::strcmp(v, "maxrate") == 0) return std::make_shared<ReplayClock>(Mode::MaxRate);
+    if (std::strcmp(v, "lockstep") == 0) return std::make_shared<ReplayClock>(Mode::LockStep);
+    return std::make_shared<ReplayClock>(Mode::RealTime);
+}
+
+const char* ReplayClock::modeName(Mode mode) {
+    switch (mode) {
+        case Mode::RealTime: return "realtime";
+        case Mode::MaxRate: return "max";
+        case Mode::LockStep: return "lockstep";
+    }
+    return "unknown";
+}
+
+void ReplayClock::start(double fps, uint64_t epochNs) {
+    const double f = fps > 0.0 ? fps : 30.0;
+    period_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / f));
+    period_ns_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(period_).count());
+    const auto now = std::chrono::steady_clock::now();
+    next_tp_ = now;
+    epoch_ns_ = epochNs ? epochNs
+                        : static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count());
+    ticks_.store(0);
+    emitted_.store(0);
+    acked_.store(0);
+    cancelled_.store(false);
+}
+
+uint64_t ReplayClock::timestampNs(uint64_t tick) const {
+    if (mode_ == Mode::RealTime) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+    return epoch_ns_ + tick * period_ns_;
+}
+
+bool ReplayClock::pace(bool emitted) {
+    ticks_.fetch_add(1, std::memory_order_relaxed);
+    switch (mode_) {
+        case Mode::RealTime:
+            next_tp_ += period_;
+            std::this_thread::sleep_until(next_tp_);
+            return !cancelled_.load(std::memory_order_acquire);
+        case Mode::MaxRate:
+            return !cancelled_.load(std::memory_order_acquire);
+        case Mode::LockStep: {
+            if (!emitted) return !cancelled_.load(std::memory_order_acquire);
+            const uint64_t target = emitted_.fetch_add(1, std::memory_order_acq_rel) + 1;
+            std::unique_lock<std::mutex> lk(mutex_);
+            const bool done = cv_.wait_for(lk, lock_step_timeout_, [&] {
+                return acked_.load(std::memory_order_acquire) >= target || cancelled_.load(std::memory_order_acquire);
+            });
+            if (!done) {
+                timeouts_.fetch_add(1, std::memory_order_relaxed);
+                acked_.store(target, std::memory_order_release); // resynchronise: skip the lost ack
+            }
+            return !cancelled_.load(std::memory_order_acquire);
+        }
+    }
+    return true;
+}
+
+void ReplayClock::cancel() {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        cancelled_.store(true, std::memory_order_release);
+    }
+    cv_.notify_all();
+}
+
+void ReplayClock::frameDone() {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        acked_.fetch_add(1, std::memory_order_acq_rel);
+    }
+    cv_.notify_all();
+}
+
+ReplayClock::Stats ReplayClock::stats() const {
+    return Stats{ticks_.load(std::memory_order_relaxed), acked_.load(std::memory_order_relaxed),
+                 timeouts_.load(std::memory_order_relaxed)};
+}
+
+} // namespace caldera::backend::hal
@@ -0,0 +1,77 @@
+// ReplayClock.h
+// Injectable frame pacing for playback / synthetic devices (MockSensorDevice, SyntheticSensorDevice).
+
+#ifndef CALDERA_BACKEND_HAL_REPLAY_CLOCK_H
+#define CALDERA_BACKEND_HAL_REPLAY_CLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace caldera::backend::hal {
+
+// Modes:
+//  - RealTime : sleep to the nominal frame period (default; what devices did before).
+//  - MaxRate  : emit back-to-back; measures the pipeline ceiling and runs tests faster than real time.
+//  - LockStep : after each emitted frame wait until the consumer calls frameDone() (bounded by
+//               lockStepTimeout so a consumer that drops a frame cannot stall the device forever).
+// In MaxRate and LockStep, frame timestamps are synthetic (epoch + tick * period), so replays are
+// deterministic and consistent with the nominal fps regardless of how fast they run.
+class ReplayClock {
+public:
+    enum class Mode { RealTime, MaxRate, LockStep };
+
+    struct Stats {
+        uint64_t ticks = 0;              // frames paced
+        uint64_t acknowledged = 0;       // frameDone() calls
+        uint64_t lockstep_timeouts = 0;  // LockStep waits that gave up
+    };
+
+    explicit ReplayClock(Mode mode = Mode::RealTime,
+                         std::chrono::milliseconds lockStepTimeout = std::chrono::milliseconds(1000));
+
+    // CALDERA_REPLAY_CLOCK=realtime|max|lockstep; nullptr when unset (devices keep their default pacing).
+    static std::shared_ptr<ReplayClock> fromEnv();
+    static const char* modeName(Mode mode);
+
+    Mode mode() const { return mode_; }
+    bool synthetic() const { return mode_ != Mode::RealTime; }
+
+    // Device side. start() anchors tick 0 at steady_clock::now() (or epochNs if non-zero).
+    void start(double fps, uint64_t epochNs = 0);
+    // Timestamp for frame `tick`: synthetic in MaxRate/LockStep, steady_clock::now() in RealTime.
+    uint64_t timestampNs(uint64_t tick) const;
+    // Call once per produced frame after delivering it (emitted=false if it was dropped / not
+    // delivered, so LockStep does not wait for an acknowledgement that will never come).
+    // Returns false if the wait was cut short by cancel().
+    bool pace(bool emitted);
+    // Wakes a device blocked in pace() (device close / pipeline stop). Sticky until start().
+    void cancel();
+
+    // Consumer side (LockStep): the frame handed out last has been fully processed.
+    void frameDone();
+
+    Stats stats() const;
+
+private:
+    const Mode mode_;
+    const std::chrono::milliseconds lock_step_timeout_;
+    std::chrono::steady_clock::duration period_{};
+    std::chrono::steady_clock::time_point next_tp_{};
+    uint64_t epoch_ns_ = 0;
+    uint64_t period_ns_ = 0;
+    std::atomic<uint64_t> ticks_{0};
+    std::atomic<uint64_t> emitted_{0};
+    std::atomic<uint64_t> acked_{0};
+    std::atomic<uint64_t> timeouts_{0};
+    std::atomic<bool> cancelled_{false};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+} // namespace caldera::backend::hal
+
+#endif // CALDERA_BACKEND_HAL_REPLAY_CLOCK_H
@@ -0,0 +1,194 @@
+#include "hal/SandSurfaceGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace caldera::backend::hal {
+
+namespace {
+
+constexpr float kTwoPi = 6.28318530718f;
+
+inline uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform [0,1) from a 16-bit field.
+inline float unit16(uint64_t bits) { return static_cast<float>(bits & 0xFFFF) * (1.0f / 65536.0f); }
+
+// Squared distance from p to segment a-b.
+inline float segmentDist2(float px, float py, float ax, float ay, float bx, float by) {
+    const float dx = bx - ax, dy = by - ay;
+    const float len2 = dx * dx + dy * dy;
+    float t = len2 > 0.0f ? ((px - ax) * dx + (py - ay) * dy) / len2 : 0.0f;
+    t = std::clamp(t, 0.0f, 1.0f);
+    const float ex = px - (ax + t * dx), ey = py - (ay + t * dy);
+    return ex * ex + ey * ey;
+}
+
+} // namespace
+
+SandSurfaceGenerator::SandSurfaceGenerator(int width, int height, double fps, const Config& cfg)
+    : width_(std::max(1, width)), height_(std::max(1, height)), fps_(fps > 0.0 ? fps : 30.0), cfg_(cfg) {
+    const size_t n = static_cast<size_t>(width_) * height_;
+    const float scale = static_cast<float>(width_) / 640.0f;
+
+    // Dunes: three waves with seed-dependent direction and phase, plus a slight tilt.
+    surface_.resize(n);
+    struct Wave { float kx, ky, phase, weight; };
+    Wave waves[3];
+    const float weights[3] = {0.55f, 0.30f, 0.15f};
+    const float wavelength = std::max(8.0f, cfg_.duneWavelengthPx * scale);
+    for (int i = 0; i < 3; ++i) {
+        const uint64_t h = mix64(cfg_.seed * 0x9E3779B97F4A7C15ULL + 101 + i);
+        const float angle = unit16(h) * kTwoPi;
+        const float k = kTwoPi / (wavelength / static_cast<float>(1 << i)) * (0.8f + 0.4f * unit16(h >> 16));
+        waves[i] = Wave{k * std::cos(angle), k * std::sin(angle), unit16(h >> 32) * kTwoPi, weights[i]};
+    }
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            float s = 0.0f;
+            for (const Wave& w : waves) s += w.weight * std::sin(w.kx * x + w.ky * y + w.phase);
+            const float tilt = 10.0f * (static_cast<float>(y) / height_ - 0.5f);
+            surface_[static_cast<size_t>(y) * width_ + x] = cfg_.baseDepthMm + cfg_.duneAmplitudeMm * s + tilt;
+        }
+    }
+
+    // Persistent hole blobs.
+    holeMask_.assign(n, 0);
+    for (int b = 0; b < cfg_.holeBlobs; ++b) {
+        const uint64_t h = mix64(cfg_.seed * 0xD1B54A32D192ED03ULL + 7919 + b);
+        const float cx = unit16(h) * width_, cy = unit16(h >> 16) * height_;
+        const float r = (4.0f + 10.0f * unit16(h >> 32)) * scale;
+        const int x0 = std::max(0, static_cast<int>(cx - r)), x1 = std::min(width_ - 1, static_cast<int>(cx + r));
+        const int y0 = std::max(0, static_cast<int>(cy - r)), y1 = std::min(height_ - 1, static_cast<int>(cy + r));
+        for (int y = y0; y <= y1; ++y)
+            for (int x = x0; x <= x1; ++x)
+                if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r) holeMask_[static_cast<size_t>(y) * width_ + x] = 1;
+    }
+
+    int threads = cfg_.threads;
+    if (threads <= 0) threads = static_cast<int>(std::min(4u, std::max(1u, std::thread::hardware_concurrency())));
+    threads = std::min(threads, height_);
+    for (int band = 1; band < threads; ++band) workers_.emplace_back(&SandSurfaceGenerator::workerLoop, this, band, threads);
+}
+
+SandSurfaceGenerator::~SandSurfaceGenerator() {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        stop_ = true;
+    }
+    startCv_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+void SandSurfaceGenerator::generate(uint64_t frameIndex, uint16_t* out) {
+    if (!out) return;
+    // Hands follow seed-dependent Lissajous paths; the arm reaches in from the nearest border.
+    const float scale = static_cast<float>(width_) / 640.0f;
+    const float radius = cfg_.handRadiusPx * scale;
+    const float t = static_cast<float>(static_cast<double>(frameIndex) / fps_) * cfg_.handSpeed * kTwoPi;
+    handState_.clear();
+    for (int i = 0; i < cfg_.hands; ++i) {
+        const uint64_t h = mix64(cfg_.seed * 0x94D049BB133111EBULL + 31 + i);
+        const float fx = 1.0f + unit16(h), fy = 1.0f + unit16(h >> 16), ph = unit16(h >> 32) * kTwoPi;
+        const float cx = width_ * (0.5f + 0.35f * std::sin(fx * t + ph));
+        const float cy = height_ * (0.5f + 0.35f * std::sin(fy * t));
+        float bx = cx, by = cy;
+        const float dl = cx, dr = width_ - cx, dt = cy, db = height_ - cy;
+        const float m = std::min({dl, dr, dt, db});
+        if (m == dl) bx = -radius; else if (m == dr) bx = width_ + radius; else if (m == dt) by = -radius; else by = height_ + radius;
+        handState_.push_back(Hand{cx, cy, bx, by, radius * radius, 0.45f * radius,
+                                  std::min(cx, bx) - radius, std::max(cx, bx) + radius,
+                                  std::min(cy, by) - radius, std::max(cy, by) + radius});
+    }
+    frame_ = frameIndex;
+    out_ = out;
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        ++generation_;
+        pending_ = static_cast<int>(workers_.size());
+    }
+    startCv_.notify_all();
+    const int bands = threadCount();
+    renderRows(0, height_ / bands);
+    std::unique_lock<std::mutex> lk(mutex_);
+    doneCv_.wait(lk, [this] { return pending_ == 0; });
+}
+
+void SandSurfaceGenerator::workerLoop(int band, int bands) {
+    uint64_t seen = 0;
+    const int y0 = static_cast<int>(static_cast<int64_t>(height_) * band / bands);
+    const int y1 = static_cast<int>(static_cast<int64_t>(height_) * (band + 1) / bands);
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(mutex_);
+            startCv_.wait(lk, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        renderRows(y0, y1);
+        bool last = false;
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+            last = --pending_ == 0;
+        }
+        if (last) doneCv_.notify_one();
+    }
+}
+
+void SandSurfaceGenerator::renderRows(int y0, int y1) {
+    const uint64_t frameKey = mix64(cfg_.seed ^ (frame_ * 0x9E3779B97F4A7C15ULL));
+    const uint32_t dropThreshold = static_cast<uint32_t>(std::clamp(cfg_.dropoutProbability, 0.0f, 1.0f) * 4294967295.0f);
+    const uint32_t flickerThreshold = static_cast<uint32_t>(std::clamp(cfg_.flickerProbability, 0.0f, 1.0f) * 65535.0f);
+    const float handDepth = cfg_.baseDepthMm - cfg_.handHeightMm;
+    const int shadow = std::max(0, cfg_.shadowPx);
+
+    // Hands are few and small: each pixel tests the capsules whose bounds contain it.
+    auto insideHand = [this](float px, float py) {
+        for (const Hand& h : handState_) {
+            if (px < h.minX || px > h.maxX || py < h.minY || py > h.maxY) continue;
+            const float dx = px - h.x0, dy = py - h.y0;
+            if (dx * dx + dy * dy <= h.r2) return true;
+            if (segmentDist2(px, py, h.x0, h.y0, h.x1, h.y1) <= h.halfArm * h.halfArm) return true;
+        }
+        return false;
+    };
+
+    for (int y = y0; y < y1; ++y) {
+        const size_t row = static_cast<size_t>(y) * width_;
+        for (int x = 0; x < width_; ++x) {
+            const size_t idx = row + x;
+            uint16_t* dst = out_ + idx;
+            if (holeMask_[idx]) { *dst = 0; continue; }
+            const uint64_t h1 = mix64(frameKey + idx * 0xD1B54A32D192ED03ULL);
+            const uint64_t h2 = mix64(h1 ^ 0x2545F4914F6CDD1DULL);
+            if (static_cast<uint32_t>(h2) < dropThreshold) { *dst = 0; continue; }
+
+            float z = surface_[idx];
+            if (!handState_.empty()) {
+                const float px = static_cast<float>(x), py = static_cast<float>(y);
+                if (insideHand(px, py)) {
+                    z = handDepth;
+                } else if (shadow > 0 && (insideHand(px - shadow, py) || insideHand(px - 0.5f * shadow, py) || insideHand(px - 1.0f, py))) {
+                    *dst = 0; // IR projector shadow
+                    continue;
+                }
+            }
+
+            const float zm = z * 0.001f;
+            const float sigma = cfg_.noiseSigmaBaseMm + cfg_.noiseSigmaQuadMm * zm * zm;
+            // Irwin-Hall(4) approximation of a unit gaussian from four 16-bit uniforms.
+            const float g = (unit16(h1) + unit16(h1 >> 16) + unit16(h1 >> 32) + unit16(h1 >> 48) - 2.0f) * 1.7320508f;
+            z += g * sigma;
+            const float step = cfg_.quantizationMm * zm * zm;
+            if (step > 1.0f) z = std::round(z / step) * step;
+            if (((h2 >> 32) & 0xFFFF) < flickerThreshold) z += ((h2 >> 48) & 1) ? std::max(step, 1.0f) : -std::max(step, 1.0f);
+            *dst = static_cast<uint16_t>(std::clamp(z + 0.5f, 0.0f, 65535.0f));
+        }
+    }
+}
+
+} // namespace caldera::backend::hal
@@ -0,0 +1,89 @@
+// SandSurfaceGenerator.h
+// Procedural Kinect-like depth of a sandbox surface (SyntheticSensorDevice::Pattern::SAND).
+
+#ifndef CALDERA_BACKEND_HAL_SAND_SURFACE_GENERATOR_H
+#define CALDERA_BACKEND_HAL_SAND_SURFACE_GENERATOR_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace caldera::backend::hal {
+
+// Produces production-representative depth frames (millimetres, 0 = no reading) without hardware:
+//  - static dunes: a few superposed low-frequency waves below a flat reference plane
+//  - per-pixel noise: gaussian with depth-dependent sigma (base + quad * z_m^2) and disparity-like
+//    quantization (step = quant * z_m^2), plus flicker between adjacent quantization levels
+//  - dropouts: isolated random holes, persistent hole blobs and IR shadows beside hands
+//  - moving "hands": discs with an arm reaching in from the image border, well above the sand
+//
+// Noise is a pure function of (seed, frame index, pixel), so output is deterministic and identical
+// for any thread count. Rows are split into bands rendered by persistent worker threads.
+class SandSurfaceGenerator {
+public:
+    struct Config {
+        float baseDepthMm = 1100.0f;       // sensor-to-sand distance at the flat reference plane
+        float duneAmplitudeMm = 60.0f;     // peak height of the dunes above/below the plane
+        float duneWavelengthPx = 180.0f;   // dominant dune wavelength (scaled for other resolutions)
+        float noiseSigmaBaseMm = 0.5f;     // sigma(z) = base + quad * z_m^2
+        float noiseSigmaQuadMm = 1.5f;
+        float quantizationMm = 2.85f;      // step(z) = quantizationMm * z_m^2; 0 disables
+        float flickerProbability = 0.03f;  // per pixel/frame jump to a neighbouring quantization level
+        float dropoutProbability = 0.002f; // isolated per pixel/frame holes
+        int holeBlobs = 4;                 // persistent dropout regions (specular / absorbing spots)
+        int hands = 1;                     // moving intrusions
+        float handRadiusPx = 28.0f;        // at 640 px width (scaled)
+        float handHeightMm = 350.0f;       // above the sand surface
+        float handSpeed = 0.25f;           // path cycles per second at the nominal fps
+        int shadowPx = 6;                  // IR shadow width right of each hand/arm
+        uint32_t seed = 0x5A4D;
+        int threads = 0;                   // 0 = min(4, hardware threads)
+    };
+
+    SandSurfaceGenerator(int width, int height, double fps, const Config& cfg);
+    ~SandSurfaceGenerator();
+
+    SandSurfaceGenerator(const SandSurfaceGenerator&) = delete;
+    SandSurfaceGenerator& operator=(const SandSurfaceGenerator&) = delete;
+
+    // Writes width*height samples of frame `frameIndex` to out.
+    void generate(uint64_t frameIndex, uint16_t* out);
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int threadCount() const { return static_cast<int>(workers_.size()) + 1; }
+    // Noise-free surface depth (no hands) at (x, y) in millimetres.
+    float surfaceDepthMm(int x, int y) const { return surface_[static_cast<size_t>(y) * width_ + x]; }
+
+private:
+    struct Hand { float x0, y0, x1, y1, r2, halfArm, minX, maxX, minY, maxY; }; // palm centre, arm end, bounds
+
+    void renderRows(int y0, int y1);
+    void workerLoop(int band, int bands);
+
+    const int width_;
+    const int height_;
+    const double fps_;
+    const Config cfg_;
+    std::vector<float> surface_;       // dunes, precomputed
+    std::vector<uint8_t> holeMask_;    // 1 = inside a persistent hole blob
+
+    // Per-frame job, written by generate() before the workers are released.
+    uint64_t frame_ = 0;
+    uint16_t* out_ = nullptr;
+    std::vector<Hand> handState_;
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable startCv_;
+    std::condition_variable doneCv_;
+    uint64_t generation_ = 0;
+    int pending_ = 0;
+    bool stop_ = false;
+};
+
+} // namespace caldera::backend::hal
+
+#endif // CALDERA_BACKEND_HAL_SAND_SURFACE_GENERATOR_H
@@ -1,12 +1,38 @@
 #include "hal/SensorRecorder.h"
 #include "common/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <filesystem>
 #include <cstring>
 
 namespace caldera::backend::hal {
 
-SensorRecorder::SensorRecorder(const std::string& filename) 
-    : filename_(filename) {
+namespace {
+constexpr size_t kFileBufferBytes = 1 << 20; // batch small header writes into large syscalls
+constexpr int kWriterIdleWaitUs = 2000;
+} // namespace
+
+SensorRecorder::Options SensorRecorder::Options::fromEnv() {
+    Options o;
+    if (const char* s = std::getenv("CALDERA_RECORDER_SYNC")) {
+        o.async = !(std::strcmp(s, "1") == 0 || std::strcmp(s, "true") == 0);
+    }
+    if (const char* c = std::getenv("CALDERA_RECORDER_CODEC")) {
+        if (std::strcmp(c, "raw") == 0) o.depthCodec = DepthCodec::Raw;
+        else if (std::strcmp(c, "delta") == 0) o.depthCodec = DepthCodec::DeltaBitpack;
+    }
+    if (const char* d = std::getenv("CALDERA_RECORDER_QUEUE_DEPTH")) {
+        try { int n = std::stoi(d); if (n > 0) o.queueDepth = static_cast<size_t>(n); } catch (...) {}
+    }
+    return o;
+}
+
+SensorRecorder::SensorRecorder(const std::string& filename)
+    : SensorRecorder(filename, Options::fromEnv()) {}
+
+SensorRecorder::SensorRecorder(const std::string& filename, Options options)
+    : filename_(filename), options_(options), pool_(options.queueDepth + 2) {
     logger_ = common::Logger::instance().get("HAL.SensorRecorder");
 }
 
@@ -28,17 +54,33 @@ bool SensorRecorder::startRecording() {
         std::filesystem::create_directories(filepath.parent_path());
     }
 
+    file_buffer_.resize(kFileBufferBytes);
+    file_.rdbuf()->pubsetbuf(file_buffer_.data(), static_cast<std::streamsize>(file_buffer_.size()));
     file_.open(filename_, std::ios::binary);
     if (!file_.is_open()) {
         logger_->error("Failed to open file for recording: " + filename_);
         return false;
     }
 
+    frame_count_.store(0);
+    written_.store(0);
+    failed_.store(0);
+    max_queue_depth_.store(0);
+    depth_raw_bytes_.store(0);
+    depth_encoded_bytes_.store(0);
+    write_failed_.store(false);
+    index_.clear();
+    index_offset_ = 0;
     writeHeader();
+    if (options_.async) {
+        queue_ = std::make_unique<Queue>(common::MailboxPolicy::BoundedQueue, options_.queueDepth);
+        writer_running_.store(true);
+        writer_ = std::thread(&SensorRecorder::writerLoop, this);
+    }
     is_recording_ = true;
-    frame_count_ = 0;
 
-    logger_->info("Started recording to: " + filename_);
+    logger_->info("Started recording to: " + filename_ + (options_.async ? " (async" : " (sync") +
+                  (options_.depthCodec == DepthCodec::DeltaBitpack ? ", delta-bitpack depth)" : ", raw depth)"));
     return true;
 }
 
@@ -48,87 +90,248 @@ void SensorRecorder::stopRecording() {
     }
 
     is_recording_ = false;
+
+    // Let the writer drain everything already queued
+    if (writer_.joinable()) {
+        writer_running_.store(false);
+        wake_cv_.notify_all();
+        writer_.join();
+    }
     
-    // Update frame count in header
-    updateFrameCount();
+    // Append the frame index, then patch frame count + index offset into the header
+    writeIndex();
+    updateHeader();
+    frame_count_.store(index_.size());
     
     if (file_.is_open()) {
         file_.close();
     }
 
-    logger_->info("Stopped recording. Frames: " + std::to_string(frame_count_) + 
+    const Stats s = stats();
+    logger_->info("Stopped recording. Frames: " + std::to_string(s.written) +
+                  ", dropped: " + std::to_string(s.dropped) +
+                  ", max queue: " + std::to_string(s.max_queue_depth) +
+                  ", depth bytes: " + std::to_string(s.depth_encoded_bytes) + "/" + std::to_string(s.depth_raw_bytes) +
                   ", File size: " + std::to_string(getFileSizeBytes()) + " bytes");
+    pool_.clear(); // queue_ is kept so stats() stays valid after stop
 }
 
 void SensorRecorder::recordFrame(const common::RawDepthFrame& depth, const common::RawColorFrame& color) {
     if (!is_recording_ || !file_.is_open()) {
         return;
     }
+    if (!options_.async) {
+        writeFrame(depth, color);
+        return;
+    }
 
-    try {
-        // Write timestamp (use depth frame timestamp as primary)
-        file_.write(reinterpret_cast<const char*>(&depth.timestamp_ns), sizeof(uint64_t));
-        
-        // Write depth frame
-        uint32_t depth_width = static_cast<uint32_t>(depth.width);
-        uint32_t depth_height = static_cast<uint32_t>(depth.height);
-        uint32_t depth_size = static_cast<uint32_t>(depth.data.size());
-        
-        file_.write(reinterpret_cast<const char*>(&depth_width), sizeof(uint32_t));
-        file_.write(reinterpret_cast<const char*>(&depth_height), sizeof(uint32_t));
-        file_.write(reinterpret_cast<const char*>(&depth_size), sizeof(uint32_t));
-        file_.write(reinterpret_cast<const char*>(depth.data.data()), depth_size * sizeof(uint16_t));
-        
-        // Write color frame
-        uint32_t color_width = static_cast<uint32_t>(color.width);
-        uint32_t color_height = static_cast<uint32_t>(color.height);
-        uint32_t color_size = static_cast<uint32_t>(color.data.size());
-        
-        file_.write(reinterpret_cast<const char*>(&color_width), sizeof(uint32_t));
-        file_.write(reinterpret_cast<const char*>(&color_height), sizeof(uint32_t));
-        file_.write(reinterpret_cast<const char*>(&color_size), sizeof(uint32_t));
-        file_.write(reinterpret_cast<const char*>(color.data.data()), color_size);
-        
-        frame_count_++;
-        
-        // Flush periodically for safety
-        if (frame_count_ % 30 == 0) {
-            file_.flush();
-            logger_->debug("Recorded " + std::to_string(frame_count_) + " frames");
+    // One copy into pooled frames; the writer releases them back to the pool.
+    std::shared_ptr<common::RawDepthFrame> d = pool_.acquireDepth(depth.data.size());
+    d->sensorId = depth.sensorId;
+    d->timestamp_ns = depth.timestamp_ns;
+    d->width = depth.width;
+    d->height = depth.height;
+    std::copy(depth.data.begin(), depth.data.end(), d->data.begin());
+    std::shared_ptr<common::RawColorFrame> c = pool_.acquireColor(color.data.size());
+    c->sensorId = color.sensorId;
+    c->timestamp_ns = color.timestamp_ns;
+    c->width = color.width;
+    c->height = color.height;
+    std::copy(color.data.begin(), color.data.end(), c->data.begin());
+    recordFrame(RawDepthFrameHandle(std::move(d)), RawColorFrameHandle(std::move(c)));
+}
+
+void SensorRecorder::recordFrame(const RawDepthFrameHandle& depth, const RawColorFrameHandle& color) {
+    if (!is_recording_ || !file_.is_open() || !depth) {
+        return;
+    }
+    const RawColorFrameHandle& colorFrame = color ? color : emptyColorFrame();
+    if (!options_.async) {
+        writeFrame(*depth, *colorFrame);
+        return;
+    }
+
+    if (!queue_->push([&](PendingFrame& slot) { slot.depth = depth; slot.color = colorFrame; })) {
+        return; // dropped (counted by the queue); capture is never blocked on the disk
+    }
+    frame_count_.fetch_add(1, std::memory_order_relaxed);
+    const auto q = queue_->stats();
+    const uint64_t depthNow = q.pushed - q.dropped - q.consumed;
+    uint64_t prevMax = max_queue_depth_.load(std::memory_order_relaxed);
+    while (depthNow > prevMax && !max_queue_depth_.compare_exchange_weak(prevMax, depthNow, std::memory_order_relaxed)) {}
+    pending_.fetch_add(1, std::memory_order_release);
+    wake_cv_.notify_one();
+}
+
+void SensorRecorder::writerLoop() {
+    const auto idleWait = std::chrono::microseconds(kWriterIdleWaitUs);
+    auto write = [this](PendingFrame& slot) {
+        PendingFrame f = std::move(slot); // slot no longer pins the pooled buffers
+        writeFrame(*f.depth, *f.color);
+    };
+    while (true) {
+        pending_.store(0, std::memory_order_relaxed);
+        bool any = false;
+        while (queue_->consume(write)) any = true;
+        if (!writer_running_.load(std::memory_order_acquire)) {
+            if (queue_->empty()) break;
+            continue;
         }
-        
-    } catch (const std::exception& e) {
-        logger_->error("Failed to record frame: " + std::string(e.what()));
-        stopRecording();
+        if (any) continue;
+        std::unique_lock<std::mutex> lk(wake_mutex_);
+        wake_cv_.wait_for(lk, idleWait, [this] {
+            return pending_.load(std::memory_order_acquire) != 0 || !writer_running_.load(std::memory_order_acquire);
+        });
     }
 }
 
+void SensorRecorder::writeFrame(const common::RawDepthFrame& depth, const common::RawColorFrame& color) {
+    if (write_failed_.load(std::memory_order_relaxed)) {
+        failed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    recording::IndexEntry entry;
+    entry.offset = write_offset_;
+    entry.timestamp_ns = depth.timestamp_ns;
+
+    // Write timestamp (use depth frame timestamp as primary)
+    file_.write(reinterpret_cast<const char*>(&depth.timestamp_ns), sizeof(uint64_t));
+    
+    // Write depth frame
+    uint32_t depth_width = static_cast<uint32_t>(depth.width);
+    uint32_t depth_height = static_cast<uint32_t>(depth.height);
+    uint32_t depth_size = static_cast<uint32_t>(depth.data.size());
+    
+    file_.write(reinterpret_cast<const char*>(&depth_width), sizeof(uint32_t));
+    file_.write(reinterpret_cast<const char*>(&depth_height), sizeof(uint32_t));
+    file_.write(reinterpret_cast<const char*>(&depth_size), sizeof(uint32_t));
+    size_t depth_payload = size_t(depth_size) * sizeof(uint16_t);
+    if (options_.depthCodec == DepthCodec::DeltaBitpack) {
+        encode_buffer_.clear();
+        const uint32_t encoded = static_cast<uint32_t>(
+            encodeDepthDelta(depth.data.data(), depth_size, depth_width, encode_buffer_));
+        file_.write(reinterpret_cast<const char*>(&encoded), sizeof(uint32_t));
+        file_.write(reinterpret_cast<const char*>(encode_buffer_.data()), encoded);
+        depth_payload = sizeof(uint32_t) + encoded;
+    } else {
+        file_.write(reinterpret_cast<const char*>(depth.data.data()), depth_payload);
+    }
+    depth_raw_bytes_.fetch_add(size_t(depth_size) * sizeof(uint16_t), std::memory_order_relaxed);
+    depth_encoded_bytes_.fetch_add(depth_payload, std::memory_order_relaxed);
+    
+    // Write color frame
+    uint32_t color_width = static_cast<uint32_t>(color.width);
+    uint32_t color_height = static_cast<uint32_t>(color.height);
+    uint32_t color_size = static_cast<uint32_t>(color.data.size());
+    
+    file_.write(reinterpret_cast<const char*>(&color_width), sizeof(uint32_t));
+    file_.write(reinterpret_cast<const char*>(&color_height), sizeof(uint32_t));
+    file_.write(reinterpret_cast<const char*>(&color_size), sizeof(uint32_t));
+    file_.write(reinterpret_cast<const char*>(color.data.data()), color_size);
+
+    // Pad so the next record (and its depth payload) stays aligned for mapped playback
+    const size_t record_bytes = recording::recordBytes(depth_payload, color_size);
+    const size_t padding = recording::paddingFor(record_bytes, recording::CURRENT_VERSION);
+    static const char kZeros[recording::RECORD_ALIGNMENT] = {};
+    file_.write(kZeros, static_cast<std::streamsize>(padding));
+    write_offset_ += record_bytes + padding;
+
+    if (!file_) {
+        write_offset_ = entry.offset;
+        failed_.fetch_add(1, std::memory_order_relaxed);
+        abortRecording("write failed after " + std::to_string(index_.size()) + " frames");
+        return;
+    }
+
+    entry.depth_width = depth_width;
+    entry.depth_height = depth_height;
+    entry.depth_count = depth_size;
+    entry.color_width = color_width;
+    entry.color_height = color_height;
+    entry.color_bytes = color_size;
+    index_.push_back(entry);
+    const uint64_t written = written_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (!options_.async) {
+        frame_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    // Flush periodically for safety (off the capture thread when async)
+    if (written % 30 == 0) {
+        file_.flush();
+        logger_->debug("Recorded " + std::to_string(written) + " frames");
+    }
+}
+
+void SensorRecorder::abortRecording(const std::string& reason) {
+    // Keep what is on disk indexable: later frames are discarded, the index covers the good ones.
+    write_failed_.store(true, std::memory_order_relaxed);
+    file_.clear();
+    logger_->error("Failed to record frame: " + reason);
+}
+
+SensorRecorder::Stats SensorRecorder::stats() const {
+    Stats s;
+    s.written = written_.load(std::memory_order_relaxed);
+    s.max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+    s.depth_raw_bytes = depth_raw_bytes_.load(std::memory_order_relaxed);
+    s.depth_encoded_bytes = depth_encoded_bytes_.load(std::memory_order_relaxed);
+    if (queue_) {
+        const auto q = queue_->stats();
+        s.submitted = q.pushed;
+        s.dropped = q.dropped + failed_.load(std::memory_order_relaxed);
+        s.queue_depth = q.pushed - q.dropped - q.consumed;
+    } else {
+        s.dropped = failed_.load(std::memory_order_relaxed);
+        s.submitted = s.written + s.dropped;
+    }
+    return s;
+}
+
 void SensorRecorder::writeHeader() {
     // Magic number
-    file_.write(reinterpret_cast<const char*>(&MAGIC_NUMBER), sizeof(uint32_t));
+    file_.write(reinterpret_cast<const char*>(&recording::MAGIC_NUMBER), sizeof(uint32_t));
     
     // Version
-    file_.write(reinterpret_cast<const char*>(&FILE_VERSION), sizeof(uint32_t));
+    file_.write(reinterpret_cast<const char*>(&recording::CURRENT_VERSION), sizeof(uint32_t));
     
     // Frame count placeholder (updated when recording stops)
     uint32_t placeholder_count = 0;
     file_.write(reinterpret_cast<const char*>(&placeholder_count), sizeof(uint32_t));
     
-    // Reserved space for future metadata
+    // Reserved space: [0..1] index offset (0 until finalized), [2] depth codec, rest for future metadata
     uint32_t reserved[5] = {0};
+    reserved[2] = static_cast<uint32_t>(options_.depthCodec);
     file_.write(reinterpret_cast<const char*>(reserved), sizeof(reserved));
+    write_offset_ = recording::HEADER_BYTES;
+}
+
+void SensorRecorder::writeIndex() {
+    if (!file_.is_open()) {
+        return;
+    }
+
+    if (write_failed_.load(std::memory_order_relaxed)) {
+        // The tail may hold a partial record; the index overwrites it after the last good one.
+        file_.seekp(static_cast<std::streamoff>(write_offset_));
+    }
+    index_offset_ = write_offset_;
+    file_.write(reinterpret_cast<const char*>(index_.data()),
+                static_cast<std::streamsize>(index_.size() * sizeof(recording::IndexEntry)));
+    write_offset_ += index_.size() * sizeof(recording::IndexEntry);
 }
 
-void SensorRecorder::updateFrameCount() {
+void SensorRecorder::updateHeader() {
     if (!file_.is_open()) {
         return;
     }
 
     // Seek to frame count position (after magic + version)
-    file_.seekp(sizeof(uint32_t) * 2);
+    file_.seekp(recording::FRAME_COUNT_OFFSET);
     
-    uint32_t count = static_cast<uint32_t>(frame_count_);
+    uint32_t count = static_cast<uint32_t>(index_.size());
     file_.write(reinterpret_cast<const char*>(&count), sizeof(uint32_t));
+    file_.write(reinterpret_cast<const char*>(&index_offset_), sizeof(uint64_t));
     
     // Seek back to end
     file_.seekp(0, std::ios::end);
@@ -146,4 +349,4 @@ size_t SensorRecorder::getFileSizeBytes() const {
     }
 }
 
-} // namespace caldera::backend::hal
\ No newline at end of file
+} // namespace caldera::backend::hal
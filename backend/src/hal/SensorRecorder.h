@@ -2,10 +2,19 @@
 #define CALDERA_BACKEND_HAL_SENSOR_RECORDER_H
 
 #include "hal/ISensorDevice.h"
+#include "hal/FrameBufferPool.h"
+#include "hal/DepthCodec.h"
 #include "common/DataTypes.h"
+#include "common/FrameMailbox.h"
+#include "hal/RecordingFormat.h"
+#include <atomic>
+#include <condition_variable>
 #include <string>
 #include <fstream>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <spdlog/spdlog.h>
 
 namespace caldera::backend::hal {
@@ -13,9 +22,15 @@ namespace caldera::backend::hal {
 /**
  * SensorRecorder records sensor data to files for later playback in tests.
  * 
- * File format:
- * - Header: magic number, version, frame count
- * - For each frame: timestamp, depth data, color data
+ * File format (v2, see RecordingFormat.h):
+ * - Header: magic number, version, frame count, trailing index offset, depth codec
+ * - For each frame: timestamp, depth data, color data (padded to 8 bytes)
+ * - Trailing frame index (offset, timestamp, dims), written by stopRecording()
+ *
+ * By default recordFrame() only parks the frame in a bounded queue; a background writer thread
+ * encodes depth (lossless delta-bitpack, see DepthCodec.h) and does all file I/O, so recording
+ * never adds disk latency to the sensor callback. When the queue is full the frame is dropped
+ * and counted instead of blocking capture.
  * 
  * Usage:
  *   SensorRecorder recorder("test_data.dat");
@@ -25,36 +40,85 @@ namespace caldera::backend::hal {
  */
 class SensorRecorder {
 public:
+    struct Options {
+        bool async = true;                            // false = write on the calling thread
+        DepthCodec depthCodec = DepthCodec::DeltaBitpack;
+        size_t queueDepth = 8;                        // frames buffered ahead of the writer
+        // CALDERA_RECORDER_SYNC=1, CALDERA_RECORDER_CODEC=raw|delta, CALDERA_RECORDER_QUEUE_DEPTH=N
+        static Options fromEnv();
+    };
+
+    struct Stats {
+        uint64_t submitted = 0;      // frames offered to recordFrame() while recording
+        uint64_t written = 0;        // frames on disk
+        uint64_t dropped = 0;        // rejected because the writer queue was full (or after a write error)
+        uint64_t queue_depth = 0;    // frames currently waiting for the writer
+        uint64_t max_queue_depth = 0;
+        uint64_t depth_raw_bytes = 0;     // depth payload before encoding
+        uint64_t depth_encoded_bytes = 0; // depth payload as written
+    };
+
     explicit SensorRecorder(const std::string& filename);
+    SensorRecorder(const std::string& filename, Options options);
     ~SensorRecorder();
 
-    // Start/stop recording
+    // Start/stop recording (stop drains the queue, then writes the index)
     bool startRecording();
     void stopRecording();
     bool isRecording() const { return is_recording_; }
 
-    // Record a frame (called from sensor callback)
+    // Record a frame (called from the sensor callback; single producer). Never blocks on I/O.
+    // The by-reference overload copies once into a pooled frame; the handle overload shares it.
     void recordFrame(const common::RawDepthFrame& depth, const common::RawColorFrame& color);
+    void recordFrame(const RawDepthFrameHandle& depth, const RawColorFrameHandle& color);
 
     // Get stats
-    size_t getFrameCount() const { return frame_count_; }
+    size_t getFrameCount() const { return frame_count_.load(std::memory_order_relaxed); } // accepted frames
     size_t getFileSizeBytes() const;
+    Stats stats() const;
 
 private:
+    struct PendingFrame {
+        RawDepthFrameHandle depth;
+        RawColorFrameHandle color;
+    };
+    using Queue = common::SpscFrameMailbox<PendingFrame>;
+
     void writeHeader();
-    void updateFrameCount();
+    void writeFrame(const common::RawDepthFrame& depth, const common::RawColorFrame& color);
+    void writeIndex();
+    void updateHeader();
+    void writerLoop();
+    void abortRecording(const std::string& reason);
 
     std::string filename_;
+    Options options_;
     std::ofstream file_;
-    bool is_recording_ = false;
-    size_t frame_count_ = 0;
+    std::vector<char> file_buffer_;
+    std::atomic<bool> is_recording_{false};
+    std::atomic<size_t> frame_count_{0};
+    uint64_t write_offset_ = 0;  // bytes written so far (next record offset)
+    uint64_t index_offset_ = 0;
+    std::vector<recording::IndexEntry> index_;
+    std::vector<uint8_t> encode_buffer_;
     std::shared_ptr<spdlog::logger> logger_;
 
-    // File format constants
-    static constexpr uint32_t MAGIC_NUMBER = 0x4B494E54; // "KINT"
-    static constexpr uint32_t FILE_VERSION = 1;
+    // Async writer
+    FrameBufferPool pool_;
+    std::unique_ptr<Queue> queue_;
+    std::thread writer_;
+    std::atomic<bool> writer_running_{false};
+    std::atomic<bool> write_failed_{false};
+    std::atomic<uint32_t> pending_{0};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> failed_{0}; // discarded after a write error
+    std::atomic<uint64_t> max_queue_depth_{0};
+    std::atomic<uint64_t> depth_raw_bytes_{0};
+    std::atomic<uint64_t> depth_encoded_bytes_{0};
 };
 
 } // namespace caldera::backend::hal
 
-#endif // CALDERA_BACKEND_HAL_SENSOR_RECORDER_H
\ No newline at end of file
+#endif // CALDERA_BACKEND_HAL_SENSOR_RECORDER_H
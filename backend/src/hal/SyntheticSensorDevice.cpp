@@ -28,12 +28,12 @@ bool SyntheticSensorDevice::open() {
 
 void SyntheticSensorDevice::close() {
     if (!running_.exchange(false)) return;
+    if (clock_) clock_->cancel(); // releases a LockStep wait
     if (worker_.joinable()) worker_.join();
     if (log_) log_->info("SyntheticSensorDevice stopped id={}", cfg_.sensorId);
 #ifdef __GLIBC__
-    // Clear and shrink persistent reusable buffer to encourage allocator to return pages.
-    reusable_depth_.clear();
-    reusable_depth_.shrink_to_fit();
+    // Drop idle pooled frames to encourage allocator to return pages.
+    pool_.clear();
 #endif
 #ifdef __GLIBC__
     // Optionally trim allocator caches to improve RSS stability for tight memory tests.
@@ -48,18 +48,11 @@ void SyntheticSensorDevice::close() {
 }
 
 void SyntheticSensorDevice::runLoop() {
-    using clock = std::chrono::steady_clock;
-    auto period = std::chrono::duration<double>(1.0 / cfg_.fps);
-    auto next_tp = clock::now();
+    // Without an injected clock pace in real time, as a live sensor would.
+    std::shared_ptr<ReplayClock> clock = clock_ ? clock_ : std::make_shared<ReplayClock>();
+    clock->start(cfg_.fps);
+    const uint64_t firstTick = frame_counter_;
     const size_t pixelCount = static_cast<size_t>(cfg_.width) * cfg_.height;
-    if (reusable_depth_.size() != pixelCount) {
-        reusable_depth_.assign(pixelCount, 0);
-    }
-    RawDepthFrame raw; // small struct reused each loop (vector owns copied depth data)
-    raw.sensorId = cfg_.sensorId;
-    raw.width = cfg_.width;
-    raw.height = cfg_.height;
-    raw.data.clear();
     std::mt19937 rng;
     while (running_.load()) {
         // Pause gate (simple sleep loop to avoid busy spin). Keeps steady_clock origin fresh when resuming.
@@ -67,11 +60,19 @@ void SyntheticSensorDevice::runLoop() {
             std::this_thread::sleep_for(1ms);
         }
         if (!running_.load()) break;
-        // Fill persistent depth buffer then assign into raw frame's vector (same capacity -> no alloc after first)
-    fillPattern(reusable_depth_);
-    if (base_checksum_ == 0) base_checksum_ = computeCRC(reusable_depth_);
-    raw.data.assign(reusable_depth_.begin(), reusable_depth_.end());
-        raw.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+        // Fill a pooled frame in place; it is handed downstream without a copy and recycled on release.
+        std::shared_ptr<RawDepthFrame> raw = pool_.acquireDepth(pixelCount);
+        raw->sensorId = cfg_.sensorId;
+        raw->width = cfg_.width;
+        raw->height = cfg_.height;
+        if (cfg_.pattern == Pattern::SAND) {
+            if (!sand_) sand_ = std::make_unique<SandSurfaceGenerator>(cfg_.width, cfg_.height, cfg_.fps, cfg_.sand);
+            sand_->generate(frame_counter_, raw->data.data());
+        } else {
+            fillPattern(raw->data);
+        }
+        if (base_checksum_ == 0) base_checksum_ = computeCRC(raw->data);
+        raw->timestamp_ns = clock->timestampNs(frame_counter_ - firstTick);
         produced_frames_.fetch_add(1, std::memory_order_relaxed);
         bool drop = false;
         uint32_t dropN = fi_dropEveryN_.load(std::memory_order_relaxed);
@@ -88,9 +89,14 @@ void SyntheticSensorDevice::runLoop() {
             uint32_t extra = dist(rng);
             if (extra) std::this_thread::sleep_for(std::chrono::milliseconds(extra));
         }
+        bool delivered = false;
         if (!drop) {
-            if (callback_) {
-                callback_(raw, RawColorFrame{});
+            delivered = handle_callback_ || callback_;
+            if (handle_callback_) {
+                handle_callback_(raw, emptyColorFrame());
+                emitted_frames_.fetch_add(1, std::memory_order_relaxed);
+            } else if (callback_) {
+                callback_(*raw, RawColorFrame{});
                 emitted_frames_.fetch_add(1, std::memory_order_relaxed);
             }
         } else {
@@ -112,8 +118,8 @@ void SyntheticSensorDevice::runLoop() {
                 }
             }
         }
-        next_tp += std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
-        std::this_thread::sleep_until(next_tp);
+        raw.reset(); // back to the pool before waiting, the consumer may still hold its own handle
+        clock->pace(delivered);
     }
 }
 
@@ -171,6 +177,8 @@ void SyntheticSensorDevice::fillPattern(std::vector<uint16_t>& buf) const {
             }
             break;
         }
+        case Pattern::SAND: // frame dependent, rendered by sand_ in runLoop
+            break;
     }
 }
 
@@ -5,6 +5,7 @@
 #define CALDERA_BACKEND_HAL_SYNTHETIC_SENSOR_DEVICE_H
 
 #include "hal/ISensorDevice.h"
+#include "hal/SandSurfaceGenerator.h"
 #include <atomic>
 #include <thread>
 #include <memory>
@@ -14,7 +15,9 @@ namespace caldera::backend::hal {
 
 class SyntheticSensorDevice : public ISensorDevice {
 public:
-    enum class Pattern { RAMP, CONSTANT, CHECKER, STRIPES, RADIAL }; // STRIPES: horizontal bands; RADIAL: concentric gradient center-high
+    // STRIPES: horizontal bands; RADIAL: concentric gradient center-high;
+    // SAND: Kinect-like sandbox depth with dunes, noise, dropouts and moving hands (SandSurfaceGenerator)
+    enum class Pattern { RAMP, CONSTANT, CHECKER, STRIPES, RADIAL, SAND };
     struct Config {
         int width = 16;
         int height = 16;
@@ -22,6 +25,7 @@ public:
         Pattern pattern = Pattern::RAMP;
         uint16_t constantValue = 1000; // used if pattern == CONSTANT
         std::string sensorId = "Synthetic_0";
+        SandSurfaceGenerator::Config sand{}; // used if pattern == SAND
     };
 
     struct FaultInjectionConfig {
@@ -38,6 +42,7 @@ public:
     bool isRunning() const override { return running_.load(); }
     std::string getDeviceID() const override { return cfg_.sensorId; }
     void setFrameCallback(RawFrameCallback callback) override { callback_ = std::move(callback); }
+    void setFrameHandleCallback(RawFrameHandleCallback callback) override { handle_callback_ = std::move(callback); }
     // Control hooks for fault-injection phases (test-only usage):
     void pause();
     void resume();
@@ -45,9 +50,16 @@ public:
     uint64_t framesGenerated() const { return frame_counter_; }
     bool isPaused() const { return paused_.load(); }
     void configureFaultInjection(const FaultInjectionConfig& fic);
+    // Pacing (set before open()). Default is real time; MaxRate / LockStep stamp frames with
+    // synthetic timestamps (open time + frame index * period) so replays stay deterministic.
+    void setReplayClock(std::shared_ptr<ReplayClock> clock) { clock_ = std::move(clock); }
+    std::shared_ptr<ReplayClock> replayClock() const override { return clock_; }
     struct Stats { uint64_t produced=0; uint64_t emitted=0; uint64_t dropped=0; };
     Stats stats() const { return Stats{produced_frames_.load(), emitted_frames_.load(), dropped_frames_.load()}; }
 
+    // Frame buffer pool counters (tests assert allocations stop growing once warm).
+    FrameBufferPool::Stats bufferStats() const { return pool_.stats(); }
+
     // Expose base pattern checksum (for internal debugging only); tests should regenerate pattern independently.
     uint32_t basePatternChecksum() const { return base_checksum_; }
 
@@ -59,9 +71,12 @@ private:
     Config cfg_{};
     std::shared_ptr<spdlog::logger> log_;
     RawFrameCallback callback_{};
+    RawFrameHandleCallback handle_callback_{};
     std::atomic<bool> running_{false};
     std::atomic<bool> paused_{false};
     std::thread worker_;
+    std::shared_ptr<ReplayClock> clock_;
+    std::unique_ptr<SandSurfaceGenerator> sand_; // created on first SAND frame, kept across open/close
     uint64_t frame_counter_ = 0;
     uint32_t base_checksum_ = 0; // checksum of static spatial pattern (ignoring frame counter)
     std::atomic<uint64_t> stop_after_{0};
@@ -73,8 +88,8 @@ private:
     std::atomic<uint64_t> produced_frames_{0};
     std::atomic<uint64_t> emitted_frames_{0};
     std::atomic<uint64_t> dropped_frames_{0};
-    // Persistent reusable frame buffer to allow deterministic capacity management & shrinking on close.
-    std::vector<uint16_t> reusable_depth_;
+    // Recycled depth frames filled in place each tick; released (and shrunk) on close.
+    FrameBufferPool pool_;
 };
 
 } // namespace caldera::backend::hal
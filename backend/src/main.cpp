@@ -2,6 +2,7 @@
 #include "common/LoggingNames.h"
 
 #include "AppManager.h"
+#include "hal/HAL_Manager.h"
 #include "hal/ISensorDevice.h"
 #include "hal/MockSensorDevice.h"
 #include "hal/KinectV2_Device.h"
@@ -15,11 +16,13 @@
 #endif
 #include "common/SensorResolutions.h"
 
+#include <cstdio>
 #include <exception>
 #include <thread>
 #include <chrono>
 #include <iostream>
 #include <string>
+#include <vector>
 
 void printUsage(const char* program_name) {
     std::cout << "Usage: " << program_name << " [OPTIONS]\n\n";
@@ -32,7 +35,12 @@ void printUsage(const char* program_name) {
     std::cout << "  --help, -h        Show this help message\n\n";
     std::cout << "Environment Variables:\n";
     std::cout << "  CALDERA_SENSOR_TYPE               Sensor type (same as --sensor)\n";
+    std::cout << "  CALDERA_SENSORS                   Comma-separated sensor types run together via HAL_Manager\n";
     std::cout << "  CALDERA_SENSOR_RECORDING_PATH     Path to recording file for mock_recording\n";
+    std::cout << "  CALDERA_REPLAY_CLOCK              mock_recording/synthetic pacing: realtime, max, lockstep\n";
+    std::cout << "  CALDERA_SYNTHETIC_PATTERN         synthetic pattern: ramp (default) or sand (640x480 sandbox)\n";
+    std::cout << "  CALDERA_SYNTHETIC_SIZE            synthetic resolution WxH (e.g. 512x424)\n";
+    std::cout << "  CALDERA_SYNTHETIC_FPS             synthetic frame rate (e.g. 120)\n";
     std::cout << "  CALDERA_SHM_MAX_WIDTH             SharedMemory max width (default: auto)\n";
     std::cout << "  CALDERA_SHM_MAX_HEIGHT            SharedMemory max height (default: auto)\n";
     std::cout << "  CALDERA_MULTI_SENSOR              Enable multi-sensor mode (1/true): larger SHM for fusion\n";
@@ -130,9 +138,62 @@ int main(int argc, char* argv[]) {
 		auto transportLog = Logger::instance().get(TRANSPORT_SERVER);
 		auto handshakeLog = Logger::instance().get(TRANSPORT_HANDSHAKE);
 
-		// Construct sensor device via simple factory
-		std::unique_ptr<hal::ISensorDevice> device;
-		
+		// Construct sensor devices via simple factory (index distinguishes several devices of one type)
+		auto makeDevice = [&](const std::string& sensor, size_t index) -> std::unique_ptr<hal::ISensorDevice> {
+			const std::string suffix = index ? "_" + std::to_string(index) : std::string();
+			if (sensor == "kinect_v2" || sensor == "kinect2") { // Support both new and legacy names
+				halLog->info("Factory: using KinectV2_Device");
+				return std::make_unique<hal::KinectV2_Device>();
+			} else if (sensor == "kinect_v1" || sensor == "kinect1") { // Support both new and legacy names
+	#if CALDERA_HAVE_KINECT_V1
+				halLog->info("Factory: using KinectV1_Device");
+				return std::make_unique<hal::KinectV1_Device>();
+	#else
+				halLog->error("Kinect v1 requested but CALDERA_HAVE_KINECT_V1=0 (build without libfreenect)");
+				return std::make_unique<hal::MockSensorDevice>("unused.dat");
+	#endif
+			} else if (sensor == "mock_recording") {
+				// Expect CALDERA_SENSOR_RECORDING_PATH to point to a .dat file created by SensorRecorder
+				const char* path = std::getenv("CALDERA_SENSOR_RECORDING_PATH");
+				std::string file = path ? path : "test_sensor_data.dat";
+				auto mock = std::make_unique<hal::MockSensorDevice>(file);
+				if (auto clock = hal::ReplayClock::fromEnv()) {
+					mock->setReplayClock(clock);
+					halLog->info("Factory: replay clock mode={}", hal::ReplayClock::modeName(clock->mode()));
+				}
+				halLog->info("Factory: using MockSensorDevice playback file={} (ONCE)", file);
+				return mock;
+			} else if (sensor == "synthetic") {
+				hal::SyntheticSensorDevice::Config cfg; // small deterministic config
+				cfg.sensorId = "proc_synth" + suffix;
+				cfg.width = 32; cfg.height = 24; cfg.fps = 30.0f; cfg.pattern = hal::SyntheticSensorDevice::Pattern::RAMP;
+				// CALDERA_SYNTHETIC_PATTERN=sand switches to the Kinect-like sand surface (default 640x480);
+				// CALDERA_SYNTHETIC_SIZE=WxH (e.g. 512x424) and CALDERA_SYNTHETIC_FPS override the geometry.
+				if (const char* p = std::getenv("CALDERA_SYNTHETIC_PATTERN"); p && std::string(p) == "sand") {
+					cfg.pattern = hal::SyntheticSensorDevice::Pattern::SAND;
+					cfg.width = 640; cfg.height = 480;
+					cfg.sand.seed += static_cast<uint32_t>(index); // distinct noise per sensor
+				}
+				if (const char* sz = std::getenv("CALDERA_SYNTHETIC_SIZE")) {
+					int w = 0, h = 0;
+					if (std::sscanf(sz, "%dx%d", &w, &h) == 2 && w > 0 && h > 0) { cfg.width = w; cfg.height = h; }
+				}
+				if (const char* f = std::getenv("CALDERA_SYNTHETIC_FPS")) {
+					try { double v = std::stod(f); if (v > 0.0) cfg.fps = v; } catch(...) {}
+				}
+				auto synth = std::make_unique<hal::SyntheticSensorDevice>(cfg, halLog);
+				if (auto clock = hal::ReplayClock::fromEnv()) {
+					synth->setReplayClock(clock);
+					halLog->info("Factory: replay clock mode={}", hal::ReplayClock::modeName(clock->mode()));
+				}
+				halLog->info("Factory: using SyntheticSensorDevice id={} size={}x{} fps={}", cfg.sensorId, cfg.width, cfg.height, cfg.fps);
+				return synth;
+			}
+			// fallback
+			halLog->info("Factory: using MockSensorDevice (synthetic; file load may fail if missing)");
+			return std::make_unique<hal::MockSensorDevice>("unused.dat");
+		};
+
 		// Priority: command line flag > environment variable > default
 		std::string sensor;
 		if (!sensor_override.empty()) {
@@ -141,32 +202,28 @@ int main(int argc, char* argv[]) {
 			const char* sensorType = std::getenv("CALDERA_SENSOR_TYPE");
 			sensor = sensorType ? sensorType : "mock"; // default mock
 		}
-		if (sensor == "kinect_v2" || sensor == "kinect2") { // Support both new and legacy names
-			device = std::make_unique<hal::KinectV2_Device>();
-			halLog->info("Factory: using KinectV2_Device");
-		} else if (sensor == "kinect_v1" || sensor == "kinect1") { // Support both new and legacy names
-	#if CALDERA_HAVE_KINECT_V1
-			device = std::make_unique<hal::KinectV1_Device>();
-			halLog->info("Factory: using KinectV1_Device");
-	#else
-			halLog->error("Kinect v1 requested but CALDERA_HAVE_KINECT_V1=0 (build without libfreenect)");
-			device = std::make_unique<hal::MockSensorDevice>("unused.dat");
-	#endif
-		} else if (sensor == "mock_recording") {
-			// Expect CALDERA_SENSOR_RECORDING_PATH to point to a .dat file created by SensorRecorder
-			const char* path = std::getenv("CALDERA_SENSOR_RECORDING_PATH");
-			std::string file = path ? path : "test_sensor_data.dat";
-			device = std::make_unique<hal::MockSensorDevice>(file);
-			halLog->info("Factory: using MockSensorDevice playback file={} (ONCE)", file);
-		} else if (sensor == "synthetic") {
-            hal::SyntheticSensorDevice::Config cfg; // small deterministic config
-            cfg.sensorId = "proc_synth";
-            cfg.width = 32; cfg.height = 24; cfg.fps = 30.0f; cfg.pattern = hal::SyntheticSensorDevice::Pattern::RAMP;
-            device = std::make_unique<hal::SyntheticSensorDevice>(cfg, halLog);
-            halLog->info("Factory: using SyntheticSensorDevice size={}x{} fps={}", cfg.width, cfg.height, cfg.fps);
-		} else { // fallback
-			device = std::make_unique<hal::MockSensorDevice>("unused.dat");
-			halLog->info("Factory: using MockSensorDevice (synthetic; file load may fail if missing)");
+		// CALDERA_SENSORS=type,type,... runs several devices through HAL_Manager (synchronized frame sets).
+		std::vector<std::string> sensorList;
+		if (const char* list = std::getenv("CALDERA_SENSORS")) {
+			std::string item;
+			for (const char* c = list;; ++c) {
+				if (*c == ',' || *c == '\0') {
+					if (!item.empty()) sensorList.push_back(item);
+					item.clear();
+					if (*c == '\0') break;
+				} else if (*c != ' ') {
+					item += *c;
+				}
+			}
+		}
+		std::unique_ptr<hal::ISensorDevice> device;
+		std::unique_ptr<hal::HAL_Manager> halManager;
+		if (sensorList.size() > 1) {
+			halManager = std::make_unique<hal::HAL_Manager>(halLog, udpLog, hal::HAL_Manager::Config::fromEnv());
+			for (size_t i = 0; i < sensorList.size(); ++i) halManager->addDevice(makeDevice(sensorList[i], i));
+			sensor = "multi";
+		} else {
+			device = makeDevice(sensorList.empty() ? sensor : sensorList.front(), 0);
 		}
 
 		auto processing = std::make_shared<processing::ProcessingManager>(procOrchLog, fusionLog);
@@ -224,13 +281,15 @@ int main(int argc, char* argv[]) {
 			transportLog->info("Using LocalTransportServer (in-proc FIFO)");
 		}
 
-		AppManager app(appLog, std::move(device), processing, transport);
-		app.start();
+		std::unique_ptr<AppManager> app = halManager
+			? std::make_unique<AppManager>(appLog, std::move(halManager), processing, transport)
+			: std::make_unique<AppManager>(appLog, std::move(device), processing, transport);
+		app->start();
 
 		// Run loop duration override via CALDERA_RUN_SECS (default 2)
 		int runSecs = 2; if (const char* rs = std::getenv("CALDERA_RUN_SECS")) { try { runSecs = std::max(1, std::stoi(rs)); } catch(...) {} }
 		std::this_thread::sleep_for(std::chrono::seconds(runSecs));
-		app.stop();
+		app->stop();
 	} catch (const std::exception& ex) {
 		Logger::instance().get(APP_LIFECYCLE)->critical(std::string("Fatal exception: ") + ex.what());
 		Logger::instance().shutdown();
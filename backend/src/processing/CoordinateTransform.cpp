@@ -8,6 +8,62 @@ namespace caldera::backend::processing {
 using caldera::backend::common::Point3D;
 using caldera::backend::common::DepthFrame;
 
+namespace {
+constexpr size_t kRayBlock = 64; // pixels per block = one InternalPointCloud validity word
+
+struct RayBlockInput {
+    const float* depth;
+    const float* rx;
+    const float* ry;
+    const float* rz;
+    float origin[3];
+    float scale;
+    float offset;
+    const float* minPlane;
+    const float* maxPlane;
+};
+
+// world = (depth * scale + offset) * ray + origin, then the plane test of transformPixelToWorld.
+// Block kernel as in FusedBuildKernel.h (block-local results, N = 0 for the tail). The body is
+// branch-free: depth > 0 also rejects NaN and (v - v) == 0 rejects non-finite results. Rejected
+// points are written as (0,0,0).
+template <size_t N>
+uint64_t unprojectBlock(const RayBlockInput& in, size_t base, size_t n, InternalPointCloud& out) {
+    const size_t count = N ? N : n;
+    alignas(32) float wx[kRayBlock], wy[kRayBlock], wz[kRayBlock];
+    alignas(32) uint8_t ok[kRayBlock];
+    const float* depth = in.depth + base;
+    const float* rx = in.rx + base;
+    const float* ry = in.ry + base;
+    const float* rz = in.rz + base;
+    const float* lo = in.minPlane;
+    const float* hi = in.maxPlane;
+    for (size_t k = 0; k < count; ++k) {
+        const float raw = depth[k];
+        const float d = raw * in.scale + in.offset;
+        const float x = d * rx[k] + in.origin[0];
+        const float y = d * ry[k] + in.origin[1];
+        const float z = d * rz[k] + in.origin[2];
+        const float minV = lo[0] * x + lo[1] * y + lo[2] * z + lo[3];
+        const float maxV = hi[0] * x + hi[1] * y + hi[2] * z + hi[3];
+        const bool good = (raw > 0.0f) & ((x - x) == 0.0f) & ((y - y) == 0.0f) & ((z - z) == 0.0f)
+                        & (minV >= 0.0f) & (maxV <= 0.0f);
+        wx[k] = good ? x : 0.0f;
+        wy[k] = good ? y : 0.0f;
+        wz[k] = good ? z : 0.0f;
+        ok[k] = good ? 1 : 0;
+    }
+    std::copy(wx, wx + count, out.x.data() + base);
+    std::copy(wy, wy + count, out.y.data() + base);
+    std::copy(wz, wz + count, out.z.data() + base);
+    uint64_t word = 0;
+    for (size_t k = 0; k < count; ++k) {
+        word |= static_cast<uint64_t>(ok[k]) << k;
+    }
+    return word;
+}
+} // namespace
+
 CoordinateTransform::CoordinateTransform()
     : logger_(common::Logger::instance().get("CoordinateTransform"))
     , sensorId_("")
@@ -93,6 +149,8 @@ bool CoordinateTransform::loadFromCalibration(const tools::calibration::SensorCa
                   params_.principalPointX, params_.principalPointY);
     
     isConfigured_ = true;
+    // Rays depend only on intrinsics and pose, so they are built once here for the native resolution.
+    prepareRayTable(nativeWidth_, nativeHeight_);
     logger_->info("Coordinate transformation loaded successfully for sensor: {}", sensorId_);
     
     return true;
@@ -150,17 +208,22 @@ bool CoordinateTransform::transformFrameToWorld(const DepthFrame& depthFrame, In
     int validPixels = 0;
     int totalPixels = depthFrame.width * depthFrame.height;
     
-    // Transform each pixel
-    for (int y = 0; y < depthFrame.height; y++) {
-        for (int x = 0; x < depthFrame.width; x++) {
-            int index = y * depthFrame.width + x;
-            float depthValue = depthFrame.data[index];
-            
-            Point3D worldPoint = transformPixelToWorld(x, y, depthValue);
-            pointCloud.points[index] = worldPoint;
-            
-            if (worldPoint.valid) {
-                validPixels++;
+    if (rays_.matches(static_cast<uint32_t>(depthFrame.width), static_cast<uint32_t>(depthFrame.height))
+        && depthFrame.data.size() >= static_cast<size_t>(totalPixels)) {
+        validPixels = static_cast<int>(transformFrameWithRays(depthFrame, pointCloud));
+    } else {
+        // Transform each pixel
+        for (int y = 0; y < depthFrame.height; y++) {
+            for (int x = 0; x < depthFrame.width; x++) {
+                int index = y * depthFrame.width + x;
+                float depthValue = depthFrame.data[index];
+                
+                Point3D worldPoint = transformPixelToWorld(x, y, depthValue);
+                pointCloud.setPoint(index, worldPoint);
+                
+                if (worldPoint.valid) {
+                    validPixels++;
+                }
             }
         }
     }
@@ -172,6 +235,39 @@ bool CoordinateTransform::transformFrameToWorld(const DepthFrame& depthFrame, In
     return validPixels > 0;
 }
 
+bool CoordinateTransform::prepareRayTable(int width, int height) {
+    if (!isConfigured_ || width <= 0 || height <= 0) {
+        return false;
+    }
+    if (rays_.ensure(static_cast<uint32_t>(width), static_cast<uint32_t>(height), params_)) {
+        logger_->debug("Built unprojection ray table {}x{}", width, height);
+    }
+    return true;
+}
+
+size_t CoordinateTransform::transformFrameWithRays(const DepthFrame& depthFrame, InternalPointCloud& pointCloud) const {
+    const size_t n = static_cast<size_t>(depthFrame.width) * static_cast<size_t>(depthFrame.height);
+    RayBlockInput in;
+    in.depth = depthFrame.data.data();
+    in.rx = rays_.rayX();
+    in.ry = rays_.rayY();
+    in.rz = rays_.rayZ();
+    in.origin[0] = rays_.originX(); in.origin[1] = rays_.originY(); in.origin[2] = rays_.originZ();
+    in.scale = params_.depthScale;
+    in.offset = params_.depthOffset;
+    in.minPlane = params_.minValidPlane.data();
+    in.maxPlane = params_.maxValidPlane.data();
+    size_t valid = 0;
+    for (size_t base = 0; base < n; base += kRayBlock) {
+        const size_t count = std::min(kRayBlock, n - base);
+        const uint64_t word = count == kRayBlock ? unprojectBlock<kRayBlock>(in, base, count, pointCloud)
+                                                 : unprojectBlock<0>(in, base, count, pointCloud);
+        pointCloud.validBits[base / kRayBlock] = word;
+        valid += static_cast<size_t>(__builtin_popcountll(word));
+    }
+    return valid;
+}
+
 void CoordinateTransform::initializeDefaultParameters(const std::string& sensorType) {
     logger_->debug("Initializing default parameters for sensor type: {}", sensorType);
     
@@ -181,6 +277,8 @@ void CoordinateTransform::initializeDefaultParameters(const std::string& sensorT
         params_.focalLengthY = 591.04f;   // fy in pixels  
         params_.principalPointX = 319.5f; // cx (center X)
         params_.principalPointY = 239.5f; // cy (center Y)
+        nativeWidth_ = 640;
+        nativeHeight_ = 480;
         
         // Kinect v1 depth scaling
         params_.depthScale = 0.001f;      // Raw depth is in mm, convert to meters
@@ -192,6 +290,8 @@ void CoordinateTransform::initializeDefaultParameters(const std::string& sensorT
         params_.focalLengthY = 365.456f;  // fy in pixels
         params_.principalPointX = 257.0f; // cx (center X)
         params_.principalPointY = 210.0f; // cy (center Y)
+        nativeWidth_ = 512;
+        nativeHeight_ = 424;
         
         // Kinect v2 depth scaling
         params_.depthScale = 0.001f;      // Raw depth is in mm, convert to meters  
@@ -204,6 +304,8 @@ void CoordinateTransform::initializeDefaultParameters(const std::string& sensorT
         params_.focalLengthY = 500.0f;
         params_.principalPointX = 320.0f;
         params_.principalPointY = 240.0f;
+        nativeWidth_ = 640;
+        nativeHeight_ = 480;
         params_.depthScale = 0.001f;
         params_.depthOffset = 0.0f;
     }
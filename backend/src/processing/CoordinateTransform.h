@@ -3,6 +3,7 @@
 #include "common/Logger.h"
 #include "common/DataTypes.h"
 #include "processing/ProcessingTypes.h"
+#include "processing/UnprojectionRayTable.h"
 #include "tools/calibration/CalibrationTypes.h"
 #include <memory>
 #include <spdlog/spdlog.h>
@@ -34,11 +35,21 @@ public:
     
     /**
      * Transform depth frame to world coordinates
+     * Frames matching the ray table size take the batch path (world = depth * ray + origin);
+     * other sizes fall back to transformPixelToWorld per pixel.
      * @param depthFrame Input depth frame in sensor space
      * @param worldFrame Output frame with world coordinates
      * @return True if transformation succeeded
      */
     bool transformFrameToWorld(const common::DepthFrame& depthFrame, InternalPointCloud& pointCloud) const;
+
+    /**
+     * Build the per-pixel ray table for frames of this size (done for the sensor's native
+     * resolution in loadFromCalibration). Returns false if not configured.
+     */
+    bool prepareRayTable(int width, int height);
+
+    const UnprojectionRayTable& rayTable() const { return rays_; }
     
     /**
      * Check if transformer is ready for coordinate transformation
@@ -71,11 +82,19 @@ private:
      * Project point onto base plane if needed
      */
     common::Point3D projectOntoBasePlane(const common::Point3D& worldPoint) const;
+
+    /**
+     * Batch unprojection + plane validation through rays_ (frame size must match). Returns valid count.
+     */
+    size_t transformFrameWithRays(const common::DepthFrame& depthFrame, InternalPointCloud& pointCloud) const;
     
     std::shared_ptr<spdlog::logger> logger_;
     TransformParameters params_;
     std::string sensorId_;
     bool isConfigured_;
+    int nativeWidth_ = 640;   // sensor type's depth resolution (initializeDefaultParameters)
+    int nativeHeight_ = 480;
+    UnprojectionRayTable rays_;
 };
 
 } // namespace caldera::backend::processing
\ No newline at end of file
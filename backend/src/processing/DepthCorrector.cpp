@@ -1,4 +1,5 @@
 #include "DepthCorrector.h"
+#include "FusedBuildKernel.h"
 #include "tools/calibration/SensorCalibration.h"
 #include <filesystem>
 #include <cmath>
@@ -46,10 +47,9 @@ float DepthCorrector::correctPixel(int x, int y, float rawDepth) const {
         return rawDepth;  // Return uncorrected if out of bounds
     }
     
-    // For now, simple per-pixel multiplicative correction
-    // Future: add radial distortion, intrinsic matrix transforms
-    float correctionFactor = getCorrectionFactor(x, y);
-    return rawDepth * correctionFactor;
+    int idx = y * profile_.width + x;
+    float offset = profile_.pixelOffsets.empty() ? 0.0f : profile_.pixelOffsets[idx];
+    return rawDepth * getCorrectionFactor(x, y) + offset;
 }
 
 void DepthCorrector::correctFrame(common::RawDepthFrame& frame) const {
@@ -64,21 +64,10 @@ void DepthCorrector::correctFrame(common::RawDepthFrame& frame) const {
         return;
     }
     
-    // Apply correction to each pixel
-    for (int y = 0; y < frame.height; ++y) {
-        for (int x = 0; x < frame.width; ++x) {
-            int idx = y * frame.width + x;
-            if (idx < static_cast<int>(frame.data.size())) {
-                float rawDepth = static_cast<float>(frame.data[idx]);
-                
-                // Skip invalid/zero depths
-                if (rawDepth > 0.0f) {
-                    float corrected = correctPixel(x, y, rawDepth);
-                    frame.data[idx] = static_cast<uint16_t>(std::round(corrected));
-                }
-            }
-        }
-    }
+    // Straight pass over the dense table, no per-pixel bounds checks.
+    const size_t count = std::min(frame.data.size(), profile_.pixelCorrections.size());
+    const float* offsets = profile_.pixelOffsets.size() >= count ? profile_.pixelOffsets.data() : nullptr;
+    correctRawDepth(frame.data.data(), profile_.pixelCorrections.data(), offsets, count);
 }
 
 CorrectionProfile DepthCorrector::createProfile(
@@ -101,12 +90,41 @@ CorrectionProfile DepthCorrector::createProfile(
     }
     
     // Initialize correction factors
-    int totalPixels = profile.width * profile.height;
+    const size_t totalPixels = static_cast<size_t>(profile.width) * profile.height;
     profile.pixelCorrections.resize(totalPixels, 1.0f);  // Default: no correction
     
-    // For now, create uniform correction (no per-pixel variation)
-    // Future: load actual per-pixel corrections from calibration data
-    // This would come from measuring flat surface at different distances
+    const std::vector<float>& coeffs = calibrationProfile.depthCorrectionCoeffs;
+    if (calibrationProfile.hasDepthCorrection && !coeffs.empty()) {
+        if (coeffs.size() == totalPixels) {
+            profile.pixelCorrections = coeffs;
+        } else if (coeffs.size() == 2 * totalPixels) {
+            profile.pixelOffsets.resize(totalPixels);
+            for (size_t i = 0; i < totalPixels; ++i) {
+                profile.pixelCorrections[i] = coeffs[2 * i];
+                profile.pixelOffsets[i] = coeffs[2 * i + 1];
+            }
+        } else if (coeffs.size() <= kMaxRadialCoeffs) {
+            const float centerX = profile.width * 0.5f;
+            const float centerY = profile.height * 0.5f;
+            for (int y = 0; y < profile.height; ++y) {
+                for (int x = 0; x < profile.width; ++x) {
+                    float dx = (x - centerX) / centerX;
+                    float dy = (y - centerY) / centerY;
+                    float r = std::sqrt(dx*dx + dy*dy);
+                    float factor = 0.0f;  // Horner: c0 + r*(c1 + r*(c2 + ...))
+                    for (size_t k = coeffs.size(); k-- > 0;) factor = factor * r + coeffs[k];
+                    profile.pixelCorrections[static_cast<size_t>(y) * profile.width + x] = factor;
+                }
+            }
+        } else {
+            return profile;  // Unrecognized coefficient layout: isValid remains false
+        }
+        profile.isValid = true;
+        return profile;
+    }
+    
+    // No measured corrections: apply a basic placeholder correction.
+    // Real per-pixel corrections come from measuring a flat surface at different distances.
     
     // Apply basic depth-dependent correction based on base plane
     const auto& plane = calibrationProfile.basePlaneCalibration.basePlane;
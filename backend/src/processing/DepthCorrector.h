@@ -40,6 +40,16 @@ public:
      */
     bool loadProfile(const std::string& sensorId);
 
+    /**
+     * @brief Use an already built profile (e.g. from createProfile) without touching the filesystem
+     */
+    void setProfile(const CorrectionProfile& profile) { profile_ = profile; }
+
+    /**
+     * @brief Loaded profile (dense per-pixel table, also consumed by the "correct" pipeline stage)
+     */
+    const CorrectionProfile& profile() const { return profile_; }
+
     /**
      * @brief Check if corrector has valid profile loaded
      */
@@ -55,18 +65,29 @@ public:
      * @param x Pixel x coordinate
      * @param y Pixel y coordinate  
      * @param rawDepth Raw depth value from sensor
-     * @return Corrected depth value
+     * @return Corrected depth value (rawDepth * factor + offset)
      */
     float correctPixel(int x, int y, float rawDepth) const;
 
     /**
      * @brief Correct entire depth frame in-place
+     *
+     * Single branch-free pass over the dense table; zero (no reading) stays zero and results are
+     * rounded and clamped to the uint16 range.
      * @param frame Input/output depth frame
      */
     void correctFrame(common::RawDepthFrame& frame) const;
 
     /**
      * @brief Create correction profile from calibration data
+     *
+     * depthCorrectionCoeffs (when hasDepthCorrection) is read by size:
+     * - width*height: per-pixel multiplicative factors
+     * - 2*width*height: interleaved per-pixel (factor, offset) pairs, offset in raw units
+     *   (SARndbox PixelDepthCorrection layout)
+     * - 1..kMaxRadialCoeffs: radial polynomial factor = sum c[k] * r^k, r = normalized distance
+     *   from the image center (1 at the middle of each edge)
+     * Any other size yields an invalid profile. Without coefficients a mild radial placeholder is used.
      * @param sensorId Sensor to create profile for
      * @param calibrationProfile Calibration data source
      * @return Generated correction profile
@@ -76,6 +97,8 @@ public:
         const tools::calibration::SensorCalibrationProfile& calibrationProfile
     );
 
+    static constexpr size_t kMaxRadialCoeffs = 8;
+
 private:
     std::shared_ptr<spdlog::logger> logger_;
     CorrectionProfile profile_;
@@ -6,87 +6,154 @@
 #include "FastGaussianBlur.h"
 #include <cmath>
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
 
-#ifdef _OPENMP
-#include <omp.h>
-#endif
-
 namespace caldera::backend::processing {
 
+namespace {
+constexpr float kMinWeight = 1e-4f; // blurred weight below this: (nearly) isolated pixel keeps its value
+
+// Integer exponent test so the hole scan vectorizes.
+inline bool finite(float v) {
+    uint32_t b; std::memcpy(&b, &v, sizeof b);
+    return (b & 0x7F800000u) != 0x7F800000u;
+}
+
+// Vertical box sums of one column block over rows [cy0, cy1) (N == 0: n columns, tail). Rows outside
+// the image repeat the edge row, as in the horizontal pass. Sums live in block-local arrays.
+template<int N>
+void verticalBlock(const float* in, float* out, int w, int h, int cy0, int cy1, int r, float iarr, int n) {
+    constexpr int B = FastGaussianBlur::kColBlock;
+    const int count = N ? N : n;
+    alignas(32) float acc[B], row[B];
+    auto at = [&](int y) { return in + static_cast<size_t>(std::clamp(y, 0, h - 1)) * w; };
+    for (int i = 0; i < count; ++i) acc[i] = 0.f;
+    for (int j = cy0 - r; j <= cy0 + r; ++j) {
+        const float* s = at(j);
+        for (int i = 0; i < count; ++i) acc[i] += s[i];
+    }
+    for (int y = cy0; y < cy1; ++y) {
+        if (y > cy0) {
+            const float* add = at(y + r);
+            const float* sub = at(y - r - 1);
+            for (int i = 0; i < count; ++i) acc[i] += add[i] - sub[i];
+        }
+        for (int i = 0; i < count; ++i) row[i] = acc[i] * iarr;
+        std::copy(row, row + count, out + static_cast<size_t>(y) * w);
+    }
+}
+} // namespace
+
+FastGaussianBlur::FastGaussianBlur(float sigma, int threads)
+    : sigma_(sigma), threads_(threads > 0 ? threads : common::ThreadPool::bandsFromEnv("CALDERA_FASTGAUSS_THREADS")) {}
+
 void FastGaussianBlur::apply(std::vector<float>& data, int width, int height) {
     if (data.empty() || width <= 0 || height <= 0 || sigma_ <= 0.0f) {
         return; // No-op for invalid input, following ProcessingManager style
     }
-    
+
     const size_t expectedSize = static_cast<size_t>(width) * height;
     if (data.size() != expectedSize) {
         return; // Size mismatch, no-op
     }
-    
+
     // Skip blur for trivial cases where blur would have no effect
     if (width == 1 && height == 1) {
         return; // Single pixel, no blur needed
     }
-    
-    // Ensure we have working buffers 
-    ensureBufferSize(expectedSize);
-    
-    float* in = data.data();
-    float* out = tempBuffer_.data();
-    
+
     // Calculate box blur parameters for 3-pass approximation using reference algorithm
     int boxes[3];
     std_to_box(boxes, sigma_, 3);
-    
-    // Clamp radii for very small images to avoid overlap in vertical pass loops
-    // The Ivan Kutskir box blur formulation assumes r < min(w,h)/2; when this is violated
-    // (e.g. tiny synthetic test frames) the vertical pass write loops overlap and can
-    // write one row past the buffer (observed ASAN heap-buffer-overflow). We clamp here
-    // rather than modifying inner loops to preserve algorithmic structure.
-    int maxR = static_cast<int>((std::min(width, height) - 1) / 2); // ensure at least one untouched band
-    if (maxR < 0) maxR = 0;
+
+    // The horizontal pass follows the Ivan Kutskir formulation, which assumes r < w/2; wider boxes
+    // would overlap its edge loops, so clamp the horizontal radius for very narrow frames. The vertical
+    // pass repeats edge rows by index clamping and takes any radius.
+    int rows[3], cols[3];
+    const int maxR = (width - 1) / 2;
     for (int k = 0; k < 3; ++k) {
-        if (boxes[k] > maxR) boxes[k] = maxR;
+        cols[k] = std::min(boxes[k], maxR);
+        rows[k] = height > 1 ? boxes[k] : 0;
     }
 
     // If all radii collapse to 0 no blur effect is needed.
-    if (boxes[0] == 0 && boxes[1] == 0 && boxes[2] == 0) {
+    if (std::max({cols[0], cols[1], cols[2], rows[0], rows[1], rows[2]}) == 0) {
         return;
     }
 
-    // Perform box blur passes using reference implementation (note alternating in/out)
-    box_blur(in, out, width, height, boxes[0]);
-    box_blur(out, in, width, height, boxes[1]);
-    box_blur(in, out, width, height, boxes[2]);
-    
-    // Copy result back to input vector if needed
-    if (out != data.data()) {
-        std::memcpy(data.data(), out, expectedSize * sizeof(float));
+    uint32_t holes = 0;
+    for (size_t i = 0; i < expectedSize; ++i) {
+        uint32_t b; std::memcpy(&b, &data[i], sizeof b);
+        holes |= (~b & 0x7F800000u) == 0u;
+    }
+
+    // planes[p][0] holds plane p between box passes, planes[p][1] the horizontal result.
+    float* planes[2][2] = {{data.data(), nullptr}, {nullptr, nullptr}};
+    const int planeCount = holes ? 2 : 1;
+    value_[1].resize(expectedSize);
+    planes[0][1] = value_[1].data();
+    if (holes) {
+        value_[0].resize(expectedSize);
+        weight_[0].resize(expectedSize);
+        weight_[1].resize(expectedSize);
+        planes[0][0] = value_[0].data();
+        planes[1][0] = weight_[0].data();
+        planes[1][1] = weight_[1].data();
     }
+
+    float* src = data.data();
+    for (int k = 0; k < 3; ++k) {
+        runBands(height, [&](int y0, int y1) {
+            if (k == 0 && holes) {
+                for (size_t i = static_cast<size_t>(y0) * width; i < static_cast<size_t>(y1) * width; ++i) {
+                    const bool ok = finite(src[i]);
+                    planes[0][0][i] = ok ? src[i] : 0.0f;
+                    planes[1][0][i] = ok ? 1.0f : 0.0f;
+                }
+            }
+            for (int p = 0; p < planeCount; ++p) horizontal_blur(planes[p][0], planes[p][1], width, y0, y1, cols[k]);
+        });
+        runBands(height, [&](int y0, int y1) {
+            for (int p = 0; p < planeCount; ++p) total_blur(planes[p][1], planes[p][0], width, height, y0, y1, rows[k]);
+            if (k == 2 && holes) {
+                const float* value = planes[0][0];
+                const float* weight = planes[1][0];
+                for (size_t i = static_cast<size_t>(y0) * width; i < static_cast<size_t>(y1) * width; ++i) {
+                    if (finite(src[i]) && weight[i] > kMinWeight) src[i] = value[i] / weight[i];
+                }
+            }
+        });
+    }
+}
+
+int FastGaussianBlur::rowHalo() const {
+    if (sigma_ <= 0.0f) return 0;
+    int boxes[3];
+    std_to_box(boxes, sigma_, 3);
+    return boxes[0] + boxes[1] + boxes[2];
 }
 
 void FastGaussianBlur::std_to_box(int boxes[], float sigma, int n) const {
     // ideal filter width
-    float wi = std::sqrt((12*sigma*sigma/n)+1);  
-    int wl = std::floor(wi);  
+    float wi = std::sqrt((12*sigma*sigma/n)+1);
+    int wl = std::floor(wi);
     if(wl%2==0) wl--;
     int wu = wl+2;
-    
+
     float mi = (12*sigma*sigma - n*wl*wl - 4*n*wl - 3*n)/(-4*wl - 4);
     int m = std::round(mi);
-    
-    for(int i=0; i<n; i++)  
+
+    for(int i=0; i<n; i++)
         boxes[i] = ((i < m ? wl : wu) - 1) / 2;
 }
 
-void FastGaussianBlur::horizontal_blur(float* in, float* out, int w, int h, int r) const {
+void FastGaussianBlur::horizontal_blur(const float* in, float* out, int w, int y0, int y1, int r) {
     float iarr = 1.f / (r+r+1);
-    #pragma omp parallel for
-    for(int i=0; i<h; i++) {
+    for(int i=y0; i<y1; i++) {
         int ti = i*w, li = ti, ri = ti+r;
         float fv = in[ti], lv = in[ti+w-1], val = (r+1)*fv;
-        
+
         for(int j=0; j<r; j++) val += in[ti+j];
         for(int j=0; j<=r; j++) { val += in[ri++] - fv; out[ti++] = val*iarr; }
         for(int j=r+1; j<w-r; j++) { val += in[ri++] - in[li++]; out[ti++] = val*iarr; }
@@ -94,30 +161,18 @@ void FastGaussianBlur::horizontal_blur(float* in, float* out, int w, int h, int
     }
 }
 
-void FastGaussianBlur::total_blur(float* in, float* out, int w, int h, int r) const {
-    float iarr = 1.f / (r+r+1);
-    #pragma omp parallel for
-    for(int i=0; i<w; i++) {
-        int ti = i, li = ti, ri = ti+r*w;
-        float fv = in[ti], lv = in[ti+w*(h-1)], val = (r+1)*fv;
-        
-        for(int j=0; j<r; j++) val += in[ti+j*w];
-        for(int j=0; j<=r; j++) { val += in[ri] - fv; out[ti] = val*iarr; ri+=w; ti+=w; }
-        for(int j=r+1; j<h-r; j++) { val += in[ri] - in[li]; out[ti] = val*iarr; li+=w; ri+=w; ti+=w; }
-        for(int j=h-r; j<h; j++) { val += lv - in[li]; out[ti] = val*iarr; li+=w; ti+=w; }
-    }
-}
-
-void FastGaussianBlur::box_blur(float*& in, float*& out, int w, int h, int r) const {
-    std::swap(in, out);
-    horizontal_blur(out, in, w, h, r);
-    total_blur(in, out, w, h, r);
-}
-
-void FastGaussianBlur::ensureBufferSize(size_t requiredSize) const {
-    if (tempBuffer_.size() < requiredSize) {
-        tempBuffer_.resize(requiredSize);
+// Rows instead of columns: kColBlock running sums advance one row at a time, restarting at every
+// kRowChunk boundary.
+void FastGaussianBlur::total_blur(const float* in, float* out, int w, int h, int y0, int y1, int r) {
+    const float iarr = 1.f / (r+r+1);
+    for (int cy = y0; cy < y1; cy += kRowChunk) {
+        const int cyEnd = std::min(y1, cy + kRowChunk);
+        for (int x = 0; x < w; x += kColBlock) {
+            const int n = std::min(kColBlock, w - x);
+            if (n == kColBlock) verticalBlock<kColBlock>(in + x, out + x, w, h, cy, cyEnd, r, iarr, n);
+            else verticalBlock<0>(in + x, out + x, w, h, cy, cyEnd, r, iarr, n);
+        }
     }
 }
 
-} // namespace caldera::backend::processing
\ No newline at end of file
+} // namespace caldera::backend::processing
@@ -1,46 +1,77 @@
 /*
  * FastGaussianBlur.h - Fast Gaussian blur filter implementing IHeightMapFilter
- * 
+ *
  * Based on Ivan Kutskir's linear-time algorithm: http://blog.ivank.net/fastest-gaussian-blur.html
  * Implementation by Basile Fraboni: https://github.com/bfraboni/FastGaussianBlur
- * 
+ *
  * Achieves O(n) complexity independent of blur radius using box blur approximation.
  */
 
 #pragma once
 
 #include "IHeightMapFilter.h"
+#include "common/ThreadPool.h"
+#include <algorithm>
 #include <vector>
 
 namespace caldera::backend::processing {
 
 /**
  * FastGaussianBlur - IHeightMapFilter implementation using linear-time Gaussian blur
- * 
+ *
  * Uses box blur approximation (3 passes) to achieve near-perfect Gaussian blur
  * with O(n) complexity independent of blur radius.
+ *
+ * NaN-aware by normalized convolution: when the frame has holes, a value plane (invalid = 0) and a
+ * weight plane (1 / 0) are blurred together and divided at the end, so invalid pixels never leak
+ * into their neighbours. Non-finite pixels stay as they are (holes are not filled). Frames without
+ * holes blur the single value plane in place.
+ *
+ * Work is split into row bands of whole kRowChunk chunks, run on the shared ThreadPool. The
+ * vertical pass keeps kColBlock running sums and streams rows, restarting at every chunk, so the
+ * output does not depend on the thread count.
  */
 class FastGaussianBlur final : public IHeightMapFilter {
 public:
+    static constexpr int kRowChunk = 32;
+    static constexpr int kColBlock = 64;
+
     /**
      * Constructor with configurable blur strength
      * @param sigma Standard deviation of Gaussian kernel (default 1.5f for noise reduction)
+     * @param threads Band count; <= 0: CALDERA_FASTGAUSS_THREADS or the shared pool's concurrency
      */
-    explicit FastGaussianBlur(float sigma = 1.5f) : sigma_(sigma) {}
-    
+    explicit FastGaussianBlur(float sigma = 1.5f, int threads = 0);
+
     // IHeightMapFilter interface
     void apply(std::vector<float>& data, int width, int height) override;
 
+    int threadCount() const { return threads_; }
+    // Rows of input on each side that reach an output row (sum of the three box radii).
+    int rowHalo() const;
+
 private:
     float sigma_;
-    mutable std::vector<float> tempBuffer_; // Cached working buffer
-    
+    int threads_ = 1;
+    std::vector<float> value_[2], weight_[2]; // ping-pong planes ([1] only is used without holes)
+
     // Core algorithm functions based on reference implementation
     void std_to_box(int boxes[], float sigma, int n) const;
-    void horizontal_blur(float* in, float* out, int w, int h, int r) const;
-    void total_blur(float* in, float* out, int w, int h, int r) const;
-    void box_blur(float*& in, float*& out, int w, int h, int r) const;
-    void ensureBufferSize(size_t requiredSize) const;
+    static void horizontal_blur(const float* in, float* out, int w, int y0, int y1, int r);
+    static void total_blur(const float* in, float* out, int w, int h, int y0, int y1, int r);
+
+    // Runs job(y0, y1) over up to threads_ row bands of whole chunks and waits for all of them.
+    template <typename Job>
+    void runBands(int height, const Job& job) const {
+        const int chunks = (height + kRowChunk - 1) / kRowChunk;
+        const int bands = std::max(1, std::min(threads_, chunks));
+        if (bands == 1) { job(0, height); return; }
+        common::ThreadPool::shared().parallel_for(0, bands, 1, [&](int b0, int b1) {
+            for (int b = b0; b < b1; ++b) {
+                job(std::min(height, chunks * b / bands * kRowChunk), std::min(height, chunks * (b + 1) / bands * kRowChunk));
+            }
+        });
+    }
 };
 
-} // namespace caldera::backend::processing
\ No newline at end of file
+} // namespace caldera::backend::processing
@@ -0,0 +1,122 @@
+#include "processing/FramePipeline.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace caldera::backend::processing {
+
+FramePipeline::Config FramePipeline::Config::fromEnv(){
+    Config c;
+    if(const char* d = std::getenv("CALDERA_PIPELINE_DEPTH")){
+        try { int n = std::stoi(d); if(n>=0) c.depth = static_cast<uint32_t>(n); } catch(...){}
+    }
+    return c;
+}
+
+FramePipeline::FramePipeline() : FramePipeline(Config::fromEnv()) {}
+
+FramePipeline::FramePipeline(const Config& cfg) : cfg_(cfg) {}
+
+FramePipeline::~FramePipeline(){ stop(); }
+
+void FramePipeline::addStage(std::string name, StageFn fn){
+    if(running_) return;
+    auto st = std::make_unique<Stage>();
+    st->name = std::move(name);
+    st->fn = std::move(fn);
+    stages_.push_back(std::move(st));
+}
+
+void FramePipeline::start(){
+    if(running_ || stages_.empty()) return;
+    // Every ring can hold every slot, so passing a slot on never fails or waits.
+    const uint32_t slots = slotCount();
+    for(auto& st : stages_) st->in = std::make_unique<Ring>(slots);
+    free_ = std::make_unique<Ring>(slots);
+    for(uint32_t s=0;s<slots;++s) free_->queue.push([s](uint32_t& v){ v = s; });
+    stopping_.store(false);
+    running_ = true;
+    for(size_t i=0;i<stages_.size();++i) stages_[i]->worker = std::thread([this, i]{ run(i); });
+}
+
+void FramePipeline::stop(){
+    if(!running_) return;
+    drain();
+    stopping_.store(true, std::memory_order_release);
+    for(auto& st : stages_){
+        { std::lock_guard<std::mutex> lk(st->in->mutex); }
+        st->in->cv.notify_all();
+    }
+    for(auto& st : stages_) if(st->worker.joinable()) st->worker.join();
+    running_ = false;
+}
+
+void FramePipeline::put(Ring& ring, uint32_t slot){
+    ring.queue.push([slot](uint32_t& s){ s = slot; });
+    const uint32_t depth = static_cast<uint32_t>(ring.queue.size());
+    if(depth > ring.maxDepth.load(std::memory_order_relaxed)) ring.maxDepth.store(depth, std::memory_order_relaxed); // single producer
+    // Taking the mutex orders the push before a consumer's check-then-wait, so the notify is not lost.
+    { std::lock_guard<std::mutex> lk(ring.mutex); }
+    ring.cv.notify_one();
+}
+
+bool FramePipeline::take(Ring& ring, uint32_t& slot, std::atomic<uint64_t>* waits){
+    bool waited = false;
+    for(;;){
+        const size_t depth = ring.queue.size();
+        if(ring.queue.consume([&](uint32_t& s){ slot = s; })){
+            ring.depthSum.fetch_add(depth ? depth-1 : 0, std::memory_order_relaxed);
+            return true;
+        }
+        if(waits && !waited){ waits->fetch_add(1, std::memory_order_relaxed); waited = true; }
+        std::unique_lock<std::mutex> lk(ring.mutex);
+        ring.cv.wait(lk, [&]{ return !ring.queue.empty() || stopping_.load(std::memory_order_acquire); });
+        if(ring.queue.empty()) return false; // stopping
+    }
+}
+
+void FramePipeline::run(size_t index){
+    Stage& st = *stages_[index];
+    const bool last = index+1 == stages_.size();
+    uint32_t slot = 0;
+    while(take(*st.in, slot)){
+        const auto t0 = std::chrono::steady_clock::now();
+        st.fn(slot);
+        st.busyNs.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-t0).count()), std::memory_order_relaxed);
+        st.frames.fetch_add(1, std::memory_order_relaxed);
+        put(last ? *free_ : *stages_[index+1]->in, slot);
+        if(last){
+            { std::lock_guard<std::mutex> lk(drainMutex_); completed_.fetch_add(1, std::memory_order_release); }
+            drainCv_.notify_all();
+        }
+    }
+}
+
+void FramePipeline::drain(){
+    if(!running_) return;
+    std::unique_lock<std::mutex> lk(drainMutex_);
+    drainCv_.wait(lk, [&]{ return completed_.load(std::memory_order_acquire) >= submitted_.load(std::memory_order_acquire); });
+}
+
+FramePipeline::Stats FramePipeline::stats() const {
+    Stats s;
+    s.submitted = submitted_.load(std::memory_order_relaxed);
+    s.completed = completed_.load(std::memory_order_relaxed);
+    s.submitWaits = submitWaits_.load(std::memory_order_relaxed);
+    for(const auto& st : stages_){
+        StageStats ss;
+        ss.name = st->name;
+        ss.frames = st->frames.load(std::memory_order_relaxed);
+        if(st->in){
+            ss.queueDepth = static_cast<uint32_t>(st->in->queue.size());
+            ss.maxQueueDepth = st->in->maxDepth.load(std::memory_order_relaxed);
+            const uint64_t taken = st->in->queue.stats().consumed;
+            ss.avgQueueDepth = taken ? static_cast<double>(st->in->depthSum.load(std::memory_order_relaxed)) / taken : 0.0;
+        }
+        ss.busyMs = st->busyNs.load(std::memory_order_relaxed) / 1e6;
+        s.stages.push_back(std::move(ss));
+    }
+    return s;
+}
+
+} // namespace caldera::backend::processing
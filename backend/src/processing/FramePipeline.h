@@ -0,0 +1,118 @@
+#ifndef CALDERA_BACKEND_PROCESSING_FRAME_PIPELINE_H
+#define CALDERA_BACKEND_PROCESSING_FRAME_PIPELINE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/FrameMailbox.h"
+
+namespace caldera::backend::processing {
+
+// Frame-level software pipeline: a fixed chain of stages, each on a dedicated worker thread,
+// connected by bounded SPSC rings, so different stages work on different frames at once.
+//
+// Frames live in slots owned by the caller (indices 0..slotCount()-1); only slot indices travel
+// through the rings. submit() takes a free slot (waiting while every slot is in flight), lets the
+// caller fill it and queues it to the first stage; each stage runs fn(slot) and passes it on, and the
+// last stage returns it to the free list. A stage sees frames in submission order, one at a time, so
+// a stage that carries state from frame to frame (temporal filtering, adaptive gating) runs exactly
+// as it would serially. With slotCount() = stages + depth frames in flight at most, the delay of a
+// frame stays bounded and a slow stage backs up to the producer instead of growing a queue.
+class FramePipeline {
+public:
+    using StageFn = std::function<void(uint32_t slot)>;
+
+    struct Config {
+        uint32_t depth = 2; // free slots beyond one per stage (CALDERA_PIPELINE_DEPTH)
+        static Config fromEnv();
+    };
+
+    struct StageStats {
+        std::string name;
+        uint64_t frames = 0;        // frames completed
+        uint32_t queueDepth = 0;    // frames waiting for the stage now (snapshot)
+        uint32_t maxQueueDepth = 0; // high-water mark of queueDepth
+        double avgQueueDepth = 0.0; // frames waiting behind the one taken, averaged over frames
+        double busyMs = 0.0;        // time spent in the stage function
+    };
+
+    struct Stats {
+        uint64_t submitted = 0;
+        uint64_t completed = 0;   // frames that left the last stage
+        uint64_t submitWaits = 0; // submit() calls that found every slot in flight
+        std::vector<StageStats> stages;
+    };
+
+    FramePipeline();
+    explicit FramePipeline(const Config& cfg);
+    ~FramePipeline(); // stop()
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // Stages are fixed once started.
+    void addStage(std::string name, StageFn fn);
+    void start();
+    void stop(); // drains, then joins the workers
+    bool isRunning() const { return running_; }
+
+    uint32_t slotCount() const { return static_cast<uint32_t>(stages_.size()) + cfg_.depth; }
+
+    // Producer side (one thread at a time). fill(uint32_t slot) writes the frame into the caller's
+    // slot storage before any stage sees it.
+    template <typename Fill>
+    void submit(Fill&& fill) {
+        uint32_t slot = 0;
+        if(!running_ || !take(*free_, slot, &submitWaits_)) return;
+        fill(slot);
+        submitted_.fetch_add(1, std::memory_order_relaxed);
+        put(*stages_.front()->in, slot);
+    }
+
+    void drain(); // waits until every submitted frame has left the last stage
+
+    Stats stats() const;
+
+private:
+    struct Ring {
+        explicit Ring(size_t capacity) : queue(common::MailboxPolicy::BoundedQueue, capacity) {}
+        common::SpscFrameMailbox<uint32_t> queue;
+        std::mutex mutex; // only pairs with cv; the ring itself is lock-free
+        std::condition_variable cv;
+        std::atomic<uint32_t> maxDepth{0};
+        std::atomic<uint64_t> depthSum{0};
+    };
+    struct Stage {
+        std::string name;
+        StageFn fn;
+        std::unique_ptr<Ring> in; // created by start(), sized for every slot
+        std::thread worker;
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> busyNs{0};
+    };
+
+    void put(Ring& ring, uint32_t slot);
+    bool take(Ring& ring, uint32_t& slot, std::atomic<uint64_t>* waits = nullptr);
+    void run(size_t stage);
+
+    Config cfg_;
+    std::vector<std::unique_ptr<Stage>> stages_;
+    std::unique_ptr<Ring> free_;
+    bool running_ = false;
+    std::atomic<bool> stopping_{false};
+    std::atomic<uint64_t> submitted_{0}, completed_{0}, submitWaits_{0};
+    std::mutex drainMutex_;
+    std::condition_variable drainCv_;
+};
+
+} // namespace caldera::backend::processing
+
+#endif // CALDERA_BACKEND_PROCESSING_FRAME_PIPELINE_H
@@ -0,0 +1,104 @@
+#include "processing/FusedBuildKernel.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace caldera::backend::processing {
+
+FusedBuildCounts fusedBuildHeightValidity(const uint16_t* raw, size_t rawCount, size_t pixelCount,
+                                          const uint16_t* lo, const uint16_t* hi, float depthScale,
+                                          float* height, uint8_t* validity){
+    const float qnan = std::numeric_limits<float>::quiet_NaN();
+    const size_t n = std::min(rawCount, pixelCount);
+    // Branch-free body (select + compare) so the loop vectorizes; the count is a plain reduction.
+    size_t validCount = 0;
+    for(size_t i=0; i<n; ++i){
+        const uint16_t d = raw[i];
+        const uint8_t v = (uint8_t)((d >= lo[i]) & (d <= hi[i]));
+        height[i] = v ? (float)d * depthScale : qnan;
+        validity[i] = v;
+        validCount += v;
+    }
+    for(size_t i=n; i<pixelCount; ++i){ height[i] = qnan; validity[i] = 0; }
+    FusedBuildCounts c;
+    c.valid = (uint32_t)validCount;
+    c.invalid = (uint32_t)(pixelCount - validCount);
+    return c;
+}
+
+namespace {
+constexpr size_t kCorrectBlock = 256;
+
+template<bool HasBias>
+inline float correctedDepth(float r, const float* gain, const float* bias, size_t i){
+    return HasBias ? r * gain[i] + bias[i] : r * gain[i];
+}
+
+// The NaN for rejected pixels is added rather than selected (a select would sink the multiply into
+// a branch) and the valid count is a separate pass, both to keep the main loop free of control flow.
+template<size_t N, bool HasBias>
+size_t correctedBlock(const uint16_t* raw, const uint16_t* lo, const uint16_t* hi, const float* gain,
+                      const float* bias, float depthScale, size_t n, float* height, uint8_t* validity){
+    const size_t count = N ? N : n;
+    const float qnan = std::numeric_limits<float>::quiet_NaN();
+    alignas(32) float h[kCorrectBlock];
+    alignas(32) uint8_t v[kCorrectBlock];
+    for(size_t i=0; i<count; ++i){
+        const float r = (float)raw[i];
+        const float c = correctedDepth<HasBias>(r, gain, bias, i);
+        const bool ok = (r > 0.0f) & (c >= (float)lo[i]) & (c <= (float)hi[i]);
+        h[i] = c * depthScale + (ok ? 0.0f : qnan);
+        v[i] = ok;
+    }
+    size_t valid = 0;
+    for(size_t i=0; i<count; ++i) valid += v[i];
+    std::copy(h, h + count, height);
+    std::copy(v, v + count, validity);
+    return valid;
+}
+
+// Zero depths stay zero; results are rounded and clamped to the uint16 range without branches.
+template<size_t N, bool HasBias>
+void correctRawBlock(uint16_t* data, const float* gain, const float* bias, size_t n){
+    const size_t count = N ? N : n;
+    alignas(32) uint16_t out[kCorrectBlock];
+    for(size_t i=0; i<count; ++i){
+        const float r = (float)data[i];
+        float c = correctedDepth<HasBias>(r, gain, bias, i) + 0.5f;
+        c = c < 0.0f ? 0.0f : c;
+        c = c > 65535.0f ? 65535.0f : c;
+        out[i] = (uint16_t)(int32_t)(r > 0.0f ? c : 0.0f);
+    }
+    std::copy(out, out + count, data);
+}
+}
+
+FusedBuildCounts fusedBuildHeightValidityCorrected(const uint16_t* raw, size_t rawCount, size_t pixelCount,
+                                                   const uint16_t* lo, const uint16_t* hi,
+                                                   const float* gain, const float* bias, float depthScale,
+                                                   float* height, uint8_t* validity){
+    const float qnan = std::numeric_limits<float>::quiet_NaN();
+    const size_t n = std::min(rawCount, pixelCount);
+    size_t validCount = 0;
+    forEachBlock<kCorrectBlock>(n, [&](auto N, size_t base, size_t m){
+        const uint16_t* r = raw + base; const uint16_t* l = lo + base; const uint16_t* u = hi + base;
+        const float* g = gain + base; const float* b = bias ? bias + base : nullptr;
+        float* h = height + base; uint8_t* v = validity + base;
+        validCount += b ? correctedBlock<decltype(N)::value,true>(r,l,u,g,b,depthScale,m,h,v)
+                        : correctedBlock<decltype(N)::value,false>(r,l,u,g,b,depthScale,m,h,v);
+    });
+    for(size_t i=n; i<pixelCount; ++i){ height[i] = qnan; validity[i] = 0; }
+    FusedBuildCounts c;
+    c.valid = (uint32_t)validCount;
+    c.invalid = (uint32_t)(pixelCount - validCount);
+    return c;
+}
+
+void correctRawDepth(uint16_t* data, const float* gain, const float* bias, size_t count){
+    forEachBlock<kCorrectBlock>(count, [&](auto N, size_t base, size_t m){
+        if(bias) correctRawBlock<decltype(N)::value,true>(data + base, gain + base, bias + base, m);
+        else correctRawBlock<decltype(N)::value,false>(data + base, gain + base, nullptr, m);
+    });
+}
+
+} // namespace caldera::backend::processing
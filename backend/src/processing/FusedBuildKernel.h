@@ -0,0 +1,61 @@
+#ifndef CALDERA_BACKEND_PROCESSING_FUSED_BUILD_KERNEL_H
+#define CALDERA_BACKEND_PROCESSING_FUSED_BUILD_KERNEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace caldera::backend::processing {
+
+// Single streaming pass RawDepthFrame::data -> height + validity buffers.
+//
+// For every pixel i < pixelCount:
+//   valid       = i < rawCount && lo[i] <= raw[i] <= hi[i]     (PlaneValidationTable bounds)
+//   height[i]   = valid ? raw[i] * depthScale : NaN
+//   validity[i] = valid ? 1 : 0
+// Pixels beyond rawCount (short raw buffer) are treated as zero-padded and invalid.
+// Replaces the former build-cloud -> height/validity/mask -> cloud-copy sequence.
+struct FusedBuildCounts {
+    uint32_t valid = 0;
+    uint32_t invalid = 0;
+};
+
+FusedBuildCounts fusedBuildHeightValidity(const uint16_t* raw, size_t rawCount, size_t pixelCount,
+                                          const uint16_t* lo, const uint16_t* hi, float depthScale,
+                                          float* height, uint8_t* validity);
+
+// Same pass with a per-pixel depth correction folded in (DepthCorrector table, raw units):
+//   c           = raw[i] * gain[i] + bias[i]          (bias may be null)
+//   valid       = i < rawCount && raw[i] != 0 && lo[i] <= c <= hi[i]
+//   height[i]   = valid ? c * depthScale : NaN
+// The plane bounds are tested on the corrected value, to raw-unit granularity.
+FusedBuildCounts fusedBuildHeightValidityCorrected(const uint16_t* raw, size_t rawCount, size_t pixelCount,
+                                                   const uint16_t* lo, const uint16_t* hi,
+                                                   const float* gain, const float* bias, float depthScale,
+                                                   float* height, uint8_t* validity);
+
+// Depth correction of a raw frame in place (DepthCorrector::correctFrame), with the same c as above:
+//   data[i] = data[i] != 0 ? clamp(round(c), 0, 65535) : 0          (bias may be null)
+void correctRawDepth(uint16_t* data, const float* gain, const float* bias, size_t count);
+
+// Block convention of the per-pixel kernels: results go to block-local arrays before they are
+// stored, so a loop cannot alias its outputs and vectorizes at -O2 without runtime alias checks.
+// fn(std::integral_constant<size_t, N>, base, n) runs for every block of [0, count); N is the block
+// size for full blocks (a compile-time trip count) and 0 for the tail, where n counts.
+template<size_t Block, typename Fn>
+inline void forEachBlock(size_t count, Fn&& fn){
+    for(size_t base=0; base<count; base+=Block){
+        const size_t n = std::min(Block, count - base);
+        if(n == Block) fn(std::integral_constant<size_t, Block>{}, base, n);
+        else fn(std::integral_constant<size_t, 0>{}, base, n);
+    }
+}
+
+// Bytes read + written by fusedBuildHeightValidity for a frame of `pixels` (diagnostics / benchmarks):
+// raw(2) + lo(2) + hi(2) read, height(4) + validity(1) written.
+constexpr size_t fusedBuildBytesTouched(size_t pixels) { return pixels * (2 + 2 + 2 + 4 + 1); }
+
+} // namespace caldera::backend::processing
+
+#endif // CALDERA_BACKEND_PROCESSING_FUSED_BUILD_KERNEL_H
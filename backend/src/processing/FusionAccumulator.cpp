@@ -0,0 +1,168 @@
+#include "FusionAccumulator.h"
+#include "common/ThreadPool.h"
+
+namespace caldera::backend::processing {
+
+namespace {
+constexpr size_t kChunk = 256;                  // pixels per accumulator block (stays in L1)
+constexpr size_t kParallelMinWork = 1u << 17;   // pixels x layers below which bands do not pay off
+
+// Clamp to [0,1] as max/min selects; NaN maps to 0 so a bad confidence cannot poison the sums.
+inline float unitWeight(float c) { return std::min(std::max(0.0f, c), 1.0f); }
+} // namespace
+
+FusionAccumulator::FusionAccumulator() : threads_(common::ThreadPool::bandsFromEnv("CALDERA_FUSION_THREADS")) {}
+
+void FusionAccumulator::setThreadCount(int threads) {
+    threads_ = threads > 0 ? threads : common::ThreadPool::bandsFromEnv("CALDERA_FUSION_THREADS");
+}
+
+void FusionAccumulator::fuse(std::vector<float>& outHeightMap,
+                             std::vector<float>* outConfidence,
+                             const float* weightsPerLayer,
+                             const float* perPixelWeights) {
+    outHeightMap.resize(fusedPixelCount());
+    float* conf = nullptr;
+    if (outConfidence) {
+        outConfidence->clear();
+        bool weighted = weightsPerLayer || perPixelWeights;
+        for (const auto& l : layers_) weighted = weighted || l.hasConfidence;
+        if (weighted) { outConfidence->resize(outHeightMap.size()); conf = outConfidence->data(); }
+    }
+    if (!outHeightMap.empty()) fuseInto(outHeightMap.data(), outHeightMap.size(), true, conf, weightsPerLayer, perPixelWeights);
+}
+
+size_t FusionAccumulator::fuseInto(float* out, size_t capacity, bool invalidToZero, float* outConfidence,
+                                   const float* weightsPerLayer, const float* perPixelWeights) {
+    const size_t count = fusedPixelCount();
+    if (!out || count == 0 || capacity < count) return 0;
+
+    // Dropout bookkeeping: every layer present is active; known sensors silent for longer than the
+    // window are stale (excluded from the barrier quorum via isExpected()).
+    stats_.activeLayerCount = layers_.size();
+    stats_.staleExcludedCount = 0;
+    if (dropoutWindow_ > 0) {
+        for (const auto& kv : lastSeenFrameId_) {
+            if (frameId_ > kv.second && frameId_ - kv.second > dropoutWindow_) ++stats_.staleExcludedCount;
+        }
+    }
+
+    job_ = FuseJob{};
+    job_.out = out;
+    job_.outConfidence = outConfidence;
+    job_.layerWeights = weightsPerLayer;
+    job_.pixelWeights = perPixelWeights;
+    job_.invalidToZero = invalidToZero;
+    job_.weighted = weightsPerLayer || perPixelWeights;
+    for (const auto& l : layers_) job_.weighted = job_.weighted || l.hasConfidence;
+    stats_.strategy = job_.weighted ? 1 : 0;
+
+    const int bands = (count * layers_.size() >= kParallelMinWork) ? std::min(threads_, height_) : 1;
+    bandCounts_.assign(static_cast<size_t>(std::max(bands, 1)), BandCounts{});
+    if (bands > 1) {
+        const int64_t h = height_;
+        common::ThreadPool::shared().parallel_for(0, bands, 1, [&](int b0, int b1) {
+            for (int b = b0; b < b1; ++b) {
+                fuseRows(static_cast<int>(h * b / bands), static_cast<int>(h * (b + 1) / bands), bandCounts_[static_cast<size_t>(b)]);
+            }
+        });
+    } else {
+        fuseRows(0, height_, bandCounts_[0]);
+    }
+
+    uint32_t valid = 0, fallbackMinZ = 0;
+    for (const auto& c : bandCounts_) { valid += c.valid; fallbackMinZ += c.fallbackMinZ; }
+    stats_.fusedValidCount = valid;
+    stats_.fallbackMinZCount = fallbackMinZ;
+    stats_.fallbackEmptyCount = static_cast<uint32_t>(count) - valid;
+    stats_.fusedValidRatio = static_cast<float>(valid) / static_cast<float>(count);
+    return count;
+}
+
+void FusionAccumulator::fuseRows(int y0, int y1, BandCounts& counts) const {
+    const size_t W = static_cast<size_t>(width_);
+    const size_t end = static_cast<size_t>(y1) * W;
+    for (size_t base = static_cast<size_t>(y0) * W; base < end; base += kChunk) {
+        const size_t n = std::min(kChunk, end - base);
+        if (job_.weighted) {
+            if (n == kChunk) fuseChunk<true, kChunk>(base, n, counts); else fuseChunk<true, 0>(base, n, counts);
+        } else {
+            if (n == kChunk) fuseChunk<false, kChunk>(base, n, counts); else fuseChunk<false, 0>(base, n, counts);
+        }
+    }
+}
+
+// One pass per layer over a chunk of pixels held in small accumulators, then one pass to resolve.
+// Bodies are branch-free (selects instead of ifs; (v - v) == 0 rejects NaN and inf); N is the chunk
+// size, 0 for the frame tail. Sums accumulate in layer order, independent of the band split.
+template <bool Weighted, size_t N>
+void FusionAccumulator::fuseChunk(size_t base, size_t n, BandCounts& counts) const {
+    static const std::vector<float> kOnes(kChunk, 1.0f); // stands in for absent confidence / pixel weights
+    const size_t count = N ? N : n;
+    const size_t L = layers_.size();
+    const float inf = std::numeric_limits<float>::infinity();
+    // A single layer is copied exactly: its weight sum never exceeds this threshold, so no mean.
+    const float meanMinWeight = L > 1 ? 0.0f : inf;
+    const float empty = job_.invalidToZero ? 0.0f : std::numeric_limits<float>::quiet_NaN();
+    alignas(32) float minZ[kChunk], sumW[kChunk], sumWH[kChunk], sumWC[kChunk];
+
+    std::fill_n(minZ, count, inf);
+    if (Weighted) { std::fill_n(sumW, count, 0.0f); std::fill_n(sumWH, count, 0.0f); std::fill_n(sumWC, count, 0.0f); }
+    for (size_t l = 0; l < L; ++l) {
+        const LayerEntry& e = layers_[l];
+        const float* h = heightsStorage_.data() + e.offset + base;
+        if (!Weighted) {
+            for (size_t i = 0; i < count; ++i) minZ[i] = h[i] < minZ[i] ? h[i] : minZ[i]; // NaN never compares less
+            continue;
+        }
+        const float* c = e.hasConfidence ? confidenceStorage_.data() + e.confOffset + base : kOnes.data();
+        const float* pw = job_.pixelWeights ? job_.pixelWeights + l * framePixelCount_ + base : kOnes.data();
+        const float lw = job_.layerWeights ? std::max(0.0f, job_.layerWeights[l]) : 1.0f;
+        for (size_t i = 0; i < count; ++i) {
+            const float v = h[i];
+            const bool finite = (v - v) == 0.0f;
+            const float ci = unitWeight(c[i]);
+            const float wi = (finite ? lw : 0.0f) * ci * std::max(0.0f, pw[i]);
+            minZ[i] = v < minZ[i] ? v : minZ[i];
+            sumW[i] += wi;
+            sumWH[i] += wi * (finite ? v : 0.0f);
+            sumWC[i] += wi * ci;
+        }
+    }
+
+    float* o = job_.out + base;
+    uint32_t valid = 0, fallback = 0;
+    if (Weighted) {
+        float* oc = job_.outConfidence ? job_.outConfidence + base : nullptr;
+        // Divide first, select after: a division only feeding one arm of a select gets sunk into a
+        // branch, which stops the loop from vectorizing.
+        for (size_t i = 0; i < count; ++i) {
+            const float w = sumW[i];
+            const float d = w > 0.0f ? w : 1.0f;
+            sumWH[i] = sumWH[i] / d;
+            sumWC[i] = sumWC[i] / d;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            const float z = minZ[i], w = sumW[i];
+            const bool any = z < inf;
+            const bool haveW = w > 0.0f;
+            const float fused = w > meanMinWeight ? sumWH[i] : z;
+            o[i] = any ? fused : empty;
+            sumWC[i] = haveW ? sumWC[i] : 0.0f;
+            valid += any ? 1u : 0u;
+            fallback += (any & !haveW) ? 1u : 0u;
+        }
+        if (oc) std::copy(sumWC, sumWC + count, oc);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            const float z = minZ[i];
+            const bool any = z < inf;
+            o[i] = any ? z : empty;
+            valid += any ? 1u : 0u;
+        }
+    }
+    counts.valid += valid;
+    counts.fallbackMinZ += fallback;
+}
+
+} // namespace caldera::backend::processing
@@ -28,11 +28,19 @@ struct FusionInputLayer {
 };
 
 /**
- * Phase 0 FusionAccumulator scaffold:
- *  - Collects zero or more sensor layers per frame
- *  - For single layer: passthrough copy
- *  - For >1 layers (not implemented yet): placeholder min-z strategy (TODO Phase 1)
- *  - No dynamic allocations per frame except potential first-time reserve
+ * FusionAccumulator: fuses N same-size sensor layers into one W x H height map.
+ *  - Single layer: passthrough copy
+ *  - No confidence / weights (strategy 0): per-pixel min-z over finite heights
+ *  - Any confidence or external weights (strategy 1): per-pixel weighted mean with
+ *    w = clamp(confidence,0,1) * layerWeight * pixelWeight, fused confidence sum(w*c)/sum(w);
+ *    pixels whose weights sum to zero fall back to min-z with confidence 0
+ *  - Pixels without any finite height are empty (NaN, or 0 with invalidToZero / fuse())
+ *  - Sensors absent for more than the dropout window are counted stale and not expected
+ *
+ * The kernel walks the frame in row bands (on the shared ThreadPool for large frames, see
+ * CALDERA_FUSION_THREADS); inside a band, pixels are processed in chunks layer by layer with
+ * branch-free loops so the compiler vectorizes them. Output is identical for any thread count.
+ * No dynamic allocations per frame except potential first-time reserve.
  */
 class FusionAccumulator {
 public:
@@ -48,6 +56,10 @@ public:
         int strategy = 0;                       // 0=min-z,1=confidence-weight
     };
 
+    FusionAccumulator();
+    FusionAccumulator(const FusionAccumulator&) = delete;
+    FusionAccumulator& operator=(const FusionAccumulator&) = delete;
+
     void beginFrame(uint64_t frameId, int width, int height) {
         frameId_ = frameId;
         width_ = width;
@@ -88,8 +100,8 @@ public:
         // Append heights
         heightsStorage_.insert(heightsStorage_.end(), layer.heights, layer.heights + framePixelCount_);
         // Count valid values directly from source to avoid re-reading appended region later if we refactor
-        uint32_t validCount = 0;
-        for (size_t i=0;i<framePixelCount_; ++i){ float v = layer.heights[i]; if(std::isfinite(v)) ++validCount; }
+        uint32_t validCount = 0; // branch-free ((v - v) == 0 rejects NaN/inf) so the count vectorizes
+        for (size_t i=0;i<framePixelCount_; ++i){ const float v = layer.heights[i]; validCount += (v - v) == 0.0f ? 1u : 0u; }
         if(entry.hasConfidence){
             entry.confOffset = confidenceStorage_.size();
             confidenceStorage_.insert(confidenceStorage_.end(), layer.confidence, layer.confidence + framePixelCount_);
@@ -101,48 +113,38 @@ public:
         lastSeenFrameId_[entry.sensorId] = frameId_;
     }
 
-    // weightsPerLayer: optional external array of size layerCount (pre-normalized or raw);
-    // perPixelWeights: optional flat array (layerCount * totalPixels) for future fine-grained weighting (unused Phase 1).
+    // weightsPerLayer: optional external array of size layerCount (raw, negative treated as 0);
+    // perPixelWeights: optional flat array (layerCount * totalPixels), multiplied into the weights.
+    // Empty pixels are stored as 0. outConfidence receives the fused confidence with strategy 1 and
+    // is cleared otherwise.
     void fuse(std::vector<float>& outHeightMap,
               std::vector<float>* outConfidence = nullptr,
-              const float* = nullptr,
-              const float* = nullptr) {
-        // MVP: passthrough for 1 layer, concat along width for 2 layers, else error. No weights, dropout, NaN, etc.
-        // TODO: advanced fusion, dropout, weights, NaN/invalid, confidence, metrics, etc. (see plan)
-        if (layers_.empty()) {
-            outHeightMap.clear();
-            if (outConfidence) outConfidence->clear();
-            return;
-        }
-        if (layers_.size() == 1) {
-            // Passthrough
-            const LayerEntry& L = layers_[0];
-            const float* hSrc = heightsStorage_.data() + L.offset;
-            outHeightMap.assign(hSrc, hSrc + framePixelCount_);
-            if (outConfidence) outConfidence->clear(); // not supported
-            return;
-        }
-        if (layers_.size() == 2) {
-            // Concat along width: output shape 2W x H
-            const LayerEntry& L1 = layers_[0];
-            const LayerEntry& L2 = layers_[1];
-            if (width_ <= 0 || height_ <= 0) { outHeightMap.clear(); if (outConfidence) outConfidence->clear(); return; }
-            size_t N = static_cast<size_t>(width_) * static_cast<size_t>(height_);
-            const float* h1 = heightsStorage_.data() + L1.offset;
-            const float* h2 = heightsStorage_.data() + L2.offset;
-            outHeightMap.resize(N * 2);
-            for (int y = 0; y < height_; ++y) {
-                // left: h1, right: h2
-                std::copy(h1 + y * width_, h1 + (y + 1) * width_, outHeightMap.begin() + y * 2 * width_);
-                std::copy(h2 + y * width_, h2 + (y + 1) * width_, outHeightMap.begin() + y * 2 * width_ + width_);
-            }
-            if (outConfidence) outConfidence->clear(); // not supported
-            return;
-        }
-        // Not supported
-        outHeightMap.clear();
-        if (outConfidence) outConfidence->clear();
-        // TODO: error/exception/logging for >2 sensors
+              const float* weightsPerLayer = nullptr,
+              const float* perPixelWeights = nullptr);
+
+    // Number of floats fuse()/fuseInto() produce for the current frame (0 = nothing to publish).
+    size_t fusedPixelCount() const { return layers_.empty() ? 0 : framePixelCount_; }
+
+    // Writes the fused map into caller-owned memory (e.g. a transport slot) and returns the number of
+    // floats written, or 0 if there is nothing to fuse or capacity is insufficient. With
+    // invalidToZero, empty pixels are stored as 0 in the same pass (external consumer format).
+    // outConfidence (optional, fusedPixelCount() floats) is written with strategy 1 only.
+    size_t fuseInto(float* out, size_t capacity, bool invalidToZero,
+                    float* outConfidence = nullptr,
+                    const float* weightsPerLayer = nullptr,
+                    const float* perPixelWeights = nullptr);
+
+    // Band threads used for large frames (<= 0: CALDERA_FUSION_THREADS or the shared pool's concurrency).
+    void setThreadCount(int threads);
+    int threadCount() const { return threads_; }
+
+    // Dropout rule shared with ProcessingManager's fusion barrier: a sensor is expected in frame
+    // `frameId` once it contributed a layer and has not been absent for more than the dropout window
+    // (window 0 disables dropout, so known sensors stay expected).
+    bool isExpected(const std::string& sensorId, uint64_t frameId) const {
+        auto it = lastSeenFrameId_.find(sensorId);
+        if (it == lastSeenFrameId_.end()) return false;
+        return dropoutWindow_ == 0 || frameId <= it->second + dropoutWindow_;
     }
 
     size_t layerCount() const { return layers_.size(); }
@@ -150,6 +152,20 @@ public:
     const FusionStats& stats() const { return stats_; }
 
 private:
+    struct FuseJob {
+        float* out = nullptr;
+        float* outConfidence = nullptr;
+        const float* layerWeights = nullptr;
+        const float* pixelWeights = nullptr;
+        bool weighted = false;
+        bool invalidToZero = false;
+    };
+    struct BandCounts { uint32_t valid = 0; uint32_t fallbackMinZ = 0; };
+
+    void fuseRows(int y0, int y1, BandCounts& counts) const;
+    template <bool Weighted, size_t N>
+    void fuseChunk(size_t base, size_t n, BandCounts& counts) const;
+
     uint64_t frameId_ = 0;
     int width_ = 0;
     int height_ = 0;
@@ -168,6 +184,11 @@ private:
     std::unordered_map<std::string,uint64_t> lastSeenFrameId_;
     uint64_t dropoutWindow_ = 60; // frames
     bool dropoutWindowLoaded_ = false;
+
+    // Row bands, dispatched to the shared ThreadPool.
+    int threads_ = 1;
+    FuseJob job_{};
+    std::vector<BandCounts> bandCounts_;
 };
 
 } // namespace caldera::backend::processing
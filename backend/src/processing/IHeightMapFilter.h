@@ -7,6 +7,7 @@
 #ifndef CALDERA_BACKEND_PROCESSING_IHEIGHTMAPFILTER_H
 #define CALDERA_BACKEND_PROCESSING_IHEIGHTMAPFILTER_H
 
+#include <memory>
 #include <vector>
 
 namespace caldera::backend::processing {
@@ -16,11 +17,23 @@ public:
     virtual ~IHeightMapFilter() = default;
     // Mutates 'data' in-place. Width/height supplied for kernels needing topology awareness.
     virtual void apply(std::vector<float>& data, int width, int height) = 0;
+    // Fresh instance with the same configuration and no history; ProcessingManager gives every sensor
+    // lane its own copy. nullptr = not clonable: the lanes then share this instance, serialized.
+    virtual std::shared_ptr<IHeightMapFilter> clone() const { return nullptr; }
+
+    // Row-band execution (TiledStageExecutor). A filter whose output pixel depends only on the same
+    // input pixel (and its own history) can run a frame as beginRows, applyRows over disjoint row
+    // ranges covering the frame (possibly concurrently), then endRows. Default: whole frames only.
+    virtual bool supportsRows() const { return false; }
+    virtual void beginRows(int width, int height) { (void)width; (void)height; }
+    virtual void applyRows(float* data, int width, int y0, int y1) { (void)data; (void)width; (void)y0; (void)y1; }
+    virtual void endRows() {}
 };
 
 class NoOpHeightMapFilter final : public IHeightMapFilter {
 public:
     void apply(std::vector<float>&, int, int) override { /* intentional no-op */ }
+    std::shared_ptr<IHeightMapFilter> clone() const override { return std::make_shared<NoOpHeightMapFilter>(); }
 };
 
 } // namespace caldera::backend::processing
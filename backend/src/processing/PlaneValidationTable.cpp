@@ -0,0 +1,94 @@
+#include "processing/PlaneValidationTable.h"
+#include "processing/UnprojectionRayTable.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace caldera::backend::processing {
+
+namespace {
+constexpr uint32_t kRawMin = 1;      // raw==0 means "no reading" and is never valid
+constexpr uint32_t kRawMax = 65535;
+
+// Interval [lo,hi] of raw values in [kRawMin,kRawMax] for which a monotonic predicate holds.
+// Empty interval is returned as lo>hi.
+template<typename Pred>
+inline void monotonicInterval(Pred p, uint32_t& lo, uint32_t& hi){
+    bool atMin = p(kRawMin), atMax = p(kRawMax);
+    if(atMin && atMax){ lo=kRawMin; hi=kRawMax; return; }
+    if(!atMin && !atMax){ lo=kRawMax; hi=kRawMin; return; }
+    uint32_t a=kRawMin, b=kRawMax; // invariant: p(a)==atMin, p(b)==atMax
+    while(b-a>1){ uint32_t m=a+(b-a)/2; if(p(m)==atMin) a=m; else b=m; }
+    if(atMax){ lo=b; hi=kRawMax; } else { lo=kRawMin; hi=a; }
+}
+
+// plane(z * ray + origin) = z * k + m with k, m fixed per pixel.
+struct FoldedPlane { float k, m; };
+inline FoldedPlane foldPlane(const std::array<float,4>& p, const UnprojectionRayTable& rays, size_t idx){
+    return { p[0]*rays.rayX()[idx] + p[1]*rays.rayY()[idx] + p[2]*rays.rayZ()[idx],
+             p[0]*rays.originX() + p[1]*rays.originY() + p[2]*rays.originZ() + p[3] };
+}
+}
+
+bool PlaneValidationTable::evaluate(float wx, float wy, uint16_t raw, float depthScale, const Plane& minPlane, const Plane& maxPlane){
+    if(raw==0) return false;
+    float z = (float)raw * depthScale;
+    if(!std::isfinite(z)) return false;
+    float minV = minPlane[0]*wx + minPlane[1]*wy + minPlane[2]*z + minPlane[3];
+    float maxV = maxPlane[0]*wx + maxPlane[1]*wy + maxPlane[2]*z + maxPlane[3];
+    return minV>=0.0f && maxV<=0.0f;
+}
+
+bool PlaneValidationTable::evaluateRay(const UnprojectionRayTable& rays, size_t idx, uint16_t raw, float depthScale,
+                                       const Plane& minPlane, const Plane& maxPlane){
+    if(raw==0) return false;
+    float z = (float)raw * depthScale;
+    if(!std::isfinite(z)) return false;
+    const FoldedPlane a = foldPlane(minPlane, rays, idx), b = foldPlane(maxPlane, rays, idx);
+    return z*a.k + a.m >= 0.0f && z*b.k + b.m <= 0.0f;
+}
+
+bool PlaneValidationTable::ensure(uint32_t width, uint32_t height, float depthScale,
+                                  const Plane& minPlane, const Plane& maxPlane, bool planesEnabled,
+                                  const UnprojectionRayTable* rays){
+    if(rays && !rays->matches(width, height)) rays = nullptr;
+    const uint64_t raysId = (rays && planesEnabled) ? rays->id() : 0;
+    if(built_ && width==width_ && height==height_ && depthScale==scale_ && planesEnabled==planesEnabled_
+       && (!planesEnabled || (minPlane==minPlane_ && maxPlane==maxPlane_ && raysId==raysId_))) return false;
+    width_=width; height_=height; scale_=depthScale; minPlane_=minPlane; maxPlane_=maxPlane; planesEnabled_=planesEnabled; raysId_=raysId;
+    const size_t N=(size_t)width*height;
+    lo_.resize(N); hi_.resize(N);
+
+    // Finite-depth interval is shared by every pixel.
+    uint32_t fLo, fHi;
+    monotonicInterval([&](uint32_t r){ return std::isfinite((float)r * depthScale); }, fLo, fHi);
+
+    for(uint32_t y=0; y<height; ++y){
+        const float wy = pixelWorldY(y, height);
+        for(uint32_t x=0; x<width; ++x){
+            const size_t idx=(size_t)y*width + x;
+            uint32_t lo=fLo, hi=fHi;
+            // Each plane term is evaluated only where z is finite; clamp bisection to that range.
+            auto zOf=[&](uint32_t r){ return (float)std::clamp(r, fLo, fHi) * depthScale; };
+            if(planesEnabled && lo<=hi && raysId){
+                const FoldedPlane a = foldPlane(minPlane, *rays, idx), b = foldPlane(maxPlane, *rays, idx);
+                uint32_t aLo, aHi, bLo, bHi;
+                monotonicInterval([&](uint32_t r){ return zOf(r)*a.k + a.m >= 0.0f; }, aLo, aHi);
+                monotonicInterval([&](uint32_t r){ return zOf(r)*b.k + b.m <= 0.0f; }, bLo, bHi);
+                lo=std::max({lo,aLo,bLo}); hi=std::min({hi,aHi,bHi});
+            } else if(planesEnabled && lo<=hi){
+                const float wx = pixelWorldX(x, width);
+                uint32_t aLo, aHi, bLo, bHi;
+                monotonicInterval([&](uint32_t r){ float z=zOf(r); return minPlane[0]*wx + minPlane[1]*wy + minPlane[2]*z + minPlane[3] >= 0.0f; }, aLo, aHi);
+                monotonicInterval([&](uint32_t r){ float z=zOf(r); return maxPlane[0]*wx + maxPlane[1]*wy + maxPlane[2]*z + maxPlane[3] <= 0.0f; }, bLo, bHi);
+                lo=std::max({lo,aLo,bLo}); hi=std::min({hi,aHi,bHi});
+            }
+            if(lo>hi){ lo_[idx]=(uint16_t)kRawMax; hi_[idx]=0; }
+            else { lo_[idx]=(uint16_t)lo; hi_[idx]=(uint16_t)hi; }
+        }
+    }
+    built_=true; ++rebuildCount_;
+    return true;
+}
+
+} // namespace caldera::backend::processing
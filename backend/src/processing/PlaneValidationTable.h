@@ -0,0 +1,70 @@
+#ifndef CALDERA_BACKEND_PROCESSING_PLANE_VALIDATION_TABLE_H
+#define CALDERA_BACKEND_PROCESSING_PLANE_VALIDATION_TABLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace caldera::backend::processing {
+
+class UnprojectionRayTable;
+
+// Per-pixel raw-depth bounds derived from the min/max validity planes.
+//
+// The build step accepts a pixel when
+//   minPlane(wx,wy,z) >= 0  &&  maxPlane(wx,wy,z) <= 0,   z = raw * depthScale
+// For a fixed pixel wx/wy are constant and both plane values are monotonic in raw, so the
+// accepted set is a contiguous raw interval [lo,hi]. The table stores that interval per pixel
+// (lo > hi encodes "never valid"), turning the per-frame test into two integer compares.
+// Bounds are resolved by bisection against the exact float expression the build loop used,
+// so results are bit-identical to the per-pixel plane evaluation (including boundaries).
+//
+// With a calibrated UnprojectionRayTable the world point is z * ray + origin instead of the
+// unit-pitch pixel grid; each plane then folds to z * k + m per pixel (see evaluateRay).
+class PlaneValidationTable {
+public:
+    using Plane = std::array<float,4>;
+
+    // Rebuild only if any input differs from the last build. Returns true if a rebuild happened.
+    // rays (optional) must match width x height; otherwise the pixel grid geometry is used.
+    bool ensure(uint32_t width, uint32_t height, float depthScale,
+                const Plane& minPlane, const Plane& maxPlane, bool planesEnabled,
+                const UnprojectionRayTable* rays = nullptr);
+    void invalidate() { built_ = false; }
+    // Invalidate and return the bound storage to the allocator.
+    void release() { built_ = false; std::vector<uint16_t>().swap(lo_); std::vector<uint16_t>().swap(hi_); }
+
+    // Hot-path test: raw==0 is always rejected (lo >= 1).
+    bool accepts(size_t idx, uint16_t raw) const { return raw >= lo_[idx] && raw <= hi_[idx]; }
+    const uint16_t* lo() const { return lo_.data(); }
+    const uint16_t* hi() const { return hi_.data(); }
+
+    uint32_t width() const { return width_; }
+    uint32_t height() const { return height_; }
+    uint64_t rebuildCount() const { return rebuildCount_; }
+
+    // Pixel-centred world coordinates (unit pixel pitch) shared with the build loop.
+    static float pixelWorldX(uint32_t x, uint32_t width) { return float(x) - (width-1)*0.5f; }
+    static float pixelWorldY(uint32_t y, uint32_t height) { return float(y) - (height-1)*0.5f; }
+    // Reference float evaluation (same operation order as the original per-pixel validation).
+    static bool evaluate(float wx, float wy, uint16_t raw, float depthScale, const Plane& minPlane, const Plane& maxPlane);
+    // Reference for the ray geometry: plane(z * ray + origin) folded to z * k + m (monotonic in raw).
+    static bool evaluateRay(const UnprojectionRayTable& rays, size_t idx, uint16_t raw, float depthScale,
+                            const Plane& minPlane, const Plane& maxPlane);
+
+private:
+    uint32_t width_ = 0, height_ = 0;
+    float scale_ = 0.f;
+    Plane minPlane_{}, maxPlane_{};
+    bool planesEnabled_ = false;
+    uint64_t raysId_ = 0; // UnprojectionRayTable::id() the bounds were built with, 0 = pixel grid
+    bool built_ = false;
+    uint64_t rebuildCount_ = 0;
+    std::vector<uint16_t> lo_;
+    std::vector<uint16_t> hi_;
+};
+
+} // namespace caldera::backend::processing
+
+#endif // CALDERA_BACKEND_PROCESSING_PLANE_VALIDATION_TABLE_H
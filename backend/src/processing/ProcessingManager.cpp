@@ -4,11 +4,19 @@
 // Local processing filters
 #include "SpatialFilter.h"
 #include "FastGaussianBlur.h"
+#include "FusedBuildKernel.h"
+#include "WorldGridRasterizer.h"
+#include "UnprojectionRayTable.h"
+#include "UndistortionRemap.h"
+#include "DepthCorrector.h"
+#include "TiledStageExecutor.h"
+#include "common/ThreadPool.h"
 #include "stages/BuildStage.h"
 #include "stages/TemporalStage.h"
 #include "stages/SpatialStage.h"
 #include "stages/FusionStage.h"
 #include "stages/LambdaStage.h"
+#include "stages/BandLambdaStage.h"
 #include "tools/calibration/SensorCalibration.h" // for profile auto-load
 
 #include <spdlog/logger.h>
@@ -17,8 +25,11 @@
 #include <limits>
 #include <sstream>
 #include <algorithm> // std::clamp
+#include <atomic>
 #include <cctype>
 #include <cstring>
+#include <iterator>
+#include <thread>
 #if defined(__GLIBC__)
 #include <malloc.h>
 #endif
@@ -30,6 +41,67 @@ static bool envFlag(const char* name, bool def=false){ if(const char* e=std::get
 static float envFloat(const char* n, float def){ if(const char* e=std::getenv(n)){ try { return std::stof(e);} catch(...){} } return def; }
 static int   envInt  (const char* n, int def){ if(const char* e=std::getenv(n)){ try { return std::stoi(e);} catch(...){} } return def; }
 
+// --- Spatial helpers -----------------------------------------------------------
+static std::unique_ptr<FastGaussianBlur> makeFastGauss(int threads){
+    float sigma = 1.5f;
+    if(const char* e=std::getenv("CALDERA_FASTGAUSS_SIGMA")){
+        try { float v = std::stof(e); if(v>0.1f && v<20.f) sigma=v; } catch(...){}
+    }
+    return std::make_unique<FastGaussianBlur>(sigma, threads);
+}
+
+// Evenly strided sample positions (seeded by frame id) for the spatial variance / edge metrics.
+static void spatialSampleIndices(uint64_t frameId, size_t pixels, int sampleCount, std::vector<size_t>& out){
+    out.clear();
+    if(sampleCount<=0 || pixels<=static_cast<size_t>(sampleCount)) return;
+    out.reserve(sampleCount);
+    size_t step = pixels/static_cast<size_t>(sampleCount);
+    if(step==0) step=1;
+    size_t seed = (frameId*1664525u + 1013904223u) % pixels;
+    size_t idx = seed % step;
+    for(int i=0; i<sampleCount && idx<pixels; ++i, idx+=step) out.push_back(idx);
+}
+
+// Value, right and down neighbour (NaN past the frame edge) of the sampled positions inside pixels
+// [begin, end), written to their slots in out (3 floats per sample). Ascending sample positions.
+static void spatialSampleGather(const float* heightMap, int W, int H, const std::vector<size_t>& sampleIdx, size_t begin, size_t end, float* out){
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    for(size_t k = std::lower_bound(sampleIdx.begin(), sampleIdx.end(), begin) - sampleIdx.begin(); k<sampleIdx.size() && sampleIdx[k]<end; ++k){
+        const size_t si = sampleIdx[k]; const int y=int(si/W), x=int(si%W);
+        out[3*k] = heightMap[si]; out[3*k+1] = x+1<W ? heightMap[si+1] : nan; out[3*k+2] = y+1<H ? heightMap[si+W] : nan;
+    }
+}
+
+// Sample variance and mean |forward gradient| of gathered samples; outputs untouched without enough samples.
+static void spatialGatheredStats(const float* g, size_t samples, float& var, float& edgeOut){
+    double sum=0, sumSq=0; int n=0; double edge=0; int edgeN=0;
+    for(size_t k=0;k<samples;++k){ float v=g[3*k]; if(std::isfinite(v)){ sum+=v; sumSq+=double(v)*v; ++n; }}
+    if(n>1) var = static_cast<float>((sumSq - (sum*sum)/n)/(n-1));
+    for(size_t k=0;k<samples;++k){ float c=g[3*k]; if(!std::isfinite(c)) continue; float gx=0, gy=0; float r=g[3*k+1]; if(std::isfinite(r)) gx=r-c; float d=g[3*k+2]; if(std::isfinite(d)) gy=d-c; edge += std::fabs(gx)+std::fabs(gy); ++edgeN; }
+    if(edgeN>0) edgeOut = static_cast<float>(edge/edgeN);
+}
+
+// The same over a whole frame; scratch holds the gathered samples.
+static void spatialSampleStats(const float* heightMap, int W, int H, const std::vector<size_t>& sampleIdx, std::vector<float>& scratch, float& var, float& edgeOut){
+    scratch.resize(sampleIdx.size()*3);
+    spatialSampleGather(heightMap, W, H, sampleIdx, 0, static_cast<size_t>(W)*H, scratch.data());
+    spatialGatheredStats(scratch.data(), sampleIdx.size(), var, edgeOut);
+}
+
+// --- Confidence ----------------------------------------------------------------
+// Confidence of a valid pixel from stability S, spatial variance ratio (0 = not sampled) and temporal
+// blend T, weighted by CALDERA_CONF_WEIGHT_S/R/T. Shared by the fused map and the per-lane layers.
+static float blendConfidence(float S, float varianceRatio, float T, float wS, float wR, float wT){
+    S=std::clamp(S,0.0f,1.0f); T=std::clamp(T,0.0f,1.0f);
+    float R=varianceRatio; if(!(R>=0.f) || !std::isfinite(R) || R<=0.f) R=1.0f; if(R>2.f) R=1.0f;
+    if(varianceRatio==0.0f) wR=0.0f;
+    float ws=wS+wR+wT; if(ws<=0){ wS=1; wR=0; wT=0; ws=1; }
+    float invWs=1.f/ws; float compS=wS*S; float compR=(wR>0)? wR*(1.0f-std::min(1.0f,std::max(0.0f,R))):0.f; float compT=wT*T;
+    float c=(compS+compR+compT)*invWs;
+    if(c<0) c=0; else if(c>1) c=1;
+    return c;
+}
+
 ProcessingManager::ProcessingManager(std::shared_ptr<spdlog::logger> orchestratorLogger,
                                      std::shared_ptr<spdlog::logger> fusionLogger,
                                      float depthToHeightScale)
@@ -47,6 +119,11 @@ ProcessingManager::ProcessingManager(std::shared_ptr<spdlog::logger> orchestrato
     adaptiveStrongStabFrac_  = envFloat("CALDERA_ADAPTIVE_STRONG_STAB_FRAC", adaptiveStrongStabFrac_);
     adaptiveStrongDoublePass_= envFlag ("CALDERA_ADAPTIVE_STRONG_DOUBLE", adaptiveStrongDoublePass_);
     adaptiveTemporalScale_   = envFloat("CALDERA_ADAPTIVE_TEMPORAL_SCALE", adaptiveTemporalScale_);
+    tiledExecution_          = envFlag ("CALDERA_PROCESSING_TILED", false);
+    if(const char* sk=std::getenv("CALDERA_ADAPTIVE_STRONG_KERNEL")){ // unknown values keep the default
+        const std::string v(sk);
+        if(v=="classic_double" || v=="wide5" || v=="fastgauss") adaptiveState_.strongKernelChoice = v;
+    }
 
     confidenceEnabled_       = envFlag ("CALDERA_ENABLE_CONFIDENCE_MAP", true);
     exportConfidence_        = envFlag ("CALDERA_PROCESSING_EXPORT_CONFIDENCE", false);
@@ -67,6 +144,11 @@ ProcessingManager::ProcessingManager(std::shared_ptr<spdlog::logger> orchestrato
                 tools::calibration::SensorCalibrationProfile profile;
                 if(calib.loadCalibrationProfile(profSensor, profile)){
                     applyCalibrationProfile(profile); // sets transformParamsReady_, resets planeOffsetsApplied_
+                    if(profile.hasDepthCorrection){
+                        auto corr = std::make_shared<CorrectionProfile>(DepthCorrector::createProfile(profSensor, profile));
+                        if(corr->isValid) depthCorrections_[""] = std::move(corr);
+                        else if(orch_logger_) orch_logger_->warn("Ignoring depth correction coefficients of sensor '{}' (unrecognized layout)", profSensor);
+                    }
                     // When loaded from profile we consider planes final; skip env offset application
                     planeOffsetsApplied_ = true;
                     profileLoaded_ = true;
@@ -120,6 +202,8 @@ ProcessingManager::ProcessingManager(std::shared_ptr<spdlog::logger> orchestrato
                            duplicateFusionShift_, duplicateFusionBaseConf_, duplicateFusionDupConf_);
     }
 
+    barrierTimeoutMs_ = std::max(0, envInt("CALDERA_FUSION_BARRIER_TIMEOUT_MS", barrierTimeoutMs_));
+
     // Optional proactive preallocation (now opt-in; default OFF) to eliminate allocator noise in large high-throughput tests.
     if(envFlag("CALDERA_PREALLOC_ALL", false)) { // enable explicitly when needed
         // Heuristic target: assume up to 512x512 (used in stress harness configuration) and up to 2 layers.
@@ -127,52 +211,304 @@ ProcessingManager::ProcessingManager(std::shared_ptr<spdlog::logger> orchestrato
         const int preH = envInt("CALDERA_PREALLOC_HEIGHT", 512);
         size_t pixels = static_cast<size_t>(preW) * static_cast<size_t>(preH);
         auto reserveVec = [&](auto& v, size_t count){ if(v.capacity() < count) v.reserve(count); };
-        reserveVec(heightMapBuffer_, pixels);
-        reserveVec(validityBuffer_, pixels);
-        reserveVec(layerHeightsBuffer_, pixels * 2); // allow two layers
+        preallocPixels_ = pixels; // lane height/validity buffers reserve this on creation
         reserveVec(layerConfidenceBuffer_, pixels * 2);
-        reserveVec(fusedHeightsBuffer_, pixels);
         reserveVec(fusedConfidenceBuffer_, pixels);
-        reserveVec(originalInvalidMask_, pixels);
         fusion_.reserveFor(preW, preH, 2);
         if(orch_logger_) orch_logger_->info("Preallocated processing buffers for {}x{} ({} pixels)", preW, preH, pixels);
     }
+
+    if(envFlag("CALDERA_PROCESSING_PIPELINED", false)) startPipeline();
 }
 
+// --- Sensor lanes ------------------------------------------------------------
+// Everything build / temporal / spatial touch for one sensor id. Only the thread holding `mutex`
+// uses the buffers and filter state; the snapshot is filled under fuseMutex_ at frame start and the
+// results are read by the fusion leader while `ready` is set.
+struct ProcessingManager::LaneResult {
+    uint64_t timestampNs = 0;
+    uint32_t width = 0;    // grid size when a rasterize stage ran
+    uint32_t heightPx = 0;
+    FrameValidationSummary summary;
+    SpatialApplyResult spatial;
+    bool spatialValid = false;
+    bool temporalBlendApplied = false;
+    std::chrono::steady_clock::time_point tBuildStart, tBuildEnd;
+};
+
+struct ProcessingManager::SensorLane {
+    std::string id;
+    std::mutex mutex; // one frame per sensor in flight, held through the fusion barrier
+    uint64_t frames = 0;
+    std::vector<float> height;
+    std::vector<uint8_t> validity;
+    PlaneValidationTable planeTable; // per-pixel raw bounds (self-invalidates on dims/scale/plane change)
+    UnprojectionRayTable rays;       // calibrated plane geometry (only when intrinsics are set)
+    std::shared_ptr<const CorrectionProfile> correction; // "correct" stage table (snapshot, may be null)
+    std::shared_ptr<IHeightMapFilter> temporal;
+    const IHeightMapFilter* temporalSource = nullptr; // height_filter_ the lane was bound to
+    std::unique_ptr<SpatialFilter> classic;
+    std::unique_ptr<FastGaussianBlur> fast;
+    std::unique_ptr<UndistortionRemap> undistort; // "undistort" stage (remap table rebuilt on calibration change)
+    std::vector<float> undistortOut;              // swapped with height each undistorted frame
+    std::unique_ptr<WorldGridRasterizer> raster; // "rasterize" stage, rebuilt when the grid changes
+    std::vector<float> rasterOut;                // swapped with height each rasterized frame
+    std::vector<float> prevFiltered; // filtered heights of the previous frame (adaptive temporal blend)
+    bool prevFilteredValid = false;
+    // Row-band execution (CALDERA_PROCESSING_TILED).
+    TiledStageExecutor tiles;
+    struct SpatialTile { std::unique_ptr<SpatialFilter> classic; std::unique_ptr<FastGaussianBlur> fast; std::vector<float> rows; };
+    std::vector<SpatialTile> spatialTiles; // one per band slot: a band plus its halo rows and private kernels
+    std::atomic<uint32_t> bandValid{0}, bandInvalid{0};
+    // Spatial decision of the current frame (runLane), used by the stage loop and the banded stage.
+    bool spatialApply = false;
+    bool spatialStrong = false;
+    std::string spatialAlt;
+    int spatialSamples = 512;
+    SpatialKernel spatialKernels[2] = {};
+    int spatialPassCount = 0;
+    int spatialHalo = 0;
+    std::vector<size_t> spatialSampleIdx;
+    std::vector<float> spatialSampleVals; // gathered samples (value, right, down) per sample index
+    // Snapshot of shared state (beginLaneFrame).
+    TransformParameters params{};
+    bool paramsReady = false;
+    WorldGridRasterizer::Config rasterConfig;
+    AdaptiveState adaptive;
+    uint64_t frameId = 0;
+    bool blendUnstable = false;
+    // Results handed to the fusion leader (with height / validity).
+    bool ready = false;
+    LaneResult out;
+    // processFrameSet helper thread, started on first use.
+    std::thread worker;
+    std::mutex jobMutex;
+    std::condition_variable jobCv;
+    const RawDepthFrame* job = nullptr;
+    size_t jobExpected = 0;
+    bool stopWorker = false;
+};
+
+// One frame (set) in the pipelined executor. The "lanes" stage moves each member's heights and
+// validity out of its lane (buffer swap, no copy), so the lane can build its next frame while
+// "fuse" reads these; the buffers circulate between lanes and slots and keep their capacity.
+struct ProcessingManager::PipelineSlot {
+    uint64_t frameId = 0;
+    RawDepthFrame copy;                         // processRawDepthFrame input
+    std::vector<hal::RawDepthFrameHandle> held; // processFrameSet input, released after the build
+    struct Member {
+        SensorLane* lane = nullptr;
+        const RawDepthFrame* raw = nullptr;
+        LaneResult result;
+        std::vector<float> height;
+        std::vector<uint8_t> validity;
+    };
+    std::vector<Member> members; // the first `count` are in use
+    size_t count = 0;
+    std::vector<FusionLayer> layers;
+    std::shared_ptr<WorldFrame> frame; // fuse -> publish
+};
+
 ProcessingManager::~ProcessingManager(){
+    pipeline_.reset(); // drains queued frames while lanes and callbacks still exist
+    for(auto& lane : lanes_){
+        { std::lock_guard<std::mutex> lk(lane->jobMutex); lane->stopWorker = true; }
+        lane->jobCv.notify_all();
+        if(lane->worker.joinable()) lane->worker.join();
+    }
     // Release large buffers explicitly to reduce RSS accumulation across repeated stress tests.
-    std::vector<float>().swap(heightMapBuffer_);
-    std::vector<uint8_t>().swap(validityBuffer_);
-    std::vector<float>().swap(layerHeightsBuffer_);
+    lanesById_.clear();
+    lanes_.clear();
     std::vector<float>().swap(layerConfidenceBuffer_);
-    std::vector<float>().swap(fusedHeightsBuffer_);
+    framePool_.clear();
     std::vector<float>().swap(fusedConfidenceBuffer_);
-    std::vector<uint8_t>().swap(originalInvalidMask_);
 #if defined(__GLIBC__)
     malloc_trim(0);
 #endif
 }
 
 void ProcessingManager::setWorldFrameCallback(WorldFrameCallback cb){ callback_ = std::move(cb); }
+void ProcessingManager::setWorldFrameHandleCallback(WorldFrameHandleCallback cb){ handleCallback_ = std::move(cb); }
+void ProcessingManager::setDirectPublishSink(std::shared_ptr<common::IWorldFrameSlotSink> sink){ std::lock_guard<std::mutex> lk(fuseMutex_); directSink_ = std::move(sink); }
+void ProcessingManager::setHeightMapFilter(std::shared_ptr<IHeightMapFilter> f){ std::lock_guard<std::mutex> lk(fuseMutex_); height_filter_ = std::move(f); }
+void ProcessingManager::setProcessingConfig(const ProcessingConfig& config){ std::lock_guard<std::mutex> lk(fuseMutex_); processingConfig_ = config; }
+void ProcessingManager::setSensorPose(const std::string& sensorId, const TransformParameters& pose){ std::lock_guard<std::mutex> lk(fuseMutex_); sensorPoses_[sensorId] = pose; }
+void ProcessingManager::setDepthCorrection(const std::string& sensorId, std::shared_ptr<const CorrectionProfile> profile){
+    std::lock_guard<std::mutex> lk(fuseMutex_);
+    if(profile) depthCorrections_[sensorId] = std::move(profile); else depthCorrections_.erase(sensorId);
+}
+size_t ProcessingManager::sensorLaneCount() const { std::lock_guard<std::mutex> lk(fuseMutex_); return lanes_.size(); }
+uint64_t ProcessingManager::fusionBarrierTimeouts() const { std::lock_guard<std::mutex> lk(fuseMutex_); return barrierTimeouts_; }
+
+ProcessingManager::SensorLane& ProcessingManager::laneFor(const std::string& sensorId){
+    std::lock_guard<std::mutex> lk(fuseMutex_);
+    auto it = lanesById_.find(sensorId);
+    if(it != lanesById_.end()) return *it->second;
+    lanes_.push_back(std::make_unique<SensorLane>());
+    SensorLane& lane = *lanes_.back();
+    lane.id = sensorId;
+    if(preallocPixels_){ lane.height.reserve(preallocPixels_); lane.validity.reserve(preallocPixels_); }
+    lanesById_.emplace(sensorId, &lane);
+    if(orch_logger_ && lanes_.size() > 1) orch_logger_->info("Processing lane {} added for sensor '{}'", lanes_.size()-1, sensorId);
+    return lane;
+}
+
+void ProcessingManager::processFrameSet(const hal::FrameSet& set){
+    // Distinct sensors run in parallel: lane helper threads take every member but the first, which
+    // runs on the calling thread. The barrier quorum is the member count, so sensors absent from the
+    // set are not waited for. A sensor id repeated within a set cannot share its lane concurrently;
+    // the extra frames are fused on their own afterwards.
+    auto& members = setMembers_;
+    members.clear();
+    for(const auto& depth : set.depth){
+        if(depth) members.emplace_back(&laneFor(depth->sensorId), depth.get());
+    }
+    if(members.empty()) return;
+    size_t parallel = 0;
+    for(size_t i=0;i<members.size();++i){
+        bool seen=false; for(size_t j=0;j<parallel;++j) if(members[j].first==members[i].first){ seen=true; break; }
+        if(!seen) std::swap(members[parallel++], members[i]);
+    }
+    if(pipeline_){
+        submitPipelined(members.data(), parallel, &set);
+        for(size_t i=parallel;i<members.size();++i) submitPipelined(&members[i], 1, &set);
+        return;
+    }
+    for(size_t i=1;i<parallel;++i){
+        SensorLane& lane = *members[i].first;
+        {
+            std::lock_guard<std::mutex> lk(lane.jobMutex);
+            if(!lane.worker.joinable()) lane.worker = std::thread(&ProcessingManager::laneWorkerLoop, this, std::ref(lane));
+            lane.job = members[i].second;
+            lane.jobExpected = parallel;
+        }
+        lane.jobCv.notify_all();
+    }
+    processLane(*members[0].first, *members[0].second, parallel);
+    for(size_t i=1;i<parallel;++i){
+        SensorLane& lane = *members[i].first;
+        std::unique_lock<std::mutex> lk(lane.jobMutex);
+        lane.jobCv.wait(lk, [&]{ return lane.job == nullptr; });
+    }
+    for(size_t i=parallel;i<members.size();++i) processLane(*members[i].first, *members[i].second, 1);
+}
+
+void ProcessingManager::laneWorkerLoop(SensorLane& lane){
+    std::unique_lock<std::mutex> lk(lane.jobMutex);
+    for(;;){
+        lane.jobCv.wait(lk, [&]{ return lane.job != nullptr || lane.stopWorker; });
+        if(!lane.job) return;
+        const RawDepthFrame* raw = lane.job;
+        const size_t expected = lane.jobExpected;
+        lk.unlock();
+        processLane(lane, *raw, expected);
+        lk.lock();
+        lane.job = nullptr;
+        lane.jobCv.notify_all();
+    }
+}
 
 void ProcessingManager::processRawDepthFrame(const RawDepthFrame& raw) {
-    std::lock_guard<std::mutex> lk(processMutex_);
-    auto tFrameStart = std::chrono::steady_clock::now();
+    if(pipeline_){
+        const std::pair<SensorLane*, const RawDepthFrame*> member{ &laneFor(raw.sensorId), &raw };
+        submitPipelined(&member, 1, nullptr);
+        return;
+    }
+    processLane(laneFor(raw.sensorId), raw, 0);
+}
+
+// --- Pipelined execution -----------------------------------------------------
+void ProcessingManager::startPipeline(){
+    pipeline_ = std::make_unique<FramePipeline>(FramePipeline::Config::fromEnv());
+    pipeline_->addStage("lanes", [this](uint32_t s){ pipelineBuild(*pipelineSlots_[s]); });
+    pipeline_->addStage("fuse", [this](uint32_t s){ pipelineFuse(*pipelineSlots_[s]); });
+    pipeline_->addStage("publish", [this](uint32_t s){ publishFrame(std::move(pipelineSlots_[s]->frame)); });
+    for(uint32_t i=0;i<pipeline_->slotCount();++i) pipelineSlots_.push_back(std::make_unique<PipelineSlot>());
+    pipeline_->start();
+    if(orch_logger_) orch_logger_->info("Pipelined processing enabled (frames in flight <= {})", pipeline_->slotCount());
+}
+
+void ProcessingManager::submitPipelined(const std::pair<SensorLane*, const RawDepthFrame*>* members, size_t count, const hal::FrameSet* set){
+    std::lock_guard<std::mutex> lk(pipelineSubmitMutex_);
+    pipeline_->submit([&](uint32_t s){
+        PipelineSlot& slot = *pipelineSlots_[s];
+        slot.frameId = pipelineSubmitted_++;
+        if(slot.members.size() < count) slot.members.resize(count);
+        slot.count = count;
+        if(set) slot.held.assign(set->depth.begin(), set->depth.end()); // members point into these
+        else slot.copy = *members[0].second;                             // the caller's frame is not kept
+        for(size_t i=0;i<count;++i){
+            slot.members[i].lane = members[i].first;
+            slot.members[i].raw = set ? members[i].second : &slot.copy;
+        }
+    });
+}
+
+void ProcessingManager::pipelineBuild(PipelineSlot& slot){
+    {
+        // Adaptive gating and the adaptive temporal blend depend on the previous fused frame's
+        // metrics: with those on, wait for it so the results match the serial path.
+        std::unique_lock<std::mutex> lk(fuseMutex_);
+        if(metricsEnabled_ && (adaptiveMode_==2 || adaptiveTemporalScale_>1.0f))
+            barrierCv_.wait(lk, [&]{ return frameCounter_ >= slot.frameId; });
+    }
+    for(size_t i=0;i<slot.count;++i){
+        PipelineSlot::Member& m = slot.members[i];
+        SensorLane& lane = *m.lane;
+        std::lock_guard<std::mutex> laneLock(lane.mutex);
+        beginLaneFrame(lane, *m.raw);
+        lane.frameId = slot.frameId; // frameCounter_ lags behind while earlier frames are in flight
+        runLane(lane, *m.raw);
+        m.result = lane.out;
+        m.height.swap(lane.height);
+        m.validity.swap(lane.validity);
+    }
+    slot.held.clear();
+}
+
+void ProcessingManager::pipelineFuse(PipelineSlot& slot){
+    slot.layers.clear();
+    for(size_t i=0;i<slot.count;++i){
+        const PipelineSlot::Member& m = slot.members[i];
+        slot.layers.push_back(FusionLayer{ &m.lane->id, &m.result, &m.height, &m.validity });
+    }
+    {
+        std::lock_guard<std::mutex> lk(fuseMutex_);
+        slot.frame = fuseLayers(slot.layers);
+    }
+    barrierCv_.notify_all();
+}
+
+void ProcessingManager::flush(){
+    if(pipeline_) pipeline_->drain();
+}
+
+FramePipeline::Stats ProcessingManager::pipelineStats() const {
+    return pipeline_ ? pipeline_->stats() : FramePipeline::Stats{};
+}
+
+void ProcessingManager::processLane(SensorLane& lane, const RawDepthFrame& raw, size_t expected){
+    std::lock_guard<std::mutex> laneLock(lane.mutex);
+    beginLaneFrame(lane, raw);
+    runLane(lane, raw);
+    arriveAndFuse(lane, expected);
+}
+
+void ProcessingManager::beginLaneFrame(SensorLane& lane, const RawDepthFrame& raw){
+    std::lock_guard<std::mutex> lk(fuseMutex_);
     if ((frameCounter_ % 120) == 0 && orch_logger_) {
         orch_logger_->info("Processing depth frame sensor={} w={} h={} frame={}", raw.sensorId, raw.width, raw.height, frameCounter_);
     }
     // Heuristic: if this is the first frame and looks like a high-throughput configuration (fps>=100 implied by frame rate elsewhere, we infer by small frame & typical stress dims)
     // and auto prealloc not disabled, proactively reserve exact pixel count buffers to eliminate later growth. This is lighter than global PREALLOC_ALL.
-    if(frameCounter_==0 && !envFlag("CALDERA_DISABLE_STRESS_PREALLOC", false)){
+    if(lane.frames==0 && !envFlag("CALDERA_DISABLE_STRESS_PREALLOC", false)){
         int w = raw.width; int h = raw.height; // stress test uses 320x240 at 120 FPS
         if(w*h <= 320*240 && w>=160 && h>=120){
             size_t pixels = (size_t)w*(size_t)h;
             auto reserveVec=[&](auto& v, size_t n){ if(v.capacity()<n) v.reserve(n); };
-            reserveVec(heightMapBuffer_, pixels);
-            reserveVec(validityBuffer_, pixels);
-            reserveVec(fusedHeightsBuffer_, pixels);
+            reserveVec(lane.height, pixels);
+            reserveVec(lane.validity, pixels);
             reserveVec(fusedConfidenceBuffer_, pixels);
-            reserveVec(originalInvalidMask_, pixels);
             fusion_.reserveFor(w,h,2);
             if(orch_logger_) orch_logger_->info("Stress heuristic preallocation applied for {}x{} ({} px)", w,h,pixels);
         }
@@ -202,44 +538,7 @@ void ProcessingManager::processRawDepthFrame(const RawDepthFrame& raw) {
         transformParamsReady_=true;
         planeOffsetsApplied_=false;
     }
-    // --- Unified stage-based processing path (legacy removed) -------------
-    InternalPointCloud& cloudIn = reusableCloudIn_; lastValidationSummary_={};
-    auto tBuildStart = std::chrono::steady_clock::now();
-    buildAndValidatePointCloud(raw, cloudIn, lastValidationSummary_);
-    auto tBuildEnd = std::chrono::steady_clock::now();
-    if(heightMapBuffer_.size()!=cloudIn.points.size()) heightMapBuffer_.resize(cloudIn.points.size());
-    if(validityBuffer_.size()!=cloudIn.points.size()) validityBuffer_.resize(cloudIn.points.size());
-    if(originalInvalidMask_.size()!=cloudIn.points.size()) originalInvalidMask_.assign(cloudIn.points.size(),0);
-    uint32_t recalculatedInvalid=0;
-    for(size_t i=0;i<cloudIn.points.size();++i){
-        const auto& p=cloudIn.points[i];
-        bool origInvalid = !(p.valid && std::isfinite(p.z));
-        originalInvalidMask_[i] = origInvalid?1:0;
-        float v = (p.valid && std::isfinite(p.z))? p.z : std::numeric_limits<float>::quiet_NaN();
-        heightMapBuffer_[i]=v;
-        // validityBuffer_ keeps original validity (not zero-fill normalization)
-        validityBuffer_[i] = origInvalid?0:1;
-        if(origInvalid) ++recalculatedInvalid;
-    }
-    // Override summary.invalid with recalculated (preserve semantics expected by invalid counting test)
-    lastValidationSummary_.invalid = recalculatedInvalid;
-    std::vector<float>& heightMap = heightMapBuffer_;
-    std::vector<uint8_t>& validity = validityBuffer_;
-    void* metricsOpaque = &lastStabilityMetrics_;
-    FrameContext ctx{ heightMap, validity, confidenceEnabled_? &confidenceMap_ : nullptr, metricsOpaque, adaptiveState_, transformParams_, (uint32_t)cloudIn.width, (uint32_t)cloudIn.height, frameCounter_ };
-    ctx.rawDepthFrame = &raw;
-    ctx.internalCloud = &cloudIn;
-
-    // Recompute adaptive gating pre-stages (same logic as previous legacy branch)
-    if(adaptiveMode_==2 && metricsEnabled_ && frameCounter_>0){
-        float stab=lastStabilityMetrics_.stabilityRatio; float varP=lastStabilityMetrics_.avgVariance;
-        bool unstable=(stab<adaptiveStabilityMin_) || (varP>adaptiveVarianceMax_);
-        if(unstable){ ++unstableStreak_; stableStreak_=0; } else { ++stableStreak_; unstableStreak_=0; }
-        if(!adaptiveSpatialActive_ && unstableStreak_ >= (uint32_t)adaptiveOnStreak_) adaptiveSpatialActive_=true;
-        if(adaptiveSpatialActive_ && stableStreak_ >= (uint32_t)adaptiveOffStreak_) adaptiveSpatialActive_=false;
-        ctx.adaptive.spatialActive = adaptiveSpatialActive_;
-        ctx.adaptive.strongActive = adaptiveSpatialActive_ && (varP > adaptiveStrongVarMult_ * adaptiveVarianceMax_ || stab < adaptiveStrongStabFrac_);
-    } else { ctx.adaptive.spatialActive=false; ctx.adaptive.strongActive=false; }
+    if(transformParamsReady_ && !planeOffsetsApplied_){ const char* envMin=std::getenv("CALDERA_ELEV_MIN_OFFSET_M"); const char* envMax=std::getenv("CALDERA_ELEV_MAX_OFFSET_M"); if(envMin||envMax){ auto adjust=[&](std::array<float,4>& pl, float delta){ pl[3]+= delta * pl[2]; }; if(envMin){ try{ float v=std::stof(envMin); adjust(transformParams_.minValidPlane, -v);}catch(...){} } if(envMax){ try{ float v=std::stof(envMax); adjust(transformParams_.maxValidPlane, -v);}catch(...){} } } planeOffsetsApplied_=true; }
 
     // Ensure stages vector built (pipeline spec may be parsed already). If empty, build a default pipeline.
     if(stages_.empty()){
@@ -250,35 +549,109 @@ void ProcessingManager::processRawDepthFrame(const RawDepthFrame& raw) {
         parsedPipelineSpecs_.push_back(StageSpec{"fusion",{}});
         pipelineSpecValid_=true; rebuildPipelineStages();
     }
+    // Temporal state is per sensor: the first lane uses the injected filter, later lanes a clone.
+    if(lane.temporalSource != height_filter_.get()){
+        lane.temporalSource = height_filter_.get();
+        lane.temporal = (height_filter_ && lanes_.front().get() != &lane) ? height_filter_->clone() : nullptr;
+        if(!lane.temporal) lane.temporal = height_filter_;
+    }
+
+    lane.params = transformParams_;
+    auto pose = sensorPoses_.find(lane.id);
+    if(pose != sensorPoses_.end()){
+        const TransformParameters& p = pose->second;
+        lane.params.focalLengthX = p.focalLengthX; lane.params.focalLengthY = p.focalLengthY;
+        lane.params.principalPointX = p.principalPointX; lane.params.principalPointY = p.principalPointY;
+        std::copy(std::begin(p.distortionCoeffs), std::end(p.distortionCoeffs), lane.params.distortionCoeffs);
+        lane.params.sensorPosition = p.sensorPosition;
+        std::copy(std::begin(p.sensorRotationMatrix), std::end(p.sensorRotationMatrix), lane.params.sensorRotationMatrix);
+    }
+    lane.paramsReady = transformParamsReady_;
+    lane.rasterConfig = WorldGridRasterizer::Config::fromProcessingConfig(processingConfig_);
+    lane.correction.reset();
+    if(correctionStage_){
+        auto corr = depthCorrections_.find(lane.id);
+        if(corr == depthCorrections_.end()) corr = depthCorrections_.find("");
+        if(corr != depthCorrections_.end()) lane.correction = corr->second;
+    }
+    lane.frameId = frameCounter_;
+    // Adaptive gating was decided from the previous fused frame's metrics (see fuseReadyLanes).
+    lane.adaptive = adaptiveState_;
+    const bool gated = adaptiveMode_==2 && metricsEnabled_ && frameCounter_>0;
+    lane.adaptive.spatialActive = gated && adaptiveSpatialActive_;
+    lane.adaptive.strongActive = gated && adaptiveStrongActive_;
+    lane.blendUnstable = false;
+    if(adaptiveTemporalScale_>1.0f && frameCounter_>0 && metricsEnabled_){
+        float stab=lastStabilityMetrics_.stabilityRatio; float varP=lastStabilityMetrics_.avgVariance;
+        lane.blendUnstable=(stab<adaptiveStabilityMin_) || (varP>adaptiveVarianceMax_);
+    }
+}
+
+void ProcessingManager::runLane(SensorLane& lane, const RawDepthFrame& raw){
+    // --- Unified stage-based processing path (legacy removed) -------------
+    const uint32_t frameW=(uint32_t)std::max(raw.width,0), frameH=(uint32_t)std::max(raw.height,0);
+    lane.out.summary = {};
+    std::vector<float>& heightMap = lane.height;
+    // Confidence and metrics are shared and only touched at fusion, so stages do not get them.
+    FrameContext ctx{ heightMap, lane.validity, nullptr, nullptr, lane.adaptive, lane.params, frameW, frameH, lane.frameId };
+    ctx.rawDepthFrame = &raw;
+    ctx.sensorLane = &lane;
 
     // Determine static spatial enable (independent of adaptive) and sample count
     bool staticSpatialEnabled = envFlag("CALDERA_ENABLE_SPATIAL_FILTER", false);
     int sampleCount = envInt("CALDERA_SPATIAL_SAMPLE_COUNT", 0);
     if(orch_logger_ && envFlag("CALDERA_DEBUG_PLANES", false)){
-        orch_logger_->info("[DEBUG] staticSpatialEnabled={} sampleCount={} adaptiveSpatialActive={} frame={}", staticSpatialEnabled, sampleCount, ctx.adaptive.spatialActive, frameCounter_);
+        orch_logger_->info("[DEBUG] staticSpatialEnabled={} sampleCount={} adaptiveSpatialActive={} frame={}", staticSpatialEnabled, sampleCount, ctx.adaptive.spatialActive, lane.frameId);
+    }
+    std::string altKernel;
+    const char* altEnv = std::getenv("CALDERA_SPATIAL_KERNEL_ALT"); if(altEnv&&*altEnv) altKernel=altEnv;
+    // Spatial decision for this frame, shared by the stage loop and the banded spatial stage.
+    lane.spatialApply = staticSpatialEnabled || ctx.adaptive.spatialActive;
+    lane.spatialStrong = ctx.adaptive.strongActive;
+    lane.spatialAlt = altKernel;
+    lane.spatialSamples = sampleCount>0? sampleCount:512;
+    lane.spatialPassCount = lane.spatialApply ? spatialPasses(lane, altKernel, lane.spatialStrong, lane.spatialKernels) : 0;
+    lane.out.spatial = {};
+    lane.out.spatialValid = false;
+
+    // Row-band execution of the leading band-capable stages (build, correct, temporal, spatial), so a
+    // band passes through all of them while in cache. The build runs in bands only as the first stage.
+    const size_t tiled = tiledExecution_ ? TiledStageExecutor::bandablePrefix(stages_, ctx) : 0;
+    const bool buildTiled = tiled>0 && std::strcmp(stages_[0]->name(), "build")==0;
+    lane.out.tBuildStart = std::chrono::steady_clock::now();
+    // Fused build: raw depth -> height (NaN invalid) + validity in one streaming pass (no intermediate cloud).
+    if(!buildTiled) buildHeightAndValidity(lane, raw, lane.out.summary);
+    lane.out.tBuildEnd = std::chrono::steady_clock::now();
+    if(tiled){
+        bool sharedTemporal = false;
+        for(size_t i=0;i<tiled;++i) sharedTemporal |= std::strcmp(stages_[i]->name(), "temporal")==0;
+        std::unique_lock<std::mutex> temporalLock(temporalMutex_, std::defer_lock);
+        if(sharedTemporal && lane.temporal && lane.temporal.get()==lane.temporalSource) temporalLock.lock();
+        lane.tiles.run(stages_, tiled, ctx);
+        if(buildTiled) lane.out.tBuildEnd = std::chrono::steady_clock::now(); // build time includes the banded stages
     }
 
     // Execute stages; intercept spatial to perform in-place filtering with pre/post sampling
-    SpatialApplyResult spatialResultCaptured; bool spatialResultValid=false; std::string altKernel;
-    const char* altEnv = std::getenv("CALDERA_SPATIAL_KERNEL_ALT"); if(altEnv&&*altEnv) altKernel=altEnv;
     if(orch_logger_ && envFlag("CALDERA_DEBUG_PLANES", false)){
         std::ostringstream oss; oss << "[DEBUG] Stage order:"; for(auto& st: stages_) oss << " " << st->name(); orch_logger_->info(oss.str());
     }
-    for(auto& st: stages_) {
+    for(size_t i=tiled;i<stages_.size();++i) {
+        auto& st = stages_[i];
         if(orch_logger_ && envFlag("CALDERA_DEBUG_PLANES", false)){
             orch_logger_->info(std::string("[DEBUG] Visiting stage='")+st->name()+"'");
         }
         if(std::strcmp(st->name(), "spatial")==0){
             // Replace stage application with direct call so we can sample metrics
-            bool applySpatial = (staticSpatialEnabled || ctx.adaptive.spatialActive);
+            bool applySpatial = lane.spatialApply;
             // Only sample if metrics enabled and spatial actually applied
-            spatialResultCaptured = applySpatialFilter(ctx.height, (int)ctx.width, (int)ctx.heightPx,
-                                                       altKernel, applySpatial, ctx.adaptive.strongActive,
-                                                       metricsEnabled_, sampleCount>0? sampleCount:512);
+            lane.out.spatial = applySpatialFilter(lane, ctx.height, (int)ctx.width, (int)ctx.heightPx,
+                                              altKernel, applySpatial, ctx.adaptive.strongActive,
+                                              metricsEnabled_, lane.spatialSamples);
             if(applySpatial) ctx.spatialApplied = true;
-            spatialResultValid = spatialResultCaptured.applied;
+            lane.out.spatialValid = lane.out.spatial.applied;
             if(orch_logger_ && envFlag("CALDERA_DEBUG_PLANES", false)){
-                orch_logger_->info("[DEBUG-SPATIAL] applySpatial={} sampled={} preVar={:.6f} postVar={:.6f} preEdge={:.6f} postEdge={:.6f} altKernel='{}' sampleCount={} strong={}", applySpatial, spatialResultCaptured.sampled, spatialResultCaptured.preVar, spatialResultCaptured.postVar, spatialResultCaptured.preEdge, spatialResultCaptured.postEdge, altKernel, (sampleCount>0? sampleCount:512), ctx.adaptive.strongActive);
+                const SpatialApplyResult& r = lane.out.spatial;
+                orch_logger_->info("[DEBUG-SPATIAL] applySpatial={} sampled={} preVar={:.6f} postVar={:.6f} preEdge={:.6f} postEdge={:.6f} altKernel='{}' sampleCount={} strong={}", applySpatial, r.sampled, r.preVar, r.postVar, r.preEdge, r.postEdge, altKernel, lane.spatialSamples, ctx.adaptive.strongActive);
             }
             continue; // skip original lambda
         }
@@ -287,55 +660,145 @@ void ProcessingManager::processRawDepthFrame(const RawDepthFrame& raw) {
 
     // After spatial stage we may want adaptive temporal blending similar to old path
     bool adaptiveTemporalApplied=false;
-    if(adaptiveTemporalScale_>1.0f && frameCounter_>0 && metricsEnabled_){
-        float stab=lastStabilityMetrics_.stabilityRatio; float varP=lastStabilityMetrics_.avgVariance;
-        bool unstable=(stab<adaptiveStabilityMin_) || (varP>adaptiveVarianceMax_);
-        if(unstable && prevFilteredValid_ && prevFilteredHeight_.size()==heightMap.size()){
-            float alpha=1.0f/ adaptiveTemporalScale_;
-            for(size_t i=0;i<heightMap.size();++i){ float prev=prevFilteredHeight_[i]; float cur=heightMap[i]; if(std::isfinite(prev)&&std::isfinite(cur)){ float blended=alpha*cur + (1.f-alpha)*prev; heightMap[i]=blended; }}
-            adaptiveTemporalApplied=true;
+    if(lane.blendUnstable && lane.prevFilteredValid && lane.prevFiltered.size()==heightMap.size()){
+        float alpha=1.0f/ adaptiveTemporalScale_;
+        for(size_t i=0;i<heightMap.size();++i){ float prev=lane.prevFiltered[i]; float cur=heightMap[i]; if(std::isfinite(prev)&&std::isfinite(cur)){ float blended=alpha*cur + (1.f-alpha)*prev; heightMap[i]=blended; }}
+        adaptiveTemporalApplied=true;
+    }
+    if(adaptiveTemporalScale_>1.0f){ lane.prevFiltered=heightMap; lane.prevFilteredValid=true; }
+
+    lane.out.timestampNs = raw.timestamp_ns;
+    lane.out.width = ctx.width;
+    lane.out.heightPx = ctx.heightPx;
+    lane.out.temporalBlendApplied = adaptiveTemporalApplied;
+    ++lane.frames;
+}
+
+void ProcessingManager::arriveAndFuse(SensorLane& lane, size_t expected){
+    std::unique_lock<std::mutex> lk(fuseMutex_);
+    lane.ready = true;
+    ++readyLanes_;
+    roundExpected_ = std::max(roundExpected_, expected);
+    // Whoever completes the quorum fuses every ready lane; the others wait until their layer has been
+    // consumed. If the quorum is not met in time the waiter fuses what is there and late sensors join
+    // the next round. Frame-set members are already captured and always arrive, so a fixed quorum
+    // is waited for without timeout.
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(barrierTimeoutMs_);
+    while(lane.ready){
+        if(fusionQuorumReached()){ fuseReadyLanes(); break; }
+        if(roundExpected_ > 0){ barrierCv_.wait(lk); continue; }
+        if(barrierCv_.wait_until(lk, deadline) == std::cv_status::timeout){
+            if(lane.ready){ ++barrierTimeouts_; fuseReadyLanes(); }
+            break;
         }
     }
+}
 
-    // Prepare cloud for fusion using (possibly) modified heightMap
-    InternalPointCloud& cloudFiltered = reusableCloudFiltered_;
-    cloudFiltered = cloudIn; // copy structure (points vector reused capacity internally)
-    for(size_t i=0;i<heightMap.size();++i){ float v=heightMap[i]; cloudFiltered.points[i].z=v; cloudFiltered.points[i].valid=std::isfinite(v); }
+bool ProcessingManager::fusionQuorumReached() const {
+    if(roundExpected_ > 0) return readyLanes_ >= roundExpected_;
+    // Sensors still inside the dropout window are expected; stale ones are not waited for.
+    for(const auto& lane : lanes_){
+        if(!lane->ready && fusion_.isExpected(lane->id, frameCounter_)) return false;
+    }
+    return true;
+}
+
+void ProcessingManager::fuseReadyLanes(){
+    // Ready lanes in registration order; the first defines the grid.
+    auto& layers = fusionLayers_;
+    layers.clear();
+    for(const auto& lp : lanes_){
+        if(lp->ready) layers.push_back(FusionLayer{ &lp->id, &lp->out, &lp->height, &lp->validity });
+    }
+    std::shared_ptr<WorldFrame> frame = fuseLayers(layers);
+    if(!frame) return;
+    for(auto& lp : lanes_) lp->ready = false;
+    readyLanes_ = 0;
+    roundExpected_ = 0;
+    publishFrame(std::move(frame));
+    barrierCv_.notify_all();
+}
+
+std::shared_ptr<ProcessingManager::WorldFrame> ProcessingManager::fuseLayers(const std::vector<FusionLayer>& layers){
+    // Aggregate the lane results; the first layer defines the grid.
+    if(layers.empty()) return nullptr;
+    const LaneResult& first = *layers.front().result;
+    uint64_t timestampNs = 0;
+    lastValidationSummary_ = {};
+    auto tBuildStart = std::chrono::steady_clock::time_point::max();
+    auto tBuildEnd = std::chrono::steady_clock::time_point::min();
+    SpatialApplyResult spatialForMetrics; bool spatialFound=false;
+    bool adaptiveTemporalApplied=false;
+    for(const FusionLayer& layer : layers){
+        const LaneResult& l = *layer.result;
+        timestampNs = std::max(timestampNs, l.timestampNs);
+        lastValidationSummary_.valid += l.summary.valid;
+        lastValidationSummary_.invalid += l.summary.invalid;
+        tBuildStart = std::min(tBuildStart, l.tBuildStart);
+        tBuildEnd = std::max(tBuildEnd, l.tBuildEnd);
+        if(!spatialFound && metricsEnabled_ && l.spatialValid){ spatialForMetrics = l.spatial; spatialFound = true; }
+        adaptiveTemporalApplied = adaptiveTemporalApplied || l.temporalBlendApplied;
+    }
+    const uint32_t frameW = first.width, frameH = first.heightPx;
+
+    // Fusion reads the filtered height buffers directly (NaN preserved so downstream confidence treats it as invalid).
     auto tFuseStart = std::chrono::steady_clock::now();
-    fusion_.beginFrame(frameCounter_, cloudFiltered.width, cloudFiltered.height);
-    size_t pixelCount = cloudFiltered.points.size();
-    if(layerHeightsBuffer_.size()!=pixelCount) layerHeightsBuffer_.resize(pixelCount);
-    if(confidenceEnabled_ && layerConfidenceBuffer_.size()!=pixelCount) layerConfidenceBuffer_.resize(pixelCount,0.0f);
-    std::vector<float>& layerHeights = layerHeightsBuffer_;
-    std::vector<float> layerConfidenceTmp; // alias variable not used if disabled
-    std::vector<float>& layerConfidence = confidenceEnabled_? layerConfidenceBuffer_ : layerConfidenceTmp;
-    for(size_t i=0;i<pixelCount;++i){
-        float z=cloudFiltered.points[i].z; // preserve NaN (invalid) so downstream confidence treats as invalid
-        layerHeights[i]=z;
-        if(confidenceEnabled_) layerConfidence[i]=(i<confidenceMap_.size()? confidenceMap_[i]:0.0f);
-    }
-    const float* confPtr = confidenceEnabled_? layerConfidence.data(): nullptr;
-    fusion_.addLayer(FusionInputLayer{ raw.sensorId, layerHeights.data(), confPtr, cloudFiltered.width, cloudFiltered.height });
-    if(duplicateFusionLayer_){
-        std::vector<float> dupH(pixelCount); std::vector<float> dupC; if(confidenceEnabled_) dupC.resize(pixelCount, duplicateFusionDupConf_);
-        for(size_t i=0;i<pixelCount;++i){ float v=layerHeights[i]; if(std::isfinite(v)) v+=duplicateFusionShift_; dupH[i]=v; }
-        const float* dupConf = confidenceEnabled_? dupC.data(): nullptr;
-        fusion_.addLayer(FusionInputLayer{ raw.sensorId+"_dup", dupH.data(), dupConf, cloudFiltered.width, cloudFiltered.height });
-    }
-    if(fusedHeightsBuffer_.size()!=pixelCount) fusedHeightsBuffer_.assign(pixelCount, 0.0f);
-    if(confidenceEnabled_ && exportConfidence_ && fusedConfidenceBuffer_.size()!=pixelCount) fusedConfidenceBuffer_.assign(pixelCount, 0.0f);
-    std::vector<float>& fusedHeights = fusedHeightsBuffer_;
-    std::vector<float>* fusedConfOut = (confidenceEnabled_ && exportConfidence_) ? &fusedConfidenceBuffer_ : nullptr;
-    fusion_.fuse(fusedHeights, fusedConfOut);
-    // Normalize any NaN fused values to zero for external consumers (tests expect zero-filled invalids)
-    for(float& v: fusedHeights){ if(!std::isfinite(v)) v=0.0f; }
+    fusion_.beginFrame(frameCounter_, (int)frameW, (int)frameH);
+    for(const FusionLayer& layer : layers){
+        const LaneResult& l = *layer.result;
+        const std::vector<float>& height = *layer.height;
+        size_t pixelCount = height.size();
+        // Each layer is weighted by its own lane: valid fraction, sampled spatial variance ratio and
+        // temporal blend, on the pixels the lane kept. Without a validation count there is no
+        // confidence (nullptr: min-z); a lone layer is copied as is, so it needs none either.
+        // addLayer copies, so one buffer serves every layer.
+        const float* confPtr = nullptr;
+        const size_t checked = l.summary.valid + l.summary.invalid;
+        if(confidenceEnabled_ && checked>0 && (layers.size()>1 || duplicateFusionLayer_)){
+            const float S = static_cast<float>(l.summary.valid)/checked;
+            const SpatialApplyResult& sp = l.spatial;
+            const float R = (l.spatialValid && sp.sampled && sp.preVar>0.f && sp.postVar>0.f)? sp.postVar/sp.preVar : 0.f;
+            const float c = blendConfidence(S, R, l.temporalBlendApplied?1.f:0.f, confWeightS_, confWeightR_, confWeightT_);
+            const std::vector<uint8_t>& validity = *layer.validity;
+            const bool masked = validity.size()==pixelCount;
+            layerConfidenceBuffer_.resize(pixelCount);
+            for(size_t i=0;i<pixelCount;++i) layerConfidenceBuffer_[i] = (std::isfinite(height[i]) && (!masked || validity[i]))? c : 0.0f;
+            confPtr = layerConfidenceBuffer_.data();
+        }
+        fusion_.addLayer(FusionInputLayer{ *layer.id, height.data(), confPtr, (int)l.width, (int)l.heightPx });
+        if(duplicateFusionLayer_){
+            std::vector<float> dupH(pixelCount); std::vector<float> dupC; if(confidenceEnabled_) dupC.resize(pixelCount, duplicateFusionDupConf_);
+            for(size_t i=0;i<pixelCount;++i){ float v=height[i]; if(std::isfinite(v)) v+=duplicateFusionShift_; dupH[i]=v; }
+            const float* dupConf = confidenceEnabled_? dupC.data(): nullptr;
+            fusion_.addLayer(FusionInputLayer{ *layer.id+"_dup", dupH.data(), dupConf, (int)l.width, (int)l.heightPx });
+        }
+    }
+    // Fuse straight into the output: the direct sink's writable slot (e.g. SHM back buffer) when one is
+    // attached, otherwise a pooled WorldFrame payload. NaN->0 normalization for external consumers
+    // (tests expect zero-filled invalids) is folded into that single write.
+    const size_t pixelCount = (size_t)frameW*(size_t)frameH;
+    std::shared_ptr<WorldFrame> framePtr = framePool_.acquire(pixelCount);
+    WorldFrame& frame = *framePtr;
+    frame.timestamp_ns=timestampNs; frame.frame_id=frameCounter_; frame.heightMap.width=(int)frameW; frame.heightMap.height=(int)frameH;
+    const size_t fusedCount = fusion_.fusedPixelCount();
+    const float* fusedData = nullptr;
+    common::WorldFrameSlot slot = directSink_ ? directSink_->acquireWritableSlot(frameW, frameH) : common::WorldFrameSlot{};
+    if(slot && fusedCount<=slot.capacity){
+        fusion_.fuseInto(slot.data, slot.capacity, true);
+        directSink_->commitWritableSlot(slot, common::WorldFrameSlotMeta{frame.frame_id, frame.timestamp_ns, frameW, frameH, (uint32_t)fusedCount, 0});
+        fusedData = slot.data; // committed buffer stays readable until the sink hands it out again
+        if(callback_ || handleCallback_) frame.heightMap.data.assign(fusedData, fusedData+fusedCount); // observers only
+    } else {
+        if(slot) directSink_->abandonWritableSlot(slot);
+        frame.heightMap.data.resize(fusedCount);
+        fusion_.fuseInto(frame.heightMap.data.data(), fusedCount, true);
+        fusedData = frame.heightMap.data.data();
+    }
     auto tFuseEnd = std::chrono::steady_clock::now();
-    WorldFrame frame; frame.timestamp_ns=raw.timestamp_ns; frame.frame_id=frameCounter_; frame.heightMap.width=cloudFiltered.width; frame.heightMap.height=cloudFiltered.height; frame.heightMap.data = fusedHeights;
     auto tFrameEnd = std::chrono::steady_clock::now();
 
-    SpatialApplyResult spatialForMetrics = (metricsEnabled_ && spatialResultValid)? spatialResultCaptured : SpatialApplyResult{};
     if(metricsEnabled_){
-        updateMetrics(frame.heightMap.data, frame.heightMap.width, frame.heightMap.height,
+        updateMetrics(fusedData, fusedCount, *layers.front().validity, frame.heightMap.width, frame.heightMap.height,
                       tBuildStart, tBuildEnd, tFuseStart, tFuseEnd, tFrameEnd,
                       spatialForMetrics, adaptiveTemporalApplied);
     } else {
@@ -348,102 +811,98 @@ void ProcessingManager::processRawDepthFrame(const RawDepthFrame& raw) {
             lastStabilityMetrics_.height = frame.heightMap.height;
         }
     }
-    if(adaptiveTemporalScale_>1.0f){ prevFilteredHeight_=heightMap; prevFilteredValid_=true; }
+    // Adaptive spatial gating for the next frame (hysteresis on this frame's metrics).
+    if(adaptiveMode_==2 && metricsEnabled_){
+        float stab=lastStabilityMetrics_.stabilityRatio; float varP=lastStabilityMetrics_.avgVariance;
+        bool unstable=(stab<adaptiveStabilityMin_) || (varP>adaptiveVarianceMax_);
+        if(unstable){ ++unstableStreak_; stableStreak_=0; } else { ++stableStreak_; unstableStreak_=0; }
+        if(!adaptiveSpatialActive_ && unstableStreak_ >= (uint32_t)adaptiveOnStreak_) adaptiveSpatialActive_=true;
+        if(adaptiveSpatialActive_ && stableStreak_ >= (uint32_t)adaptiveOffStreak_) adaptiveSpatialActive_=false;
+        adaptiveStrongActive_ = adaptiveSpatialActive_ && (varP > adaptiveStrongVarMult_ * adaptiveVarianceMax_ || stab < adaptiveStrongStabFrac_);
+        adaptiveState_.spatialActive = adaptiveSpatialActive_;
+        adaptiveState_.strongActive = adaptiveStrongActive_;
+    }
     ++frameCounter_;
-    if(callback_) callback_(frame);
+    return framePtr;
 }
 
-void ProcessingManager::applyTemporalFilter(std::vector<float>& heightMap, int w, int h){
-    if(height_filter_) height_filter_->apply(heightMap,w,h);
+void ProcessingManager::publishFrame(std::shared_ptr<WorldFrame> frame){
+    if(callback_) callback_(*frame);
+    if(handleCallback_) handleCallback_(WorldFrameHandle(std::move(frame)));
 }
 
-ProcessingManager::SpatialApplyResult ProcessingManager::applySpatialFilter(std::vector<float>& heightMap,
-                                                                           int w, int h,
-                                                                           const std::string& altKernel,
-                                                                           bool applySpatial,
-                                                                           bool strongPass,
-                                                                           bool metricsEnabled,
-                                                                           int sampleCount){
-    SpatialApplyResult res;
-    if(!applySpatial) return res;
-    res.applied = true;
-
-    // Lazy singletons for filter implementations
-    struct Kernels {
-        std::unique_ptr<SpatialFilter> classic;
-        std::unique_ptr<FastGaussianBlur> fast;
-    };
-    static Kernels k;
-    auto& classic = [&]() -> SpatialFilter& {
-        if(!k.classic) k.classic = std::make_unique<SpatialFilter>(true);
-        return *k.classic;
-    }();
-    auto getFast = [&]() -> FastGaussianBlur& {
-        if(!k.fast){
-            float sigma = 1.5f;
-            if(const char* e=std::getenv("CALDERA_FASTGAUSS_SIGMA")){
-                try { float v = std::stof(e); if(v>0.1f && v<20.f) sigma=v; } catch(...){}
-            }
-            k.fast = std::make_unique<FastGaussianBlur>(sigma);
-        }
-        return *k.fast;
-    };
-
-    // Pre-sample subset for variance/edge metrics
-    std::vector<size_t> sampleIdx;
-    if(metricsEnabled && sampleCount>0 && static_cast<int>(heightMap.size())>sampleCount){
-        sampleIdx.reserve(sampleCount);
-        size_t step = heightMap.size()/static_cast<size_t>(sampleCount);
-        if(step==0) step=1;
-        size_t seed = (frameCounter_*1664525u + 1013904223u) % heightMap.size();
-        size_t idx = seed % step;
-        for(int i=0; i<sampleCount && idx<heightMap.size(); ++i, idx+=step) sampleIdx.push_back(idx);
-        if(!sampleIdx.empty()){
-            double sum=0, sumSq=0; int n=0; double edge=0; int edgeN=0; int W=w, H=h;
-            for(size_t si: sampleIdx){ float v=heightMap[si]; if(std::isfinite(v)){ sum+=v; sumSq+=double(v)*v; ++n; }}
-            if(n>1) res.preVar = static_cast<float>((sumSq - (sum*sum)/n)/(n-1));
-            for(size_t si: sampleIdx){ int y=int(si/W); int x=int(si%W); float c=heightMap[si]; if(!std::isfinite(c)) continue; float gx=0, gy=0; if(x+1<W){ float r=heightMap[si+1]; if(std::isfinite(r)) gx=r-c; } if(y+1<H){ float d=heightMap[si+W]; if(std::isfinite(d)) gy=d-c; } edge += std::fabs(gx)+std::fabs(gy); ++edgeN; }
-            if(edgeN>0) res.preEdge = static_cast<float>(edge/edgeN);
-            res.sampled = true;
-        }
+void ProcessingManager::applyTemporalFilter(SensorLane& lane, std::vector<float>& heightMap, int w, int h){
+    if(!lane.temporal) return;
+    if(lane.temporal.get() == lane.temporalSource){
+        // The injected instance itself (first lane, or a non-clonable filter shared by several lanes).
+        std::lock_guard<std::mutex> lk(temporalMutex_);
+        lane.temporal->apply(heightMap,w,h);
+    } else {
+        lane.temporal->apply(heightMap,w,h);
     }
+}
 
-    auto applyClassic = [&](){ classic.apply(heightMap,w,h); };
-    auto applyFast    = [&](){ auto& f = getFast(); f.apply(heightMap,w,h); };
-
+int ProcessingManager::spatialPasses(const SensorLane& lane, const std::string& altKernel, bool strongPass, SpatialKernel passes[2]) const {
+    int n=0;
+    const std::string& sk = lane.adaptive.strongKernelChoice;
     if(altKernel=="fastgauss"){
-        applyFast();
+        passes[n++]=SpatialKernel::Fast;
         if(strongPass){
-            const std::string& sk = adaptiveState_.strongKernelChoice;
             if(sk=="classic_double" || sk=="fastgauss"){
-                if(adaptiveStrongDoublePass_) applyFast();
+                if(adaptiveStrongDoublePass_) passes[n++]=SpatialKernel::Fast;
             } else if(sk=="wide5") {
-                applyClassic();
+                passes[n++]=SpatialKernel::Classic;
             }
         }
     } else {
-        applyClassic();
+        passes[n++]=SpatialKernel::Classic;
         if(strongPass){
-            const std::string& sk = adaptiveState_.strongKernelChoice;
             if(sk=="classic_double"){
-                if(adaptiveStrongDoublePass_) applyClassic();
+                if(adaptiveStrongDoublePass_) passes[n++]=SpatialKernel::Classic;
             } else if(sk=="wide5") {
-                if(altKernel!="wide5" && adaptiveStrongDoublePass_) applyClassic();
+                if(altKernel!="wide5" && adaptiveStrongDoublePass_) passes[n++]=SpatialKernel::Classic;
             } else if(sk=="fastgauss") {
-                applyFast();
+                passes[n++]=SpatialKernel::Fast;
             }
         }
     }
+    return n;
+}
 
-    res.strong = strongPass;
-    if(res.sampled){
-        double sum=0, sumSq=0; int n=0; double edge=0; int edgeN=0; int W=w, H=h;
-        for(size_t si: sampleIdx){ float v=heightMap[si]; if(std::isfinite(v)){ sum+=v; sumSq+=double(v)*v; ++n; }}
-        if(n>1) res.postVar = static_cast<float>((sumSq - (sum*sum)/n)/(n-1));
-        for(size_t si: sampleIdx){ int y=int(si/W); int x=int(si%W); float c=heightMap[si]; if(!std::isfinite(c)) continue; float gx=0, gy=0; if(x+1<W){ float r=heightMap[si+1]; if(std::isfinite(r)) gx=r-c; } if(y+1<H){ float d=heightMap[si+W]; if(std::isfinite(d)) gy=d-c; } edge += std::fabs(gx)+std::fabs(gy); ++edgeN; }
-        if(edgeN>0) res.postEdge = static_cast<float>(edge/edgeN);
+ProcessingManager::SpatialApplyResult ProcessingManager::applySpatialFilter(SensorLane& lane,
+                                                                           std::vector<float>& heightMap,
+                                                                           int w, int h,
+                                                                           const std::string& altKernel,
+                                                                           bool applySpatial,
+                                                                           bool strongPass,
+                                                                           bool metricsEnabled,
+                                                                           int sampleCount){
+    SpatialApplyResult res;
+    if(!applySpatial) return res;
+    res.applied = true;
+
+    // Lazily created per lane: the kernels keep scratch buffers, so sensors must not share them.
+    if(!lane.classic) lane.classic = std::make_unique<SpatialFilter>(true);
+    if(!lane.fast) lane.fast = makeFastGauss(0);
+
+    // Pre-sample subset for variance/edge metrics
+    std::vector<size_t>& sampleIdx = lane.spatialSampleIdx;
+    spatialSampleIndices(lane.frameId, metricsEnabled ? heightMap.size() : 0, sampleCount, sampleIdx);
+    if(!sampleIdx.empty()){
+        spatialSampleStats(heightMap.data(), w, h, sampleIdx, lane.spatialSampleVals, res.preVar, res.preEdge);
+        res.sampled = true;
     }
 
+    SpatialKernel passes[2];
+    const int passCount = spatialPasses(lane, altKernel, strongPass, passes);
+    for(int p=0;p<passCount;++p){
+        if(passes[p]==SpatialKernel::Fast) lane.fast->apply(heightMap,w,h);
+        else lane.classic->apply(heightMap,w,h);
+    }
+
+    res.strong = strongPass;
+    if(res.sampled) spatialSampleStats(heightMap.data(), w, h, sampleIdx, lane.spatialSampleVals, res.postVar, res.postEdge);
+
     return res;
 }
 
@@ -457,31 +916,189 @@ void ProcessingManager::parsePipelineEnv(){
 
 void ProcessingManager::rebuildPipelineStages(){
     stages_.clear();
+    correctionStage_ = false;
     if(!pipelineSpecValid_ || parsedPipelineSpecs_.empty()) return;
     stages_.reserve(parsedPipelineSpecs_.size());
 
+    bool rasterized = false; // later stages see the world grid instead of sensor pixels
     for(const auto& spec: parsedPipelineSpecs_){
         if(spec.name=="build"){
             // Build + validate stage
-            stages_.push_back(std::make_unique<LambdaStage>("build", [this](FrameContext& ctx){
+            // Whole frames: the build runs before the stage loop. Row bands (tiled execution, build
+            // first): buffers and tables are prepared once, then each band builds its pixels.
+            BandLambdaStage::BandOps ops;
+            ops.halo = [](const FrameContext& ctx){ return ctx.rawDepthFrame && ctx.sensorLane ? 0 : -1; };
+            ops.begin = [this](FrameContext& ctx, const StageBandIO&){
+                auto* lane = static_cast<SensorLane*>(ctx.sensorLane);
+                prepareBuild(*lane, *static_cast<const RawDepthFrame*>(ctx.rawDepthFrame));
+                lane->bandValid.store(0, std::memory_order_relaxed);
+                lane->bandInvalid.store(0, std::memory_order_relaxed);
+            };
+            ops.band = [this](FrameContext& ctx, uint32_t y0, uint32_t y1, const StageBandIO&, int){
+                auto* lane = static_cast<SensorLane*>(ctx.sensorLane);
+                FrameValidationSummary part;
+                buildPixels(*lane, *static_cast<const RawDepthFrame*>(ctx.rawDepthFrame), (size_t)y0*ctx.width, (size_t)y1*ctx.width, part);
+                lane->bandValid.fetch_add(part.valid, std::memory_order_relaxed);
+                lane->bandInvalid.fetch_add(part.invalid, std::memory_order_relaxed);
+            };
+            ops.end = [](FrameContext& ctx, const StageBandIO&){
+                auto* lane = static_cast<SensorLane*>(ctx.sensorLane);
+                lane->out.summary.valid += lane->bandValid.load(std::memory_order_relaxed);
+                lane->out.summary.invalid += lane->bandInvalid.load(std::memory_order_relaxed);
+            };
+            stages_.push_back(std::make_unique<BandLambdaStage>("build", [](FrameContext& ctx){
                 auto* rawPtr = static_cast<const RawDepthFrame*>(ctx.rawDepthFrame);
                 if(!rawPtr) return;
                 // Build internal cloud + height map already occurs prior to stage loop in migration step (will move here later)
                 (void)ctx; (void)rawPtr; // placeholder for future relocation
-            }));
+            }, std::move(ops)));
+        } else if(spec.name=="correct"){
+            // Per-pixel depth correction is folded into the build pass (buildHeightAndValidity), so the
+            // stage only switches it on; its position in the spec does not matter.
+            correctionStage_ = true;
+            BandLambdaStage::BandOps ops;
+            ops.halo = [](const FrameContext&){ return 0; };
+            ops.band = [](FrameContext&, uint32_t, uint32_t, const StageBandIO&, int){};
+            stages_.push_back(std::make_unique<BandLambdaStage>("correct", [](FrameContext&){}, std::move(ops)));
         } else if(spec.name=="temporal"){
             if(height_filter_){
-                stages_.push_back(std::make_unique<LambdaStage>("temporal", [this](FrameContext& ctx){
-                    height_filter_->apply(ctx.height, static_cast<int>(ctx.width), static_cast<int>(ctx.heightPx));
-                }));
+                // Row bands only for filters that support them (pointwise in space); the caller holds
+                // temporalMutex_ around the banded run when the lane uses the shared instance.
+                BandLambdaStage::BandOps ops;
+                ops.halo = [](const FrameContext& ctx){
+                    auto* lane = static_cast<SensorLane*>(ctx.sensorLane);
+                    return lane && lane->temporal && lane->temporal->supportsRows() ? 0 : -1;
+                };
+                ops.begin = [](FrameContext& ctx, const StageBandIO&){
+                    static_cast<SensorLane*>(ctx.sensorLane)->temporal->beginRows(static_cast<int>(ctx.width), static_cast<int>(ctx.heightPx));
+                };
+                ops.band = [](FrameContext& ctx, uint32_t y0, uint32_t y1, const StageBandIO& io, int){
+                    static_cast<SensorLane*>(ctx.sensorLane)->temporal->applyRows(io.dst, static_cast<int>(ctx.width), static_cast<int>(y0), static_cast<int>(y1));
+                };
+                ops.end = [](FrameContext& ctx, const StageBandIO&){ static_cast<SensorLane*>(ctx.sensorLane)->temporal->endRows(); };
+                stages_.push_back(std::make_unique<BandLambdaStage>("temporal", [this](FrameContext& ctx){
+                    if(auto* lane = static_cast<SensorLane*>(ctx.sensorLane))
+                        applyTemporalFilter(*lane, ctx.height, static_cast<int>(ctx.width), static_cast<int>(ctx.heightPx));
+                }, std::move(ops)));
             }
         } else if(spec.name=="spatial"){
             std::string alt; auto it=spec.params.find("kernel"); if(it!=spec.params.end()) alt=it->second;
-            stages_.push_back(std::make_unique<LambdaStage>("spatial", [this, alt](FrameContext& ctx){
+            // Row bands follow the frame's spatial decision (runLane), like the stage loop's spatial
+            // intercept. Each band is filtered with its halo rows by slot-private kernels, so rows
+            // away from the frame edge see the same neighbourhood as in a whole-frame pass.
+            BandLambdaStage::BandOps ops;
+            ops.halo = [](const FrameContext& ctx){
+                auto* lane = static_cast<SensorLane*>(ctx.sensorLane);
+                if(!lane) return -1;
+                if(!lane->spatialApply) return 0;
+                if(!lane->classic) lane->classic = std::make_unique<SpatialFilter>(true);
+                if(!lane->fast) lane->fast = makeFastGauss(0);
+                int halo = 0;
+                for(int p=0;p<lane->spatialPassCount;++p)
+                    halo += lane->spatialKernels[p]==SpatialKernel::Fast ? lane->fast->rowHalo() : lane->classic->radius();
+                lane->spatialHalo = halo;
+                return halo;
+            };
+            ops.begin = [this](FrameContext& ctx, const StageBandIO& io){
+                auto* lane = static_cast<SensorLane*>(ctx.sensorLane);
+                lane->out.spatial = {};
+                if(!lane->spatialApply) return;
+                lane->out.spatial.applied = true;
+                lane->out.spatial.strong = lane->spatialStrong;
+                if(lane->spatialTiles.size() < static_cast<size_t>(io.slots)) lane->spatialTiles.resize(io.slots);
+                for(int i=0;i<io.slots;++i){
+                    auto& tile = lane->spatialTiles[i];
+                    if(!tile.classic) tile.classic = std::make_unique<SpatialFilter>(true);
+                    if(!tile.fast) tile.fast = makeFastGauss(1);
+                }
+                // io.src is not built for this frame yet: bands gather their pre-filter samples.
+                const size_t pixels = (size_t)ctx.width*ctx.heightPx;
+                spatialSampleIndices(lane->frameId, metricsEnabled_ ? pixels : 0, lane->spatialSamples, lane->spatialSampleIdx);
+                lane->spatialSampleVals.resize(lane->spatialSampleIdx.size()*3);
+                lane->out.spatial.sampled = !lane->spatialSampleIdx.empty();
+            };
+            ops.band = [](FrameContext& ctx, uint32_t y0, uint32_t y1, const StageBandIO& io, int slot){
+                auto* lane = static_cast<SensorLane*>(ctx.sensorLane);
+                if(!lane->spatialApply) return;
+                const size_t w = ctx.width;
+                const uint32_t t0 = y0 > (uint32_t)lane->spatialHalo ? y0 - lane->spatialHalo : 0;
+                const uint32_t t1 = std::min<uint32_t>(ctx.heightPx, y1 + lane->spatialHalo);
+                auto& tile = lane->spatialTiles[slot];
+                // Row y1 (down neighbours) is inside the halo, so io.src already holds it.
+                if(lane->out.spatial.sampled)
+                    spatialSampleGather(io.src, (int)w, (int)ctx.heightPx, lane->spatialSampleIdx, y0*w, y1*w, lane->spatialSampleVals.data());
+                tile.rows.assign(io.src + t0*w, io.src + t1*w);
+                for(int p=0;p<lane->spatialPassCount;++p){
+                    if(lane->spatialKernels[p]==SpatialKernel::Fast) tile.fast->apply(tile.rows, (int)w, (int)(t1-t0));
+                    else tile.classic->apply(tile.rows, (int)w, (int)(t1-t0));
+                }
+                std::copy(tile.rows.begin() + (y0-t0)*w, tile.rows.begin() + (y1-t0)*w, io.dst + y0*w);
+            };
+            ops.end = [](FrameContext& ctx, const StageBandIO& io){
+                auto* lane = static_cast<SensorLane*>(ctx.sensorLane);
+                if(lane->out.spatial.sampled){
+                    SpatialApplyResult& r = lane->out.spatial;
+                    spatialGatheredStats(lane->spatialSampleVals.data(), lane->spatialSampleIdx.size(), r.preVar, r.preEdge);
+                    spatialSampleStats(io.dst, (int)ctx.width, (int)ctx.heightPx, lane->spatialSampleIdx, lane->spatialSampleVals, r.postVar, r.postEdge);
+                }
+                lane->out.spatialValid = lane->out.spatial.applied;
+                if(lane->spatialApply) ctx.spatialApplied = true;
+            };
+            stages_.push_back(std::make_unique<BandLambdaStage>("spatial", [this, alt](FrameContext& ctx){
                 // Use existing helper (strong adaptive gating handled in manager prior to stage execution for now)
+                auto* lane = static_cast<SensorLane*>(ctx.sensorLane);
+                if(!lane) return;
                 bool strong = ctx.adaptive.strongActive;
-                applySpatialFilter(ctx.height, static_cast<int>(ctx.width), static_cast<int>(ctx.heightPx), alt, ctx.adaptive.spatialActive, strong, true, 512);
+                applySpatialFilter(*lane, ctx.height, static_cast<int>(ctx.width), static_cast<int>(ctx.heightPx), alt, ctx.adaptive.spatialActive, strong, true, 512);
                 ctx.spatialApplied = true;
+            }, std::move(ops)));
+        } else if(spec.name=="undistort"){
+            // Lens undistortion of the lane's heights through a fixed-point remap table built once per
+            // calibration; no-op without intrinsics + distortion coefficients (TransformParameters).
+            // The table is in sensor pixels, so it cannot follow rasterize.
+            if(rasterized){
+                if(orch_logger_) orch_logger_->warn("Pipeline stage 'undistort' after 'rasterize' ignored (needs sensor pixels)");
+                continue;
+            }
+            stages_.push_back(std::make_unique<LambdaStage>("undistort", [](FrameContext& ctx){
+                auto* lane = static_cast<SensorLane*>(ctx.sensorLane);
+                if(!lane || !UndistortionRemap::hasDistortion(ctx.transform)) return;
+                if(!lane->undistort) lane->undistort = std::make_unique<UndistortionRemap>();
+                UndistortionRemap& u = *lane->undistort;
+                u.ensure(ctx.width, ctx.heightPx, ctx.transform);
+                if(!u.matches(ctx.width, ctx.heightPx) || ctx.height.size() != (size_t)ctx.width*ctx.heightPx) return;
+                lane->undistortOut.resize(ctx.height.size());
+                u.apply(ctx.height.data(), lane->undistortOut.data());
+                ctx.height.swap(lane->undistortOut);
+                ctx.validityMask.resize(ctx.height.size());
+                for(size_t i=0;i<ctx.height.size();++i) ctx.validityMask[i] = std::isfinite(ctx.height[i]) ? 1 : 0;
+            }));
+        } else if(spec.name=="rasterize"){
+            rasterized = true;
+            // Scatter the lane's heights into the shared world grid (ProcessingConfig), so sensors
+            // covering different parts of the table fuse pixel-aligned. Later stages see the grid.
+            WorldGridRasterizer::Mode mode = WorldGridRasterizer::Mode::MinZ;
+            auto it=spec.params.find("mode");
+            if(it!=spec.params.end() && !WorldGridRasterizer::parseMode(it->second, mode) && orch_logger_)
+                orch_logger_->warn("Unknown rasterize mode '{}', using min", it->second);
+            stages_.push_back(std::make_unique<LambdaStage>("rasterize", [mode](FrameContext& ctx){
+                auto* lane = static_cast<SensorLane*>(ctx.sensorLane);
+                if(!lane) return;
+                WorldGridRasterizer::Config cfg = lane->rasterConfig;
+                cfg.mode = mode;
+                const WorldGridRasterizer::Config* cur = lane->raster ? &lane->raster->config() : nullptr;
+                if(!cur || cur->gridWidth!=cfg.gridWidth || cur->gridHeight!=cfg.gridHeight || cur->resolution!=cfg.resolution
+                   || cur->originX!=cfg.originX || cur->originY!=cfg.originY || cur->mode!=cfg.mode){
+                    lane->raster = std::make_unique<WorldGridRasterizer>(cfg);
+                }
+                WorldGridRasterizer& r = *lane->raster;
+                lane->rasterOut.resize(r.cellCount());
+                r.rasterize(ctx.height.data(), static_cast<int>(ctx.width), static_cast<int>(ctx.heightPx), ctx.transform, lane->rasterOut.data());
+                ctx.height.swap(lane->rasterOut);
+                ctx.validityMask.resize(ctx.height.size());
+                for(size_t i=0;i<ctx.height.size();++i) ctx.validityMask[i] = std::isfinite(ctx.height[i]) ? 1 : 0;
+                ctx.width = static_cast<uint32_t>(r.config().gridWidth);
+                ctx.heightPx = static_cast<uint32_t>(r.config().gridHeight);
             }));
         } else if(spec.name=="fusion"){
             stages_.push_back(std::make_unique<LambdaStage>("fusion", [this](FrameContext& ctx){
@@ -493,51 +1110,62 @@ void ProcessingManager::rebuildPipelineStages(){
     }
 }
 
-void ProcessingManager::buildAndValidatePointCloud(const RawDepthFrame& raw,
-                                                   InternalPointCloud& cloud,
-                                                   FrameValidationSummary& summary){
-    cloud.resize(raw.width, raw.height); cloud.timestamp_ns = raw.timestamp_ns; const float depthScale=scale_;
-    if(frameCounter_==0 && orch_logger_ && envFlag("CALDERA_DEBUG_PLANES", false)){
+void ProcessingManager::buildHeightAndValidity(SensorLane& lane, const RawDepthFrame& raw,
+                                               FrameValidationSummary& summary){
+    prepareBuild(lane, raw);
+    buildPixels(lane, raw, 0, lane.height.size(), summary);
+}
+
+void ProcessingManager::prepareBuild(SensorLane& lane, const RawDepthFrame& raw){
+    const float depthScale=scale_;
+    const TransformParameters& tp=lane.params;
+    if(lane.frameId==0 && orch_logger_ && envFlag("CALDERA_DEBUG_PLANES", false)){
         orch_logger_->info("[DEBUG] scale={} minPlane=({:.3f},{:.3f},{:.3f},{:.3f}) maxPlane=({:.3f},{:.3f},{:.3f},{:.3f})", depthScale,
-            transformParams_.minValidPlane[0], transformParams_.minValidPlane[1], transformParams_.minValidPlane[2], transformParams_.minValidPlane[3],
-            transformParams_.maxValidPlane[0], transformParams_.maxValidPlane[1], transformParams_.maxValidPlane[2], transformParams_.maxValidPlane[3]);
+            tp.minValidPlane[0], tp.minValidPlane[1], tp.minValidPlane[2], tp.minValidPlane[3],
+            tp.maxValidPlane[0], tp.maxValidPlane[1], tp.maxValidPlane[2], tp.maxValidPlane[3]);
     }
-    if(transformParamsReady_ && !planeOffsetsApplied_){ const char* envMin=std::getenv("CALDERA_ELEV_MIN_OFFSET_M"); const char* envMax=std::getenv("CALDERA_ELEV_MAX_OFFSET_M"); if(envMin||envMax){ auto adjust=[&](std::array<float,4>& pl, float delta){ pl[3]+= delta * pl[2]; }; if(envMin){ try{ float v=std::stof(envMin); adjust(transformParams_.minValidPlane, -v);}catch(...){} } if(envMax){ try{ float v=std::stof(envMax); adjust(transformParams_.maxValidPlane, -v);}catch(...){} } } planeOffsetsApplied_=true; }
-    const float pixelScaleX=1.0f, pixelScaleY=1.0f; const float cx=(raw.width-1)*0.5f; const float cy=(raw.height-1)*0.5f; const size_t N= std::min<size_t>(raw.data.size(), (size_t)raw.width*raw.height);
-    // Revised semantics: depth==0 is published as 0 height but counted as invalid (so invalid pixel tests and confidence treat it as invalid). Tail is zero-padded and also counted invalid.
-    for(size_t idx=0; idx<N; ++idx){
-        int y = int(idx / raw.width);
-        int x = int(idx % raw.width);
-        common::Point3D& pt = cloud.points[idx];
-        uint16_t d = raw.data[idx];
-    float z = (d==0)? 0.0f : (float)d * depthScale;
-        float wx = (float(x)-cx)*pixelScaleX;
-        float wy = (float(y)-cy)*pixelScaleY;
-        bool valid = (d!=0) && std::isfinite(z);
-        if(valid && transformParamsReady_){
-            float minV = transformParams_.minValidPlane[0]*wx + transformParams_.minValidPlane[1]*wy + transformParams_.minValidPlane[2]*z + transformParams_.minValidPlane[3];
-            float maxV = transformParams_.maxValidPlane[0]*wx + transformParams_.maxValidPlane[1]*wy + transformParams_.maxValidPlane[2]*z + transformParams_.maxValidPlane[3];
-            if(!(minV>=0.0f && maxV<=0.0f)) valid=false;
-        }
-        if(!valid){
-            pt = common::Point3D(wx,wy,std::numeric_limits<float>::quiet_NaN(), false);
-            ++summary.invalid;
-        } else {
-            pt = common::Point3D(wx,wy,z,true);
-            ++summary.valid;
-        }
-    }
-    for(size_t idx=N; idx<(size_t)raw.width*raw.height; ++idx){
-        int y = int(idx / raw.width);
-        int x = int(idx % raw.width);
-        common::Point3D& pt = cloud.points[idx];
-        float wx = (float(x)-cx)*pixelScaleX; float wy=(float(y)-cy)*pixelScaleY;
-        pt = common::Point3D(wx,wy,0.0f,false); // zero padded but invalid logically
-        ++summary.invalid;
+    // Plane validation is resolved into per-pixel raw bounds; rebuilt only when dims/scale/planes change.
+    // With intrinsics the planes are tested on the unprojected world point (ray table, rebuilt only
+    // when intrinsics/pose change); otherwise on the unit-pitch pixel grid.
+    const UnprojectionRayTable* rays = nullptr;
+    if(UnprojectionRayTable::hasIntrinsics(tp) && raw.width>0 && raw.height>0){
+        lane.rays.ensure((uint32_t)raw.width, (uint32_t)raw.height, tp);
+        rays = &lane.rays;
     }
+    lane.planeTable.ensure((uint32_t)raw.width, (uint32_t)raw.height, depthScale, tp.minValidPlane, tp.maxValidPlane, lane.paramsReady, rays);
+    const size_t pixels=(size_t)std::max(raw.width,0)*(size_t)std::max(raw.height,0);
+    if(lane.height.size()!=pixels) lane.height.resize(pixels);
+    if(lane.validity.size()!=pixels) lane.validity.resize(pixels);
+}
+
+void ProcessingManager::buildPixels(SensorLane& lane, const RawDepthFrame& raw, size_t begin, size_t end,
+                                    FrameValidationSummary& summary) const {
+    const size_t pixels=lane.height.size();
+    end = std::min(end, pixels);
+    if(begin>=end) return;
+    // Revised semantics: depth==0 and the zero-padded tail of a short raw buffer are counted invalid (NaN height, validity 0).
+    // With a "correct" stage the per-pixel correction is applied in the same pass, before the bounds test.
+    const CorrectionProfile* corr = lane.correction.get();
+    const bool corrected = corr && corr->isValid && corr->width==raw.width && corr->height==raw.height
+                           && corr->pixelCorrections.size()==pixels;
+    const size_t rawBegin = std::min(begin, raw.data.size());
+    const uint16_t* rawPtr = raw.data.data() + rawBegin;
+    const size_t rawCount = raw.data.size() - rawBegin;
+    FusedBuildCounts counts = corrected
+        ? fusedBuildHeightValidityCorrected(rawPtr, rawCount, end-begin,
+                                            lane.planeTable.lo()+begin, lane.planeTable.hi()+begin,
+                                            corr->pixelCorrections.data()+begin,
+                                            corr->pixelOffsets.size()==pixels ? corr->pixelOffsets.data()+begin : nullptr,
+                                            scale_, lane.height.data()+begin, lane.validity.data()+begin)
+        : fusedBuildHeightValidity(rawPtr, rawCount, end-begin,
+                                   lane.planeTable.lo()+begin, lane.planeTable.hi()+begin, scale_,
+                                   lane.height.data()+begin, lane.validity.data()+begin);
+    summary.valid += counts.valid;
+    summary.invalid += counts.invalid;
 }
 
-void ProcessingManager::updateMetrics(const std::vector<float>& fusedHeights,
+void ProcessingManager::updateMetrics(const float* fusedHeights, size_t fusedCount,
+                                      const std::vector<uint8_t>& validity,
                                       uint32_t width,
                                       uint32_t height,
                                       const std::chrono::steady_clock::time_point& tBuildStart,
@@ -557,21 +1185,40 @@ void ProcessingManager::updateMetrics(const std::vector<float>& fusedHeights,
     lastStabilityMetrics_.fuseMs = Fms(tFuseEnd - tFuseStart).count();
     lastStabilityMetrics_.procTotalMs = Fms(tFrameEnd - tBuildStart).count();
 
-    // Mean abs neighbor difference variance proxy
-    double totalDiff=0.0; uint32_t countDiff=0; const auto& data=fusedHeights;
-    for(uint32_t y=0;y<height;++y){
-        for(uint32_t x=1;x<width;++x){
-            float a=data[y*width + x-1]; float b=data[y*width + x];
-            if(std::isfinite(a)&&std::isfinite(b)) { totalDiff+=std::fabs(a-b); ++countDiff; }
+    // Mean abs neighbor difference variance proxy. Both passes run over kMetricsRows-row blocks on the
+    // shared ThreadPool; block partials are summed in order.
+    constexpr uint32_t kMetricsRows = 16;
+    const float* data=fusedHeights;
+    const int blocks = static_cast<int>((height + kMetricsRows - 1) / kMetricsRows);
+    metricsBlocks_.assign(static_cast<size_t>(blocks), MetricsBlock{});
+    auto& pool = common::ThreadPool::shared();
+    pool.parallel_for(0, blocks, 1, [&](int b0, int b1){
+        for(int b=b0;b<b1;++b){
+            MetricsBlock& m = metricsBlocks_[b];
+            for(uint32_t y=b*kMetricsRows, yEnd=std::min(height, y+kMetricsRows); y<yEnd; ++y){
+                for(uint32_t x=1;x<width;++x){
+                    float a=data[y*width + x-1]; float c=data[y*width + x];
+                    if(std::isfinite(a)&&std::isfinite(c)) { m.diff+=std::fabs(a-c); ++m.count; }
+                }
+            }
         }
-    }
+    });
+    double totalDiff=0.0; uint32_t countDiff=0;
+    for(const auto& m : metricsBlocks_){ totalDiff+=m.diff; countDiff+=m.count; }
     float meanAbsDiff = (countDiff>0)? static_cast<float>(totalDiff/countDiff):0.0f;
     const float alpha=0.1f; emaVariance_ = (emaVariance_==0.0f)? meanAbsDiff : (alpha*meanAbsDiff + (1.f-alpha)*emaVariance_);
     lastStabilityMetrics_.avgVariance = emaVariance_;
 
     // Stability ratio
-    uint32_t stable=0, considered=0; float diffThresh = meanAbsDiff*1.5f + 1e-6f;
-    for(uint32_t y=0;y<height;++y){ for(uint32_t x=1;x<width;++x){ float a=data[y*width + x-1]; float b=data[y*width + x]; if(std::isfinite(a)&&std::isfinite(b)){ ++considered; if(std::fabs(a-b)<=diffThresh) ++stable; } }}
+    uint32_t stable=0, considered=countDiff; float diffThresh = meanAbsDiff*1.5f + 1e-6f;
+    pool.parallel_for(0, blocks, 1, [&](int b0, int b1){
+        for(int b=b0;b<b1;++b){
+            uint32_t n=0;
+            for(uint32_t y=b*kMetricsRows, yEnd=std::min(height, y+kMetricsRows); y<yEnd; ++y){ for(uint32_t x=1;x<width;++x){ float a=data[y*width + x-1]; float c=data[y*width + x]; if(std::isfinite(a)&&std::isfinite(c)&&std::fabs(a-c)<=diffThresh) ++n; } }
+            metricsBlocks_[b].stable = n;
+        }
+    });
+    for(const auto& m : metricsBlocks_) stable+=m.stable;
     lastStabilityMetrics_.stabilityRatio = considered? static_cast<float>(stable)/considered:1.0f;
     lastStabilityMetrics_.adaptiveSpatial = adaptiveSpatialActive_?1.0f:0.0f;
     lastStabilityMetrics_.adaptiveStrong = (spatialRes.strong && spatialRes.applied)?1.0f:0.0f;
@@ -581,24 +1228,20 @@ void ProcessingManager::updateMetrics(const std::vector<float>& fusedHeights,
     if(spatialRes.sampled && spatialRes.preEdge>0.f && spatialRes.applied) lastStabilityMetrics_.spatialEdgePreservationRatio = spatialRes.postEdge>0.f? (spatialRes.postEdge/spatialRes.preEdge):0.f; else lastStabilityMetrics_.spatialEdgePreservationRatio=0.f;
 
     if(confidenceEnabled_){
-        if(confidenceMap_.size()!=fusedHeights.size()) confidenceMap_.assign(fusedHeights.size(),0.0f);
-        float S=lastStabilityMetrics_.stabilityRatio; S=std::clamp(S,0.0f,1.0f);
-        float R=lastStabilityMetrics_.spatialVarianceRatio; if(!(R>=0.f) || !std::isfinite(R) || R<=0.f) R=1.0f; if(R>2.f) R=1.0f;
-        float T=lastStabilityMetrics_.adaptiveTemporalBlend; T=std::clamp(T,0.0f,1.0f);
-        float wS=confWeightS_, wR=confWeightR_, wT=confWeightT_; if(lastStabilityMetrics_.spatialVarianceRatio==0.0f) wR=0.0f; float ws=wS+wR+wT; if(ws<=0){ wS=1; wR=0; wT=0; ws=1; }
-        float invWs=1.f/ws; float compS=wS*S; float compR=(wR>0)? wR*(1.0f-std::min(1.0f,std::max(0.0f,R))):0.f; float compT=wT*T;
+        if(confidenceMap_.size()!=fusedCount) confidenceMap_.assign(fusedCount,0.0f);
+        const float S=lastStabilityMetrics_.stabilityRatio, R=lastStabilityMetrics_.spatialVarianceRatio, T=lastStabilityMetrics_.adaptiveTemporalBlend;
+        const float conf = blendConfidence(S, R, T, confWeightS_, confWeightR_, confWeightT_);
         double sumC=0.0; size_t lowCnt=0, highCnt=0; size_t validCnt=0;
-        for(size_t i=0;i<fusedHeights.size();++i){
-            bool origInvalid = (i<originalInvalidMask_.size() && originalInvalidMask_[i]);
+        for(size_t i=0;i<fusedCount;++i){
+            bool origInvalid = (i<validity.size() && !validity[i]);
             bool valid=std::isfinite(fusedHeights[i]) && !origInvalid;
-            float c=0.f; if(valid){ c=(compS+compR+compT)*invWs; ++validCnt; } // orig invalids stay 0
-            if(c<0) c=0; else if(c>1) c=1; confidenceMap_[i]=c; sumC+=c; if(c<confLowThresh_) ++lowCnt; else if(c>confHighThresh_) ++highCnt; }
-        if(validCnt==0 && !fusedHeights.empty()){
+            float c=0.f; if(valid){ c=conf; ++validCnt; } // orig invalids stay 0
+            confidenceMap_[i]=c; sumC+=c; if(c<confLowThresh_) ++lowCnt; else if(c>confHighThresh_) ++highCnt; }
+        if(validCnt==0 && fusedCount>0){
             // Fallback: use geometric valid count estimate (total - hardInvalid) so meanConfidence reflects stability even if all values became non-finite upstream.
-            size_t geomValid = fusedHeights.size() > lastValidationSummary_.invalid ? fusedHeights.size() - lastValidationSummary_.invalid : 0;
+            size_t geomValid = fusedCount > lastValidationSummary_.invalid ? fusedCount - lastValidationSummary_.invalid : 0;
             if(geomValid>0){
-                float estC = (compS+compR+compT); if(ws>0) estC *= invWs; if(estC<0) estC=0; if(estC>1) estC=1;
-                sumC = estC * geomValid;
+                sumC = conf * geomValid;
                 validCnt = geomValid;
             }
         }
@@ -606,8 +1249,8 @@ void ProcessingManager::updateMetrics(const std::vector<float>& fusedHeights,
         lastStabilityMetrics_.fractionLowConfidence = confidenceMap_.empty()?0.f: static_cast<float>(lowCnt)/confidenceMap_.size();
         lastStabilityMetrics_.fractionHighConfidence= confidenceMap_.empty()?0.f: static_cast<float>(highCnt)/confidenceMap_.size();
         if(orch_logger_ && envFlag("CALDERA_DEBUG_PLANES", false)){
-            orch_logger_->info("[DEBUG-CONF] S={:.3f} R={:.3f} T={:.3f} compS={:.3f} compR={:.3f} compT={:.3f} validCnt={} total={} meanC={:.3f} lowFrac={:.3f}",
-                               S,R,T,compS,compR,compT,validCnt,fusedHeights.size(), lastStabilityMetrics_.meanConfidence, lastStabilityMetrics_.fractionLowConfidence);
+            orch_logger_->info("[DEBUG-CONF] S={:.3f} R={:.3f} T={:.3f} C={:.3f} validCnt={} total={} meanC={:.3f} lowFrac={:.3f}",
+                               S,R,T,conf,validCnt,fusedCount, lastStabilityMetrics_.meanConfidence, lastStabilityMetrics_.fractionLowConfidence);
         }
     } else {
         lastStabilityMetrics_.meanConfidence=0; lastStabilityMetrics_.fractionLowConfidence=0; lastStabilityMetrics_.fractionHighConfidence=0; }
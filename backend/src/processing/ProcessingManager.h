@@ -1,17 +1,25 @@
 #ifndef CALDERA_BACKEND_PROCESSING_MANAGER_H
 #define CALDERA_BACKEND_PROCESSING_MANAGER_H
 
+#include <condition_variable>
 #include <functional>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
 
 #include "common/DataTypes.h"
+#include "common/WorldFramePool.h"
+#include "common/WorldFrameSlot.h"
+#include "hal/FrameSet.h"
+#include "processing/FramePipeline.h"
 #include "processing/IHeightMapFilter.h"
 #include "processing/ProcessingTypes.h"
 #include "processing/FusionAccumulator.h"
 #include "processing/ProcessingStages.h" // stage scaffolding (future use)
 #include "processing/PipelineParser.h" // StageSpec definition
+#include "processing/PlaneValidationTable.h"
 
 namespace spdlog { class logger; }
 
@@ -22,6 +30,9 @@ public:
     using WorldFrame = caldera::backend::common::WorldFrame;
     using RawDepthFrame = caldera::backend::common::RawDepthFrame;
     using WorldFrameCallback = std::function<void(const WorldFrame&)>;
+    using WorldFrameHandle = caldera::backend::common::WorldFrameHandle;
+    // Zero-copy delivery: the handle shares a pooled payload that is recycled once every holder releases it.
+    using WorldFrameHandleCallback = std::function<void(const WorldFrameHandle&)>;
 
     ProcessingManager(std::shared_ptr<spdlog::logger> orchestratorLogger,
               std::shared_ptr<spdlog::logger> fusionLogger = nullptr,
@@ -29,11 +40,50 @@ public:
     ~ProcessingManager();
 
     void setWorldFrameCallback(WorldFrameCallback cb);
+    void setWorldFrameHandleCallback(WorldFrameHandleCallback cb); // pooled shared-ownership delivery (no copy)
+    // Fused heights are written straight into the sink's writable slot and committed there; the
+    // WorldFrame callbacks (if any) then receive a copy. nullptr restores the pooled-frame path.
+    void setDirectPublishSink(std::shared_ptr<common::IWorldFrameSlotSink> sink);
 
+    // Each sensor id owns a lane (build / temporal / spatial state and buffers), so frames of
+    // different sensors are processed concurrently when called from different threads. Lanes meet at
+    // the fusion barrier: the last sensor to arrive fuses and publishes one frame for all of them.
+    // Sensors within the FusionAccumulator dropout window are waited for, up to
+    // CALDERA_FUSION_BARRIER_TIMEOUT_MS (default 35); callers feeding several sensors from a single
+    // thread should use processFrameSet instead.
     void processRawDepthFrame(const RawDepthFrame& raw);
+    // Synchronized multi-sensor batch from HAL_Manager: members run their lanes in parallel (the first
+    // on the calling thread) and are fused into a single frame; missing sensors are not waited for.
+    void processFrameSet(const hal::FrameSet& set);
+
+    // Pipelined execution (CALDERA_PROCESSING_PIPELINED=1): the process* calls queue the frame (set)
+    // and return; build + filters ("lanes"), fusion and callback delivery ("publish") run on
+    // dedicated workers connected by bounded rings, so frame k+1 is built while frame k is fused and
+    // published. Each worker takes frames in order; each call becomes one fused frame (a single
+    // sensor frame is not waited for by other sensors, use processFrameSet for joint rounds). A call
+    // blocks while CALDERA_PIPELINE_DEPTH frames beyond one per stage are in flight. Frame-set members
+    // are built one after another on the single "lanes" worker (no per-lane parallelism).
+    bool pipelined() const { return pipeline_ != nullptr; }
+    void flush(); // waits until every queued frame has been published (no-op when not pipelined)
+    FramePipeline::Stats pipelineStats() const; // per-stage frames, queue depths and busy time
 
     // Inject a height map filter (ownership shared to allow reuse in tests). If not set, no-op.
-    void setHeightMapFilter(std::shared_ptr<IHeightMapFilter> f) { height_filter_ = std::move(f); }
+    // Each sensor lane after the first uses clone() of it; non-clonable filters are shared, serialized.
+    void setHeightMapFilter(std::shared_ptr<IHeightMapFilter> f);
+
+    // Output grid of the "rasterize" stage (heightMapWidth/Height/Resolution); sensor resolution is
+    // independent of it. Takes effect from the next frame of each lane.
+    void setProcessingConfig(const ProcessingConfig& config);
+    // Per-sensor intrinsics and pose (focal length, principal point, distortion, sensorPosition/RotationMatrix)
+    // used by "undistort" / "rasterize"; sensors without one use setTransformParameters' values.
+    void setSensorPose(const std::string& sensorId, const TransformParameters& pose);
+    // Dense per-pixel depth correction (DepthCorrector::createProfile) applied by the "correct" stage
+    // inside the build pass. An empty sensorId sets the default for sensors without their own;
+    // nullptr removes. Profiles whose size differs from the frame are ignored.
+    void setDepthCorrection(const std::string& sensorId, std::shared_ptr<const CorrectionProfile> profile);
+
+    size_t sensorLaneCount() const;
+    uint64_t fusionBarrierTimeouts() const; // rounds fused without every expected sensor
 
     struct FrameValidationSummary {
         uint32_t valid = 0;
@@ -94,18 +144,58 @@ public:
         transformParams_.planeD = profile.basePlaneCalibration.basePlane.d;
         transformParams_.minValidPlane = {profile.minValidPlane.a, profile.minValidPlane.b, profile.minValidPlane.c, profile.minValidPlane.d};
         transformParams_.maxValidPlane = {profile.maxValidPlane.a, profile.maxValidPlane.b, profile.maxValidPlane.c, profile.maxValidPlane.d};
+        if (profile.hasIntrinsicCalibration) {
+            transformParams_.focalLengthX = profile.focalLengthX;
+            transformParams_.focalLengthY = profile.focalLengthY;
+            transformParams_.principalPointX = profile.principalPointX;
+            transformParams_.principalPointY = profile.principalPointY;
+            for (size_t k = 0; k < 5; ++k)
+                transformParams_.distortionCoeffs[k] = k < profile.distortionCoeffs.size() ? profile.distortionCoeffs[k] : 0.0f;
+        }
         transformParamsReady_ = true;
         planeOffsetsApplied_ = false; // allow env offsets to apply once with new params
         // Depth scale: if profile has intrinsic calibration with depth correction (future), we could override scale_ here.
     }
 
 private:
-    // Build an internal point cloud (minimal world-space) & validate points.
-    void buildAndValidatePointCloud(const RawDepthFrame& raw,
-                                    InternalPointCloud& cloud,
-                                    FrameValidationSummary& summary);
+    struct SensorLane; // per-sensor buffers and filter state (ProcessingManager.cpp)
+    struct LaneResult; // one lane's frame as handed to fusion (ProcessingManager.cpp)
+    struct PipelineSlot; // one frame (set) in flight through pipeline_ (ProcessingManager.cpp)
+    // A fusion input: the lane's result and the buffers holding its heights / validity.
+    struct FusionLayer {
+        const std::string* id;
+        const LaneResult* result;
+        const std::vector<float>* height;
+        const std::vector<uint8_t>* validity;
+    };
+
+    SensorLane& laneFor(const std::string& sensorId);
+    // One frame through a lane: snapshot shared state, build/filter without locks, then the barrier.
+    // expected > 0 fixes the barrier quorum (frame sets); 0 derives it from the dropout window.
+    void processLane(SensorLane& lane, const RawDepthFrame& raw, size_t expected);
+    void beginLaneFrame(SensorLane& lane, const RawDepthFrame& raw); // under fuseMutex_
+    void runLane(SensorLane& lane, const RawDepthFrame& raw);
+    void arriveAndFuse(SensorLane& lane, size_t expected);
+    bool fusionQuorumReached() const;                                // under fuseMutex_
+    void fuseReadyLanes();                                           // under fuseMutex_
+    // Fuses one round, updates metrics and adaptive gating; nullptr if layers is empty. Under fuseMutex_.
+    std::shared_ptr<WorldFrame> fuseLayers(const std::vector<FusionLayer>& layers);
+    void publishFrame(std::shared_ptr<WorldFrame> frame);            // callbacks
+    // Queues one round (members = lane + raw frame); set keeps the frames alive, otherwise the single member is copied.
+    void submitPipelined(const std::pair<SensorLane*, const RawDepthFrame*>* members, size_t count, const hal::FrameSet* set);
+    void startPipeline();
+    void pipelineBuild(PipelineSlot& slot);
+    void pipelineFuse(PipelineSlot& slot);
+    void laneWorkerLoop(SensorLane& lane);                           // processFrameSet helper thread
+    // Fused build + plane validation straight into the lane's height / validity buffers.
+    void buildHeightAndValidity(SensorLane& lane, const RawDepthFrame& raw,
+                                FrameValidationSummary& summary);
+    // The same in two steps for row bands: size buffers / refresh tables once, then build pixels [begin, end).
+    void prepareBuild(SensorLane& lane, const RawDepthFrame& raw);
+    void buildPixels(SensorLane& lane, const RawDepthFrame& raw, size_t begin, size_t end,
+                     FrameValidationSummary& summary) const;
     // Helpers (refactor targets) used by both legacy and pipeline execution paths
-    void applyTemporalFilter(std::vector<float>& heightMap, int w, int h);
+    void applyTemporalFilter(SensorLane& lane, std::vector<float>& heightMap, int w, int h);
     struct SpatialApplyResult {
         bool applied=false;
         bool strong=false;
@@ -115,7 +205,11 @@ private:
         float preEdge=0.f;
         float postEdge=0.f;
     };
-    SpatialApplyResult applySpatialFilter(std::vector<float>& heightMap,
+    enum class SpatialKernel : uint8_t { Classic, Fast };
+    // Kernel passes of one spatial application (base kernel, then the strong pass if any); returns the count.
+    int spatialPasses(const SensorLane& lane, const std::string& altKernel, bool strongPass, SpatialKernel passes[2]) const;
+    SpatialApplyResult applySpatialFilter(SensorLane& lane,
+                                          std::vector<float>& heightMap,
                                           int w,
                                           int h,
                                           const std::string& altKernel,
@@ -125,7 +219,8 @@ private:
                                           int sampleCount);
 
     // Shared metrics/confidence aggregation (used by both legacy and stage execution paths)
-    void updateMetrics(const std::vector<float>& fusedHeights,
+    void updateMetrics(const float* fusedHeights, size_t fusedCount,
+                       const std::vector<uint8_t>& validity,
                        uint32_t width,
                        uint32_t height,
                        const std::chrono::steady_clock::time_point& tBuildStart,
@@ -144,25 +239,36 @@ private:
     std::shared_ptr<spdlog::logger> orch_logger_;
     std::shared_ptr<spdlog::logger> fusion_logger_;
     WorldFrameCallback callback_;
+    WorldFrameHandleCallback handleCallback_;
+    std::shared_ptr<common::IWorldFrameSlotSink> directSink_;
     uint64_t frameCounter_ = 0;
     float scale_ = 0.001f;
     std::shared_ptr<IHeightMapFilter> height_filter_{}; // optional
     FrameValidationSummary lastValidationSummary_{};
     TransformParameters transformParams_{};
     bool transformParamsReady_ = false;
+    ProcessingConfig processingConfig_{};
+    std::unordered_map<std::string, TransformParameters> sensorPoses_; // setSensorPose
+    std::unordered_map<std::string, std::shared_ptr<const CorrectionProfile>> depthCorrections_; // setDepthCorrection ("" = default)
+    bool correctionStage_ = false; // "correct" present in the pipeline (rebuildPipelineStages)
     bool planeOffsetsApplied_ = false; // guard to only apply env overrides once
     FusionAccumulator fusion_; // Phase 0 scaffold (single-sensor passthrough)
+    bool tiledExecution_ = false; // CALDERA_PROCESSING_TILED: leading band-capable stages run in row bands
     // Stability instrumentation
     bool metricsEnabled_ = false;
     StabilityMetrics lastStabilityMetrics_{};
     // Simple running exponential moving average for variance proxy
     float emaVariance_ = 0.0f;
+    // Per-row-block partials of the neighbour-difference metrics, summed in block order (thread count independent)
+    struct MetricsBlock { double diff = 0.0; uint32_t count = 0, stable = 0; };
+    std::vector<MetricsBlock> metricsBlocks_;
     // Adaptive control
     int adaptiveMode_ = 0; // 0=off,1=static behavior,2=adaptive spatial toggle
     float adaptiveStabilityMin_ = 0.85f; // below this -> enable spatial
     float adaptiveVarianceMax_ = 0.02f;  // above this -> enable spatial
     // Phase 2 hysteresis & strong mode
     bool adaptiveSpatialActive_ = false;
+    bool adaptiveStrongActive_ = false; // decided with the streaks after each fused frame
     uint32_t unstableStreak_ = 0;
     uint32_t stableStreak_ = 0;
     int adaptiveOnStreak_ = 2;   // need N consecutive unstable frames (based on prev metrics) to enable
@@ -172,8 +278,6 @@ private:
     bool adaptiveStrongDoublePass_ = true;     // double-pass strong filtering
     // Adaptive temporal scaling
     float adaptiveTemporalScale_ = 1.0f; // >1 enables extra temporal smoothing when unstable
-    std::vector<float> prevFilteredHeight_; // buffer after spatial (pre-fusion) from previous frame
-    bool prevFilteredValid_ = false;
     // Confidence map support (M5 MVP)
     bool confidenceEnabled_ = false; // env CALDERA_ENABLE_CONFIDENCE_MAP
     std::vector<float> confidenceMap_; // same dimensions as height map when enabled
@@ -199,24 +303,32 @@ private:
     float duplicateFusionBaseConf_ = 0.9f; // CALDERA_FUSION_DUP_LAYER_CONF (base,dup)
     float duplicateFusionDupConf_ = 0.5f;
     bool profileLoaded_ = false; // true when a calibration profile successfully loaded (skip env plane overrides)
-    // Thread-safety: Phase 0 design assumed single-sensor feed. Multi-sensor tests invoke
-    // processRawDepthFrame concurrently from multiple SyntheticSensorDevice threads, which led
-    // to data races (and a heap-use-after-free via FusionAccumulator using a pointer to a
-    // stack-local vector from another thread). For now we serialize the entire processing
-    // pipeline per frame with a coarse mutex. Future Phase (pipeline orchestration) can
-    // introduce finer-grained stage isolation or per-sensor instances.
+    // Thread-safety: every sensor id gets a SensorLane (height/validity buffers, plane table, temporal
+    // filter, spatial kernels, adaptive-blend history) guarded by its own mutex, so build/temporal/
+    // spatial run concurrently per sensor. Everything else (calibration, adaptive gating, metrics,
+    // confidence, fusion, publishing) is guarded by fuseMutex_, taken briefly at lane start to
+    // snapshot shared state and again at the fusion barrier. Lock order: lane mutex -> fuseMutex_.
+    std::vector<std::unique_ptr<SensorLane>> lanes_;                  // registration = layer order
+    std::unordered_map<std::string, SensorLane*> lanesById_;
+    size_t readyLanes_ = 0;      // lanes waiting at the barrier
+    size_t roundExpected_ = 0;   // fixed quorum for the current round (frame sets), 0 = dropout window
+    uint64_t barrierTimeouts_ = 0;
+    int barrierTimeoutMs_ = 35;  // CALDERA_FUSION_BARRIER_TIMEOUT_MS
+    std::condition_variable barrierCv_;
+    std::mutex temporalMutex_;   // guards an injected temporal filter used directly by a lane
+    std::vector<std::pair<SensorLane*, const RawDepthFrame*>> setMembers_; // processFrameSet scratch (single caller)
+    std::vector<FusionLayer> fusionLayers_; // fuseReadyLanes scratch
+    // Pipelined execution (CALDERA_PROCESSING_PIPELINED): stages "lanes" -> "fuse" -> "publish".
+    std::unique_ptr<FramePipeline> pipeline_;
+    std::vector<std::unique_ptr<PipelineSlot>> pipelineSlots_;
+    std::mutex pipelineSubmitMutex_; // one producer at a time
+    uint64_t pipelineSubmitted_ = 0; // frame id of the next submitted frame (under pipelineSubmitMutex_)
+    size_t preallocPixels_ = 0;  // CALDERA_PREALLOC_ALL: reserve applied to every new lane
     // Persistent reusable buffers (memory stability)
-    std::vector<float> heightMapBuffer_;
-    std::vector<uint8_t> validityBuffer_;
-    std::vector<float> layerHeightsBuffer_;
-    std::vector<float> layerConfidenceBuffer_;
-    std::vector<float> fusedHeightsBuffer_;
+    std::vector<float> layerConfidenceBuffer_; // one fusion layer's confidence (FusionAccumulator copies it)
+    common::WorldFramePool framePool_; // recycled fused-height payloads handed to callbacks
     std::vector<float> fusedConfidenceBuffer_;
-    InternalPointCloud reusableCloudIn_;
-    InternalPointCloud reusableCloudFiltered_;
-    // Track original invalid pixels (pre zero-fill) for counting & confidence zeroing
-    std::vector<uint8_t> originalInvalidMask_;
-    mutable std::mutex processMutex_;
+    mutable std::mutex fuseMutex_;
 };
 
 } // namespace caldera::backend::processing
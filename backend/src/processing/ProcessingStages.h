@@ -6,6 +6,7 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
 #include <vector>
 
 namespace caldera::backend::processing {
@@ -17,7 +18,7 @@ struct AdaptiveState {
     uint32_t stableStreak = 0;      // consecutive stable frames
     float lastStability = 0.f;      // previous frame stabilityRatio
     float lastVariance = 0.f;       // previous frame avgVariance proxy
-        std::string strongKernelChoice = "classic_double"; // parsed from CALDERA_ADAPTIVE_STRONG_KERNEL
+    std::string strongKernelChoice = "fastgauss"; // CALDERA_ADAPTIVE_STRONG_KERNEL: classic_double | wide5 | fastgauss
     float temporalBlendApplied = 0.f; // 1.0f if adaptive temporal blend applied this frame
 };
 
@@ -46,15 +47,36 @@ struct FrameContext {
     // Migration support additions (Stage Exec Phase):
     const void* rawDepthFrame = nullptr;        // opaque pointer to RawDepthFrame (avoid include)
     void* internalCloud = nullptr;              // pointer to InternalPointCloud (avoid include)
+    void* sensorLane = nullptr;                 // owning ProcessingManager::SensorLane (per-sensor filter state)
     bool spatialApplied = false;                // whether spatial filter executed this frame
     bool fusionCompleted = false;               // whether fusion stage finished
 };
 
+// Planes of one stage in a row-band run (TiledStageExecutor). Stages without a halo work in place
+// (src == dst); a stage with a halo reads src and writes dst, a plane of its own.
+struct StageBandIO {
+    const float* src = nullptr;
+    float* dst = nullptr;
+    int slots = 1; // concurrent applyBand callers; the slot passed to applyBand is < slots
+};
+
 class IProcessingStage {
 public:
     virtual ~IProcessingStage() = default;
     virtual const char* name() const = 0;
     virtual void apply(FrameContext& ctx) = 0; // may mutate height/confidence/metrics/adaptive
+
+    // Optional row-band execution. bandHalo() >= 0 marks a stage that can run on horizontal bands of
+    // this frame: beginBands once, applyBand for disjoint row ranges covering the frame (concurrently,
+    // one caller per slot), then endBands. applyBand(y0, y1) writes rows [y0, y1) of io.dst and may
+    // read rows [y0 - halo, y1 + halo) of io.src. ctx.height is sized width x heightPx and must not
+    // be resized; stages that change the frame size cannot run in bands.
+    virtual int bandHalo(const FrameContext& ctx) const { (void)ctx; return -1; }
+    virtual void beginBands(FrameContext& ctx, const StageBandIO& io) { (void)ctx; (void)io; }
+    virtual void applyBand(FrameContext& ctx, uint32_t y0, uint32_t y1, const StageBandIO& io, int slot) {
+        (void)ctx; (void)y0; (void)y1; (void)io; (void)slot;
+    }
+    virtual void endBands(FrameContext& ctx, const StageBandIO& io) { (void)ctx; (void)io; }
 };
 
 } // namespace caldera::backend::processing
@@ -5,28 +5,71 @@
 #include <chrono>
 #include <cstdint>
 #include <array>
+#include <algorithm>
+#include <cstddef>
 
 namespace caldera::backend::processing {
 
 /**
  * Internal point cloud for processing pipeline (not part of external contract)
+ *
+ * Structure-of-arrays layout: separate x/y/z float planes plus a packed validity
+ * bitmask (bit i of word i/64 == pixel i). Keeps per-pixel traffic at 12 bytes + 1 bit
+ * instead of a padded 16-byte Point3D and lets per-plane loops auto-vectorize.
  */
 struct InternalPointCloud {
     uint64_t timestamp_ns = 0;
     int width = 0;
     int height = 0;
-    std::vector<common::Point3D> points;
-    
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<uint64_t> validBits;
+
+    static size_t wordCount(size_t n) { return (n + 63) / 64; }
+
+    size_t size() const { return z.size(); }
+
     void resize(int w, int h) {
         width = w;
         height = h;
-        points.resize(w * h);
+        const size_t n = static_cast<size_t>(w) * static_cast<size_t>(h);
+        x.resize(n);
+        y.resize(n);
+        z.resize(n);
+        validBits.resize(wordCount(n));
     }
-    
+
     void clear() {
         width = 0;
         height = 0;
-        points.clear();
+        x.clear();
+        y.clear();
+        z.clear();
+        validBits.clear();
+    }
+
+    bool isValid(size_t i) const { return (validBits[i >> 6] >> (i & 63)) & 1u; }
+    void setValid(size_t i, bool v) {
+        const uint64_t bit = uint64_t(1) << (i & 63);
+        if (v) validBits[i >> 6] |= bit; else validBits[i >> 6] &= ~bit;
+    }
+    void clearValid() { std::fill(validBits.begin(), validBits.end(), uint64_t(0)); }
+
+    // Number of set validity bits (tail bits beyond size() are kept clear by writers).
+    size_t validCount() const {
+        size_t n = 0;
+        for (uint64_t w : validBits) n += static_cast<size_t>(__builtin_popcountll(w));
+        return n;
+    }
+
+    // AoS convenience accessors (tests / debug paths; hot loops use the planes directly).
+    common::Point3D point(size_t i) const { return common::Point3D(x[i], y[i], z[i], isValid(i)); }
+    void setPoint(size_t i, const common::Point3D& p) {
+        x[i] = p.x;
+        y[i] = p.y;
+        z[i] = p.z;
+        setValid(i, p.valid);
     }
 };
 
@@ -39,6 +82,8 @@ struct TransformParameters {
     float focalLengthY = 0.0f;
     float principalPointX = 0.0f;
     float principalPointY = 0.0f;
+    // Lens distortion on normalized coordinates: k1, k2, p1, p2, k3 (Brown-Conrady; all zero = none)
+    float distortionCoeffs[5] = {0, 0, 0, 0, 0};
     
     // Base plane equation (ax + by + cz + d = 0)
     float planeA = 0.0f, planeB = 0.0f, planeC = 1.0f, planeD = 0.0f;
@@ -77,13 +122,12 @@ struct TransformParameters {
 struct CorrectionProfile {
     std::string sensorId;
     std::vector<float> pixelCorrections;  // Per-pixel correction factors
+    std::vector<float> pixelOffsets;      // Per-pixel additive term in raw units (empty = none)
     int width = 0;
     int height = 0;
     bool isValid = false;
     
-    // Future extensions:
-    // Matrix3f intrinsicMatrix;     // Camera intrinsics  
-    // Vector4f distortionCoeffs;    // Radial/tangential distortion
+    // Intrinsics and lens distortion live in TransformParameters (UndistortionRemap, "undistort" stage).
     
     void resize(int w, int h) {
         width = w;
@@ -94,6 +138,7 @@ struct CorrectionProfile {
     void clear() {
         sensorId.clear();
         pixelCorrections.clear();
+        pixelOffsets.clear();
         width = 0;
         height = 0;
         isValid = false;
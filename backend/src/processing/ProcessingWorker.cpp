@@ -0,0 +1,104 @@
+#include "processing/ProcessingWorker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+#include <spdlog/logger.h>
+
+#include "processing/ProcessingManager.h"
+
+namespace caldera::backend::processing {
+
+ProcessingWorker::Config ProcessingWorker::Config::fromEnv(){
+    Config c;
+    if(const char* m = std::getenv("CALDERA_PROCESSING_MAILBOX")){
+        std::string v(m);
+        if(v=="queue" || v=="bounded") c.policy = common::MailboxPolicy::BoundedQueue;
+        else if(v=="latest") c.policy = common::MailboxPolicy::LatestWins;
+    }
+    if(const char* d = std::getenv("CALDERA_PROCESSING_QUEUE_DEPTH")){
+        try { int n = std::stoi(d); if(n>0) c.queueDepth = static_cast<size_t>(n); } catch(...){}
+    }
+    return c;
+}
+
+ProcessingWorker::ProcessingWorker(std::shared_ptr<ProcessingManager> processing, Config cfg,
+                                   std::shared_ptr<spdlog::logger> logger)
+    : processing_(std::move(processing)), cfg_(cfg), logger_(std::move(logger)) {}
+
+ProcessingWorker::~ProcessingWorker(){ stop(); }
+
+ProcessingWorker::Mailbox* ProcessingWorker::addLane(const std::string& name){
+    if(running_.load()) return nullptr; // lanes are fixed while the worker runs
+    lanes_.push_back(Lane{name, std::make_unique<Mailbox>(cfg_.policy, cfg_.queueDepth)});
+    return lanes_.back().mailbox.get();
+}
+
+void ProcessingWorker::submit(Mailbox* lane, const hal::RawDepthFrameHandle& frame){
+    if(!lane || !frame) return;
+    lane->push([&](hal::RawDepthFrameHandle& slot){ slot = frame; }); // a superseded handle is released here
+    pending_.fetch_add(1, std::memory_order_release);
+    wakeCv_.notify_one(); // lock-free notify; a race with the wait costs at most idleWaitUs
+}
+
+void ProcessingWorker::submit(Mailbox* lane, const common::RawDepthFrame& frame){
+    if(!lane) return;
+    std::shared_ptr<common::RawDepthFrame> copy = copyPool_.acquireDepth(frame.data.size());
+    copy->sensorId = frame.sensorId;
+    copy->timestamp_ns = frame.timestamp_ns;
+    copy->width = frame.width;
+    copy->height = frame.height;
+    std::copy(frame.data.begin(), frame.data.end(), copy->data.begin()); // reuses pooled capacity
+    submit(lane, hal::RawDepthFrameHandle(std::move(copy)));
+}
+
+void ProcessingWorker::start(){
+    if(running_.exchange(true)) return;
+    thread_ = std::thread([this]{ run(); });
+    if(logger_) logger_->info("ProcessingWorker started lanes={} policy={} depth={}", lanes_.size(),
+        cfg_.policy==common::MailboxPolicy::LatestWins? "latest":"queue", cfg_.queueDepth);
+}
+
+void ProcessingWorker::stop(){
+    if(!running_.exchange(false)) return;
+    wakeCv_.notify_all();
+    if(thread_.joinable()) thread_.join();
+    if(logger_){
+        Stats s = stats();
+        logger_->info("ProcessingWorker stopped submitted={} processed={} coalesced={} dropped={}", s.submitted, s.processed, s.coalesced, s.dropped);
+    }
+}
+
+void ProcessingWorker::run(){
+    const auto idleWait = std::chrono::microseconds(cfg_.idleWaitUs>0? cfg_.idleWaitUs : 1);
+    auto process = [this](hal::RawDepthFrameHandle& slot){
+        hal::RawDepthFrameHandle f = std::move(slot); // slot no longer pins the buffer
+        processing_->processRawDepthFrame(*f);
+        processed_.fetch_add(1, std::memory_order_relaxed);
+        f.reset();
+        if(onProcessed_) onProcessed_();
+    };
+    while(running_.load(std::memory_order_acquire)){
+        pending_.store(0, std::memory_order_relaxed);
+        bool any = false;
+        // One frame per lane per round keeps sensors fair under load.
+        for(auto& lane : lanes_) any |= lane.mailbox->consume(process);
+        if(any) continue;
+        std::unique_lock<std::mutex> lk(wakeMutex_);
+        wakeCv_.wait_for(lk, idleWait, [this]{ return pending_.load(std::memory_order_acquire)!=0 || !running_.load(std::memory_order_acquire); });
+    }
+}
+
+ProcessingWorker::Stats ProcessingWorker::stats() const {
+    Stats s; s.processed = processed_.load(std::memory_order_relaxed);
+    for(const auto& lane : lanes_){ auto m = lane.mailbox->stats(); s.submitted += m.pushed; s.coalesced += m.coalesced; s.dropped += m.dropped; }
+    return s;
+}
+
+ProcessingWorker::Mailbox::Stats ProcessingWorker::laneStats(size_t lane) const {
+    return lane < lanes_.size() ? lanes_[lane].mailbox->stats() : Mailbox::Stats{};
+}
+
+} // namespace caldera::backend::processing
@@ -0,0 +1,99 @@
+#ifndef CALDERA_BACKEND_PROCESSING_PROCESSING_WORKER_H
+#define CALDERA_BACKEND_PROCESSING_PROCESSING_WORKER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/DataTypes.h"
+#include "common/FrameMailbox.h"
+#include "hal/FrameBufferPool.h"
+
+namespace spdlog { class logger; }
+
+namespace caldera::backend::processing {
+
+class ProcessingManager;
+
+// Dedicated processing thread fed by one lock-free mailbox per capture source.
+//
+// Capture threads call submit(), which parks the pooled frame handle in the lane's mailbox and
+// returns immediately (LatestWins coalesces, BoundedQueue drops when full), so a slow frame never
+// stalls a USB callback. The worker drains all lanes round-robin and runs
+// ProcessingManager::processRawDepthFrame on the frame; the handle (and with it the device
+// buffer) is released as soon as processing finishes or the frame is superseded.
+class ProcessingWorker {
+public:
+    using Mailbox = common::SpscFrameMailbox<hal::RawDepthFrameHandle>;
+
+    struct Config {
+        common::MailboxPolicy policy = common::MailboxPolicy::LatestWins;
+        size_t queueDepth = 4;       // BoundedQueue capacity per lane
+        int idleWaitUs = 2000;       // upper bound on wake-up latency if a notify races the wait
+        // CALDERA_PROCESSING_MAILBOX=latest|queue, CALDERA_PROCESSING_QUEUE_DEPTH=N
+        static Config fromEnv();
+    };
+
+    struct Stats {
+        uint64_t submitted = 0;  // frames offered by capture threads (all lanes)
+        uint64_t processed = 0;  // frames run through ProcessingManager
+        uint64_t coalesced = 0;  // superseded before processing (LatestWins)
+        uint64_t dropped = 0;    // rejected because a lane was full (BoundedQueue)
+    };
+
+    ProcessingWorker(std::shared_ptr<ProcessingManager> processing, Config cfg,
+                     std::shared_ptr<spdlog::logger> logger = nullptr);
+    ~ProcessingWorker();
+
+    ProcessingWorker(const ProcessingWorker&) = delete;
+    ProcessingWorker& operator=(const ProcessingWorker&) = delete;
+
+    // Registers a producer lane (exactly one producer thread per lane). Lanes must be added
+    // before start(); the returned pointer stays valid for the worker's lifetime.
+    Mailbox* addLane(const std::string& name);
+
+    // Producer side: never blocks on processing. The handle overload shares the device buffer;
+    // the by-reference overload copies once into a frame from the worker's own pool.
+    void submit(Mailbox* lane, const hal::RawDepthFrameHandle& frame);
+    void submit(Mailbox* lane, const common::RawDepthFrame& frame);
+
+    // Invoked on the worker thread after each processed frame (e.g. ReplayClock::frameDone for
+    // lock-step replay). Set before start().
+    void setFrameProcessedCallback(std::function<void()> cb) { onProcessed_ = std::move(cb); }
+
+    void start();
+    void stop(); // joins; frames still pending in the mailboxes are discarded
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    Stats stats() const;
+    Mailbox::Stats laneStats(size_t lane) const;
+    size_t laneCount() const { return lanes_.size(); }
+
+private:
+    struct Lane { std::string name; std::unique_ptr<Mailbox> mailbox; };
+
+    void run();
+
+    std::shared_ptr<ProcessingManager> processing_;
+    Config cfg_;
+    std::shared_ptr<spdlog::logger> logger_;
+    std::vector<Lane> lanes_;
+    hal::FrameBufferPool copyPool_; // backs the by-reference submit path
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint32_t> pending_{0}; // doorbell: bumped by producers, cleared by the worker
+    std::mutex wakeMutex_;             // only pairs with wakeCv_; producers never lock it
+    std::condition_variable wakeCv_;
+    std::atomic<uint64_t> processed_{0};
+    std::function<void()> onProcessed_;
+};
+
+} // namespace caldera::backend::processing
+
+#endif // CALDERA_BACKEND_PROCESSING_PROCESSING_WORKER_H
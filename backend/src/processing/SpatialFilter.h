@@ -1,8 +1,12 @@
 #pragma once
 #include "processing/IHeightMapFilter.h"
+#include "common/ThreadPool.h"
+#include <algorithm>
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 #include <cmath>
+#include <cstring>
 #include <limits>
 #include <string>
 #include <cstdlib>
@@ -11,6 +15,12 @@ namespace caldera::backend::processing {
 
 // Simple separable spatial smoothing filter using kernel [1 2 1] / 4 in each direction.
 // Phase M2: CPU reference implementation, NaN-aware (skips NaN neighbors; renormalizes by sum of weights actually used).
+// Kernels are binomial rows specialized on the radius (1: [1 2 1], 2: [1 4 6 4 1], 3: [1 6 15 20 15 6 1]).
+// Interior pixels run through fixed-size blocks whose taps are masked instead of skipped, so the
+// loops vectorize; blocks with no NaN in reach (per-chunk scan) drop the masks altogether and the
+// radius-wide borders take the bounds-checked path. All paths accumulate the taps in the same
+// order, so results do not depend on where the block boundaries fall. Rows are independent within a
+// pass and run on the shared ThreadPool in kRowGrain chunks.
 class SpatialFilter : public IHeightMapFilter {
 public:
     explicit SpatialFilter(bool enableNaNAware = true)
@@ -19,6 +29,7 @@ public:
         if (alt) {
             std::string v(alt);
             if (v == "wide5") mode_ = Mode::Wide5;
+            else if (v == "wide7") mode_ = Mode::Wide7;
         }
     }
     void apply(std::vector<float>& heightMap, int width, int height) override {
@@ -26,63 +37,183 @@ public:
         if (heightMap.size() != static_cast<size_t>(width*height)) return;
         if (scratch_.size() != heightMap.size()) scratch_.resize(heightMap.size());
         switch(mode_) {
-            case Mode::Classic3: applySeparable(heightMap, width, height, 1); break;
-            case Mode::Wide5: applySeparableWide5(heightMap, width, height); break;
+            case Mode::Classic3: applySeparable<1>(heightMap, width, height); break;
+            case Mode::Wide5: applySeparable<2>(heightMap, width, height); break;
+            case Mode::Wide7: applySeparable<3>(heightMap, width, height); break;
         }
     }
+    // Kernel radius (rows of input on each side that reach an output row).
+    int radius() const { return mode_ == Mode::Wide7 ? 3 : mode_ == Mode::Wide5 ? 2 : 1; }
 private:
-    enum class Mode { Classic3, Wide5 } mode_ = Mode::Classic3;
+    enum class Mode { Classic3, Wide5, Wide7 } mode_ = Mode::Classic3;
     bool nanAware_ = true;
     std::vector<float> scratch_;
 
-    // radius=1 kernel [1 2 1]
-    void applySeparable(std::vector<float>& buf, int w, int h, int radius) {
-        // Horizontal
-        for (int y=0; y<h; ++y) {
-            int off = y*w;
-            for (int x=0; x<w; ++x) {
-                float c = buf[off+x];
-                if (!std::isfinite(c)) { scratch_[off+x] = c; continue; }
-                float acc=0.f, wsum=0.f;
-                for(int dx=-radius; dx<=radius; ++dx){ int xx=x+dx; if(xx<0||xx>=w) continue; float v=buf[off+xx]; if(nanAware_ && !std::isfinite(v)) continue; float wgt = (dx==0)?2.f:1.f; acc+=v*wgt; wsum+=wgt; }
-                scratch_[off+x] = wsum>0? acc/wsum : c;
+    static constexpr int kBlock = 64;
+    static constexpr int kRowGrain = 16;
+
+    template<typename Body>
+    static void forRows(int h, const Body& body) { common::ThreadPool::shared().parallel_for(0, h, kRowGrain, body); }
+
+    template<int R> struct Taps { float w[2*R+1]; };
+    // Row 2R of Pascal's triangle.
+    template<int R> static constexpr Taps<R> binomialTaps() {
+        Taps<R> t{};
+        float c = 1.0f;
+        for (int k = 0; k <= 2*R; ++k) { t.w[k] = c; c = c * (2*R - k) / (k + 1); }
+        return t;
+    }
+
+    static bool finite(float v) { // integer exponent test: vectorizes like the rest of the block
+        uint32_t b; std::memcpy(&b, &v, sizeof b);
+        return (b & 0x7F800000u) != 0x7F800000u;
+    }
+    // v where keep, +0 otherwise; a bit mask rather than a select so the compiler cannot split the
+    // multiply-add into branches.
+    static float keepIf(bool keep, float v) {
+        uint32_t b; std::memcpy(&b, &v, sizeof b);
+        b &= keep ? 0xFFFFFFFFu : 0u;
+        float r; std::memcpy(&r, &b, sizeof r);
+        return r;
+    }
+    static float selectBits(bool first, float a, float b) {
+        uint32_t ab, bb; std::memcpy(&ab, &a, sizeof ab); std::memcpy(&bb, &b, sizeof bb);
+        const uint32_t m = first ? 0xFFFFFFFFu : 0u;
+        const uint32_t r = (ab & m) | (bb & ~m);
+        float f; std::memcpy(&f, &r, sizeof f);
+        return f;
+    }
+
+    // finiteChunks_[y * chunks + c]: row y, columns [c*kBlock, (c+1)*kBlock) hold no NaN/inf. With the
+    // NaN-aware kernel a finite center yields a finite result, so the flags also describe scratch_.
+    std::vector<uint8_t> finiteChunks_;
+    int chunks_ = 0;
+
+    template<int N>
+    static bool allFinite(const float* v, int n) {
+        const int count = N ? N : n;
+        uint32_t bad = 0;
+        for (int i = 0; i < count; ++i) { uint32_t b; std::memcpy(&b, &v[i], sizeof b); bad |= (~b & 0x7F800000u) == 0u; }
+        return bad == 0;
+    }
+    void scanFinite(const float* buf, int w, int h) {
+        chunks_ = (w + kBlock - 1) / kBlock;
+        finiteChunks_.resize(static_cast<size_t>(chunks_) * h);
+        forRows(h, [&](int y0, int y1) {
+            for (int y = y0; y < y1; ++y) {
+                const float* row = buf + static_cast<size_t>(y) * w;
+                for (int c = 0; c < chunks_; ++c) {
+                    const int x = c * kBlock, n = std::min(kBlock, w - x);
+                    finiteChunks_[static_cast<size_t>(y) * chunks_ + c] = n == kBlock ? allFinite<kBlock>(row + x, n) : allFinite<0>(row + x, n);
+                }
             }
+        });
+    }
+    // Columns [x0, x1) of rows [y0, y1] hold only finite values.
+    bool spanFinite(int x0, int x1, int y0, int y1) const {
+        for (int y = y0; y <= y1; ++y)
+            for (int c = x0 / kBlock; c <= (x1 - 1) / kBlock; ++c)
+                if (!finiteChunks_[static_cast<size_t>(y) * chunks_ + c]) return false;
+        return true;
+    }
+
+    template<int R>
+    void applySeparable(std::vector<float>& buf, int w, int h) {
+        if (nanAware_) {
+            scanFinite(buf.data(), w, h);
+            horizontalPass<R, true>(buf.data(), scratch_.data(), w, h);
+            verticalPass<R, true>(scratch_.data(), buf.data(), w, h);
+        } else {
+            horizontalPass<R, false>(buf.data(), scratch_.data(), w, h);
+            verticalPass<R, false>(scratch_.data(), buf.data(), w, h);
         }
-        // Vertical
-        for (int y=0; y<h; ++y) {
-            for (int x=0; x<w; ++x) {
-                float c = scratch_[y*w+x];
-                if (!std::isfinite(c)) { buf[y*w+x] = c; continue; }
-                float acc=0.f, wsum=0.f;
-                for(int dy=-radius; dy<=radius; ++dy){ int yy=y+dy; if(yy<0||yy>=h) continue; float v=scratch_[yy*w+x]; if(nanAware_ && !std::isfinite(v)) continue; float wgt=(dy==0)?2.f:1.f; acc+=v*wgt; wsum+=wgt; }
-                buf[y*w+x] = wsum>0? acc/wsum : c;
-            }
+    }
+
+    // One pixel with bounds: taps k in [kLo, kHi] only. Non-finite centers pass through.
+    template<int R, bool NanAware>
+    static float filterPixel(const float* c, ptrdiff_t stride, int kLo, int kHi) {
+        constexpr Taps<R> W = binomialTaps<R>();
+        float acc = 0.f, wsum = 0.f;
+        for (int k = kLo; k <= kHi; ++k) {
+            const float v = c[(k - R) * stride];
+            const bool ok = !NanAware || finite(v);
+            acc += keepIf(ok, v) * W.w[k];
+            wsum += keepIf(ok, W.w[k]);
         }
+        return finite(*c) ? acc / wsum : *c;
     }
 
-    // radius=2 wide5 kernel [1 4 6 4 1] (normalized by sum=16)
-    void applySeparableWide5(std::vector<float>& buf, int w, int h) {
-        // Horizontal pass
-        for(int y=0;y<h;++y){
-            int off=y*w;
-            for(int x=0;x<w;++x){
-                float c=buf[off+x];
-                if(!std::isfinite(c)){ scratch_[off+x]=c; continue; }
-                float acc=0.f, wsum=0.f;
-                for(int dx=-2; dx<=2; ++dx){ int xx=x+dx; if(xx<0||xx>=w) continue; float v=buf[off+xx]; if(nanAware_ && !std::isfinite(v)) continue; float wgt = (dx==0)?6.f: (std::abs(dx)==1?4.f:1.f); acc+=v*wgt; wsum+=wgt; }
-                scratch_[off+x] = wsum>0? acc/wsum : c;
+    // N consecutive pixels whose taps are all in bounds (N == 0: n pixels, tail), block-local results
+    // as in FusedBuildKernel.h. Unmasked blocks (no NaN in reach, or NaN-aware off) skip the weight
+    // sums: the full sum is 4^R, so the division is an exact scale.
+    template<int R, bool Masked, int N>
+    static void filterBlock(const float* src, ptrdiff_t stride, float* dst, int n) {
+        constexpr Taps<R> W = binomialTaps<R>();
+        constexpr float kInvSum = 1.0f / static_cast<float>(1 << (2*R));
+        const int count = N ? N : n;
+        alignas(32) float acc[kBlock], wsum[kBlock], out[kBlock];
+        for (int i = 0; i < count; ++i) { acc[i] = 0.f; wsum[i] = 0.f; }
+        for (int k = 0; k <= 2*R; ++k) {
+            const float* tap = src + (k - R) * stride;
+            const float wk = W.w[k];
+            if (Masked) {
+                for (int i = 0; i < count; ++i) {
+                    const bool ok = finite(tap[i]);
+                    acc[i] += keepIf(ok, tap[i]) * wk;
+                    wsum[i] += keepIf(ok, wk);
+                }
+            } else {
+                for (int i = 0; i < count; ++i) acc[i] += tap[i] * wk;
             }
         }
-        // Vertical pass
-        for(int y=0;y<h;++y){
-            for(int x=0;x<w;++x){
-                float c=scratch_[y*w+x];
-                if(!std::isfinite(c)){ buf[y*w+x]=c; continue; }
-                float acc=0.f, wsum=0.f;
-                for(int dy=-2; dy<=2; ++dy){ int yy=y+dy; if(yy<0||yy>=h) continue; float v=scratch_[yy*w+x]; if(nanAware_ && !std::isfinite(v)) continue; float wgt = (dy==0)?6.f: (std::abs(dy)==1?4.f:1.f); acc+=v*wgt; wsum+=wgt; }
-                buf[y*w+x] = wsum>0? acc/wsum : c;
+        if (Masked) for (int i = 0; i < count; ++i) out[i] = selectBits(finite(src[i]), acc[i] / wsum[i], src[i]);
+        else for (int i = 0; i < count; ++i) out[i] = selectBits(finite(src[i]), acc[i] * kInvSum, src[i]);
+        std::copy(out, out + count, dst);
+    }
+
+    template<int R, bool Masked>
+    static void filterRun(const float* src, ptrdiff_t stride, float* dst, int n) {
+        if (n == kBlock) filterBlock<R, Masked, kBlock>(src, stride, dst, n);
+        else filterBlock<R, Masked, 0>(src, stride, dst, n);
+    }
+
+    template<int R, bool NanAware>
+    void horizontalPass(const float* src, float* dst, int w, int h) const {
+        const int x0 = std::min(R, w), x1 = std::max(x0, w - R); // interior [x0, x1)
+        forRows(h, [&](int y0, int y1) {
+            for (int y = y0; y < y1; ++y) {
+                const float* row = src + static_cast<size_t>(y) * w;
+                float* out = dst + static_cast<size_t>(y) * w;
+                for (int x = 0; x < x0; ++x) out[x] = filterPixel<R, NanAware>(row + x, 1, std::max(0, R - x), std::min(2*R, R + w - 1 - x));
+                for (int x = x0; x < x1; x += kBlock) {
+                    const int n = std::min(kBlock, x1 - x);
+                    if (NanAware && !spanFinite(x - R, x + n + R, y, y)) filterRun<R, true>(row + x, 1, out + x, n);
+                    else filterRun<R, false>(row + x, 1, out + x, n);
+                }
+                for (int x = x1; x < w; ++x) out[x] = filterPixel<R, NanAware>(row + x, 1, std::max(0, R - x), std::min(2*R, R + w - 1 - x));
             }
-        }
+        });
+    }
+
+    template<int R, bool NanAware>
+    void verticalPass(const float* src, float* dst, int w, int h) const {
+        const ptrdiff_t stride = w;
+        forRows(h, [&](int y0, int y1) {
+            for (int y = y0; y < y1; ++y) {
+                const float* row = src + static_cast<size_t>(y) * w;
+                float* out = dst + static_cast<size_t>(y) * w;
+                if (y >= R && y < h - R) {
+                    for (int x = 0; x < w; x += kBlock) {
+                        const int n = std::min(kBlock, w - x);
+                        if (NanAware && !spanFinite(x, x + n, y - R, y + R)) filterRun<R, true>(row + x, stride, out + x, n);
+                        else filterRun<R, false>(row + x, stride, out + x, n);
+                    }
+                    continue;
+                }
+                const int kLo = std::max(0, R - y), kHi = std::min(2*R, R + h - 1 - y);
+                for (int x = 0; x < w; ++x) out[x] = filterPixel<R, NanAware>(row + x, stride, kLo, kHi);
+            }
+        });
     }
 };
 
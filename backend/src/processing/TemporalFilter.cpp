@@ -4,7 +4,9 @@ based on SARndbox FrameFilter for stability detection and jitter elimination.
 ***********************************************************************/
 
 #include "TemporalFilter.h"
+#include "common/ThreadPool.h"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <chrono>
 #include <iostream>
@@ -24,6 +26,10 @@ TemporalFilter::TemporalFilter(const FilterConfig& config)
     : config_(config) {
 }
 
+std::shared_ptr<IHeightMapFilter> TemporalFilter::clone() const {
+    return std::make_shared<TemporalFilter>(config_);
+}
+
 void TemporalFilter::initialize(uint32_t width, uint32_t height) {
     width_ = width;
     height_ = height;
@@ -51,25 +57,70 @@ void TemporalFilter::initialize(uint32_t width, uint32_t height) {
 }
 
 void TemporalFilter::apply(std::vector<float>& data, int width, int height) {
+    beginRows(width, height);
+    if (data.empty() || width_ == 0 || height_ == 0) {
+        return; // Pass-through if not initialized
+    }
+    
+    // Process each pixel (based on SARndbox main filtering loop). Pixels are independent, so ranges
+    // run on the shared ThreadPool and only the counters are combined.
+    const size_t numPixels = std::min(data.size(), size_t(width_ * height_));
+    common::ThreadPool::shared().parallel_for(0, static_cast<int>(numPixels), kPixelGrain, [&](int begin, int end) {
+        uint32_t s = 0, u = 0;
+        filterPixels(data.data(), static_cast<size_t>(begin), static_cast<size_t>(end), numPixels, s, u);
+        rowsStable_.fetch_add(s, std::memory_order_relaxed);
+        rowsUnstable_.fetch_add(u, std::memory_order_relaxed);
+    });
+    endRows();
+}
+
+void TemporalFilter::beginRows(int width, int height) {
     // Initialize if dimensions changed
     if (uint32_t(width) != width_ || uint32_t(height) != height_) {
         initialize(width, height);
     }
+    rowsStart_ = std::chrono::steady_clock::now();
+    rowsStable_.store(0, std::memory_order_relaxed);
+    rowsUnstable_.store(0, std::memory_order_relaxed);
+}
+
+void TemporalFilter::applyRows(float* data, int width, int y0, int y1) {
+    if (uint32_t(width) != width_ || width_ == 0) return;
+    y1 = std::min(y1, static_cast<int>(height_));
+    if (y0 >= y1) return;
+    uint32_t s = 0, u = 0;
+    filterPixels(data, static_cast<size_t>(y0) * width_, static_cast<size_t>(y1) * width_, size_t(width_ * height_), s, u);
+    rowsStable_.fetch_add(s, std::memory_order_relaxed);
+    rowsUnstable_.fetch_add(u, std::memory_order_relaxed);
+}
+
+void TemporalFilter::endRows() {
+    if (width_ == 0 || height_ == 0) return;
+    stablePixelCount_ = rowsStable_.load(std::memory_order_relaxed);
+    unstablePixelCount_ = rowsUnstable_.load(std::memory_order_relaxed);
     
-    if (data.empty() || width_ == 0 || height_ == 0) {
-        return; // Pass-through if not initialized
+    // Advance to next averaging slot (circular buffer)
+    if (++averagingSlotIndex_ >= config_.numAveragingSlots) {
+        averagingSlotIndex_ = 0;
     }
     
-    auto startTime = std::chrono::high_resolution_clock::now();
-    
-    // Reset frame statistics
-    stablePixelCount_ = 0;
-    unstablePixelCount_ = 0;
+    frameCount_++;
     
-    // Process each pixel (based on SARndbox main filtering loop)  
-    const size_t numPixels = std::min(data.size(), size_t(width_ * height_));
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - rowsStart_);
     
-    for (size_t i = 0; i < numPixels; ++i) {
+    // Log statistics periodically (every 30 frames = ~1 second at 30fps)
+    if (frameCount_ % 30 == 0) {
+        float stabilityRatio = float(stablePixelCount_) / float(stablePixelCount_ + unstablePixelCount_);
+        std::cout << "TemporalFilter frame " << frameCount_ 
+                  << ": " << stablePixelCount_ << " stable, " << unstablePixelCount_ << " unstable"
+                  << " (stability: " << (stabilityRatio * 100.0f) << "%)"
+                  << " processing: " << (duration.count() / 1000.0f) << "ms" << std::endl;
+    }
+}
+
+void TemporalFilter::filterPixels(float* data, size_t begin, size_t end, size_t numPixels,
+                                  uint32_t& stable, uint32_t& unstable) {
+    for (size_t i = begin; i < end; ++i) {
         float inputHeight = data[i];
         
         // Skip invalid input pixels (NaN or infinity)
@@ -102,7 +153,7 @@ void TemporalFilter::apply(std::vector<float>& data, int width, int height) {
             validBuffer_[i] = outputValue;
             stats.lastValidValue = outputValue;
             stats.isStable = true;
-            stablePixelCount_++;
+            ++stable;
         } else {
             // Pixel is unstable
             if (config_.retainValids) {
@@ -114,28 +165,9 @@ void TemporalFilter::apply(std::vector<float>& data, int width, int height) {
                 validBuffer_[i] = config_.instableValue;
             }
             stats.isStable = false;
-            unstablePixelCount_++;
+            ++unstable;
         }
     }
-    
-    // Advance to next averaging slot (circular buffer)
-    if (++averagingSlotIndex_ >= config_.numAveragingSlots) {
-        averagingSlotIndex_ = 0;
-    }
-    
-    frameCount_++;
-    
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-    
-    // Log statistics periodically (every 30 frames = ~1 second at 30fps)
-    if (frameCount_ % 30 == 0) {
-        float stabilityRatio = float(stablePixelCount_) / float(stablePixelCount_ + unstablePixelCount_);
-        std::cout << "TemporalFilter frame " << frameCount_ 
-                  << ": " << stablePixelCount_ << " stable, " << unstablePixelCount_ << " unstable"
-                  << " (stability: " << (stabilityRatio * 100.0f) << "%)"
-                  << " processing: " << (duration.count() / 1000.0f) << "ms" << std::endl;
-    }
 }
 
 void TemporalFilter::updatePixelStatistics(uint32_t pixelIndex, float newValue, uint16_t oldBufferValue) {
@@ -258,21 +290,16 @@ void TemporalFilter::reset() {
 }
 
 void TemporalFilter::processFrame(const InternalPointCloud& input, InternalPointCloud& output) {
-    if (input.points.empty()) {
+    if (input.size() == 0) {
         output = input; // Pass-through if empty
         return;
     }
     
     // Convert InternalPointCloud to height map
-    std::vector<float> heightMap;
-    heightMap.reserve(input.points.size());
-    
-    for (const auto& point : input.points) {
-        if (point.valid && std::isfinite(point.z)) {
-            heightMap.push_back(point.z);
-        } else {
-            heightMap.push_back(std::numeric_limits<float>::quiet_NaN());
-        }
+    std::vector<float> heightMap(input.size());
+    for (size_t i = 0; i < input.size(); ++i) {
+        const float z = input.z[i];
+        heightMap[i] = (input.isValid(i) && std::isfinite(z)) ? z : std::numeric_limits<float>::quiet_NaN();
     }
     
     // Apply temporal filtering
@@ -280,9 +307,9 @@ void TemporalFilter::processFrame(const InternalPointCloud& input, InternalPoint
     
     // Convert back to InternalPointCloud
     output = input; // Copy structure
-    for (size_t i = 0; i < std::min(heightMap.size(), output.points.size()); ++i) {
-        output.points[i].z = heightMap[i];
-        output.points[i].valid = std::isfinite(heightMap[i]);
+    for (size_t i = 0; i < std::min(heightMap.size(), output.size()); ++i) {
+        output.z[i] = heightMap[i];
+        output.setValid(i, std::isfinite(heightMap[i]));
     }
 }
 
@@ -8,6 +8,8 @@ multi-frame averaging to eliminate jittering in static regions.
 
 #include "IHeightMapFilter.h"
 #include "ProcessingTypes.h"
+#include <atomic>
+#include <chrono>
 #include <vector>
 #include <memory>
 
@@ -111,6 +113,8 @@ private:
     uint64_t frameCount_ = 0;
     uint32_t stablePixelCount_ = 0;
     uint32_t unstablePixelCount_ = 0;
+    std::atomic<uint32_t> rowsStable_{0}, rowsUnstable_{0}; // applyRows accumulators
+    std::chrono::steady_clock::time_point rowsStart_;
 
 public:
     /**
@@ -134,6 +138,13 @@ public:
      * Based on SARndbox filterThreadMethod algorithm
      */
     void apply(std::vector<float>& data, int width, int height) override;
+    std::shared_ptr<IHeightMapFilter> clone() const override; // same config, empty history
+
+    // Row bands: every pixel only sees its own history, so any row split gives apply()'s result.
+    bool supportsRows() const override { return true; }
+    void beginRows(int width, int height) override;
+    void applyRows(float* data, int width, int y0, int y1) override;
+    void endRows() override;
     
     /**
      * Process a point cloud through temporal filtering (alternative interface)
@@ -173,6 +184,13 @@ public:
     const std::vector<float>& getValidBuffer() const { return validBuffer_; }
     
 private:
+    static constexpr int kPixelGrain = 8192; // pixels per ThreadPool chunk
+
+    /**
+     * Filter pixels [begin, end) of one frame, counting stable and unstable outputs
+     */
+    void filterPixels(float* data, size_t begin, size_t end, size_t numPixels, uint32_t& stable, uint32_t& unstable);
+    
     /**
      * Update pixel statistics with new sample (based on SARndbox algorithm)
      */
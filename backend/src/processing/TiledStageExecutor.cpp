@@ -0,0 +1,136 @@
+#include "processing/TiledStageExecutor.h"
+#include "common/ThreadPool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+namespace caldera::backend::processing {
+
+TiledStageExecutor::Config TiledStageExecutor::Config::fromEnv() {
+    Config cfg;
+    if (const char* v = std::getenv("CALDERA_TILE_ROWS")) {
+        try { int n = std::stoi(v); if (n > 0) cfg.bandRows = static_cast<uint32_t>(n); } catch (...) {}
+    }
+    return cfg;
+}
+
+TiledStageExecutor::TiledStageExecutor() : TiledStageExecutor(Config::fromEnv()) {}
+
+TiledStageExecutor::TiledStageExecutor(const Config& cfg) : cfg_(cfg) {
+    cfg_.bandRows = std::max(1u, cfg_.bandRows);
+}
+
+TiledStageExecutor::Stats TiledStageExecutor::stats() const {
+    Stats s;
+    s.frames = frames_.load(std::memory_order_relaxed);
+    s.bands = bands_.load(std::memory_order_relaxed);
+    s.boundaryBands = boundaryBands_.load(std::memory_order_relaxed);
+    return s;
+}
+
+size_t TiledStageExecutor::bandablePrefix(const std::vector<std::unique_ptr<IProcessingStage>>& stages, const FrameContext& ctx) {
+    size_t n = 0;
+    while (n < stages.size() && n < kMaxStages && stages[n]->bandHalo(ctx) >= 0) ++n;
+    return n;
+}
+
+void TiledStageExecutor::run(const std::vector<std::unique_ptr<IProcessingStage>>& stages, size_t count, FrameContext& ctx) {
+    const size_t pixels = static_cast<size_t>(ctx.width) * ctx.heightPx;
+    count = std::min({count, stages.size(), kMaxStages});
+    if (count == 0 || pixels == 0) return;
+    if (ctx.height.size() != pixels) ctx.height.resize(pixels);
+    ctx_ = &ctx;
+    count_ = count;
+
+    // Planes: halo stages get their own output plane, the others work in place on the current one.
+    size_t planeCount = 0;
+    int64_t depth = 0;
+    int halos[kMaxStages];
+    for (size_t s = 0; s < count; ++s) {
+        stages_[s] = stages[s].get();
+        halos[s] = std::max(0, stages_[s]->bandHalo(ctx));
+        depth += halos[s];
+        depth_[s] = depth;
+        if (halos[s] > 0) ++planeCount;
+    }
+    if (planes_.size() < planeCount) planes_.resize(planeCount);
+    auto& pool = common::ThreadPool::shared();
+    const int64_t h = ctx.heightPx;
+    int blocks = cfg_.blocks > 0 ? cfg_.blocks : pool.concurrency();
+    blocks = static_cast<int>(std::max<int64_t>(1, std::min<int64_t>(blocks, h / cfg_.bandRows)));
+    blocks_.resize(static_cast<size_t>(blocks));
+    for (int b = 0; b < blocks; ++b) blocks_[b] = Block{h * b / blocks, h * (b + 1) / blocks};
+
+    float* cur = ctx.height.data();
+    for (size_t s = 0, p = 0; s < count; ++s) {
+        io_[s].src = cur;
+        if (halos[s] > 0) {
+            planes_[p].resize(pixels);
+            cur = planes_[p++].data();
+        }
+        io_[s].dst = cur;
+        io_[s].slots = blocks;
+        stages_[s]->beginBands(ctx, io_[s]);
+    }
+
+    pool.parallel_for(0, blocks, 1, [this](int b0, int b1) { for (int b = b0; b < b1; ++b) sweep(b); });
+    if (blocks > 1) {
+        for (size_t s = 0; s < count; ++s) {
+            if (depth_[s] == 0) continue;
+            pool.parallel_for(0, blocks, 1, [this, s](int b0, int b1) { for (int b = b0; b < b1; ++b) finishBoundaries(s, b); });
+        }
+    }
+
+    for (size_t s = 0; s < count; ++s) stages_[s]->endBands(ctx, io_[s]);
+    if (cur != ctx.height.data()) {
+        for (auto& plane : planes_) {
+            if (plane.data() == cur) { ctx.height.swap(plane); break; }
+        }
+    }
+    frames_.fetch_add(1, std::memory_order_relaxed);
+    ctx_ = nullptr;
+}
+
+void TiledStageExecutor::sweepRange(size_t s, int b, int64_t& lo, int64_t& hi) const {
+    const Block& blk = blocks_[b];
+    const int64_t head = b > 0 ? depth_[s] : 0;
+    const int64_t tail = b + 1 < static_cast<int>(blocks_.size()) ? depth_[s] : 0;
+    lo = std::min(blk.y1, blk.y0 + head);
+    hi = std::max(lo, blk.y1 - tail);
+}
+
+void TiledStageExecutor::sweep(int b) {
+    int64_t lo[kMaxStages], hi[kMaxStages], done[kMaxStages];
+    for (size_t s = 0; s < count_; ++s) {
+        sweepRange(s, b, lo[s], hi[s]);
+        done[s] = lo[s];
+    }
+    const Block& blk = blocks_[b];
+    uint64_t calls = 0;
+    for (int64_t f = blk.y0; f < blk.y1;) {
+        f = std::min<int64_t>(blk.y1, f + cfg_.bandRows);
+        for (size_t s = 0; s < count_; ++s) {
+            // Stage s may produce rows whose input reach (its halo) stage s-1 has already produced.
+            const int64_t upTo = f == blk.y1 ? hi[s] : std::min(hi[s], f - depth_[s]);
+            if (upTo <= done[s]) continue;
+            stages_[s]->applyBand(*ctx_, static_cast<uint32_t>(done[s]), static_cast<uint32_t>(upTo), io_[s], b);
+            done[s] = upTo;
+            ++calls;
+        }
+    }
+    bands_.fetch_add(calls, std::memory_order_relaxed);
+}
+
+void TiledStageExecutor::finishBoundaries(size_t s, int b) {
+    int64_t lo, hi;
+    sweepRange(s, b, lo, hi);
+    const Block& blk = blocks_[b];
+    uint64_t calls = 0;
+    if (lo > blk.y0) { stages_[s]->applyBand(*ctx_, static_cast<uint32_t>(blk.y0), static_cast<uint32_t>(lo), io_[s], b); ++calls; }
+    if (hi < blk.y1) { stages_[s]->applyBand(*ctx_, static_cast<uint32_t>(hi), static_cast<uint32_t>(blk.y1), io_[s], b); ++calls; }
+    bands_.fetch_add(calls, std::memory_order_relaxed);
+    boundaryBands_.fetch_add(calls, std::memory_order_relaxed);
+}
+
+} // namespace caldera::backend::processing
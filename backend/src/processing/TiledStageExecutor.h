@@ -0,0 +1,76 @@
+#ifndef CALDERA_BACKEND_PROCESSING_TILED_STAGE_EXECUTOR_H
+#define CALDERA_BACKEND_PROCESSING_TILED_STAGE_EXECUTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "processing/ProcessingStages.h"
+
+namespace caldera::backend::processing {
+
+// Runs a chain of band-capable stages (IProcessingStage::bandHalo >= 0) over horizontal row bands,
+// so a band goes through every stage while it is still in cache instead of each stage streaming the
+// whole frame through memory.
+//
+// The frame is split into one block of rows per pool participant. Inside a block, bands of
+// bandRows rows are swept top to bottom; stage s trails the sweep by the sum of the halos of stages
+// 0..s, so every row it reads has already been produced by stage s-1 in the same block. Rows within
+// that distance of an inner block boundary need a neighbour's output (halo exchange): they are
+// finished after the sweep, stage by stage, once every block has produced its part. Each stage runs
+// exactly once per row, which keeps stateful pointwise stages (temporal) correct.
+//
+// Halo stages write a plane of their own (one per halo stage, reused across frames) and read the
+// previous one; the last plane is swapped into ctx.height at the end.
+class TiledStageExecutor {
+public:
+    static constexpr size_t kMaxStages = 16;
+
+    struct Config {
+        uint32_t bandRows = 64; // rows per band (CALDERA_TILE_ROWS)
+        int blocks = 0;         // row blocks run in parallel; <= 0: shared ThreadPool concurrency
+        static Config fromEnv();
+    };
+
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t bands = 0;      // applyBand calls
+        uint64_t boundaryBands = 0; // of which deferred to the halo exchange pass
+    };
+
+    TiledStageExecutor();
+    explicit TiledStageExecutor(const Config& cfg);
+
+    // Number of leading stages that can run in bands for this frame (at most kMaxStages).
+    static size_t bandablePrefix(const std::vector<std::unique_ptr<IProcessingStage>>& stages, const FrameContext& ctx);
+
+    // Runs stages[0, count) over ctx in row bands (each must be band-capable for ctx).
+    void run(const std::vector<std::unique_ptr<IProcessingStage>>& stages, size_t count, FrameContext& ctx);
+
+    const Config& config() const { return cfg_; }
+    Stats stats() const;
+
+private:
+    struct Block { int64_t y0, y1; };
+    // Rows of stage s that block b produces during the sweep: [lo, hi).
+    void sweepRange(size_t s, int b, int64_t& lo, int64_t& hi) const;
+    void sweep(int b);
+    void finishBoundaries(size_t s, int b);
+
+    Config cfg_;
+    std::vector<std::vector<float>> planes_;
+    // Current frame.
+    IProcessingStage* stages_[kMaxStages] = {};
+    StageBandIO io_[kMaxStages];
+    int64_t depth_[kMaxStages] = {}; // cumulative halo of stages 0..s
+    size_t count_ = 0;
+    FrameContext* ctx_ = nullptr;
+    std::vector<Block> blocks_;
+    std::atomic<uint64_t> frames_{0}, bands_{0}, boundaryBands_{0};
+};
+
+} // namespace caldera::backend::processing
+
+#endif // CALDERA_BACKEND_PROCESSING_TILED_STAGE_EXECUTOR_H
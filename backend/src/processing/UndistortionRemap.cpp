@@ -0,0 +1,145 @@
+#include "UndistortionRemap.h"
+#include "common/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace caldera::backend::processing {
+
+namespace {
+constexpr uint32_t kOne = 1u << 15; // Q15 weight of a full tap
+} // namespace
+
+UndistortionRemap::UndistortionRemap(int threads) : threads_(threads > 0 ? threads : common::ThreadPool::bandsFromEnv("CALDERA_UNDISTORT_THREADS")) {
+    bandValid_.resize(static_cast<size_t>(threads_));
+}
+
+bool UndistortionRemap::hasDistortion(const TransformParameters& p) {
+    if (!(p.focalLengthX > 0.0f && p.focalLengthY > 0.0f)) return false;
+    return std::any_of(std::begin(p.distortionCoeffs), std::end(p.distortionCoeffs), [](float c) { return c != 0.0f; });
+}
+
+void UndistortionRemap::sourcePosition(const TransformParameters& p, float u, float v, float& sx, float& sy) {
+    const float* k = p.distortionCoeffs; // k1 k2 p1 p2 k3
+    const float x = (u - p.principalPointX) / p.focalLengthX;
+    const float y = (v - p.principalPointY) / p.focalLengthY;
+    const float r2 = x * x + y * y;
+    const float radial = 1.0f + r2 * (k[0] + r2 * (k[1] + r2 * k[4]));
+    const float xd = x * radial + 2.0f * k[2] * x * y + k[3] * (r2 + 2.0f * x * x);
+    const float yd = y * radial + k[2] * (r2 + 2.0f * y * y) + 2.0f * k[3] * x * y;
+    sx = p.focalLengthX * xd + p.principalPointX;
+    sy = p.focalLengthY * yd + p.principalPointY;
+}
+
+bool UndistortionRemap::ensure(uint32_t width, uint32_t height, const TransformParameters& p) {
+    const float intr[4] = {p.focalLengthX, p.focalLengthY, p.principalPointX, p.principalPointY};
+    if (built_ && width == width_ && height == height_ && std::equal(intr, intr + 4, intrinsics_)
+        && std::equal(std::begin(p.distortionCoeffs), std::end(p.distortionCoeffs), coeffs_)) return false;
+    width_ = width; height_ = height;
+    std::copy(intr, intr + 4, intrinsics_);
+    std::copy(std::begin(p.distortionCoeffs), std::end(p.distortionCoeffs), coeffs_);
+    built_ = false;
+    if (width < 2 || height < 2 || !(intr[0] > 0.0f && intr[1] > 0.0f)) return false; // apply() copies
+
+    taps_.resize(static_cast<size_t>(width) * height);
+    const float maxX = static_cast<float>(width - 1), maxY = static_cast<float>(height - 1);
+    for (uint32_t v = 0; v < height; ++v) {
+        for (uint32_t u = 0; u < width; ++u) {
+            Tap& t = taps_[static_cast<size_t>(v) * width + u];
+            float sx, sy;
+            sourcePosition(p, static_cast<float>(u), static_cast<float>(v), sx, sy);
+            if (!(sx >= 0.0f && sx <= maxX && sy >= 0.0f && sy <= maxY)) {
+                t.src = kOutside;
+                std::fill(std::begin(t.w), std::end(t.w), uint16_t{0});
+                continue;
+            }
+            // Top-left tap stays one short of the last row / column; the fraction then reaches 1.
+            const uint32_t x0 = std::min(static_cast<uint32_t>(sx), width - 2);
+            const uint32_t y0 = std::min(static_cast<uint32_t>(sy), height - 2);
+            const uint32_t qx = static_cast<uint32_t>(std::lround((sx - x0) * kOne));
+            const uint32_t qy = static_cast<uint32_t>(std::lround((sy - y0) * kOne));
+            // Truncate three products and give the remainder to the fourth: sum is exactly kOne, none negative.
+            const uint32_t w00 = ((kOne - qx) * (kOne - qy)) >> 15;
+            const uint32_t w10 = (qx * (kOne - qy)) >> 15;
+            const uint32_t w01 = ((kOne - qx) * qy) >> 15;
+            t.src = y0 * width + x0;
+            t.w[0] = static_cast<uint16_t>(w00);
+            t.w[1] = static_cast<uint16_t>(w10);
+            t.w[2] = static_cast<uint16_t>(w01);
+            t.w[3] = static_cast<uint16_t>(kOne - w00 - w10 - w01);
+        }
+    }
+    built_ = true; ++rebuildCount_;
+    return true;
+}
+
+size_t UndistortionRemap::apply(const float* src, float* dst) {
+    const size_t n = static_cast<size_t>(width_) * height_;
+    if (!src || !dst || n == 0) return 0;
+    if (!built_) {
+        std::copy(src, src + n, dst);
+        return static_cast<size_t>(std::count_if(src, src + n, [](float z) { return std::isfinite(z); }));
+    }
+    src_ = src; dst_ = dst;
+    bands_ = std::max(1, std::min(threads_, tileRowCount()));
+    if (bands_ == 1) return remapRows(0, static_cast<int>(height_));
+    common::ThreadPool::shared().parallel_for(0, bands_, 1, [this](int b0, int b1) {
+        for (int band = b0; band < b1; ++band) {
+            int y0, y1;
+            bandRows(band, y0, y1);
+            bandValid_[static_cast<size_t>(band)] = remapRows(y0, y1);
+        }
+    });
+    size_t valid = 0;
+    for (int band = 0; band < bands_; ++band) valid += bandValid_[static_cast<size_t>(band)];
+    return valid;
+}
+
+int UndistortionRemap::tileRowCount() const {
+    return static_cast<int>((height_ + kTileRows - 1) / kTileRows);
+}
+
+// Bands are whole tile rows, so tiles never straddle two threads.
+void UndistortionRemap::bandRows(int band, int& y0, int& y1) const {
+    const int tiles = tileRowCount(), h = static_cast<int>(height_);
+    y0 = std::min(h, tiles * band / bands_ * kTileRows);
+    y1 = std::min(h, tiles * (band + 1) / bands_ * kTileRows);
+}
+
+size_t UndistortionRemap::remapRows(int y0, int y1) const {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const size_t W = width_;
+    const Tap* taps = taps_.data();
+    const float* src = src_;
+    float* dst = dst_;
+    size_t valid = 0;
+    for (int ty = y0; ty < y1; ty += kTileRows) {
+        const int tyEnd = std::min(y1, ty + kTileRows);
+        for (size_t tx = 0; tx < W; tx += kTileCols) {
+            const size_t txEnd = std::min(W, tx + kTileCols);
+            for (int y = ty; y < tyEnd; ++y) {
+                const size_t row = static_cast<size_t>(y) * W;
+                for (size_t x = tx; x < txEnd; ++x) {
+                    const Tap& t = taps[row + x];
+                    if (t.src == kOutside) { dst[row + x] = nan; continue; }
+                    const float* s = src + t.src;
+                    const float v[4] = {s[0], s[1], s[W], s[W + 1]};
+                    float sum = 0.0f, wsum = 0.0f;
+                    for (int k = 0; k < 4; ++k) {
+                        const bool ok = std::isfinite(v[k]);
+                        const float w = static_cast<float>(t.w[k]);
+                        sum += ok ? w * v[k] : 0.0f;
+                        wsum += ok ? w : 0.0f;
+                    }
+                    const bool any = wsum >= static_cast<float>(kOne / 2);
+                    dst[row + x] = any ? sum / wsum : nan;
+                    valid += any ? 1 : 0;
+                }
+            }
+        }
+    }
+    return valid;
+}
+
+} // namespace caldera::backend::processing
@@ -0,0 +1,77 @@
+#ifndef CALDERA_BACKEND_PROCESSING_UNDISTORTION_REMAP_H
+#define CALDERA_BACKEND_PROCESSING_UNDISTORTION_REMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "processing/ProcessingTypes.h"
+
+namespace caldera::backend::processing {
+
+// Removes lens distortion from a depth / height image by a precomputed remap.
+//
+// For every output (undistorted) pixel the Brown-Conrady model of TransformParameters
+// (focal length, principal point, distortion k1 k2 p1 p2 k3) gives the position in the distorted
+// source image. The table stores that as the index of the top-left source tap plus four bilinear
+// weights in Q15 fixed point (12 bytes per pixel), rebuilt only when size, intrinsics or
+// coefficients change. Sampling is NaN-aware: invalid taps are dropped and the rest renormalized;
+// the output is NaN when valid taps carry less than half the weight (holes do not grow) or the
+// source position falls outside the image.
+//
+// apply() walks the output in tiles of kTileRows x kTileCols so the source window of a tile stays in
+// cache, with row bands run on the shared ThreadPool. Output is identical for any thread count.
+class UndistortionRemap {
+public:
+    static constexpr int kTileRows = 16;
+    static constexpr int kTileCols = 128;
+    static constexpr uint32_t kOutside = 0xFFFFFFFFu;
+
+    explicit UndistortionRemap(int threads = 0); // <= 0: CALDERA_UNDISTORT_THREADS or the shared pool's concurrency
+    UndistortionRemap(const UndistortionRemap&) = delete;
+    UndistortionRemap& operator=(const UndistortionRemap&) = delete;
+
+    // Intrinsics are set and at least one distortion coefficient is non-zero.
+    static bool hasDistortion(const TransformParameters& p);
+    // Rebuild only if the size, intrinsics or coefficients differ. Returns true if a rebuild happened.
+    bool ensure(uint32_t width, uint32_t height, const TransformParameters& params);
+    // src / dst: width*height of the last ensure(), must not overlap. Returns valid output pixels.
+    size_t apply(const float* src, float* dst);
+
+    bool matches(uint32_t width, uint32_t height) const { return built_ && width == width_ && height == height_; }
+    uint32_t width() const { return width_; }
+    uint32_t height() const { return height_; }
+    int threadCount() const { return threads_; }
+    uint64_t rebuildCount() const { return rebuildCount_; }
+
+    // Distorted source position of output pixel (u, v) (reference / tests).
+    static void sourcePosition(const TransformParameters& p, float u, float v, float& sx, float& sy);
+
+private:
+    struct Tap {
+        uint32_t src;     // top-left source index, kOutside = no source
+        uint16_t w[4];    // Q15 weights: (x0,y0) (x1,y0) (x0,y1) (x1,y1), summing to 32768
+    };
+
+    int tileRowCount() const;
+    void bandRows(int band, int& y0, int& y1) const;
+    size_t remapRows(int y0, int y1) const;
+
+    int threads_ = 1;
+    uint32_t width_ = 0, height_ = 0;
+    float intrinsics_[4] = {0, 0, 0, 0}; // fx, fy, cx, cy
+    float coeffs_[5] = {0, 0, 0, 0, 0};
+    bool built_ = false;
+    uint64_t rebuildCount_ = 0;
+    std::vector<Tap> taps_;
+
+    // Current job; bands_ <= threads_ bands of whole tile rows.
+    const float* src_ = nullptr;
+    float* dst_ = nullptr;
+    int bands_ = 1;
+    std::vector<size_t> bandValid_;
+};
+
+} // namespace caldera::backend::processing
+
+#endif // CALDERA_BACKEND_PROCESSING_UNDISTORTION_REMAP_H
@@ -0,0 +1,44 @@
+#include "processing/UnprojectionRayTable.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace caldera::backend::processing {
+
+namespace {
+std::atomic<uint64_t> g_nextTableId{1};
+}
+
+bool UnprojectionRayTable::ensure(uint32_t width, uint32_t height, const TransformParameters& p){
+    const float intr[4] = {p.focalLengthX, p.focalLengthY, p.principalPointX, p.principalPointY};
+    const float origin[3] = {p.sensorPosition.x, p.sensorPosition.y, p.sensorPosition.z};
+    if(built_ && width==width_ && height==height_
+       && std::equal(intr, intr+4, intrinsics_)
+       && std::equal(p.sensorRotationMatrix, p.sensorRotationMatrix+9, rotation_)
+       && std::equal(origin, origin+3, origin_)) return false;
+    width_=width; height_=height;
+    std::copy(intr, intr+4, intrinsics_);
+    std::copy(p.sensorRotationMatrix, p.sensorRotationMatrix+9, rotation_);
+    std::copy(origin, origin+3, origin_);
+    const size_t N=(size_t)width*height;
+    rayX_.resize(N); rayY_.resize(N); rayZ_.resize(N);
+
+    const float* R = rotation_;
+    const float fx = intr[0] != 0.0f ? intr[0] : 1.0f, fy = intr[1] != 0.0f ? intr[1] : 1.0f;
+    std::vector<float> xn(width);
+    for(uint32_t x=0; x<width; ++x) xn[x] = ((float)x - intr[2]) / fx;
+    for(uint32_t y=0; y<height; ++y){
+        const float yn = ((float)y - intr[3]) / fy;
+        const size_t row=(size_t)y*width;
+        for(uint32_t x=0; x<width; ++x){
+            rayX_[row+x] = R[0]*xn[x] + R[1]*yn + R[2];
+            rayY_[row+x] = R[3]*xn[x] + R[4]*yn + R[5];
+            rayZ_[row+x] = R[6]*xn[x] + R[7]*yn + R[8];
+        }
+    }
+    built_=true; ++rebuildCount_;
+    id_ = g_nextTableId.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace caldera::backend::processing
@@ -0,0 +1,53 @@
+#ifndef CALDERA_BACKEND_PROCESSING_UNPROJECTION_RAY_TABLE_H
+#define CALDERA_BACKEND_PROCESSING_UNPROJECTION_RAY_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "processing/ProcessingTypes.h"
+
+namespace caldera::backend::processing {
+
+// Per-pixel camera rays premultiplied by the sensor rotation, so unprojection of a whole frame is
+//   world[i] = depthMeters[i] * ray[i] + origin
+// with ray[i] = R * ((u - cx) / fx, (v - cy) / fy, 1) and origin = sensorPosition. Replaces the
+// per-pixel pixelToCamera -> cameraToWorld chain; rays are stored as separate x/y/z planes so the
+// batch loops stream them like InternalPointCloud.
+class UnprojectionRayTable {
+public:
+    // Rebuild only if the size or any intrinsic / pose value differs. Returns true if a rebuild happened.
+    bool ensure(uint32_t width, uint32_t height, const TransformParameters& params);
+    void invalidate() { built_ = false; }
+
+    // Rays need focal lengths; uncalibrated parameters (fx or fy <= 0) cannot build a table.
+    static bool hasIntrinsics(const TransformParameters& p) { return p.focalLengthX > 0.0f && p.focalLengthY > 0.0f; }
+
+    bool built() const { return built_; }
+    bool matches(uint32_t width, uint32_t height) const { return built_ && width == width_ && height == height_; }
+    uint32_t width() const { return width_; }
+    uint32_t height() const { return height_; }
+    const float* rayX() const { return rayX_.data(); }
+    const float* rayY() const { return rayY_.data(); }
+    const float* rayZ() const { return rayZ_.data(); }
+    float originX() const { return origin_[0]; }
+    float originY() const { return origin_[1]; }
+    float originZ() const { return origin_[2]; }
+    // Distinct for every build of every table: cache key for tables derived from the rays.
+    uint64_t id() const { return id_; }
+    uint64_t rebuildCount() const { return rebuildCount_; }
+
+private:
+    uint32_t width_ = 0, height_ = 0;
+    float intrinsics_[4] = {0, 0, 0, 0}; // fx, fy, cx, cy
+    float rotation_[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+    float origin_[3] = {0, 0, 0};
+    bool built_ = false;
+    uint64_t id_ = 0;
+    uint64_t rebuildCount_ = 0;
+    std::vector<float> rayX_, rayY_, rayZ_;
+};
+
+} // namespace caldera::backend::processing
+
+#endif // CALDERA_BACKEND_PROCESSING_UNPROJECTION_RAY_TABLE_H
@@ -0,0 +1,186 @@
+#include "WorldGridRasterizer.h"
+#include "common/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace caldera::backend::processing {
+
+WorldGridRasterizer::Config WorldGridRasterizer::Config::fromProcessingConfig(const ProcessingConfig& pc) {
+    Config c;
+    if (pc.heightMapWidth > 0) c.gridWidth = pc.heightMapWidth;
+    if (pc.heightMapHeight > 0) c.gridHeight = pc.heightMapHeight;
+    if (pc.heightMapResolution > 0.0f) c.resolution = pc.heightMapResolution;
+    c.originX = -0.5f * c.gridWidth * c.resolution;
+    c.originY = -0.5f * c.gridHeight * c.resolution;
+    return c;
+}
+
+bool WorldGridRasterizer::parseMode(const std::string& s, Mode& out) {
+    if (s == "min") { out = Mode::MinZ; return true; }
+    if (s == "max") { out = Mode::MaxZ; return true; }
+    if (s == "mean") { out = Mode::Mean; return true; }
+    return false;
+}
+
+WorldGridRasterizer::WorldGridRasterizer(const Config& cfg) : cfg_(cfg) {
+    cfg_.gridWidth = std::max(cfg_.gridWidth, 1);
+    cfg_.gridHeight = std::max(cfg_.gridHeight, 1);
+    if (!(cfg_.resolution > 0.0f)) cfg_.resolution = 0.001f;
+    if (!std::isfinite(cfg_.originX)) cfg_.originX = -0.5f * cfg_.gridWidth * cfg_.resolution;
+    if (!std::isfinite(cfg_.originY)) cfg_.originY = -0.5f * cfg_.gridHeight * cfg_.resolution;
+    threads_ = std::min(cfg_.threads > 0 ? cfg_.threads : common::ThreadPool::bandsFromEnv("CALDERA_RASTER_THREADS"), cfg_.gridHeight);
+    acc_.resize(cellCount());
+    if (cfg_.mode == Mode::Mean) accW_.resize(cellCount());
+    bins_.resize(static_cast<size_t>(threads_));
+    for (auto& b : bins_) b.resize(static_cast<size_t>(threads_));
+    bandStats_.resize(static_cast<size_t>(threads_));
+}
+
+void WorldGridRasterizer::rasterize(const float* heights, int width, int height, const TransformParameters& pose,
+                                    float* out, const float* weights) {
+    stats_ = Stats{};
+    if (!out) return;
+    if (!heights || width <= 0 || height <= 0) {
+        std::fill(out, out + cellCount(), std::numeric_limits<float>::quiet_NaN());
+        return;
+    }
+    Job& j = job_;
+    j = Job{};
+    j.heights = heights;
+    j.weights = cfg_.mode == Mode::Mean ? weights : nullptr;
+    j.width = width;
+    j.height = height;
+    j.out = out;
+    j.perspective = pose.focalLengthX > 0.0f && pose.focalLengthY > 0.0f;
+    j.fx = pose.focalLengthX; j.fy = pose.focalLengthY;
+    j.cx = pose.principalPointX; j.cy = pose.principalPointY;
+    j.orthoStep = cfg_.resolution;
+    // world = R * camera + position; cell = (world.xy - origin) / resolution.
+    const float* R = pose.sensorRotationMatrix;
+    const float inv = 1.0f / cfg_.resolution;
+    for (int k = 0; k < 3; ++k) {
+        j.rx[k] = R[k] * inv;
+        j.ry[k] = R[3 + k] * inv;
+        j.rz[k] = R[6 + k];
+    }
+    j.t[0] = (pose.sensorPosition.x - cfg_.originX) * inv;
+    j.t[1] = (pose.sensorPosition.y - cfg_.originY) * inv;
+    j.t[2] = pose.sensorPosition.z;
+
+    bands_ = std::max(1, std::min(threads_, height));
+    tileRows_ = (cfg_.gridHeight + bands_ - 1) / bands_;
+    std::fill(bandStats_.begin(), bandStats_.end(), BandStats{});
+    if (bands_ == 1) {
+        // Single band: no binning, points go straight into the accumulators in source order.
+        resetCells(0, cellCount());
+        scatterRows(0);
+        bandStats_[0].filled = resolveCells(0, cellCount());
+    } else {
+        runPhase(1);
+        runPhase(2);
+    }
+    for (const auto& b : bandStats_) {
+        stats_.points += b.points;
+        stats_.outside += b.outside;
+        stats_.filledCells += b.filled;
+    }
+}
+
+void WorldGridRasterizer::resetCells(size_t begin, size_t end) {
+    const float init = cfg_.mode == Mode::MinZ ? std::numeric_limits<float>::infinity()
+                     : cfg_.mode == Mode::MaxZ ? -std::numeric_limits<float>::infinity() : 0.0f;
+    std::fill(acc_.begin() + begin, acc_.begin() + end, init);
+    if (cfg_.mode == Mode::Mean) std::fill(accW_.begin() + begin, accW_.begin() + end, 0.0f);
+}
+
+inline void WorldGridRasterizer::accumulate(uint32_t cell, float z, float w) {
+    float& a = acc_[cell];
+    switch (cfg_.mode) {
+    case Mode::MinZ: a = z < a ? z : a; break;
+    case Mode::MaxZ: a = z > a ? z : a; break;
+    case Mode::Mean: a += w * z; accW_[cell] += w; break;
+    }
+}
+
+uint32_t WorldGridRasterizer::resolveCells(size_t begin, size_t end) {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    uint32_t filled = 0;
+    float* out = job_.out;
+    if (cfg_.mode == Mode::Mean) {
+        for (size_t i = begin; i < end; ++i) {
+            const float w = accW_[i];
+            const bool any = w > 0.0f;
+            out[i] = any ? acc_[i] / w : nan;
+            filled += any ? 1u : 0u;
+        }
+    } else {
+        for (size_t i = begin; i < end; ++i) {
+            const float a = acc_[i];
+            const bool any = std::isfinite(a);
+            out[i] = any ? a : nan;
+            filled += any ? 1u : 0u;
+        }
+    }
+    return filled;
+}
+
+void WorldGridRasterizer::scatterRows(int band) {
+    const Job& j = job_;
+    const int y0 = static_cast<int>(static_cast<int64_t>(j.height) * band / bands_);
+    const int y1 = static_cast<int>(static_cast<int64_t>(j.height) * (band + 1) / bands_);
+    const bool direct = bands_ == 1;
+    auto& bins = bins_[static_cast<size_t>(band)];
+    if (!direct) for (auto& b : bins) b.clear();
+    const float gw = static_cast<float>(cfg_.gridWidth), gh = static_cast<float>(cfg_.gridHeight);
+    const uint32_t W = static_cast<uint32_t>(cfg_.gridWidth);
+    const float invFx = j.perspective ? 1.0f / j.fx : 0.0f, invFy = j.perspective ? 1.0f / j.fy : 0.0f;
+    const float halfW = 0.5f * (j.width - 1), halfH = 0.5f * (j.height - 1);
+    BandStats& st = bandStats_[static_cast<size_t>(band)];
+    for (int v = y0; v < y1; ++v) {
+        const float* row = j.heights + static_cast<size_t>(v) * j.width;
+        const float* wrow = j.weights ? j.weights + static_cast<size_t>(v) * j.width : nullptr;
+        // Camera x/y are z times a per-column / per-row ray slope (perspective) or fixed (orthographic).
+        const float sy = j.perspective ? (v - j.cy) * invFy : (v - halfH) * j.orthoStep;
+        for (int u = 0; u < j.width; ++u) {
+            const float z = row[u];
+            if (!std::isfinite(z)) continue;
+            ++st.points;
+            const float sx = j.perspective ? (u - j.cx) * invFx : (u - halfW) * j.orthoStep;
+            const float xc = j.perspective ? sx * z : sx;
+            const float yc = j.perspective ? sy * z : sy;
+            const float gx = j.rx[0] * xc + j.rx[1] * yc + j.rx[2] * z + j.t[0];
+            const float gy = j.ry[0] * xc + j.ry[1] * yc + j.ry[2] * z + j.t[1];
+            if (!(gx >= 0.0f && gx < gw && gy >= 0.0f && gy < gh)) { ++st.outside; continue; }
+            const float wz = j.rz[0] * xc + j.rz[1] * yc + j.rz[2] * z + j.t[2];
+            const float w = wrow ? wrow[u] : 1.0f;
+            if (!(w > 0.0f)) continue;
+            const uint32_t cy = static_cast<uint32_t>(gy);
+            const uint32_t cell = cy * W + static_cast<uint32_t>(gx);
+            if (direct) accumulate(cell, wz, w);
+            else bins[cy / static_cast<uint32_t>(tileRows_)].push_back(Entry{cell, wz, w});
+        }
+    }
+}
+
+void WorldGridRasterizer::mergeTile(int tile) {
+    const size_t W = static_cast<size_t>(cfg_.gridWidth);
+    const size_t r0 = std::min<size_t>(static_cast<size_t>(tile) * tileRows_, cfg_.gridHeight);
+    const size_t r1 = std::min<size_t>(r0 + tileRows_, cfg_.gridHeight);
+    resetCells(r0 * W, r1 * W);
+    // Source bands in order keep the per-cell accumulation order equal to the single-band pass.
+    for (int band = 0; band < bands_; ++band) {
+        for (const Entry& e : bins_[static_cast<size_t>(band)][static_cast<size_t>(tile)]) accumulate(e.cell, e.z, e.w);
+    }
+    bandStats_[static_cast<size_t>(tile)].filled = resolveCells(r0 * W, r1 * W);
+}
+
+void WorldGridRasterizer::runPhase(int phase) {
+    common::ThreadPool::shared().parallel_for(0, bands_, 1, [&](int b0, int b1) {
+        for (int b = b0; b < b1; ++b) {
+            if (phase == 1) scatterRows(b); else mergeTile(b);
+        }
+    });
+}
+
+} // namespace caldera::backend::processing
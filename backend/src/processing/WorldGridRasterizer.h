@@ -0,0 +1,104 @@
+#ifndef CALDERA_BACKEND_PROCESSING_WORLD_GRID_RASTERIZER_H
+#define CALDERA_BACKEND_PROCESSING_WORLD_GRID_RASTERIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "processing/ProcessingTypes.h"
+
+namespace caldera::backend::processing {
+
+// Scatters one sensor's height image into a shared world XY grid, so sensors that each see a
+// different part of the sandbox produce pixel-aligned layers for FusionAccumulator.
+//
+// Pixel (u, v) with depth z (metres, NaN = invalid) is unprojected with the sensor's
+// TransformParameters: camera point ((u - cx) z / fx, (v - cy) z / fy, z) when intrinsics are set,
+// otherwise orthographic ((u - (w-1)/2) res, (v - (h-1)/2) res, z), so an uncalibrated sensor of
+// grid size maps 1:1 onto the grid. The pose (sensorRotationMatrix, sensorPosition) moves it to world
+// space; world x/y select the cell, world z is the value. Several points per cell resolve by mode:
+// z-buffer min, max, or a weighted mean (per-point weights optional, 1 otherwise).
+//
+// Parallel without atomics: source rows are split into bands and each band bins its points by
+// destination tile (a row band of the grid); then each tile merges the bins of every source band in
+// order. Both phases run on the shared ThreadPool. Points reach a cell in source order, so the result
+// is identical for any thread count.
+class WorldGridRasterizer {
+public:
+    enum class Mode { MinZ, MaxZ, Mean };
+
+    struct Config {
+        int gridWidth = 640;            // ProcessingConfig::heightMapWidth
+        int gridHeight = 480;           // ProcessingConfig::heightMapHeight
+        float resolution = 0.001f;      // metres per cell (ProcessingConfig::heightMapResolution)
+        // World x/y of the grid's (0,0) corner; NaN centres the grid on the world origin.
+        float originX = std::numeric_limits<float>::quiet_NaN();
+        float originY = std::numeric_limits<float>::quiet_NaN();
+        Mode mode = Mode::MinZ;
+        int threads = 0;                // <= 0: CALDERA_RASTER_THREADS or the shared pool's concurrency
+
+        // Grid size and resolution from heightMapWidth/Height/Resolution, centred on the world origin.
+        static Config fromProcessingConfig(const ProcessingConfig& pc);
+    };
+
+    struct Stats {
+        uint32_t points = 0;        // finite input points
+        uint32_t outside = 0;       // landed outside the grid
+        uint32_t filledCells = 0;   // cells that received at least one point
+    };
+
+    explicit WorldGridRasterizer(const Config& cfg);
+    WorldGridRasterizer(const WorldGridRasterizer&) = delete;
+    WorldGridRasterizer& operator=(const WorldGridRasterizer&) = delete;
+
+    // heights: width*height depths (metres, NaN invalid); weights optional (Mean only, <= 0 ignored).
+    // out receives gridWidth*gridHeight values, NaN for empty cells.
+    void rasterize(const float* heights, int width, int height, const TransformParameters& pose,
+                   float* out, const float* weights = nullptr);
+
+    static bool parseMode(const std::string& s, Mode& out); // "min" | "max" | "mean"
+
+    const Config& config() const { return cfg_; }
+    size_t cellCount() const { return static_cast<size_t>(cfg_.gridWidth) * static_cast<size_t>(cfg_.gridHeight); }
+    int threadCount() const { return threads_; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Entry { uint32_t cell; float z; float w; };
+    struct Job {
+        const float* heights = nullptr;
+        const float* weights = nullptr;
+        int width = 0;
+        int height = 0;
+        float* out = nullptr;
+        // Camera-to-grid mapping: cell coordinates are affine in the camera point.
+        float rx[3] = {0, 0, 0}, ry[3] = {0, 0, 0}, rz[3] = {0, 0, 0}, t[3] = {0, 0, 0};
+        bool perspective = false;
+        float fx = 1, fy = 1, cx = 0, cy = 0, orthoStep = 0;
+    };
+    struct BandStats { uint32_t points = 0; uint32_t outside = 0; uint32_t filled = 0; };
+
+    void scatterRows(int band);  // phase 1: source band -> bins_[band][tile] (or straight into acc_)
+    void mergeTile(int tile);    // phase 2: bins_[*][tile] -> accumulators -> out
+    void resetCells(size_t begin, size_t end);
+    void accumulate(uint32_t cell, float z, float w);
+    uint32_t resolveCells(size_t begin, size_t end);
+    void runPhase(int phase);
+
+    Config cfg_;
+    int threads_ = 1;
+    Job job_{};
+    Stats stats_{};
+    int bands_ = 1;        // source bands == destination tiles this frame
+    int tileRows_ = 0;     // grid rows per tile
+    std::vector<std::vector<std::vector<Entry>>> bins_; // [source band][tile], capacity reused
+    std::vector<float> acc_;   // min/max z, or sum(w*z)
+    std::vector<float> accW_;  // Mean: sum(w)
+    std::vector<BandStats> bandStats_;
+};
+
+} // namespace caldera::backend::processing
+
+#endif // CALDERA_BACKEND_PROCESSING_WORLD_GRID_RASTERIZER_H
@@ -0,0 +1,26 @@
+#pragma once
+#include "processing/stages/LambdaStage.h"
+#include <functional>
+#include <string>
+
+namespace caldera::backend::processing {
+
+// LambdaStage that can also run in row bands (TiledStageExecutor); see IProcessingStage::bandHalo.
+class BandLambdaStage : public LambdaStage {
+public:
+    struct BandOps {
+        std::function<int(const FrameContext&)> halo;                       // rows; < 0: whole frame only
+        std::function<void(FrameContext&, const StageBandIO&)> begin;       // optional
+        std::function<void(FrameContext&, uint32_t, uint32_t, const StageBandIO&, int)> band;
+        std::function<void(FrameContext&, const StageBandIO&)> end;         // optional
+    };
+    BandLambdaStage(std::string name, Fn fn, BandOps ops) : LambdaStage(std::move(name), std::move(fn)), ops_(std::move(ops)) {}
+    int bandHalo(const FrameContext& ctx) const override { return ops_.halo && ops_.band ? ops_.halo(ctx) : -1; }
+    void beginBands(FrameContext& ctx, const StageBandIO& io) override { if(ops_.begin) ops_.begin(ctx, io); }
+    void applyBand(FrameContext& ctx, uint32_t y0, uint32_t y1, const StageBandIO& io, int slot) override { ops_.band(ctx, y0, y1, io, slot); }
+    void endBands(FrameContext& ctx, const StageBandIO& io) override { if(ops_.end) ops_.end(ctx, io); }
+private:
+    BandOps ops_;
+};
+
+} // namespace caldera::backend::processing
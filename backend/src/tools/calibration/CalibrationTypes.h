@@ -73,6 +73,7 @@ struct SensorCalibrationProfile {
     float focalLengthY = 0.0f;
     float principalPointX = 0.0f;
     float principalPointY = 0.0f;
+    std::vector<float> distortionCoeffs;  // k1, k2, p1, p2, k3 (Brown-Conrady; missing = 0)
     
     // Validation bounds for processing
     PlaneEquation minValidPlane;  // Points above this are valid
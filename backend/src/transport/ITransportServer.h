@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "common/DataTypes.h"
+#include "common/WorldFramePool.h"
 
 namespace spdlog { class logger; }
 
@@ -15,6 +16,9 @@ public:
     virtual void start() = 0;
     virtual void stop() = 0;
     virtual void sendWorldFrame(const caldera::backend::common::WorldFrame& frame) = 0;
+    // Shared-ownership variant used by the processing pipeline (pooled, no payload copy).
+    // Servers that can retain the frame beyond the call may override; default publishes by reference.
+    virtual void sendWorldFrame(const caldera::backend::common::WorldFrameHandle& frame) { if (frame) sendWorldFrame(*frame); }
 };
 
 } // namespace caldera::backend::transport
@@ -32,6 +32,7 @@ public:
 
     void start() override;
     void stop() override;
+    using ITransportServer::sendWorldFrame;
     void sendWorldFrame(const caldera::backend::common::WorldFrame& frame) override;
 
     bool isClientAlive(std::chrono::milliseconds timeout) const; // heartbeat freshness
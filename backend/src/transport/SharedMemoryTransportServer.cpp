@@ -7,6 +7,7 @@
 #include <cstring>
 #include <cerrno>
 #include <chrono>
+#include <algorithm>
 #include "common/Logger.h"
 #include <memory>
 #include "common/Checksum.h"
@@ -84,33 +85,62 @@ bool SharedMemoryTransportServer::ensureMapped() {
 }
 
 void SharedMemoryTransportServer::sendWorldFrame(const caldera::backend::common::WorldFrame& frame) {
-    if (!running_) return;
-    if (!mapping_.get() && !ensureMapped()) return;
-    stats_.frames_attempted++;
     const auto& hm = frame.heightMap;
-    if (hm.width > static_cast<int>(cfg_.max_width) || hm.height > static_cast<int>(cfg_.max_height)) {
+    common::WorldFrameSlot slot = acquireWritableSlot(static_cast<uint32_t>(std::max(hm.width, 0)), static_cast<uint32_t>(std::max(hm.height, 0)));
+    if (!slot) return;
+    if (hm.data.size() > slot.capacity) { abandonWritableSlot(slot); ++stats_.frames_dropped_capacity; return; }
+    std::memcpy(slot.data, hm.data.data(), hm.data.size() * sizeof(float));
+    publishSlot(slot, common::WorldFrameSlotMeta{frame.frame_id, frame.timestamp_ns, static_cast<uint32_t>(hm.width), static_cast<uint32_t>(hm.height),
+                                                 static_cast<uint32_t>(hm.data.size()), frame.checksum}, false);
+}
+
+common::WorldFrameSlot SharedMemoryTransportServer::acquireWritableSlot(uint32_t width, uint32_t height) {
+    if (!running_) return {};
+    if (!mapping_.get() && !ensureMapped()) return {};
+    stats_.frames_attempted++;
+    if (width > cfg_.max_width || height > cfg_.max_height) {
         // Rate limited via central Logger singleton (once per 2s)
         caldera::backend::common::Logger::instance().warnRateLimited(logger_->name(), "shm_drop", std::chrono::milliseconds(2000),
-            fmt::format("Frame dimensions exceed shm capacity {}x{} vs {}x{} -> dropping", hm.width, hm.height, cfg_.max_width, cfg_.max_height));
+            fmt::format("Frame dimensions exceed shm capacity {}x{} vs {}x{} -> dropping", width, height, cfg_.max_width, cfg_.max_height));
         ++stats_.frames_dropped_capacity;
-        return;
+        return {};
     }
     auto* hdr = reinterpret_cast<ShmHeader*>(mapping_.get());
     uint32_t write_index = 1 - hdr->active_index; // flip buffer
+    hdr->buffers[write_index].ready = 0; // mark invalid while writing
+    slot_outstanding_ = true;
+    char* base = reinterpret_cast<char*>(mapping_.get()) + sizeof(ShmHeader) + write_index * single_buffer_bytes_;
+    return common::WorldFrameSlot{reinterpret_cast<float*>(base), single_buffer_bytes_ / sizeof(float), write_index};
+}
+
+bool SharedMemoryTransportServer::commitWritableSlot(const common::WorldFrameSlot& slot, const common::WorldFrameSlotMeta& meta) {
+    return publishSlot(slot, meta, true);
+}
+
+void SharedMemoryTransportServer::abandonWritableSlot(const common::WorldFrameSlot& slot) {
+    if (slot && slot_outstanding_) slot_outstanding_ = false; // back buffer stays ready=0; active buffer untouched
+}
+
+bool SharedMemoryTransportServer::publishSlot(const common::WorldFrameSlot& slot, const common::WorldFrameSlotMeta& m, bool direct) {
+    if (!running_ || !mapping_.get() || !slot || !slot_outstanding_) return false;
+    auto* hdr = reinterpret_cast<ShmHeader*>(mapping_.get());
+    const uint32_t write_index = slot.index;
+    slot_outstanding_ = false;
+    if (write_index != 1 - hdr->active_index) return false; // stale slot (not the current back buffer)
+    if (m.float_count > slot.capacity) { ++stats_.frames_dropped_capacity; return false; }
     BufferMeta &meta = hdr->buffers[write_index];
-    meta.ready = 0; // mark invalid while writing
-    meta.frame_id = frame.frame_id;
-    meta.timestamp_ns = frame.timestamp_ns;
-    meta.width = static_cast<uint32_t>(hm.width);
-    meta.height = static_cast<uint32_t>(hm.height);
-    meta.float_count = static_cast<uint32_t>(hm.data.size());
-    uint32_t cs = frame.checksum;
+    meta.frame_id = m.frame_id;
+    meta.timestamp_ns = m.timestamp_ns;
+    meta.width = m.width;
+    meta.height = m.height;
+    meta.float_count = m.float_count;
+    uint32_t cs = m.checksum;
     bool need_auto = (cs == 0);
-    if (cfg_.checksum_interval_ms > 0 && need_auto && !hm.data.empty()) {
+    if (cfg_.checksum_interval_ms > 0 && need_auto && m.float_count > 0) {
         uint64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
         uint64_t interval_ns = static_cast<uint64_t>(cfg_.checksum_interval_ms) * 1'000'000ULL;
         if (last_checksum_compute_ns_ == 0 || now_ns - last_checksum_compute_ns_ >= interval_ns) {
-            cs = caldera::backend::common::crc32(hm.data);
+            cs = caldera::backend::common::crc32(slot.data, m.float_count);
             last_checksum_compute_ns_ = now_ns;
         } else {
             cs = 0; // leave zero (interpreted as 'not computed')
@@ -120,9 +150,6 @@ void SharedMemoryTransportServer::sendWorldFrame(const caldera::backend::common:
         cs = 0;
     }
     meta.checksum = cs;
-    // compute buffer base
-    char* base = reinterpret_cast<char*>(mapping_.get()) + sizeof(ShmHeader) + write_index * single_buffer_bytes_;
-    std::memcpy(base, hm.data.data(), hm.data.size() * sizeof(float));
     __sync_synchronize();
     meta.ready = 1; // publish data
     __sync_synchronize();
@@ -130,7 +157,8 @@ void SharedMemoryTransportServer::sendWorldFrame(const caldera::backend::common:
 
     // Stats update
     stats_.frames_published++;
-    stats_.bytes_written += hm.data.size() * sizeof(float);
+    stats_.bytes_written += static_cast<uint64_t>(m.float_count) * sizeof(float);
+    if (direct) stats_.frames_direct_published++;
     // FPS estimate using simple EWMA over intervals (alpha=0.2)
     uint64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
     if (last_publish_ts_ns_ != 0) {
@@ -162,6 +190,7 @@ void SharedMemoryTransportServer::sendWorldFrame(const caldera::backend::common:
             logger_->debug("SHM wrote frame id={} idx={} size={}x{} floats={} active={}", meta.frame_id, write_index, meta.width, meta.height, meta.float_count, hdr->active_index);
         }
     }
+    return true;
 }
 
 } // namespace caldera::backend::transport
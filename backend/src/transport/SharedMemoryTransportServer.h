@@ -2,6 +2,7 @@
 #define CALDERA_BACKEND_TRANSPORT_SHARED_MEMORY_TRANSPORT_SERVER_H
 
 #include "ITransportServer.h"
+#include "common/WorldFrameSlot.h"
 #include "common/SensorResolutions.h"
 #include <memory>
 #include <string>
@@ -16,7 +17,9 @@ namespace caldera::backend::transport {
 
 // Simple shared memory writer (single-producer) for WorldFrame height map.
 // Not thread-safe beyond single writer usage pattern.
-class SharedMemoryTransportServer : public ITransportServer {
+// Besides sendWorldFrame (memcpy into the back buffer) it exposes the back buffer as a writable
+// slot so a producer can write the payload in place and commit only metadata.
+class SharedMemoryTransportServer : public ITransportServer, public common::IWorldFrameSlotSink {
 public:
     struct Config {
         std::string shm_name = "/caldera_worldframe"; // POSIX shm object name
@@ -34,7 +37,8 @@ public:
         uint64_t frames_attempted = 0;         // Total sendWorldFrame calls
         uint64_t frames_published = 0;          // Successfully written & made active
         uint64_t frames_dropped_capacity = 0;   // Dropped because frame dimensions exceed configured capacity
-        uint64_t bytes_written = 0;             // Payload bytes copied (floats * 4)
+        uint64_t bytes_written = 0;             // Payload bytes published (floats * 4)
+        uint64_t frames_direct_published = 0;   // Published via writable slot (producer wrote in place, no copy)
         double   last_publish_fps = 0.0;        // Approx instantaneous FPS (EWMA) of publishes
         uint64_t frames_verified = 0;           // (Future) optionally updated if reader feeds back verification metrics
     };
@@ -44,8 +48,13 @@ public:
 
     void start() override;
     void stop() override;
+    using ITransportServer::sendWorldFrame;
     void sendWorldFrame(const caldera::backend::common::WorldFrame& frame) override;
 
+    common::WorldFrameSlot acquireWritableSlot(uint32_t width, uint32_t height) override;
+    bool commitWritableSlot(const common::WorldFrameSlot& slot, const common::WorldFrameSlotMeta& meta) override;
+    void abandonWritableSlot(const common::WorldFrameSlot& slot) override;
+
     // Returns a copy of internal counters. Safe to call from tests after stopping producer.
     Stats snapshotStats() const { return stats_; }
 
@@ -58,6 +67,7 @@ private:
     static constexpr uint32_t kHardMaxHeight = 2048;
 
     bool ensureMapped();
+    bool publishSlot(const common::WorldFrameSlot& slot, const common::WorldFrameSlotMeta& meta, bool direct);
 
     std::shared_ptr<spdlog::logger> logger_;
     Config cfg_;
@@ -86,6 +96,7 @@ private:
     uint64_t last_checksum_compute_ns_ = 0; // monotonic time of last auto checksum
     mutable Stats stats_{}; // mutable to allow snapshot from const context
     uint64_t last_publish_ts_ns_ = 0; // for instantaneous FPS estimate
+    bool slot_outstanding_ = false; // back buffer handed out via acquireWritableSlot and not yet committed
 };
 
 } // namespace caldera::backend::transport
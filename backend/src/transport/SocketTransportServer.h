@@ -28,6 +28,7 @@ public:
 
     void start() override;
     void stop() override;
+    using ITransportServer::sendWorldFrame;
     void sendWorldFrame(const caldera::backend::common::WorldFrame& frame) override;
 
 private:
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include "processing/FusedBuildKernel.h"
+#include "processing/PlaneValidationTable.h"
+#include "common/DataTypes.h"
+
+using namespace caldera::backend::processing;
+using caldera::backend::common::Point3D;
+
+namespace {
+
+// Bytes moved per pixel by the former multi-pass sequence (AoS Point3D = 16 bytes):
+//  1) build cloud:          raw(2) + lo/hi(4) read, Point3D(16) written
+//  2) height/validity/mask: Point3D(16) read, height(4) + validity(1) + invalidMask(1) written
+//  3) cloudFiltered = cloudIn:  Point3D(16) read + Point3D(16) written
+//  4) write z back:         height(4) read, Point3D(16) read-modify-write (16+16)
+//  5) layerHeights copy:    Point3D(16) read (strided z), layerHeights(4) written
+constexpr size_t kLegacyBytesPerPixel = (2+4+16) + (16+4+1+1) + (16+16) + (4+16+16) + (16+4);
+
+struct LegacyBuffers {
+    std::vector<Point3D> cloudIn, cloudFiltered;
+    std::vector<float> height, layerHeights;
+    std::vector<uint8_t> validity, invalidMask;
+};
+
+void legacyMultiPass(const std::vector<uint16_t>& raw, uint32_t w, uint32_t h, float scale,
+                     const PlaneValidationTable& table, LegacyBuffers& b){
+    const size_t n=(size_t)w*h; const float qnan=std::numeric_limits<float>::quiet_NaN();
+    b.cloudIn.resize(n); b.height.resize(n); b.validity.resize(n); b.invalidMask.resize(n); b.layerHeights.resize(n);
+    for(size_t i=0;i<n;++i){
+        float wx=PlaneValidationTable::pixelWorldX((uint32_t)(i%w), w), wy=PlaneValidationTable::pixelWorldY((uint32_t)(i/w), h);
+        bool v=table.accepts(i, raw[i]);
+        b.cloudIn[i]= v? Point3D(wx,wy,raw[i]*scale,true) : Point3D(wx,wy,qnan,false);
+    }
+    for(size_t i=0;i<n;++i){ bool inv=!(b.cloudIn[i].valid && std::isfinite(b.cloudIn[i].z)); b.invalidMask[i]=inv; b.height[i]=inv? qnan : b.cloudIn[i].z; b.validity[i]=!inv; }
+    b.cloudFiltered = b.cloudIn;
+    for(size_t i=0;i<n;++i){ b.cloudFiltered[i].z=b.height[i]; b.cloudFiltered[i].valid=std::isfinite(b.height[i]); }
+    for(size_t i=0;i<n;++i) b.layerHeights[i]=b.cloudFiltered[i].z;
+}
+
+template<typename Fn>
+double msPerFrame(int frames, Fn&& fn){
+    auto t0=std::chrono::steady_clock::now();
+    for(int i=0;i<frames;++i) fn();
+    return std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-t0).count()/frames;
+}
+
+} // namespace
+
+TEST(BuildPassBenchmark, FusedKernelTouchesFewerBytesAndMatchesLegacy){
+    const uint32_t W=640, H=480; const float scale=0.001f; const int frames=20;
+    std::vector<uint16_t> raw((size_t)W*H);
+    for(uint32_t y=0;y<H;++y) for(uint32_t x=0;x<W;++x) raw[(size_t)y*W+x]=(uint16_t)(((x*37+y*11)%2600)); // includes 0 and out-of-band values
+    PlaneValidationTable table;
+    table.ensure(W,H,scale,{0.f,0.f,1.f,-0.5f},{0.f,0.f,1.f,-2.0f},true);
+
+    LegacyBuffers legacy;
+    std::vector<float> height((size_t)W*H); std::vector<uint8_t> validity((size_t)W*H);
+    legacyMultiPass(raw,W,H,scale,table,legacy);
+    FusedBuildCounts counts = fusedBuildHeightValidity(raw.data(), raw.size(), raw.size(), table.lo(), table.hi(), scale, height.data(), validity.data());
+
+    size_t legacyValid=0;
+    for(size_t i=0;i<raw.size();++i){
+        ASSERT_EQ(validity[i], legacy.validity[i]) << "i=" << i;
+        if(validity[i]){ ASSERT_EQ(std::memcmp(&height[i], &legacy.layerHeights[i], sizeof(float)), 0); ++legacyValid; }
+        else ASSERT_TRUE(std::isnan(height[i]) && std::isnan(legacy.layerHeights[i]));
+    }
+    EXPECT_EQ(counts.valid, legacyValid);
+    EXPECT_EQ(counts.valid + counts.invalid, raw.size());
+
+    const size_t legacyBytes = kLegacyBytesPerPixel * raw.size();
+    const size_t fusedBytes = fusedBuildBytesTouched(raw.size());
+    EXPECT_LT(fusedBytes * 5, legacyBytes); // fused pass moves well under a fifth of the former traffic
+
+    double legacyMs = msPerFrame(frames, [&]{ legacyMultiPass(raw,W,H,scale,table,legacy); });
+    double fusedMs  = msPerFrame(frames, [&]{ fusedBuildHeightValidity(raw.data(), raw.size(), raw.size(), table.lo(), table.hi(), scale, height.data(), validity.data()); });
+
+    std::cout << "[BUILD-BENCH] " << W << "x" << H
+              << " legacyBytes/frame=" << legacyBytes
+              << " fusedBytes/frame=" << fusedBytes
+              << " legacyMs=" << legacyMs
+              << " fusedMs=" << fusedMs << "\n";
+}
+
+TEST(BuildPassBenchmark, CorrectedKernelMatchesPerPixelCorrection){
+    const uint32_t W=640, H=480; const float scale=0.001f; const int frames=20;
+    const size_t n=(size_t)W*H;
+    std::vector<uint16_t> raw(n);
+    std::vector<float> gain(n), bias(n);
+    for(uint32_t y=0;y<H;++y) for(uint32_t x=0;x<W;++x){
+        const size_t i=(size_t)y*W+x;
+        raw[i]=(uint16_t)((x*37+y*11)%2600);
+        gain[i]=0.98f + 0.0001f*(float)((x*7+y*3)%400);
+        bias[i]=-3.0f + 0.01f*(float)((x+y)%600);
+    }
+    PlaneValidationTable table;
+    table.ensure(W,H,scale,{0.f,0.f,1.f,-0.5f},{0.f,0.f,1.f,-2.0f},true);
+
+    // Per-pixel reference in the DepthCorrector::correctPixel form, validated on the corrected value.
+    std::vector<float> refHeight(n); std::vector<uint8_t> refValidity(n);
+    auto perPixel=[&](const float* b){
+        size_t valid=0;
+        for(uint32_t y=0;y<H;++y) for(uint32_t x=0;x<W;++x){
+            const size_t i=(size_t)y*W+x;
+            const float c=b ? (float)raw[i]*gain[i]+b[i] : (float)raw[i]*gain[i];
+            const bool ok=raw[i]!=0 && c>=(float)table.lo()[i] && c<=(float)table.hi()[i];
+            refHeight[i]= ok ? c*scale : std::numeric_limits<float>::quiet_NaN();
+            refValidity[i]=ok; valid+=ok;
+        }
+        return valid;
+    };
+    std::vector<float> height(n); std::vector<uint8_t> validity(n);
+    const float* biasVariants[] = {bias.data(), nullptr}; // gain + offset, gain only
+    for(const float* b : biasVariants){
+        const size_t refValid=perPixel(b);
+        FusedBuildCounts counts = fusedBuildHeightValidityCorrected(raw.data(), raw.size(), n, table.lo(), table.hi(),
+                                                                    gain.data(), b, scale, height.data(), validity.data());
+        for(size_t i=0;i<n;++i){
+            ASSERT_EQ(validity[i], refValidity[i]) << "i=" << i;
+            if(validity[i]){
+                ASSERT_EQ(std::memcmp(&height[i], &refHeight[i], sizeof(float)), 0) << "i=" << i;
+            } else {
+                ASSERT_TRUE(std::isnan(height[i]));
+            }
+        }
+        EXPECT_EQ(counts.valid, refValid);
+        EXPECT_EQ(counts.valid + counts.invalid, n);
+    }
+
+    // Short raw buffer: the tail is invalid exactly as in the uncorrected pass.
+    FusedBuildCounts shortCounts = fusedBuildHeightValidityCorrected(raw.data(), n-100, n, table.lo(), table.hi(),
+                                                                     gain.data(), bias.data(), scale, height.data(), validity.data());
+    EXPECT_EQ(shortCounts.valid + shortCounts.invalid, n);
+    for(size_t i=n-100;i<n;++i){ ASSERT_EQ(validity[i], 0); ASSERT_TRUE(std::isnan(height[i])); }
+
+    double plainMs = msPerFrame(frames, [&]{ fusedBuildHeightValidity(raw.data(), raw.size(), n, table.lo(), table.hi(), scale, height.data(), validity.data()); });
+    double corrMs  = msPerFrame(frames, [&]{ fusedBuildHeightValidityCorrected(raw.data(), raw.size(), n, table.lo(), table.hi(), gain.data(), bias.data(), scale, height.data(), validity.data()); });
+    double refMs   = msPerFrame(frames, [&]{ perPixel(bias.data()); });
+    EXPECT_LT(corrMs, refMs * 2.0); // loose: timing noise on shared runners; the printed delta is the figure of merit
+
+    std::cout << "[BUILD-BENCH] corrected " << W << "x" << H
+              << " plainMs=" << plainMs
+              << " correctedMs=" << corrMs
+              << " correctionCostMs=" << (corrMs - plainMs)
+              << " perPixelMs=" << refMs << "\n";
+}
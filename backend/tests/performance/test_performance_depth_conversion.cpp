@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include "hal/DepthConversion.h"
+#include "common/SensorResolutions.h"
+
+using namespace caldera::backend::hal;
+
+namespace {
+
+const DepthConversionKernel kKernels[] = {DepthConversionKernel::Scalar, DepthConversionKernel::SSE2, DepthConversionKernel::AVX2};
+
+template<typename Fn>
+double msPerFrame(int frames, Fn&& fn){
+    auto t0=std::chrono::steady_clock::now();
+    for(int i=0;i<frames;++i) fn();
+    return std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-t0).count()/frames;
+}
+
+// Reference big-endian bit packer (layout of libfreenect's *_PACKED depth formats).
+std::vector<uint8_t> packBigEndian(const std::vector<uint16_t>& values, unsigned bits){
+    std::vector<uint8_t> out((values.size()*bits + 7)/8, 0);
+    size_t bit = 0;
+    for(uint16_t v : values){
+        for(unsigned b=0;b<bits;++b,++bit){
+            if((v >> (bits-1-b)) & 1u) out[bit/8] |= (uint8_t)(0x80u >> (bit%8));
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(DepthConversion, EdgeValuesAgreeAcrossKernels){
+    const float inf=std::numeric_limits<float>::infinity(), qnan=std::numeric_limits<float>::quiet_NaN();
+    // 37 entries: not a multiple of any vector width, so every tail path runs.
+    std::vector<float> src = {0.f, 0.4f, 0.99f, 1.f, 499.5f, 500.f, 4500.f, 4500.9f, 32767.f, 32768.f, 32768.5f,
+                              65534.9f, 65535.f, 65535.5f, 70000.f, 1e9f, inf, -0.f, -0.5f, -1.f, -70000.f, -inf, qnan,
+                              1234.f, 2345.f, 3456.f, 4567.f, 5678.f, 6789.f, 7890.f, 8901.f, 9012.f, 40000.f, 50000.f,
+                              60000.f, 65000.f, qnan};
+    const std::vector<uint16_t> expected = {0, 0, 0, 1, 499, 500, 4500, 4500, 32767, 32768, 32768,
+                                            65534, 65535, 65535, 65535, 65535, 65535, 0, 0, 0, 0, 0, 0,
+                                            1234, 2345, 3456, 4567, 5678, 6789, 7890, 8901, 9012, 40000, 50000,
+                                            60000, 65000, 0};
+    ASSERT_EQ(src.size(), expected.size());
+    for(DepthConversionKernel k : kKernels){
+        std::vector<uint16_t> dst(src.size(), 0xBEEF);
+        convertDepthFloatToU16(k, src.data(), dst.data(), src.size());
+        EXPECT_EQ(dst, expected) << depthConversionKernelName(k);
+    }
+    std::vector<uint16_t> dst(src.size(), 0xBEEF);
+    convertDepthFloatToU16(src.data(), dst.data(), src.size());
+    EXPECT_EQ(dst, expected);
+}
+
+TEST(DepthConversionBenchmark, SimdMatchesScalarOnKinectV2Frame){
+    namespace res = caldera::backend::common;
+    const size_t n = res::KinectV2::DEPTH_PIXEL_COUNT; // 512x424
+    const int frames = 200;
+    std::vector<float> src(n);
+    for(size_t i=0;i<n;++i){
+        // Mostly valid sand-table range with a sprinkling of zero / NaN / saturating samples.
+        const size_t r = (i*2654435761u) % 97;
+        src[i] = r==0 ? 0.f : r==1 ? std::numeric_limits<float>::quiet_NaN() : r==2 ? 80000.f : 500.f + (float)((i*37)%4000) + 0.25f*(float)(i%4);
+    }
+    std::vector<uint16_t> ref(n), out(n);
+    convertDepthFloatToU16(DepthConversionKernel::Scalar, src.data(), ref.data(), n);
+
+    std::cout << "[DEPTH-CONV-BENCH] " << res::KinectV2::DEPTH_WIDTH << "x" << res::KinectV2::DEPTH_HEIGHT
+              << " active=" << depthConversionKernelName(activeDepthConversionKernel());
+    for(DepthConversionKernel k : kKernels){
+        if(!depthConversionKernelSupported(k)) { std::cout << " " << depthConversionKernelName(k) << "=n/a"; continue; }
+        std::fill(out.begin(), out.end(), 0);
+        convertDepthFloatToU16(k, src.data(), out.data(), n);
+        ASSERT_EQ(out, ref) << depthConversionKernelName(k);
+        double ms = msPerFrame(frames, [&]{ convertDepthFloatToU16(k, src.data(), out.data(), n); });
+        std::cout << " " << depthConversionKernelName(k) << "Ms=" << ms;
+    }
+    std::cout << "\n";
+}
+
+TEST(DepthConversion, PackedUnpackMatchesReferenceAcrossKernels){
+    for(unsigned bits : {10u, 11u}){
+        const uint32_t maxRaw = (1u << bits) - 1u;
+        std::vector<uint16_t> lut(maxRaw + 1);
+        for(uint32_t r=0;r<=maxRaw;++r) lut[r] = (uint16_t)(r == maxRaw ? 0 : 400 + r*7);
+        for(size_t n : {size_t(1), size_t(7), size_t(8), size_t(15), size_t(16), size_t(33), size_t(1000), size_t(4099)}){
+            std::vector<uint16_t> raw(n);
+            for(size_t i=0;i<n;++i) raw[i] = (uint16_t)(i==0 ? maxRaw : (i*2654435761u) % (maxRaw+1));
+            const std::vector<uint8_t> packed = packBigEndian(raw, bits);
+            std::vector<uint16_t> expectMapped(n);
+            for(size_t i=0;i<n;++i) expectMapped[i] = lut[raw[i]];
+
+            PackedDepthUnpacker plain(bits), mapped(bits, lut.data());
+            ASSERT_EQ(plain.packedBytes(n), packed.size());
+            for(DepthConversionKernel k : kKernels){
+                std::vector<uint16_t> out(n, 0xBEEF);
+                plain.unpack(k, packed.data(), out.data(), n);
+                EXPECT_EQ(out, raw) << depthConversionKernelName(k) << " bits=" << bits << " n=" << n;
+                std::fill(out.begin(), out.end(), 0xBEEF);
+                mapped.unpack(k, packed.data(), out.data(), n);
+                EXPECT_EQ(out, expectMapped) << depthConversionKernelName(k) << " bits=" << bits << " n=" << n;
+            }
+        }
+    }
+}
+
+TEST(DepthConversionBenchmark, PackedElevenBitUnpackOnKinectV1Frame){
+    namespace res = caldera::backend::common;
+    const size_t n = res::KinectV1::PIXEL_COUNT; // 640x480
+    const int frames = 200;
+    std::vector<uint16_t> lut(2048);
+    for(uint32_t r=0;r<2047;++r){ // OpenKinect disparity fit; 2047 = no reading
+        const double denom = r * -0.0030711016 + 3.3309495161;
+        lut[r] = denom > 0 ? (uint16_t)std::min(65535.0, 1000.0 / denom) : 0;
+    }
+    std::vector<uint16_t> raw(n);
+    for(size_t i=0;i<n;++i) raw[i] = (uint16_t)((i*37) % 97 == 0 ? 2047 : 600 + (i*13) % 400);
+    const std::vector<uint8_t> packed = packBigEndian(raw, 11);
+    PackedDepthUnpacker unpacker(11, lut.data());
+    std::vector<uint16_t> ref(n), out(n);
+    unpacker.unpack(DepthConversionKernel::Scalar, packed.data(), ref.data(), n);
+
+    std::cout << "[PACKED-UNPACK-BENCH] " << res::KinectV1::WIDTH << "x" << res::KinectV1::HEIGHT
+              << " packedBytes=" << packed.size() << " unpackedBytes=" << n * sizeof(uint16_t)
+              << " active=" << depthConversionKernelName(activeDepthConversionKernel());
+    for(DepthConversionKernel k : {DepthConversionKernel::Scalar, DepthConversionKernel::AVX2}){
+        if(!depthConversionKernelSupported(k)) { std::cout << " " << depthConversionKernelName(k) << "=n/a"; continue; }
+        std::fill(out.begin(), out.end(), 0);
+        unpacker.unpack(k, packed.data(), out.data(), n);
+        ASSERT_EQ(out, ref) << depthConversionKernelName(k);
+        double ms = msPerFrame(frames, [&]{ unpacker.unpack(k, packed.data(), out.data(), n); });
+        std::cout << " " << depthConversionKernelName(k) << "Ms=" << ms;
+    }
+    std::cout << "\n";
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "processing/FusionAccumulator.h"
+
+using namespace caldera::backend::processing;
+
+namespace {
+
+// Straightforward per-pixel reference: loops over layers with branches, one pixel at a time.
+void referenceFuse(const std::vector<std::vector<float>>& h, const std::vector<std::vector<float>>& c,
+                   std::vector<float>& out, std::vector<float>& outConf){
+    const size_t n=h[0].size(); out.resize(n); outConf.resize(n);
+    for(size_t i=0;i<n;++i){
+        float sw=0, swh=0, swc=0, mz=std::numeric_limits<float>::infinity(); bool any=false;
+        for(size_t l=0;l<h.size();++l){
+            float v=h[l][i]; if(!std::isfinite(v)) continue;
+            any=true; mz=std::min(mz,v);
+            float w=std::clamp(c[l][i],0.0f,1.0f); sw+=w; swh+=w*v; swc+=w*w;
+        }
+        if(!any){ out[i]=0.0f; outConf[i]=0.0f; }
+        else if(sw>0){ out[i]=swh/sw; outConf[i]=swc/sw; }
+        else { out[i]=mz; outConf[i]=0.0f; }
+    }
+}
+
+template<typename Fn>
+double msPerFrame(int frames, Fn&& fn){
+    auto t0=std::chrono::steady_clock::now();
+    for(int i=0;i<frames;++i) fn();
+    return std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-t0).count()/frames;
+}
+
+} // namespace
+
+TEST(FusionBenchmark, WeightedFusionTwoFourEightLayers){
+    const int W=640, H=480, frames=20; const size_t N=(size_t)W*H;
+    for(int L : {2,4,8}){
+        std::vector<std::vector<float>> h(L, std::vector<float>(N)), c(L, std::vector<float>(N));
+        for(int l=0;l<L;++l) for(size_t i=0;i<N;++i){
+            h[l][i] = ((i*13+l*7)%61==0) ? std::nanf("") : 0.9f + 0.0005f*(float)((i*29+l*5)%400);
+            c[l][i] = (float)((i+3*l)%16)/15.0f;
+        }
+        std::vector<float> ref, refConf;
+        const double refMs=msPerFrame(frames,[&]{ referenceFuse(h,c,ref,refConf); });
+
+        // Layers are ingested once (addLayer copies them); fuse() can then be repeated for timing.
+        FusionAccumulator fusion;
+        std::vector<float> out, conf;
+        const double ingestMs=msPerFrame(frames,[&]{
+            fusion.beginFrame(1,W,H);
+            for(int l=0;l<L;++l) fusion.addLayer(FusionInputLayer{"S"+std::to_string(l), h[l].data(), c[l].data(), W,H});
+        });
+        fusion.setThreadCount(1);
+        fusion.fuse(out,&conf);
+        const double singleMs=msPerFrame(frames,[&]{ fusion.fuse(out,&conf); });
+        fusion.setThreadCount(0); // CALDERA_FUSION_THREADS or the shared pool's concurrency
+        fusion.fuse(out,&conf);   // warm the banded path
+        const double bandedMs=msPerFrame(frames,[&]{ fusion.fuse(out,&conf); });
+
+        ASSERT_EQ(out.size(), N);
+        size_t mismatches=0;
+        for(size_t i=0;i<N;++i) if(std::fabs(out[i]-ref[i])>1e-4f || std::fabs(conf[i]-refConf[i])>1e-4f) ++mismatches;
+        EXPECT_EQ(mismatches, 0u) << L << " layers";
+        EXPECT_EQ(fusion.stats().layerCount, (size_t)L);
+        // Timings are printed only: wall-clock comparisons flake on a loaded runner.
+        std::cout << "[FusionBenchmark] 640x480 " << L << " layers: reference " << refMs << " ms, ingest " << ingestMs
+                  << " ms, fuse 1 thread " << singleMs << " ms, " << fusion.threadCount() << " threads " << bandedMs << " ms" << std::endl;
+    }
+}
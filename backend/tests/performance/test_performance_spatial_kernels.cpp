@@ -3,13 +3,18 @@
 #include <vector>
 #include <numeric>
 #include <cstdlib>
+#include <cstring>
+#include <cmath>
 #include <spdlog/sinks/null_sink.h>
 #include <spdlog/logger.h>
 #include "processing/ProcessingManager.h"
+#include "processing/SpatialFilter.h"
 #include "common/DataTypes.h"
+#include "common/ThreadPool.h"
 
 using namespace caldera::backend::processing;
 using caldera::backend::common::RawDepthFrame;
+using caldera::backend::common::ThreadPool;
 
 static std::shared_ptr<spdlog::logger> makeBenchLogger(){
   auto sink = std::make_shared<spdlog::sinks::null_sink_st>();
@@ -80,3 +85,60 @@ TEST(SpatialKernelBenchmark, BasicComparativeTiming) {
               << "\n";
   }
 }
+
+// Former scalar SpatialFilter passes (per-tap isfinite branches and bounds checks), kept as the
+// reference for the blocked kernels: binomial weights of the given radius.
+static void referenceSeparable(std::vector<float>& buf, std::vector<float>& scratch, int w, int h, int radius){
+  std::vector<float> wt(2*radius+1); float c=1.f; for(int k=0;k<=2*radius;++k){ wt[k]=c; c=c*(2*radius-k)/(k+1); }
+  scratch.resize(buf.size());
+  for(int y=0;y<h;++y){ int off=y*w; for(int x=0;x<w;++x){ float cv=buf[off+x]; if(!std::isfinite(cv)){ scratch[off+x]=cv; continue; }
+    float acc=0.f, wsum=0.f; for(int dx=-radius; dx<=radius; ++dx){ int xx=x+dx; if(xx<0||xx>=w) continue; float v=buf[off+xx]; if(!std::isfinite(v)) continue; acc+=v*wt[dx+radius]; wsum+=wt[dx+radius]; }
+    scratch[off+x]= wsum>0? acc/wsum : cv; } }
+  for(int y=0;y<h;++y){ for(int x=0;x<w;++x){ float cv=scratch[y*w+x]; if(!std::isfinite(cv)){ buf[y*w+x]=cv; continue; }
+    float acc=0.f, wsum=0.f; for(int dy=-radius; dy<=radius; ++dy){ int yy=y+dy; if(yy<0||yy>=h) continue; float v=scratch[yy*w+x]; if(!std::isfinite(v)) continue; acc+=v*wt[dy+radius]; wsum+=wt[dy+radius]; }
+    buf[y*w+x]= wsum>0? acc/wsum : cv; } }
+}
+
+TEST(SpatialKernelBenchmark, BlockedKernelsMatchScalarReferenceAtVGA) {
+  const int W=640, H=480, frames=30;
+  // Speckled: a NaN in every block (masked path everywhere). Holes: a few clustered dropouts as in
+  // real depth frames (timed input; most blocks take the unmasked path).
+  std::vector<float> speckled((size_t)W*H), input((size_t)W*H);
+  for(size_t i=0;i<input.size();++i){
+    const float v = 0.5f + 0.001f*(float)((i*37)%400);
+    speckled[i] = (i%61==3 || i%487==0) ? std::nanf("") : v;
+    const int x=(int)(i%W), y=(int)(i/W);
+    const bool hole = (x-200)*(x-200)+(y-150)*(y-150) < 400 || (x>=600 && y<40) || (x==320 && y%7==0);
+    input[i] = hole ? std::nanf("") : v;
+  }
+  const struct { const char* alt; int radius; } kernels[] = {{"", 1}, {"wide5", 2}, {"wide7", 3}};
+  for(const auto& k : kernels){
+    if(*k.alt) setenv("CALDERA_SPATIAL_KERNEL_ALT", k.alt, 1); else unsetenv("CALDERA_SPATIAL_KERNEL_ALT");
+    SpatialFilter filter(true);
+    unsetenv("CALDERA_SPATIAL_KERNEL_ALT");
+    std::vector<float> a, b, scratch;
+    for(const auto* in : {&speckled, &input}){
+      a=*in; b=*in;
+      filter.apply(a, W, H);
+      referenceSeparable(b, scratch, W, H, k.radius);
+      ASSERT_EQ(std::memcmp(a.data(), b.data(), a.size()*sizeof(float)), 0) << "radius " << k.radius;
+    }
+
+    auto time=[&](auto&& fn){ auto t0=std::chrono::steady_clock::now(); for(int i=0;i<frames;++i){ a=input; fn(); }
+      return std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-t0).count()/frames; };
+    // One participant: the speedup is the kernel's alone, not the row bands spread over the pool.
+    const ThreadPool::Config restore = ThreadPool::Config::fromEnv();
+    ThreadPool::shared().configure(ThreadPool::Config{1, {}});
+    const double blockedMs = time([&]{ filter.apply(a, W, H); });
+    const double scalarMs = time([&]{ referenceSeparable(a, scratch, W, H, k.radius); });
+    ThreadPool::shared().configure(restore);
+    // Loose; the printed speedup is the figure of merit against a 4-8x target. On one SSE2 core this
+    // build measures roughly 3.7-3.9x at r=1, 4.0-4.3x at r=2 and 4.3-4.6x at r=3: the 3-tap kernel
+    // misses the 4x floor.
+    EXPECT_LT(blockedMs, scalarMs);
+    const double speedup = scalarMs/blockedMs;
+    std::cout << "[SPATIAL-BENCH] radius=" << k.radius << " " << W << "x" << H
+              << " blockedMs=" << blockedMs << " scalarMs=" << scalarMs
+              << " speedup=" << speedup << (speedup < 4.0 ? " (below 4x target)" : "") << "\n";
+  }
+}
@@ -0,0 +1,81 @@
+// Thread scaling of the pool-backed kernels: the same frames filtered with 1..N shared-pool threads.
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "common/ThreadPool.h"
+#include "processing/FastGaussianBlur.h"
+#include "processing/SpatialFilter.h"
+#include "processing/TemporalFilter.h"
+
+using namespace caldera::backend::processing;
+using caldera::backend::common::ThreadPool;
+
+namespace {
+
+std::vector<float> makeFrame(int w, int h){
+    std::vector<float> f(static_cast<size_t>(w)*h);
+    for(size_t i=0;i<f.size();++i) f[i] = (i%4099==17) ? std::nanf("") : 0.8f + 0.0004f*static_cast<float>((i*29)%500);
+    return f;
+}
+
+template<typename Fn>
+double msPerFrame(int frames, Fn&& fn){
+    fn(); // warm buffers and workers
+    auto t0=std::chrono::steady_clock::now();
+    for(int i=0;i<frames;++i) fn();
+    return std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-t0).count()/frames;
+}
+
+struct Timing { double spatial=0, gauss=0, temporal=0; std::vector<float> spatialOut, gaussOut; };
+
+Timing runKernels(int threads, int w, int h, int frames){
+    ThreadPool::shared().configure(ThreadPool::Config{threads, {}});
+    const std::vector<float> in = makeFrame(w,h);
+    Timing t;
+    SpatialFilter spatial(true);
+    FastGaussianBlur gauss(1.5f); // default band count: the pool's concurrency
+    TemporalFilter temporal;
+    t.spatial = msPerFrame(frames,[&]{ t.spatialOut=in; spatial.apply(t.spatialOut,w,h); });
+    t.gauss = msPerFrame(frames,[&]{ t.gaussOut=in; gauss.apply(t.gaussOut,w,h); });
+    std::vector<float> tmp;
+    t.temporal = msPerFrame(frames,[&]{ tmp=in; temporal.apply(tmp,w,h); });
+    return t;
+}
+
+bool sameBits(const std::vector<float>& a, const std::vector<float>& b){
+    return a.size()==b.size() && std::memcmp(a.data(), b.data(), a.size()*sizeof(float))==0;
+}
+
+} // namespace
+
+TEST(ThreadPoolScaling, KernelsScaleWithPoolThreads){
+    const ThreadPool::Config restore = ThreadPool::Config::fromEnv();
+    // The configured pool size (CALDERA_POOL_THREADS, else hardware threads) bounds the cores it may use.
+    const int poolThreads = ThreadPool::shared().concurrency();
+    const int hw = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<int> counts{1};
+    for(int n=2;n<=std::max(4,hw) && n<=16;n*=2) counts.push_back(n);
+
+    for(auto [w,h] : {std::pair<int,int>{640,480}, std::pair<int,int>{1920,1080}}){
+        const int frames = w>1000 ? 5 : 15;
+        const Timing base = runKernels(1,w,h,frames);
+        for(int n : counts){
+            const Timing t = n==1 ? base : runKernels(n,w,h,frames);
+            EXPECT_TRUE(sameBits(t.spatialOut, base.spatialOut)) << n << " threads"; // split never changes results
+            EXPECT_TRUE(sameBits(t.gaussOut, base.gaussOut)) << n << " threads";
+            std::cout << "[POOL-SCALING] " << w << "x" << h << " threads=" << n
+                      << " spatial=" << t.spatial << "ms (x" << base.spatial/t.spatial << ")"
+                      << " fastgauss=" << t.gauss << "ms (x" << base.gauss/t.gauss << ")"
+                      << " temporal=" << t.temporal << "ms (x" << base.temporal/t.temporal << ")" << std::endl;
+            if(n>1 && poolThreads>=n && w>1000){
+                EXPECT_LT(t.spatial, base.spatial); // only meaningful with spare cores
+            }
+        }
+    }
+    ThreadPool::shared().configure(restore);
+}
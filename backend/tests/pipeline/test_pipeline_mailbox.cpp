@@ -0,0 +1,116 @@
+// Capture -> processing hand-off: lock-free per-sensor mailboxes and the processing thread.
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "common/FrameMailbox.h"
+#include "common/DataTypes.h"
+#include "common/Logger.h"
+#include "processing/ProcessingManager.h"
+#include "processing/ProcessingWorker.h"
+
+using caldera::backend::common::MailboxPolicy;
+using caldera::backend::common::RawDepthFrame;
+using caldera::backend::common::SpscFrameMailbox;
+using caldera::backend::common::WorldFrame;
+using caldera::backend::processing::ProcessingManager;
+using caldera::backend::processing::ProcessingWorker;
+
+namespace {
+struct Seq { uint64_t id = 0; std::vector<uint16_t> payload; };
+}
+
+TEST(FrameMailbox, LatestWinsCoalescesAndKeepsNewest) {
+    SpscFrameMailbox<Seq> mb(MailboxPolicy::LatestWins);
+    for (uint64_t i = 1; i <= 5; ++i) mb.push([&](Seq& s){ s.id = i; });
+    uint64_t got = 0;
+    EXPECT_TRUE(mb.consume([&](Seq& s){ got = s.id; }));
+    EXPECT_EQ(got, 5u);
+    EXPECT_FALSE(mb.consume([&](Seq&){}));
+    auto st = mb.stats();
+    EXPECT_EQ(st.pushed, 5u);
+    EXPECT_EQ(st.consumed, 1u);
+    EXPECT_EQ(st.coalesced, 4u);
+    EXPECT_EQ(st.dropped, 0u);
+}
+
+TEST(FrameMailbox, BoundedQueueIsFifoAndDropsWhenFull) {
+    SpscFrameMailbox<Seq> mb(MailboxPolicy::BoundedQueue, 3);
+    for (uint64_t i = 1; i <= 5; ++i) mb.push([&](Seq& s){ s.id = i; });
+    std::vector<uint64_t> order;
+    while (mb.consume([&](Seq& s){ order.push_back(s.id); })) {}
+    EXPECT_EQ(order, (std::vector<uint64_t>{1, 2, 3}));
+    auto st = mb.stats();
+    EXPECT_EQ(st.dropped, 2u);
+    EXPECT_EQ(st.consumed, 3u);
+}
+
+TEST(FrameMailbox, ConcurrentProducerConsumerNeverTearsOrReorders) {
+    for (MailboxPolicy policy : {MailboxPolicy::LatestWins, MailboxPolicy::BoundedQueue}) {
+        SpscFrameMailbox<Seq> mb(policy, 4);
+        constexpr uint64_t kFrames = 20000;
+        std::atomic<bool> done{false};
+        std::thread producer([&]{
+            for (uint64_t i = 1; i <= kFrames; ++i)
+                mb.push([&](Seq& s){ s.id = i; s.payload.assign(64, static_cast<uint16_t>(i)); });
+            done = true;
+        });
+        uint64_t last = 0; bool ok = true;
+        auto check = [&](Seq& s){
+            if (s.id <= last) ok = false;
+            for (uint16_t v : s.payload) if (v != static_cast<uint16_t>(s.id)) ok = false;
+            last = s.id;
+        };
+        while (!done.load()) mb.consume(check);
+        while (mb.consume(check)) {}
+        producer.join();
+        EXPECT_TRUE(ok);
+        auto st = mb.stats();
+        EXPECT_EQ(st.pushed, kFrames);
+        EXPECT_EQ(st.consumed + st.coalesced + st.dropped, kFrames);
+        if (policy == MailboxPolicy::LatestWins) {
+            EXPECT_EQ(last, kFrames); // newest always delivered
+        }
+    }
+}
+
+TEST(ProcessingWorkerTest, CaptureNeverBlocksOnSlowProcessing) {
+    auto& logger = caldera::backend::common::Logger::instance();
+    if (!logger.isInitialized()) logger.initialize("logs/test/pipeline_mailbox.log");
+    auto pm = std::make_shared<ProcessingManager>(logger.get("Test.Mailbox.Proc"));
+    std::atomic<int> delivered{0};
+    pm->setWorldFrameCallback([&](const WorldFrame&){ std::this_thread::sleep_for(std::chrono::milliseconds(5)); ++delivered; });
+
+    ProcessingWorker::Config cfg; cfg.policy = MailboxPolicy::LatestWins;
+    ProcessingWorker worker(pm, cfg);
+    auto* lane = worker.addLane("mailbox_sensor");
+    ASSERT_NE(lane, nullptr);
+    worker.start();
+    EXPECT_EQ(worker.addLane("late"), nullptr); // lanes are fixed while running
+
+    RawDepthFrame f; f.sensorId = "mailbox_sensor"; f.width = 32; f.height = 24; f.data.assign(32 * 24, 1000);
+    constexpr int kFrames = 60;
+    std::chrono::nanoseconds worstSubmit{0};
+    for (int i = 0; i < kFrames; ++i) {
+        f.timestamp_ns = static_cast<uint64_t>(i);
+        auto t0 = std::chrono::steady_clock::now();
+        worker.submit(lane, f);
+        worstSubmit = std::max(worstSubmit, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0));
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    // Each processed frame takes >= 5 ms; submits must stay far below that.
+    EXPECT_LT(worstSubmit, std::chrono::milliseconds(3));
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!lane->empty() && std::chrono::steady_clock::now() < deadline) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20)); // let the in-flight frame finish
+    worker.stop();
+
+    auto st = worker.stats();
+    EXPECT_EQ(st.submitted, static_cast<uint64_t>(kFrames));
+    EXPECT_GT(st.coalesced, 0u);
+    EXPECT_EQ(st.processed + st.coalesced, st.submitted);
+    EXPECT_EQ(static_cast<uint64_t>(delivered.load()), st.processed);
+}
@@ -0,0 +1,85 @@
+// Shared work-stealing pool used by the processing kernels.
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "common/ThreadPool.h"
+
+using caldera::backend::common::ThreadPool;
+
+TEST(ThreadPool, CoversEveryIndexExactlyOnce) {
+    ThreadPool pool(ThreadPool::Config{4, {}});
+    EXPECT_EQ(pool.concurrency(), 4);
+    for (int grain : {1, 3, 16, 1000}) {
+        std::vector<std::atomic<int>> hits(997);
+        pool.parallel_for(0, 997, grain, [&](int b, int e) {
+            EXPECT_LE(e - b, grain);
+            for (int i = b; i < e; ++i) hits[i].fetch_add(1);
+        });
+        for (size_t i = 0; i < hits.size(); ++i) ASSERT_EQ(hits[i].load(), 1) << "grain " << grain << " index " << i;
+    }
+    int calls = 0;
+    pool.parallel_for(5, 5, 1, [&](int, int) { ++calls; });
+    EXPECT_EQ(calls, 0);
+}
+
+TEST(ThreadPool, NestedAndConcurrentCallsRunInline) {
+    ThreadPool pool(ThreadPool::Config{3, {}});
+    std::atomic<int> inner{0};
+    pool.parallel_for(0, 8, 1, [&](int b, int e) {
+        for (int i = b; i < e; ++i) {
+            const auto self = std::this_thread::get_id();
+            pool.parallel_for(0, 4, 1, [&](int ib, int ie) {
+                EXPECT_EQ(std::this_thread::get_id(), self); // nested: serial on the calling thread
+                inner.fetch_add(ie - ib);
+            });
+        }
+    });
+    EXPECT_EQ(inner.load(), 32);
+
+    // Two callers at once (e.g. two sensor lanes): neither blocks, both cover their ranges.
+    std::atomic<int> a{0}, b{0};
+    std::thread other([&] { for (int r = 0; r < 50; ++r) pool.parallel_for(0, 64, 4, [&](int x, int y) { a.fetch_add(y - x); }); });
+    for (int r = 0; r < 50; ++r) pool.parallel_for(0, 64, 4, [&](int x, int y) { b.fetch_add(y - x); });
+    other.join();
+    EXPECT_EQ(a.load(), 50 * 64);
+    EXPECT_EQ(b.load(), 50 * 64);
+}
+
+TEST(ThreadPool, ConfigureStatsAndEnv) {
+    ThreadPool pool(ThreadPool::Config{1, {}});
+    std::atomic<int> sum{0};
+    pool.parallel_for(0, 100, 10, [&](int b, int e) { sum.fetch_add(e - b); });
+    EXPECT_EQ(pool.stats().serialJobs, 1u); // no workers
+    pool.configure(ThreadPool::Config{2, {0}});
+    EXPECT_EQ(pool.concurrency(), 2);
+    pool.parallel_for(0, 100, 10, [&](int b, int e) { sum.fetch_add(e - b); });
+    pool.parallel_for(0, 100, 100, [&](int b, int e) { sum.fetch_add(e - b); }); // single chunk: inline
+    EXPECT_EQ(sum.load(), 300);
+    const auto st = pool.stats();
+    EXPECT_EQ(st.jobs, 1u);
+    EXPECT_EQ(st.serialJobs, 2u);
+
+    setenv("CALDERA_POOL_THREADS", "3", 1);
+    setenv("CALDERA_POOL_AFFINITY", "2,x,5", 1);
+    const auto cfg = ThreadPool::Config::fromEnv();
+    unsetenv("CALDERA_POOL_THREADS");
+    unsetenv("CALDERA_POOL_AFFINITY");
+    EXPECT_EQ(cfg.threads, 3);
+    EXPECT_EQ(cfg.cpus, (std::vector<int>{2, 5}));
+}
+
+TEST(ThreadPool, BandsDefaultToSharedConcurrency) {
+    const ThreadPool::Config restore = ThreadPool::Config::fromEnv();
+    ThreadPool::shared().configure(ThreadPool::Config{6, {}});
+    unsetenv("CALDERA_TEST_BANDS");
+    EXPECT_EQ(ThreadPool::bandsFromEnv("CALDERA_TEST_BANDS"), 6); // not capped below the pool size
+    setenv("CALDERA_TEST_BANDS", "2", 1);
+    EXPECT_EQ(ThreadPool::bandsFromEnv("CALDERA_TEST_BANDS"), 2);
+    setenv("CALDERA_TEST_BANDS", "0", 1);
+    EXPECT_EQ(ThreadPool::bandsFromEnv("CALDERA_TEST_BANDS"), 6);
+    unsetenv("CALDERA_TEST_BANDS");
+    ThreadPool::shared().configure(restore);
+}
@@ -4,6 +4,9 @@
 #include "common/Logger.h"
 #include "common/DataTypes.h"
 #include "tools/calibration/SensorCalibration.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
 #include <limits>
 
 using namespace caldera::backend::processing;
@@ -188,12 +191,12 @@ TEST_F(CoordinateTransformTest, TransformFrameWithCalibration) {
     EXPECT_TRUE(result);
     EXPECT_EQ(pointCloud.width, 2);
     EXPECT_EQ(pointCloud.height, 2);
-    EXPECT_EQ(pointCloud.points.size(), 4);
+    EXPECT_EQ(pointCloud.size(), 4);
     
     // Check that all points are valid
-    for (const auto& point : pointCloud.points) {
-        EXPECT_TRUE(point.valid);
-        EXPECT_GT(point.z, 0.0f); // All should have positive world Z
+    for (size_t i = 0; i < pointCloud.size(); ++i) {
+        EXPECT_TRUE(pointCloud.isValid(i));
+        EXPECT_GT(pointCloud.z[i], 0.0f); // All should have positive world Z
     }
 }
 
@@ -226,13 +229,13 @@ TEST_F(CoordinateTransformTest, TransformFrameWithInvalidPixels) {
     EXPECT_TRUE(result); // Should succeed since some pixels are valid
     EXPECT_EQ(pointCloud.width, 2);
     EXPECT_EQ(pointCloud.height, 2);
-    EXPECT_EQ(pointCloud.points.size(), 4);
+    EXPECT_EQ(pointCloud.size(), 4);
     
     // Check validity pattern
-    EXPECT_TRUE(pointCloud.points[0].valid);   // First pixel valid
-    EXPECT_FALSE(pointCloud.points[1].valid);  // Second pixel invalid (zero depth)
-    EXPECT_FALSE(pointCloud.points[2].valid);  // Third pixel invalid (negative depth)
-    EXPECT_TRUE(pointCloud.points[3].valid);   // Fourth pixel valid
+    EXPECT_TRUE(pointCloud.isValid(0));   // First pixel valid
+    EXPECT_FALSE(pointCloud.isValid(1));  // Second pixel invalid (zero depth)
+    EXPECT_FALSE(pointCloud.isValid(2));  // Third pixel invalid (negative depth)
+    EXPECT_TRUE(pointCloud.isValid(3));   // Fourth pixel valid
 }
 
 TEST_F(CoordinateTransformTest, TransformFrameAllInvalidPixels) {
@@ -264,8 +267,8 @@ TEST_F(CoordinateTransformTest, TransformFrameAllInvalidPixels) {
     EXPECT_FALSE(result); // Should fail since no pixels are valid
     
     // Check that all points are marked invalid
-    for (const auto& point : pointCloud.points) {
-        EXPECT_FALSE(point.valid);
+    for (size_t i = 0; i < pointCloud.size(); ++i) {
+        EXPECT_FALSE(pointCloud.isValid(i));
     }
 }
 
@@ -360,6 +363,51 @@ TEST_F(CoordinateTransformTest, PlaneBasedValidationWithAngledPlane) {
     EXPECT_TRUE(center.valid) << "Center point should be valid with angled plane";
 }
 
+TEST_F(CoordinateTransformTest, BatchFrameMatchesPerPixelTransform) {
+    CoordinateTransform transform;
+    SensorCalibrationProfile calibProfile;
+    calibProfile.sensorId = "test-kinect-v1";
+    calibProfile.sensorType = "kinect-v1";
+    calibProfile.basePlaneCalibration.basePlane.a = 0.0f;
+    calibProfile.basePlaneCalibration.basePlane.b = 0.0f;
+    calibProfile.basePlaneCalibration.basePlane.c = 1.0f;
+    calibProfile.basePlaneCalibration.basePlane.d = -0.5f;  // valid band 0.65m .. 1.45m
+    ASSERT_TRUE(transform.loadFromCalibration(calibProfile));
+    ASSERT_TRUE(transform.rayTable().matches(640, 480)); // built for the native resolution
+
+    const int W = 640, H = 480;
+    DepthFrame depthFrame;
+    depthFrame.width = W;
+    depthFrame.height = H;
+    depthFrame.data.resize(static_cast<size_t>(W) * H);
+    const float samples[7] = {900.0f, 0.0f, 1200.0f, 600.0f, std::numeric_limits<float>::quiet_NaN(), 1500.0f, -50.0f};
+    for (size_t i = 0; i < depthFrame.data.size(); ++i) depthFrame.data[i] = samples[(i * 7 + i / W) % 7];
+
+    InternalPointCloud batch;
+    ASSERT_TRUE(transform.transformFrameToWorld(depthFrame, batch)); // sizes the cloud
+    const auto t0 = std::chrono::steady_clock::now();
+    ASSERT_TRUE(transform.transformFrameToWorld(depthFrame, batch));
+    const double batchMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    size_t mismatches = 0, valid = 0;
+    const auto t1 = std::chrono::steady_clock::now();
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            const size_t i = static_cast<size_t>(y) * W + x;
+            const Point3D ref = transform.transformPixelToWorld(x, y, depthFrame.data[i]);
+            valid += ref.valid ? 1 : 0;
+            if (ref.valid != batch.isValid(i) || std::fabs(ref.x - batch.x[i]) > 1e-5f ||
+                std::fabs(ref.y - batch.y[i]) > 1e-5f || std::fabs(ref.z - batch.z[i]) > 1e-5f) ++mismatches;
+        }
+    }
+    const double pixelMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t1).count();
+    EXPECT_EQ(mismatches, 0u);
+    EXPECT_EQ(batch.validCount(), valid);
+    EXPECT_GT(valid, 0u);
+    EXPECT_LT(batchMs, pixelMs);
+    std::cout << "[CoordinateTransform] 640x480 batch " << batchMs << " ms, per-pixel " << pixelMs << " ms" << std::endl;
+}
+
 // Integration test - only runs if calibration file exists
 TEST_F(CoordinateTransformTest, DISABLED_LoadRealCalibrationProfile) {
     CoordinateTransform transform;
@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
 #include "processing/DepthCorrector.h"
+#include "processing/ProcessingManager.h"
 #include "common/Logger.h"
 #include "tools/calibration/SensorCalibration.h"
 
@@ -140,6 +144,109 @@ TEST_F(DepthCorrectorTest, HandlesOutOfBoundsPixels) {
     EXPECT_FLOAT_EQ(corrector.correctPixel(320, 480, 1000.0f), 1000.0f);
 }
 
+TEST_F(DepthCorrectorTest, CreateProfileReadsCoefficientLayouts) {
+    SensorCalibrationProfile calibProfile;
+    calibProfile.sensorType = "kinect-v2";
+    calibProfile.hasDepthCorrection = true;
+    const size_t pixels = 512 * 424;
+
+    // Per-pixel factors.
+    calibProfile.depthCorrectionCoeffs.assign(pixels, 1.0f);
+    calibProfile.depthCorrectionCoeffs[7] = 1.05f;
+    auto factors = DepthCorrector::createProfile("v2", calibProfile);
+    ASSERT_TRUE(factors.isValid);
+    EXPECT_FLOAT_EQ(factors.pixelCorrections[7], 1.05f);
+    EXPECT_TRUE(factors.pixelOffsets.empty());
+
+    // Interleaved (factor, offset) pairs.
+    calibProfile.depthCorrectionCoeffs.assign(2 * pixels, 0.0f);
+    for (size_t i = 0; i < pixels; ++i) {
+        calibProfile.depthCorrectionCoeffs[2 * i] = 1.0f;
+        calibProfile.depthCorrectionCoeffs[2 * i + 1] = (i == 9) ? -4.0f : 0.0f;
+    }
+    auto pairs = DepthCorrector::createProfile("v2", calibProfile);
+    ASSERT_TRUE(pairs.isValid);
+    ASSERT_EQ(pairs.pixelOffsets.size(), pixels);
+    EXPECT_FLOAT_EQ(pairs.pixelCorrections[9], 1.0f);
+    EXPECT_FLOAT_EQ(pairs.pixelOffsets[9], -4.0f);
+
+    // Radial polynomial 1 + 0.01 r^2: exactly 1 at the center, 1.02 in the corner (r = sqrt(2)).
+    calibProfile.depthCorrectionCoeffs = {1.0f, 0.0f, 0.01f};
+    auto radial = DepthCorrector::createProfile("v2", calibProfile);
+    ASSERT_TRUE(radial.isValid);
+    EXPECT_FLOAT_EQ(radial.pixelCorrections[212 * 512 + 256], 1.0f);
+    EXPECT_NEAR(radial.pixelCorrections[0], 1.02f, 1e-5f);
+
+    // Anything else is rejected.
+    calibProfile.depthCorrectionCoeffs.assign(100, 1.0f);
+    EXPECT_FALSE(DepthCorrector::createProfile("v2", calibProfile).isValid);
+}
+
+TEST_F(DepthCorrectorTest, CorrectFrameMatchesCorrectPixel) {
+    SensorCalibrationProfile calibProfile;
+    calibProfile.sensorType = "kinect-v1";
+    calibProfile.hasDepthCorrection = true;
+    const size_t pixels = 640 * 480;
+    calibProfile.depthCorrectionCoeffs.resize(2 * pixels);
+    for (size_t i = 0; i < pixels; ++i) {
+        calibProfile.depthCorrectionCoeffs[2 * i] = 0.97f + 0.0001f * static_cast<float>(i % 600);
+        calibProfile.depthCorrectionCoeffs[2 * i + 1] = (i % 3 == 0) ? -2.5f : 1.25f;
+    }
+    DepthCorrector corrector;
+    corrector.setProfile(DepthCorrector::createProfile("test", calibProfile));
+    ASSERT_TRUE(corrector.isReady());
+
+    RawDepthFrame frame;
+    frame.width = 640;
+    frame.height = 480;
+    frame.data.resize(pixels);
+    for (size_t i = 0; i < pixels; ++i) frame.data[i] = static_cast<uint16_t>((i * 13) % 4096); // includes zeros
+    frame.data[1] = 65535; // clamps instead of wrapping
+    frame.data[2] = 1;     // 0.97 - 2.5 clamps at zero
+    const std::vector<uint16_t> input = frame.data;
+
+    corrector.correctFrame(frame);
+    for (size_t i = 0; i < pixels; ++i) {
+        const int x = static_cast<int>(i % 640), y = static_cast<int>(i / 640);
+        float expected = input[i] == 0 ? 0.0f
+                       : std::min(std::max(std::round(corrector.correctPixel(x, y, input[i])), 0.0f), 65535.0f);
+        ASSERT_EQ(frame.data[i], static_cast<uint16_t>(expected)) << "i=" << i;
+    }
+}
+
+TEST_F(DepthCorrectorTest, CorrectStageAppliesProfileInBuildPass) {
+    setenv("CALDERA_PROCESSING_PIPELINE", "correct,build,fusion", 1);
+    ProcessingManager mgr(nullptr);
+    unsetenv("CALDERA_PROCESSING_PIPELINE");
+    TransformParameters tp; // accept 0.5 m .. 1.5 m
+    tp.minValidPlane = {0.f, 0.f, 1.f, -0.5f};
+    tp.maxValidPlane = {0.f, 0.f, 1.f, -1.5f};
+    mgr.setTransformParameters(tp);
+
+    auto corr = std::make_shared<CorrectionProfile>();
+    corr->resize(4, 2);
+    corr->pixelCorrections = {1.0f, 1.1f, 0.4f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+    corr->pixelOffsets = {0.0f, 0.0f, 0.0f, 20.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    corr->isValid = true;
+    mgr.setDepthCorrection("", corr);
+
+    WorldFrame last;
+    mgr.setWorldFrameCallback([&](const WorldFrame& f) { last = f; });
+    RawDepthFrame raw;
+    raw.sensorId = "Corr";
+    raw.width = 4;
+    raw.height = 2;
+    raw.data = {1000, 1000, 1000, 1000, 1000, 1000, 0, 1000};
+    mgr.processRawDepthFrame(raw);
+    ASSERT_EQ(last.heightMap.data.size(), 8u);
+    EXPECT_NEAR(last.heightMap.data[0], 1.0f, 1e-6f);
+    EXPECT_NEAR(last.heightMap.data[1], 1.1f, 1e-6f);
+    EXPECT_FLOAT_EQ(last.heightMap.data[2], 0.0f); // corrected to 0.4 m: below the min plane
+    EXPECT_NEAR(last.heightMap.data[3], 1.02f, 1e-6f);
+    EXPECT_FLOAT_EQ(last.heightMap.data[6], 0.0f);
+    EXPECT_EQ(mgr.lastValidationSummary().invalid, 2u);
+}
+
 // Integration test - only runs if calibration file exists
 TEST_F(DepthCorrectorTest, DISABLED_LoadRealCalibrationProfile) {
     DepthCorrector corrector;
@@ -8,6 +8,8 @@
 #include <cmath>
 #include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <limits>
 
 using namespace caldera::backend::processing;
 
@@ -230,4 +232,39 @@ TEST_F(FastGaussianBlurTest, IntegrationWithProcessingManager) {
     for (size_t i = 0; i < testData.size(); i++) {
         EXPECT_FLOAT_EQ(testData[i], directBlur[i]) << "Interface and direct usage should match";
     }
-}
\ No newline at end of file
+}
+TEST_F(FastGaussianBlurTest, HolesDoNotContaminateNeighbours) {
+    const int w = 96, h = 80;
+    std::vector<float> data(w * h, 0.5f);
+    for (int y = 30; y < 40; y++) for (int x = 20; x < 34; x++) data[y * w + x] = std::nanf("");
+    data[5 * w + 70] = std::numeric_limits<float>::infinity();
+
+    FastGaussianBlur blur(2.0f, 1);
+    blur.apply(data, w, h);
+    for (int i = 0; i < w * h; i++) {
+        const int x = i % w, y = i / w;
+        const bool hole = (y >= 30 && y < 40 && x >= 20 && x < 34);
+        if (hole) { EXPECT_TRUE(std::isnan(data[i])) << x << "," << y; continue; } // holes are not filled
+        if (i == 5 * w + 70) { EXPECT_TRUE(std::isinf(data[i])); continue; }
+        EXPECT_NEAR(data[i], 0.5f, 1e-5f) << x << "," << y; // normalized: valid neighbours only
+    }
+}
+
+TEST_F(FastGaussianBlurTest, OutputIndependentOfThreadCount) {
+    const int w = 640, h = 480;
+    std::vector<float> input(static_cast<size_t>(w) * h);
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = (i % 97 == 5) ? std::nanf("") : 0.8f + 0.0004f * static_cast<float>((i * 31) % 500);
+    }
+    for (int round = 0; round < 2; round++) {
+        if (round == 1) for (float& v : input) if (std::isnan(v)) v = 1.0f; // no holes: single-plane path
+        std::vector<float> a = input, b = input;
+        FastGaussianBlur one(1.5f, 1), four(1.5f, 4);
+        EXPECT_EQ(four.threadCount(), 4);
+        one.apply(a, w, h);
+        four.apply(b, w, h);
+        b = input;
+        four.apply(b, w, h); // reused workers and buffers
+        EXPECT_EQ(std::memcmp(a.data(), b.data(), a.size() * sizeof(float)), 0) << "round " << round;
+    }
+}
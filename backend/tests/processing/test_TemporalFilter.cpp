@@ -27,14 +27,14 @@ protected:
         InternalPointCloud cloud;
         cloud.width = width;
         cloud.height = height;
-        cloud.points.resize(width * height);
+        cloud.resize(width, height);
         cloud.timestamp_ns = 1000;  // Mock timestamp
         
-        for (size_t i = 0; i < cloud.points.size() && i < heights.size(); ++i) {
-            cloud.points[i].x = float(i % width);
-            cloud.points[i].y = float(i / width);
-            cloud.points[i].z = heights[i];
-            cloud.points[i].valid = (heights[i] != -1.0f); // -1.0f = invalid
+        for (size_t i = 0; i < cloud.size() && i < heights.size(); ++i) {
+            cloud.x[i] = float(i % width);
+            cloud.y[i] = float(i / width);
+            cloud.z[i] = heights[i];
+            cloud.setValid(i, heights[i] != -1.0f); // -1.0f = invalid
         }
         
         return cloud;
@@ -79,7 +79,7 @@ TEST_F(TemporalFilterTest, SingleFrameProcessing) {
     // Check output structure
     EXPECT_EQ(outputCloud.width, width);
     EXPECT_EQ(outputCloud.height, height);
-    EXPECT_EQ(outputCloud.points.size(), width * height);
+    EXPECT_EQ(outputCloud.size(), width * height);
     EXPECT_EQ(outputCloud.timestamp_ns, inputCloud.timestamp_ns);
     
     // After single frame, no pixels should be stable yet (need minNumSamples)
@@ -129,8 +129,8 @@ TEST_F(TemporalFilterTest, HysteresisFiltering) {
     filter->processFrame(inputCloud, outputCloud);
     
     // Output should retain previous values due to hysteresis
-    for (size_t i = 0; i < outputCloud.points.size(); ++i) {
-        EXPECT_NEAR(outputCloud.points[i].z, 1.0f, 0.01f) 
+    for (size_t i = 0; i < outputCloud.size(); ++i) {
+        EXPECT_NEAR(outputCloud.z[i], 1.0f, 0.01f) 
             << "Pixel " << i << " should retain previous value due to hysteresis";
     }
     
@@ -161,10 +161,10 @@ TEST_F(TemporalFilterTest, InvalidPixelHandling) {
     filter->processFrame(inputCloud, outputCloud);
     
     // Check that invalid pixels are handled correctly
-    for (size_t i = 0; i < outputCloud.points.size(); ++i) {
-        if (!inputCloud.points[i].valid) {
+    for (size_t i = 0; i < outputCloud.size(); ++i) {
+        if (!inputCloud.isValid(i)) {
             // Invalid input pixels should use previous valid value (initially 0.0)
-            EXPECT_EQ(outputCloud.points[i].z, 0.0f);
+            EXPECT_EQ(outputCloud.z[i], 0.0f);
         }
     }
 }
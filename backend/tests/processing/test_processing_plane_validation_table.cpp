@@ -0,0 +1,122 @@
+#include "processing/PlaneValidationTable.h"
+#include "processing/UnprojectionRayTable.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+
+using namespace caldera::backend::processing;
+
+namespace {
+// Exhaustively compare table bounds with the reference float evaluation for every raw value.
+void expectMatchesReference(uint32_t w, uint32_t h, float scale,
+                            const PlaneValidationTable::Plane& minP, const PlaneValidationTable::Plane& maxP){
+    PlaneValidationTable table;
+    ASSERT_TRUE(table.ensure(w,h,scale,minP,maxP,true));
+    size_t mismatches=0;
+    for(uint32_t y=0;y<h;++y){
+        float wy=PlaneValidationTable::pixelWorldY(y,h);
+        for(uint32_t x=0;x<w;++x){
+            float wx=PlaneValidationTable::pixelWorldX(x,w);
+            size_t idx=(size_t)y*w+x;
+            for(uint32_t r=0;r<=65535;++r){
+                bool ref=PlaneValidationTable::evaluate(wx,wy,(uint16_t)r,scale,minP,maxP);
+                if(ref!=table.accepts(idx,(uint16_t)r)) ++mismatches;
+            }
+        }
+    }
+    EXPECT_EQ(mismatches, 0u);
+}
+}
+
+TEST(PlaneValidationTable, FlatBandMatchesReferenceIncludingBoundaries){
+    expectMatchesReference(4,3,0.001f,{0.f,0.f,1.f,-0.5f},{0.f,0.f,1.f,-2.0f});
+    PlaneValidationTable t; t.ensure(1,1,0.001f,{0.f,0.f,1.f,-0.5f},{0.f,0.f,1.f,-2.0f},true);
+    EXPECT_FALSE(t.accepts(0,0));
+    EXPECT_FALSE(t.accepts(0,499));
+    EXPECT_TRUE(t.accepts(0,500));
+    EXPECT_TRUE(t.accepts(0,2000));
+    EXPECT_FALSE(t.accepts(0,2001));
+}
+
+TEST(PlaneValidationTable, TiltedAndInvertedPlanesMatchReference){
+    // Tilted band (depends on wx/wy) and planes with negative z coefficients.
+    expectMatchesReference(9,7,0.001f,{0.01f,-0.02f,1.f,-0.6f},{-0.015f,0.005f,1.f,-1.7f});
+    expectMatchesReference(5,5,0.0013f,{0.f,0.003f,-1.f,1.9f},{0.002f,0.f,-1.f,0.4f});
+    // z-independent planes: all-or-nothing per pixel.
+    expectMatchesReference(6,2,0.001f,{1.f,0.f,0.f,0.f},{0.f,0.f,1.f,-3.0f});
+}
+
+TEST(PlaneValidationTable, EmptyIntervalAndDisabledPlanes){
+    PlaneValidationTable t;
+    t.ensure(2,2,0.001f,{0.f,0.f,1.f,-2.0f},{0.f,0.f,1.f,-1.0f},true); // min above max -> nothing valid
+    for(uint32_t r=0;r<=65535;++r) ASSERT_FALSE(t.accepts(3,(uint16_t)r));
+    t.ensure(2,2,0.001f,{0.f,0.f,1.f,-2.0f},{0.f,0.f,1.f,-1.0f},false); // planes disabled -> any non-zero depth
+    EXPECT_FALSE(t.accepts(0,0));
+    EXPECT_TRUE(t.accepts(0,1));
+    EXPECT_TRUE(t.accepts(0,65535));
+}
+
+TEST(PlaneValidationTable, RebuildsOnlyWhenInputsChange){
+    PlaneValidationTable t;
+    PlaneValidationTable::Plane minP{0.f,0.f,1.f,-0.5f}, maxP{0.f,0.f,1.f,-2.0f};
+    EXPECT_TRUE(t.ensure(8,8,0.001f,minP,maxP,true));
+    EXPECT_FALSE(t.ensure(8,8,0.001f,minP,maxP,true));
+    EXPECT_TRUE(t.ensure(8,8,0.002f,minP,maxP,true));
+    maxP[3]=-1.5f;
+    EXPECT_TRUE(t.ensure(8,8,0.002f,minP,maxP,true));
+    EXPECT_TRUE(t.ensure(16,8,0.002f,minP,maxP,true));
+    EXPECT_EQ(t.rebuildCount(), 4u);
+}
+
+TEST(PlaneValidationTable, RayGeometryMatchesReference){
+    // Pinhole sensor 0.3 m off-centre, rolled a little: every pixel gets its own folded plane.
+    TransformParameters tp;
+    tp.focalLengthX=5.f; tp.focalLengthY=4.f; tp.principalPointX=2.f; tp.principalPointY=1.5f;
+    const float c=std::cos(0.1f), s=std::sin(0.1f);
+    const float R[9]={c,-s,0.f, s,c,0.f, 0.f,0.f,1.f};
+    std::copy(R,R+9,tp.sensorRotationMatrix);
+    tp.sensorPosition.x=0.3f; tp.sensorPosition.z=0.05f;
+    UnprojectionRayTable rays;
+    ASSERT_TRUE(rays.ensure(5,4,tp));
+    const PlaneValidationTable::Plane minP{0.02f,-0.05f,1.f,-0.6f}, maxP{-0.1f,0.04f,1.f,-1.7f};
+    PlaneValidationTable table;
+    ASSERT_TRUE(table.ensure(5,4,0.001f,minP,maxP,true,&rays));
+    size_t mismatches=0, accepted=0;
+    for(size_t idx=0; idx<20; ++idx){
+        for(uint32_t r=0;r<=65535;++r){
+            bool ref=PlaneValidationTable::evaluateRay(rays,idx,(uint16_t)r,0.001f,minP,maxP);
+            if(ref!=table.accepts(idx,(uint16_t)r)) ++mismatches;
+            accepted += ref ? 1 : 0;
+        }
+    }
+    EXPECT_EQ(mismatches, 0u);
+    EXPECT_GT(accepted, 0u);
+    // Centre ray looks straight down z: the flat band is 0.55 m .. 1.65 m of depth there.
+    PlaneValidationTable flat;
+    flat.ensure(5,4,0.001f,{0.f,0.f,1.f,-0.6f},{0.f,0.f,1.f,-1.7f},true,&rays);
+    const size_t centre = 1*5 + 2;
+    EXPECT_FALSE(flat.accepts(centre,549));
+    EXPECT_TRUE(flat.accepts(centre,551));
+    EXPECT_TRUE(flat.accepts(centre,1649));
+    EXPECT_FALSE(flat.accepts(centre,1651));
+}
+
+TEST(PlaneValidationTable, RebuildsWhenRayTableChanges){
+    TransformParameters tp;
+    tp.focalLengthX=tp.focalLengthY=100.f; tp.principalPointX=3.5f; tp.principalPointY=3.5f;
+    UnprojectionRayTable rays;
+    rays.ensure(8,8,tp);
+    PlaneValidationTable t;
+    PlaneValidationTable::Plane minP{0.f,0.f,1.f,-0.5f}, maxP{0.f,0.f,1.f,-2.0f};
+    EXPECT_TRUE(t.ensure(8,8,0.001f,minP,maxP,true,&rays));
+    EXPECT_FALSE(t.ensure(8,8,0.001f,minP,maxP,true,&rays));
+    EXPECT_FALSE(rays.ensure(8,8,tp));            // same geometry: rays and bounds kept
+    EXPECT_FALSE(t.ensure(8,8,0.001f,minP,maxP,true,&rays));
+    tp.sensorPosition.z=0.1f;
+    EXPECT_TRUE(rays.ensure(8,8,tp));
+    EXPECT_TRUE(t.ensure(8,8,0.001f,minP,maxP,true,&rays));
+    EXPECT_TRUE(t.ensure(8,8,0.001f,minP,maxP,true));   // back to the pixel grid
+    UnprojectionRayTable other; other.ensure(4,4,tp);  // size mismatch -> pixel grid, no rebuild
+    EXPECT_FALSE(t.ensure(8,8,0.001f,minP,maxP,true,&other));
+    EXPECT_EQ(t.rebuildCount(), 3u);
+}
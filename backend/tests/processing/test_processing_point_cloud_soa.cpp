@@ -0,0 +1,35 @@
+#include "processing/ProcessingTypes.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+using namespace caldera::backend::processing;
+
+TEST(InternalPointCloudSoA, ValidityBitsPackAcrossWordBoundaries){
+    InternalPointCloud c;
+    c.resize(13,11); // 143 px -> 3 words, last one partial
+    EXPECT_EQ(c.size(), 143u);
+    EXPECT_EQ(c.validBits.size(), 3u);
+    EXPECT_EQ(c.validCount(), 0u);
+    for(size_t i : {0u, 63u, 64u, 127u, 128u, 142u}) c.setValid(i,true);
+    EXPECT_EQ(c.validCount(), 6u);
+    EXPECT_TRUE(c.isValid(63));
+    EXPECT_TRUE(c.isValid(64));
+    EXPECT_FALSE(c.isValid(65));
+    c.setValid(64,false);
+    EXPECT_FALSE(c.isValid(64));
+    EXPECT_EQ(c.validCount(), 5u);
+    c.clearValid();
+    EXPECT_EQ(c.validCount(), 0u);
+}
+
+TEST(InternalPointCloudSoA, PointAccessorsRoundTrip){
+    InternalPointCloud c;
+    c.resize(2,2);
+    c.setPoint(3, caldera::backend::common::Point3D(1.f,2.f,3.f,true));
+    auto p = c.point(3);
+    EXPECT_FLOAT_EQ(p.x,1.f);
+    EXPECT_FLOAT_EQ(p.y,2.f);
+    EXPECT_FLOAT_EQ(p.z,3.f);
+    EXPECT_TRUE(p.valid);
+    EXPECT_FALSE(c.point(0).valid);
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "processing/ProcessingManager.h"
+#include "common/DataTypes.h"
+#include "hal/FrameSet.h"
+
+using namespace caldera::backend::processing;
+using namespace caldera::backend::common;
+using caldera::backend::hal::FrameSet;
+using caldera::backend::hal::RawDepthFrameHandle;
+
+namespace {
+RawDepthFrameHandle makeDepth(const std::string& id, int w, int h, uint16_t d, uint64_t ts) {
+    auto f = std::make_shared<RawDepthFrame>();
+    f->sensorId = id; f->width = w; f->height = h; f->timestamp_ns = ts;
+    f->data.assign(static_cast<size_t>(w) * h, d);
+    return f;
+}
+
+FrameSet makeSet(uint64_t id, std::vector<RawDepthFrameHandle> depth) {
+    FrameSet set;
+    set.id = id;
+    set.depth = std::move(depth);
+    set.color.assign(set.depth.size(), nullptr);
+    for (const auto& d : set.depth) set.present += d ? 1 : 0;
+    return set;
+}
+
+// Stateful temporal filter: outputs the first frame it saw forever and counts its calls per
+// instance. Shared state between sensors would leak one sensor's heights into the other's layer.
+class LatchFilter : public IHeightMapFilter {
+public:
+    LatchFilter(std::atomic<int>* clones, std::atomic<int>* applies, int index = 0)
+        : clones_(clones), applies_(applies), index_(index) {}
+    void apply(std::vector<float>& data, int, int) override {
+        applies_[index_].fetch_add(1);
+        if (latched_.empty()) latched_ = data; else data = latched_;
+    }
+    std::shared_ptr<IHeightMapFilter> clone() const override {
+        const int index = clones_->fetch_add(1) + 1;
+        return std::make_shared<LatchFilter>(clones_, applies_, index);
+    }
+private:
+    std::atomic<int>* clones_;
+    std::atomic<int>* applies_;
+    int index_;
+    std::vector<float> latched_;
+};
+} // namespace
+
+TEST(ProcessingSensorLanes, ConcurrentSensorsMeetAtFusionBarrier) {
+    setenv("CALDERA_FUSION_BARRIER_TIMEOUT_MS", "2000", 1);
+    ProcessingManager mgr(nullptr);
+    unsetenv("CALDERA_FUSION_BARRIER_TIMEOUT_MS");
+    // One joint round makes both sensors known, so from then on each waits for the other.
+    mgr.processFrameSet(makeSet(1, {makeDepth("LaneA", 8, 4, 500, 1), makeDepth("LaneB", 8, 4, 800, 1)}));
+    std::mutex m;
+    std::vector<size_t> sizes;
+    mgr.setWorldFrameCallback([&](const WorldFrame& f) { std::lock_guard<std::mutex> lk(m); sizes.push_back(f.heightMap.data.size()); });
+    auto feed = [&](const char* id, uint16_t depth) {
+        for (int i = 0; i < 20; ++i) mgr.processRawDepthFrame(*makeDepth(id, 8, 4, depth, 1000 + i));
+    };
+    std::thread a(feed, "LaneA", 500), b(feed, "LaneB", 800);
+    a.join(); b.join();
+    EXPECT_EQ(mgr.sensorLaneCount(), 2u);
+    EXPECT_EQ(mgr.fusionBarrierTimeouts(), 0u);
+    // Every round fused both layers onto the shared W x H grid.
+    ASSERT_EQ(sizes.size(), 20u);
+    for (size_t n : sizes) EXPECT_EQ(n, 32u);
+}
+
+TEST(ProcessingSensorLanes, FrameSetFusesOncePerSetWithoutWaitingForMissingSensors) {
+    ProcessingManager mgr(nullptr);
+    std::vector<size_t> sizes;
+    std::vector<uint64_t> stamps;
+    mgr.setWorldFrameCallback([&](const WorldFrame& f) { sizes.push_back(f.heightMap.data.size()); stamps.push_back(f.timestamp_ns); });
+    mgr.processFrameSet(makeSet(1, {makeDepth("SetA", 8, 4, 500, 10), makeDepth("SetB", 8, 4, 800, 12)}));
+    const auto t0 = std::chrono::steady_clock::now();
+    mgr.processFrameSet(makeSet(2, {makeDepth("SetA", 8, 4, 500, 20), nullptr}));
+    const auto partialMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    mgr.processFrameSet(makeSet(3, {makeDepth("SetA", 8, 4, 500, 30), makeDepth("SetB", 8, 4, 800, 31)}));
+    ASSERT_EQ(sizes.size(), 3u);
+    EXPECT_EQ(sizes[0], 32u); // both layers fused
+    EXPECT_EQ(sizes[1], 32u); // SetA alone
+    EXPECT_EQ(sizes[2], 32u);
+    EXPECT_EQ(stamps[0], 12u); // newest member
+    EXPECT_EQ(mgr.fusionBarrierTimeouts(), 0u);
+    EXPECT_LT(partialMs, 30.0);
+}
+
+TEST(ProcessingSensorLanes, TemporalStateIsPerSensor) {
+    std::atomic<int> clones{0};
+    std::atomic<int> applies[2] = {{0}, {0}};
+    // Confidence-weighted fusion with metrics: layer weights come from each lane, not from the
+    // previous fused frame, so the fused output of a repeated input does not change after frame 0.
+    setenv("CALDERA_PROCESSING_STABILITY_METRICS", "1", 1);
+    setenv("CALDERA_ENABLE_CONFIDENCE_MAP", "1", 1);
+    ProcessingManager mgr(nullptr);
+    unsetenv("CALDERA_PROCESSING_STABILITY_METRICS");
+    unsetenv("CALDERA_ENABLE_CONFIDENCE_MAP");
+    mgr.setHeightMapFilter(std::make_shared<LatchFilter>(&clones, applies));
+    std::vector<float> last;
+    mgr.setWorldFrameCallback([&](const WorldFrame& f) { last = f.heightMap.data; });
+    mgr.processFrameSet(makeSet(1, {makeDepth("TmpA", 4, 2, 500, 1), makeDepth("TmpB", 4, 2, 800, 1)}));
+    const std::vector<float> first = last;
+    for (uint64_t i = 2; i < 6; ++i) {
+        mgr.processFrameSet(makeSet(i, {makeDepth("TmpA", 4, 2, 600, i), makeDepth("TmpB", 4, 2, 900, i)}));
+    }
+    EXPECT_EQ(clones.load(), 1); // first lane uses the injected instance, the second a clone
+    EXPECT_EQ(applies[0].load(), 5); // each instance only ever sees its own sensor
+    EXPECT_EQ(applies[1].load(), 5);
+    ASSERT_EQ(last.size(), 8u);
+    EXPECT_EQ(last, first);          // each lane still outputs its own first frame
+}
+
+TEST(ProcessingSensorLanes, FrameSetThroughputScalesWithSensors) {
+    setenv("CALDERA_ENABLE_SPATIAL_FILTER", "1", 1);
+    const int W = 640, H = 480, frames = 20;
+    double perSet[3] = {0, 0, 0};
+    const int counts[3] = {1, 2, 4};
+    for (int c = 0; c < 3; ++c) {
+        ProcessingManager mgr(nullptr);
+        std::vector<RawDepthFrameHandle> depth;
+        for (int s = 0; s < counts[c]; ++s) depth.push_back(makeDepth("Scale" + std::to_string(s), W, H, static_cast<uint16_t>(900 + 50 * s), 1));
+        const FrameSet set = makeSet(1, depth);
+        mgr.processFrameSet(set); // warm up lanes and helper threads
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; ++i) mgr.processFrameSet(set);
+        perSet[c] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / frames;
+        EXPECT_EQ(mgr.fusionBarrierTimeouts(), 0u);
+    }
+    unsetenv("CALDERA_ENABLE_SPATIAL_FILTER");
+    std::cout << "[SensorLanes] 640x480 per set: 1 sensor " << perSet[0] << " ms, 2 sensors " << perSet[1]
+              << " ms, 4 sensors " << perSet[2] << " ms" << std::endl;
+    if (std::thread::hardware_concurrency() >= 4) {
+        EXPECT_LT(perSet[2], perSet[0] * 2.5); // serialized lanes would take ~4x
+    }
+}
@@ -0,0 +1,204 @@
+// Row-band tiled execution of the build -> temporal -> spatial prefix (CALDERA_PROCESSING_TILED).
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/DataTypes.h"
+#include "common/ThreadPool.h"
+#include "processing/ProcessingManager.h"
+#include "processing/ProcessingTypes.h"
+#include "processing/TemporalFilter.h"
+#include "processing/TiledStageExecutor.h"
+#include "processing/stages/BandLambdaStage.h"
+
+using namespace caldera::backend::processing;
+using caldera::backend::common::RawDepthFrame;
+using caldera::backend::common::ThreadPool;
+
+namespace {
+
+// Pointwise stage: writes y*1000+x and counts how often each row is produced.
+std::unique_ptr<IProcessingStage> seedStage(std::vector<std::atomic<int>>* visits) {
+    BandLambdaStage::BandOps ops;
+    ops.halo = [](const FrameContext&) { return 0; };
+    ops.band = [visits](FrameContext& ctx, uint32_t y0, uint32_t y1, const StageBandIO& io, int) {
+        for (uint32_t y = y0; y < y1; ++y) {
+            if (visits) (*visits)[y].fetch_add(1);
+            for (uint32_t x = 0; x < ctx.width; ++x) io.dst[y * ctx.width + x] = static_cast<float>(y * 1000 + x);
+        }
+    };
+    return std::make_unique<BandLambdaStage>("seed", [](FrameContext& ctx) {
+        for (uint32_t y = 0; y < ctx.heightPx; ++y)
+            for (uint32_t x = 0; x < ctx.width; ++x) ctx.height[y * ctx.width + x] = static_cast<float>(y * 1000 + x);
+    }, std::move(ops));
+}
+
+// Vertical box of radius r, clamped at the frame edge.
+void boxRows(const float* src, float* dst, uint32_t w, uint32_t h, int r, uint32_t y0, uint32_t y1) {
+    for (uint32_t y = y0; y < y1; ++y)
+        for (uint32_t x = 0; x < w; ++x) {
+            float s = 0.f;
+            for (int d = -r; d <= r; ++d) {
+                const int yy = std::min<int>(static_cast<int>(h) - 1, std::max(0, static_cast<int>(y) + d));
+                s += src[yy * w + x] * (d == 0 ? 3.f : 1.f);
+            }
+            dst[y * w + x] = s;
+        }
+}
+
+std::unique_ptr<IProcessingStage> boxStage(int r) {
+    BandLambdaStage::BandOps ops;
+    ops.halo = [r](const FrameContext&) { return r; };
+    ops.band = [r](FrameContext& ctx, uint32_t y0, uint32_t y1, const StageBandIO& io, int) {
+        ASSERT_NE(io.src, io.dst);
+        boxRows(io.src, io.dst, ctx.width, ctx.heightPx, r, y0, y1);
+    };
+    return std::make_unique<BandLambdaStage>("box", [r](FrameContext& ctx) {
+        std::vector<float> out(ctx.height.size());
+        boxRows(ctx.height.data(), out.data(), ctx.width, ctx.heightPx, r, 0, ctx.heightPx);
+        ctx.height.swap(out);
+    }, std::move(ops));
+}
+
+struct Frame {
+    std::vector<float> height;
+    std::vector<uint8_t> validity;
+    AdaptiveState adaptive;
+    TransformParameters transform;
+    FrameContext ctx;
+    Frame(uint32_t w, uint32_t h) : height(static_cast<size_t>(w) * h), ctx{height, validity, nullptr, nullptr, adaptive, transform, w, h, 0} {}
+};
+
+RawDepthFrame makeRaw(int w, int h, int frame) {
+    RawDepthFrame f; f.sensorId = "tiled"; f.width = w; f.height = h; f.timestamp_ns = 1000u * frame;
+    f.data.resize(static_cast<size_t>(w) * h);
+    for (size_t i = 0; i < f.data.size(); ++i) {
+        const uint16_t base = static_cast<uint16_t>(900 + (i * 37 + frame * 11) % 120);
+        f.data[i] = (i % 211 == 5) ? 0 : base; // scattered holes
+    }
+    return f;
+}
+
+// ratios (optional): spatial variance / edge preservation ratios per frame, with stability metrics on.
+std::vector<std::vector<float>> runManager(bool tiled, const char* altKernel, int frames, std::vector<uint32_t>& valid,
+                                           std::vector<std::pair<float, float>>* ratios = nullptr) {
+    setenv("CALDERA_ENABLE_SPATIAL_FILTER", "1", 1);
+    if (ratios) setenv("CALDERA_PROCESSING_STABILITY_METRICS", "1", 1);
+    if (tiled) setenv("CALDERA_PROCESSING_TILED", "1", 1); else unsetenv("CALDERA_PROCESSING_TILED");
+    if (altKernel) setenv("CALDERA_SPATIAL_KERNEL_ALT", altKernel, 1); else unsetenv("CALDERA_SPATIAL_KERNEL_ALT");
+    setenv("CALDERA_TILE_ROWS", "8", 1); // read when the sensor lane is created
+    ProcessingManager mgr(nullptr);
+    TemporalFilter::FilterConfig temporal;
+    temporal.minNumSamples = 2; // heights from the second frame on (default: 10 frames of zeros)
+    mgr.setHeightMapFilter(std::make_shared<TemporalFilter>(temporal));
+    std::vector<std::vector<float>> out;
+    mgr.setWorldFrameCallback([&](const caldera::backend::common::WorldFrame& f) { out.push_back(f.heightMap.data); });
+    for (int i = 0; i < frames; ++i) {
+        mgr.processRawDepthFrame(makeRaw(96, 70, i));
+        valid.push_back(static_cast<uint32_t>(mgr.lastValidationSummary().valid));
+        if (ratios) ratios->emplace_back(mgr.lastStabilityMetrics().spatialVarianceRatio, mgr.lastStabilityMetrics().spatialEdgePreservationRatio);
+    }
+    unsetenv("CALDERA_ENABLE_SPATIAL_FILTER");
+    unsetenv("CALDERA_PROCESSING_STABILITY_METRICS");
+    unsetenv("CALDERA_PROCESSING_TILED");
+    unsetenv("CALDERA_SPATIAL_KERNEL_ALT");
+    unsetenv("CALDERA_TILE_ROWS");
+    return out;
+}
+
+} // namespace
+
+TEST(TiledStageExecutor, BandsMatchWholeFrameAndRunEachRowOnce) {
+    const ThreadPool::Config restore = ThreadPool::Config::fromEnv();
+    ThreadPool::shared().configure(ThreadPool::Config{4, {}});
+    const uint32_t w = 13, h = 101;
+    Frame ref(w, h);
+    std::vector<std::unique_ptr<IProcessingStage>> refStages;
+    refStages.push_back(seedStage(nullptr));
+    refStages.push_back(boxStage(2));
+    refStages.push_back(boxStage(1));
+    for (auto& s : refStages) s->apply(ref.ctx);
+
+    for (int blocks : {1, 3, 4}) {
+        for (uint32_t bandRows : {1u, 7u, 64u}) {
+            std::vector<std::atomic<int>> visits(h);
+            std::vector<std::unique_ptr<IProcessingStage>> stages;
+            stages.push_back(seedStage(&visits));
+            stages.push_back(boxStage(2));
+            stages.push_back(boxStage(1));
+            stages.push_back(std::make_unique<LambdaStage>("fusion", [](FrameContext&) {}));
+            Frame f(w, h);
+            ASSERT_EQ(TiledStageExecutor::bandablePrefix(stages, f.ctx), 3u);
+            TiledStageExecutor exec(TiledStageExecutor::Config{bandRows, blocks});
+            exec.run(stages, 3, f.ctx);
+            exec.run(stages, 3, f.ctx); // planes reused across frames
+            EXPECT_EQ(f.height, ref.height) << "blocks=" << blocks << " bandRows=" << bandRows;
+            for (uint32_t y = 0; y < h; ++y) ASSERT_EQ(visits[y].load(), 2) << "row " << y;
+            const auto st = exec.stats();
+            EXPECT_EQ(st.frames, 2u);
+            if (blocks == 1 || bandRows * 2 > h) {
+                EXPECT_EQ(st.boundaryBands, 0u); // one block per bandRows at most
+            } else {
+                EXPECT_GT(st.boundaryBands, 0u);
+            }
+        }
+    }
+    ThreadPool::shared().configure(restore);
+}
+
+TEST(TiledStageExecutor, ManagerTiledMatchesStageLoop) {
+    const ThreadPool::Config restore = ThreadPool::Config::fromEnv();
+    ThreadPool::shared().configure(ThreadPool::Config{3, {}});
+    std::vector<uint32_t> validA, validB;
+    const auto plain = runManager(false, nullptr, 4, validA);
+    const auto tiled = runManager(true, nullptr, 4, validB);
+    ASSERT_EQ(plain.size(), 4u);
+    ASSERT_EQ(tiled.size(), plain.size());
+    EXPECT_EQ(validA, validB);
+    for (size_t i = 0; i < plain.size(); ++i) {
+        ASSERT_EQ(plain[i].size(), tiled[i].size());
+        // Classic kernel and temporal filter are exact per row: bitwise equal (NaN positions included).
+        EXPECT_EQ(0, std::memcmp(plain[i].data(), tiled[i].data(), plain[i].size() * sizeof(float))) << "frame " << i;
+    }
+
+    validA.clear(); validB.clear();
+    const auto plainFast = runManager(false, "fastgauss", 3, validA);
+    const auto tiledFast = runManager(true, "fastgauss", 3, validB);
+    ASSERT_EQ(tiledFast.size(), plainFast.size());
+    EXPECT_EQ(validA, validB);
+    for (size_t i = 0; i < plainFast.size(); ++i) {
+        ASSERT_EQ(plainFast[i].size(), tiledFast[i].size());
+        for (size_t p = 0; p < plainFast[i].size(); ++p) {
+            const float a = plainFast[i][p], b = tiledFast[i][p];
+            ASSERT_EQ(std::isnan(a), std::isnan(b)) << "frame " << i << " px " << p;
+            if (!std::isnan(a)) {
+                ASSERT_NEAR(a, b, 1e-5f) << "frame " << i << " px " << p; // running sums restart per tile
+            }
+        }
+    }
+    ThreadPool::shared().configure(restore);
+}
+
+TEST(TiledStageExecutor, ManagerTiledSpatialMetricsMatchStageLoop) {
+    // Pre-filter samples are gathered per band from the rows the earlier stages just produced, so the
+    // metrics describe this frame like the whole-frame path does (not the previous frame's output).
+    const ThreadPool::Config restore = ThreadPool::Config::fromEnv();
+    ThreadPool::shared().configure(ThreadPool::Config{3, {}});
+    std::vector<uint32_t> validA, validB;
+    std::vector<std::pair<float, float>> plain, tiled;
+    runManager(false, nullptr, 4, validA, &plain);
+    runManager(true, nullptr, 4, validB, &tiled);
+    ASSERT_EQ(plain.size(), 4u);
+    EXPECT_EQ(plain, tiled);
+    for (size_t i = 1; i < plain.size(); ++i) { // frame 0 is all zeros (temporal warm-up)
+        EXPECT_GT(plain[i].first, 0.f) << "frame " << i;
+        EXPECT_LT(plain[i].first, 1.f) << "frame " << i; // smoothing reduces the variance
+        EXPECT_GT(plain[i].second, 0.f) << "frame " << i;
+    }
+    ThreadPool::shared().configure(restore);
+}
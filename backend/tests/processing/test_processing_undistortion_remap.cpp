@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "processing/UndistortionRemap.h"
+#include "processing/ProcessingManager.h"
+#include "common/DataTypes.h"
+
+using namespace caldera::backend::processing;
+using namespace caldera::backend::common;
+
+namespace {
+TransformParameters lens(int w, int h, float k1, float k2 = 0.0f, float p1 = 0.0f, float p2 = 0.0f) {
+    TransformParameters p;
+    p.focalLengthX = p.focalLengthY = 0.9f * w;
+    p.principalPointX = 0.5f * (w - 1) + 1.5f;
+    p.principalPointY = 0.5f * (h - 1) - 2.0f;
+    p.distortionCoeffs[0] = k1;
+    p.distortionCoeffs[1] = k2;
+    p.distortionCoeffs[2] = p1;
+    p.distortionCoeffs[3] = p2;
+    return p;
+}
+
+float ramp(float x, float y) { return 1.0f + 0.001f * x + 0.002f * y; }
+
+bool sameBits(const std::vector<float>& a, const std::vector<float>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+} // namespace
+
+TEST(UndistortionRemap, ZeroCoefficientsAreIdentity) {
+    const int W = 64, H = 48;
+    std::vector<float> in(W * H), out(W * H);
+    for (int i = 0; i < W * H; ++i) in[i] = (i % 11 == 4) ? std::nanf("") : ramp(i % W, i / W);
+    TransformParameters p = lens(W, H, 0.0f);
+    EXPECT_FALSE(UndistortionRemap::hasDistortion(p));
+    UndistortionRemap r(1);
+    ASSERT_TRUE(r.ensure(W, H, p));
+    r.apply(in.data(), out.data());
+    for (int i = 0; i < W * H; ++i) {
+        if (std::isnan(in[i])) {
+            EXPECT_TRUE(std::isnan(out[i])) << i;
+        } else {
+            EXPECT_EQ(out[i], in[i]) << i;
+        }
+    }
+}
+
+TEST(UndistortionRemap, SamplesDistortedSourcePosition) {
+    const int W = 160, H = 120;
+    std::vector<float> in(W * H), out(W * H);
+    for (int y = 0; y < H; ++y) for (int x = 0; x < W; ++x) in[y * W + x] = ramp(x, y);
+    TransformParameters p = lens(W, H, -0.25f, 0.05f, 0.002f, -0.001f);
+    ASSERT_TRUE(UndistortionRemap::hasDistortion(p));
+    UndistortionRemap r(1);
+    r.ensure(W, H, p);
+    const size_t valid = r.apply(in.data(), out.data());
+    size_t expectedValid = 0;
+    for (int v = 0; v < H; ++v) {
+        for (int u = 0; u < W; ++u) {
+            float sx, sy;
+            UndistortionRemap::sourcePosition(p, u, v, sx, sy);
+            const bool inside = sx >= 0.0f && sx <= W - 1 && sy >= 0.0f && sy <= H - 1;
+            const float o = out[v * W + u];
+            if (!inside) { EXPECT_TRUE(std::isnan(o)) << u << "," << v; continue; }
+            ++expectedValid;
+            EXPECT_NEAR(o, ramp(sx, sy), 2e-5f) << u << "," << v; // bilinear is exact on a ramp up to Q15 weights
+        }
+    }
+    EXPECT_EQ(valid, expectedValid);
+    EXPECT_GT(valid, 0u);
+    EXPECT_FALSE(r.ensure(W, H, p)); // unchanged calibration keeps the table
+    p.distortionCoeffs[4] = 0.01f;
+    EXPECT_TRUE(r.ensure(W, H, p));
+    EXPECT_EQ(r.rebuildCount(), 2u);
+}
+
+TEST(UndistortionRemap, InvalidTapsAreRenormalizedAndHolesDoNotGrow) {
+    const int W = 96, H = 64;
+    std::vector<float> in(W * H, 0.75f), out(W * H);
+    in[30 * W + 40] = std::nanf("");
+    TransformParameters p = lens(W, H, -0.1f);
+    UndistortionRemap r(1);
+    r.ensure(W, H, p);
+    r.apply(in.data(), out.data());
+    int holes = 0;
+    for (int v = 8; v < H - 8; ++v) { // central region maps inside the source
+        for (int u = 8; u < W - 8; ++u) {
+            const float o = out[v * W + u];
+            if (std::isnan(o)) { ++holes; continue; }
+            EXPECT_FLOAT_EQ(o, 0.75f) << u << "," << v; // NaN neighbours never leak into valid outputs
+        }
+    }
+    EXPECT_LE(holes, 2); // at most the outputs whose nearest source is the NaN pixel
+}
+
+TEST(UndistortionRemap, OutputIndependentOfThreadCountAndFitsFrameBudget) {
+    const int W = 640, H = 480;
+    std::vector<float> in(static_cast<size_t>(W) * H), a(in.size()), b(in.size());
+    for (size_t i = 0; i < in.size(); ++i) in[i] = (i % 53 == 7) ? std::nanf("") : 0.8f + 0.0003f * static_cast<float>((i * 29) % 700);
+    const TransformParameters p = lens(W, H, -0.18f, 0.03f, 0.001f, 0.0005f);
+    UndistortionRemap one(1), four(4);
+    EXPECT_EQ(four.threadCount(), 4);
+    one.ensure(W, H, p);
+    four.ensure(W, H, p);
+    const size_t validOne = one.apply(in.data(), a.data());
+    for (int round = 0; round < 2; ++round) {
+        EXPECT_EQ(four.apply(in.data(), b.data()), validOne);
+        EXPECT_TRUE(sameBits(a, b)) << "round " << round;
+    }
+
+    const int frames = 20;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; ++i) four.apply(in.data(), b.data());
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / frames;
+    std::cout << "[UNDISTORT-BENCH] " << W << "x" << H << " threads=4 ms=" << ms << "\n";
+    EXPECT_LT(ms, 33.0); // loose: one 30 fps frame period even on a loaded runner
+}
+
+TEST(UndistortionRemap, StageUndistortsLaneHeights) {
+    setenv("CALDERA_PROCESSING_PIPELINE", "build,undistort,fusion", 1);
+    ProcessingManager mgr(nullptr);
+    unsetenv("CALDERA_PROCESSING_PIPELINE");
+    const int W = 32, H = 24;
+    TransformParameters pose = lens(W, H, 0.4f); // pincushion: the corners sample outside the image
+    mgr.setSensorPose("Lens", pose);
+    WorldFrame last;
+    mgr.setWorldFrameCallback([&](const WorldFrame& f) { last = f; });
+    RawDepthFrame raw;
+    raw.sensorId = "Lens"; raw.width = W; raw.height = H;
+    raw.data.assign(static_cast<size_t>(W) * H, 1000);
+    mgr.processRawDepthFrame(raw);
+    ASSERT_EQ(last.heightMap.data.size(), static_cast<size_t>(W) * H);
+    EXPECT_NEAR(last.heightMap.data[12 * W + 16], 1.0f, 1e-6f);
+    EXPECT_FLOAT_EQ(last.heightMap.data[0], 0.0f);             // invalid after undistortion
+    EXPECT_FLOAT_EQ(last.heightMap.data[W * H - 1], 0.0f);
+}
+
+TEST(UndistortionRemap, StageAfterRasterizeIsIgnored) {
+    // The remap is in sensor pixels; after rasterize the heights are world-grid cells.
+    auto run = [](const char* pipeline) {
+        setenv("CALDERA_PROCESSING_PIPELINE", pipeline, 1);
+        ProcessingManager mgr(nullptr);
+        unsetenv("CALDERA_PROCESSING_PIPELINE");
+        ProcessingConfig pc;
+        pc.heightMapWidth = 32; pc.heightMapHeight = 24; pc.heightMapResolution = 0.01f;
+        mgr.setProcessingConfig(pc);
+        mgr.setSensorPose("Lens", lens(32, 24, 0.4f));
+        WorldFrame last;
+        mgr.setWorldFrameCallback([&](const WorldFrame& f) { last = f; });
+        RawDepthFrame raw;
+        raw.sensorId = "Lens"; raw.width = 32; raw.height = 24;
+        raw.data.resize(static_cast<size_t>(32) * 24);
+        for (size_t i = 0; i < raw.data.size(); ++i) raw.data[i] = static_cast<uint16_t>(900 + (i * 7) % 200);
+        mgr.processRawDepthFrame(raw);
+        return last.heightMap.data;
+    };
+    const std::vector<float> grid = run("build,rasterize,fusion");
+    ASSERT_EQ(grid.size(), static_cast<size_t>(32) * 24);
+    EXPECT_TRUE(sameBits(run("build,rasterize,undistort,fusion"), grid));
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "processing/WorldGridRasterizer.h"
+#include "processing/ProcessingManager.h"
+#include "common/DataTypes.h"
+#include "hal/FrameSet.h"
+
+using namespace caldera::backend::processing;
+using namespace caldera::backend::common;
+using caldera::backend::hal::FrameSet;
+using caldera::backend::hal::RawDepthFrameHandle;
+
+namespace {
+WorldGridRasterizer::Config gridConfig(int w, int h, float res, WorldGridRasterizer::Mode mode, int threads = 1) {
+    ProcessingConfig pc;
+    pc.heightMapWidth = w; pc.heightMapHeight = h; pc.heightMapResolution = res;
+    auto cfg = WorldGridRasterizer::Config::fromProcessingConfig(pc);
+    cfg.mode = mode;
+    cfg.threads = threads;
+    return cfg;
+}
+
+bool sameBits(const std::vector<float>& a, const std::vector<float>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::isnan(a[i]) != std::isnan(b[i])) return false;
+        if (!std::isnan(a[i]) && a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+RawDepthFrameHandle makeDepth(const std::string& id, int w, int h, uint16_t d, uint64_t ts) {
+    auto f = std::make_shared<RawDepthFrame>();
+    f->sensorId = id; f->width = w; f->height = h; f->timestamp_ns = ts;
+    f->data.assign(static_cast<size_t>(w) * h, d);
+    return f;
+}
+} // namespace
+
+TEST(WorldGridRaster, UncalibratedSensorOfGridSizeMapsOneToOne) {
+    const int W = 8, H = 6;
+    std::vector<float> in(W * H);
+    for (int i = 0; i < W * H; ++i) in[i] = (i % 7 == 3) ? std::nanf("") : 1.0f + 0.001f * i;
+    WorldGridRasterizer r(gridConfig(W, H, 0.01f, WorldGridRasterizer::Mode::MinZ));
+    std::vector<float> out(r.cellCount());
+    r.rasterize(in.data(), W, H, TransformParameters{}, out.data());
+    EXPECT_TRUE(sameBits(out, in));
+    EXPECT_EQ(r.stats().points, 41u);
+    EXPECT_EQ(r.stats().outside, 0u);
+    EXPECT_EQ(r.stats().filledCells, 41u);
+}
+
+TEST(WorldGridRaster, SharedCellsResolveByMode) {
+    // 4x4 pinhole image at ~1 m, 1 cm rays; each 2x2 pixel block lands in one 2 cm cell.
+    const int W = 4, H = 4;
+    std::vector<float> in(W * H), weights(W * H, 1.0f);
+    for (int i = 0; i < W * H; ++i) in[i] = 1.0f + 0.01f * i;
+    weights[1] = 3.0f; // cell 0: z 1.00, 1.01(x3), 1.04, 1.05
+    in[15] = std::nanf("");
+    TransformParameters pose;
+    pose.focalLengthX = pose.focalLengthY = 100.0f;
+    pose.principalPointX = pose.principalPointY = 1.5f;
+
+    auto run = [&](WorldGridRasterizer::Mode mode) {
+        WorldGridRasterizer r(gridConfig(2, 2, 0.02f, mode));
+        std::vector<float> out(r.cellCount());
+        r.rasterize(in.data(), W, H, pose, out.data(), weights.data());
+        EXPECT_EQ(r.stats().points, 15u);
+        EXPECT_EQ(r.stats().filledCells, 4u);
+        return out;
+    };
+    const auto mn = run(WorldGridRasterizer::Mode::MinZ);
+    const auto mx = run(WorldGridRasterizer::Mode::MaxZ);
+    const auto mean = run(WorldGridRasterizer::Mode::Mean);
+    EXPECT_FLOAT_EQ(mn[0], 1.00f);
+    EXPECT_FLOAT_EQ(mx[0], 1.05f);
+    EXPECT_NEAR(mean[0], (1.00f + 3 * 1.01f + 1.04f + 1.05f) / 6.0f, 1e-6f);
+    EXPECT_FLOAT_EQ(mn[3], 1.10f);
+    EXPECT_FLOAT_EQ(mx[3], 1.14f); // the NaN at 1.15 is skipped
+}
+
+TEST(WorldGridRaster, PoseMovesPointsAndCountsOutside) {
+    const int W = 8, H = 4;
+    std::vector<float> in(W * H, 0.5f);
+    TransformParameters pose;
+    pose.sensorPosition.x = 0.04f; // half a frame to the right: columns 4..7 leave the grid
+    pose.sensorPosition.z = 0.25f;
+    WorldGridRasterizer r(gridConfig(W, H, 0.01f, WorldGridRasterizer::Mode::MaxZ));
+    std::vector<float> out(r.cellCount());
+    r.rasterize(in.data(), W, H, pose, out.data());
+    EXPECT_EQ(r.stats().outside, 16u);
+    EXPECT_EQ(r.stats().filledCells, 16u);
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            const float v = out[y * W + x];
+            if (x < 4) {
+                EXPECT_TRUE(std::isnan(v)) << x << "," << y;
+            } else {
+                EXPECT_FLOAT_EQ(v, 0.75f) << x << "," << y;
+            }
+        }
+    }
+}
+
+TEST(WorldGridRaster, OutputIndependentOfThreadCount) {
+    const int W = 640, H = 480;
+    std::vector<float> in(static_cast<size_t>(W) * H), weights(in.size());
+    for (size_t i = 0; i < in.size(); ++i) {
+        in[i] = (i % 97 == 5) ? std::nanf("") : 0.9f + 0.0004f * static_cast<float>((i * 37) % 500);
+        weights[i] = static_cast<float>((i * 11) % 5) * 0.25f; // includes zero weights
+    }
+    TransformParameters pose;
+    pose.focalLengthX = pose.focalLengthY = 580.0f;
+    pose.principalPointX = 319.5f; pose.principalPointY = 239.5f;
+    const float c = std::cos(0.2f), s = std::sin(0.2f); // yaw, so rows straddle several tiles
+    const float rot[9] = {c, -s, 0, s, c, 0, 0, 0, 1};
+    std::copy(rot, rot + 9, pose.sensorRotationMatrix);
+    pose.sensorPosition.x = 0.05f;
+
+    for (auto mode : {WorldGridRasterizer::Mode::MinZ, WorldGridRasterizer::Mode::Mean}) {
+        WorldGridRasterizer one(gridConfig(320, 240, 0.004f, mode, 1));
+        WorldGridRasterizer four(gridConfig(320, 240, 0.004f, mode, 4));
+        EXPECT_EQ(four.threadCount(), 4);
+        std::vector<float> a(one.cellCount()), b(four.cellCount());
+        one.rasterize(in.data(), W, H, pose, a.data(), weights.data());
+        for (int round = 0; round < 2; ++round) { // second round reuses the bins
+            four.rasterize(in.data(), W, H, pose, b.data(), weights.data());
+            EXPECT_TRUE(sameBits(a, b)) << "round " << round;
+        }
+        EXPECT_GT(one.stats().filledCells, 0u);
+        EXPECT_GT(one.stats().outside, 0u);
+        EXPECT_EQ(one.stats().points, four.stats().points);
+        EXPECT_EQ(one.stats().outside, four.stats().outside);
+        EXPECT_EQ(one.stats().filledCells, four.stats().filledCells);
+    }
+}
+
+TEST(WorldGridRaster, StageFusesSensorsCoveringDifferentHalves) {
+    setenv("CALDERA_PROCESSING_PIPELINE", "build,rasterize(mode=min),fusion", 1);
+    ProcessingManager mgr(nullptr);
+    unsetenv("CALDERA_PROCESSING_PIPELINE");
+    ProcessingConfig pc;
+    pc.heightMapWidth = 16; pc.heightMapHeight = 4; pc.heightMapResolution = 0.01f;
+    mgr.setProcessingConfig(pc);
+    TransformParameters left, right;
+    left.sensorPosition.x = -0.04f;
+    right.sensorPosition.x = 0.04f;
+    mgr.setSensorPose("RasterL", left);
+    mgr.setSensorPose("RasterR", right);
+    WorldFrame last;
+    mgr.setWorldFrameCallback([&](const WorldFrame& f) { last = f; });
+    FrameSet set;
+    set.id = 1;
+    set.depth = {makeDepth("RasterL", 8, 4, 500, 1), makeDepth("RasterR", 8, 4, 800, 1)};
+    set.color.assign(2, nullptr);
+    set.present = 2;
+    mgr.processFrameSet(set);
+    ASSERT_EQ(last.heightMap.width, 16);
+    ASSERT_EQ(last.heightMap.height, 4);
+    ASSERT_EQ(last.heightMap.data.size(), 64u);
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 16; ++x) EXPECT_NEAR(last.heightMap.data[y * 16 + x], x < 8 ? 0.5f : 0.8f, 1e-6f) << x << "," << y;
+    }
+}
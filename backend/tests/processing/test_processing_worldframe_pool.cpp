@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "processing/ProcessingManager.h"
+#include "common/WorldFramePool.h"
+#include "common/DataTypes.h"
+#include "common/Logger.h"
+#include <vector>
+
+using namespace caldera::backend::processing;
+using caldera::backend::common::RawDepthFrame;
+using caldera::backend::common::WorldFrameHandle;
+using caldera::backend::common::WorldFramePool;
+
+static RawDepthFrame mkFrame(uint32_t w, uint32_t h, uint16_t v){ RawDepthFrame f; f.sensorId="pool"; f.width=w; f.height=h; f.data.assign((size_t)w*h, v); f.timestamp_ns=0; return f; }
+
+TEST(WorldFramePoolTest, RecyclesReleasedFramesAndKeepsCapacity){
+    WorldFramePool pool(2);
+    const float* firstData = nullptr;
+    {
+        auto f = pool.acquire(1024);
+        f->heightMap.data.resize(1024, 1.0f); f->frame_id = 7;
+        firstData = f->heightMap.data.data();
+    }
+    EXPECT_EQ(pool.idleCount(), 1u);
+    auto g = pool.acquire(1024);
+    EXPECT_EQ(g->heightMap.data.data(), firstData); // same storage handed back
+    EXPECT_EQ(g->frame_id, 0u);                      // metadata reset
+    auto s = pool.stats();
+    EXPECT_EQ(s.acquired, 2u);
+    EXPECT_EQ(s.allocated, 1u);
+    EXPECT_EQ(s.recycled, 1u);
+}
+
+TEST(WorldFramePoolTest, BoundsIdleListAndSurvivesPoolDestruction){
+    std::vector<std::shared_ptr<caldera::backend::common::WorldFrame>> held;
+    WorldFrameHandle outlived;
+    {
+        WorldFramePool pool(1);
+        for(int i=0;i<3;++i) held.push_back(pool.acquire(16));
+        held.clear();
+        EXPECT_EQ(pool.idleCount(), 1u);
+        EXPECT_EQ(pool.stats().discarded, 2u);
+        outlived = pool.acquire(16);
+    }
+    ASSERT_TRUE(outlived); // handle stays valid after the pool is gone and is simply freed on release
+    outlived.reset();
+}
+
+TEST(WorldFramePoolTest, ProcessingManagerDeliversPooledHandlesWithoutCopy){
+    auto &loggerSingleton = caldera::backend::common::Logger::instance();
+    if(!loggerSingleton.isInitialized()) loggerSingleton.initialize("logs/test_worldframe_pool.log");
+    ProcessingManager pm(spdlog::default_logger());
+    std::vector<WorldFrameHandle> kept;
+    std::vector<const float*> seen;
+    pm.setWorldFrameHandleCallback([&](const WorldFrameHandle& h){
+        seen.push_back(h->heightMap.data.data());
+        if(h->frame_id==0) kept.push_back(h); // retain the first frame across later ones
+    });
+    for(int i=0;i<6;++i) pm.processRawDepthFrame(mkFrame(16,8,(uint16_t)(1000+i)));
+    ASSERT_EQ(seen.size(), 6u);
+    ASSERT_EQ(kept.size(), 1u);
+    EXPECT_EQ(kept[0]->frame_id, 0u);
+    EXPECT_EQ(kept[0]->heightMap.data.size(), 16u*8u);
+    // The retained frame must not be recycled underneath its holder.
+    for(size_t i=1;i<seen.size();++i) EXPECT_NE(seen[i], seen[0]);
+    // Released frames are reused: frames 1..5 cycle through a single payload.
+    for(size_t i=2;i<seen.size();++i) EXPECT_EQ(seen[i], seen[1]);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "hal/DepthCodec.h"
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace caldera::backend::hal;
+
+namespace {
+
+std::vector<uint16_t> roundTrip(const std::vector<uint16_t>& src, uint32_t width, size_t* encodedBytes = nullptr) {
+    std::vector<uint8_t> enc;
+    const size_t n = encodeDepthDelta(src.data(), src.size(), width, enc);
+    EXPECT_EQ(n, enc.size());
+    if (encodedBytes) *encodedBytes = n;
+    std::vector<uint16_t> out(src.size(), 0xBEEF);
+    EXPECT_TRUE(decodeDepthDelta(enc.data(), enc.size(), src.size(), width, out.data()));
+    return out;
+}
+
+// Smooth sand-table-like depth (mm) with sensor noise and patches of invalid (0) pixels.
+std::vector<uint16_t> sandFrame(uint32_t w, uint32_t h) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> noise(-1, 1);
+    std::vector<uint16_t> d((size_t)w * h);
+    for (uint32_t y = 0; y < h; ++y) for (uint32_t x = 0; x < w; ++x) {
+        const bool hole = ((x / 40 + y / 30) % 11) == 0 && (x % 40) < 12;
+        const double z = 1100.0 + 60.0 * std::sin(x * 0.02) * std::cos(y * 0.025) + 0.05 * x;
+        d[(size_t)y * w + x] = hole ? 0 : (uint16_t)(z + noise(rng));
+    }
+    return d;
+}
+
+} // namespace
+
+TEST(DepthCodec, RoundTripsExtremesAndRandomData) {
+    std::vector<uint16_t> edge = {0, 65535, 0, 32768, 32767, 1, 65534, 0, 0, 0, 0, 65535, 65535, 7};
+    EXPECT_EQ(roundTrip(edge, 0), edge);
+    EXPECT_EQ(roundTrip(edge, 5), edge); // rows of 5 with a partial last row
+
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> any(0, 65535);
+    std::vector<uint16_t> random(4099);
+    for (auto& v : random) v = (uint16_t)any(rng);
+    EXPECT_EQ(roundTrip(random, 64), random);
+
+    std::vector<uint16_t> flat(10000, 0);
+    size_t bytes = 0;
+    EXPECT_EQ(roundTrip(flat, 100, &bytes), flat);
+    EXPECT_EQ(bytes, 10000u / 16u); // one width byte per all-zero block
+
+    EXPECT_TRUE(roundTrip({}, 10).empty());
+}
+
+TEST(DepthCodec, RejectsTruncatedOrOverlongInput) {
+    std::vector<uint16_t> src = sandFrame(64, 48);
+    std::vector<uint8_t> enc;
+    encodeDepthDelta(src.data(), src.size(), 64, enc);
+    std::vector<uint16_t> out(src.size());
+    EXPECT_FALSE(decodeDepthDelta(enc.data(), enc.size() - 1, src.size(), 64, out.data()));
+    enc.push_back(0);
+    EXPECT_FALSE(decodeDepthDelta(enc.data(), enc.size(), src.size(), 64, out.data()));
+    const uint8_t badWidth[] = {17, 0, 0, 0}; // block bit width above 16
+    EXPECT_FALSE(decodeDepthDelta(badWidth, sizeof(badWidth), 16, 4, out.data()));
+}
+
+TEST(DepthCodec, CompressesSandFramesAtLeastThreeTimes) {
+    const uint32_t w = 512, h = 424;
+    std::vector<uint16_t> frame = sandFrame(w, h);
+    size_t bytes = 0;
+    EXPECT_EQ(roundTrip(frame, w, &bytes), frame);
+    const double ratio = double(frame.size() * sizeof(uint16_t)) / double(bytes);
+    std::cout << "[DEPTH-CODEC] " << w << "x" << h << " raw=" << frame.size() * sizeof(uint16_t)
+              << " encoded=" << bytes << " ratio=" << ratio << "\n";
+    EXPECT_GE(ratio, 3.0);
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/Logger.h"
+#include "hal/FrameBufferPool.h"
+#include "hal/SyntheticSensorDevice.h"
+#include "processing/ProcessingManager.h"
+#include "processing/ProcessingWorker.h"
+
+using caldera::backend::common::Logger;
+using caldera::backend::hal::FrameBufferPool;
+using caldera::backend::hal::RawColorFrameHandle;
+using caldera::backend::hal::RawDepthFrameHandle;
+using caldera::backend::hal::SyntheticSensorDevice;
+using caldera::backend::processing::ProcessingManager;
+using caldera::backend::processing::ProcessingWorker;
+
+namespace {
+std::shared_ptr<spdlog::logger> testLogger(const char* name) {
+    if (!Logger::instance().isInitialized()) Logger::instance().initialize("logs/test/frame_buffer_pool.log");
+    return Logger::instance().get(name);
+}
+
+template <typename Pred>
+bool waitFor(Pred pred, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+} // namespace
+
+TEST(FrameBufferPool, RecyclesBuffersAndCountsAllocations) {
+    FrameBufferPool pool(2);
+    const uint16_t* first = nullptr;
+    {
+        auto d = pool.acquireDepth(640 * 480);
+        ASSERT_EQ(d->data.size(), 640u * 480u);
+        first = d->data.data();
+    }
+    EXPECT_EQ(pool.allocationCount(), 1u);
+    {
+        auto d = pool.acquireDepth(320 * 240); // smaller: reuses capacity
+        EXPECT_EQ(d->data.data(), first);
+        EXPECT_EQ(d->data.size(), 320u * 240u);
+    }
+    EXPECT_EQ(pool.allocationCount(), 1u);
+    { auto d = pool.acquireDepth(1024 * 1024); } // growth of a recycled buffer counts
+    EXPECT_EQ(pool.allocationCount(), 2u);
+    { auto c = pool.acquireColor(640 * 480 * 3); }
+    auto st = pool.stats();
+    EXPECT_EQ(st.allocations, 3u);
+    EXPECT_EQ(st.acquired, 4u);
+    EXPECT_EQ(st.recycled, 4u);
+}
+
+TEST(FrameBufferPool, SyntheticDeviceReachesZeroSteadyStateAllocations) {
+    SyntheticSensorDevice::Config cfg; cfg.width = 64; cfg.height = 48; cfg.fps = 500.0; cfg.sensorId = "pool_synth";
+    SyntheticSensorDevice dev(cfg, testLogger("Test.FramePool.Synthetic"));
+    std::atomic<uint64_t> frames{0};
+    std::mutex mtx;
+    RawDepthFrameHandle retained;
+    std::vector<uint16_t> retainedCopy;
+    dev.setFrameHandleCallback([&](const RawDepthFrameHandle& depth, const RawColorFrameHandle& color) {
+        ASSERT_TRUE(depth); ASSERT_TRUE(color);
+        if (frames.load() == 3) { std::lock_guard<std::mutex> lk(mtx); retained = depth; retainedCopy = depth->data; }
+        ++frames;
+    });
+    ASSERT_TRUE(dev.open());
+    ASSERT_TRUE(waitFor([&] { return frames.load() >= 10; }, std::chrono::seconds(5)));
+    const uint64_t warm = dev.bufferStats().allocations;
+    const uint64_t warmFrames = frames.load();
+    ASSERT_TRUE(waitFor([&] { return frames.load() >= warmFrames + 50; }, std::chrono::seconds(5)));
+    dev.close();
+    auto st = dev.bufferStats();
+    EXPECT_EQ(st.allocations, warm) << "steady-state capture must not allocate";
+    EXPECT_LE(warm, 3u);
+    EXPECT_GT(st.recycled, 40u);
+    std::lock_guard<std::mutex> lk(mtx);
+    ASSERT_TRUE(retained);
+    EXPECT_EQ(retained->data, retainedCopy); // a retained frame is never recycled underneath its holder
+}
+
+TEST(FrameBufferPool, DeviceToProcessingWorkerIsAllocationFreeWhenWarm) {
+    SyntheticSensorDevice::Config cfg; cfg.width = 64; cfg.height = 48; cfg.fps = 400.0; cfg.sensorId = "pool_worker";
+    SyntheticSensorDevice dev(cfg, testLogger("Test.FramePool.Worker"));
+    auto pm = std::make_shared<ProcessingManager>(testLogger("Test.FramePool.Proc"));
+    ProcessingWorker worker(pm, ProcessingWorker::Config{});
+    auto* lane = worker.addLane(cfg.sensorId);
+    dev.setFrameHandleCallback([&](const RawDepthFrameHandle& depth, const RawColorFrameHandle&) { worker.submit(lane, depth); });
+    worker.start();
+    ASSERT_TRUE(dev.open());
+    ASSERT_TRUE(waitFor([&] { return worker.stats().processed >= 20; }, std::chrono::seconds(5)));
+    const uint64_t warm = dev.bufferStats().allocations;
+    const uint64_t warmProcessed = worker.stats().processed;
+    ASSERT_TRUE(waitFor([&] { return worker.stats().processed >= warmProcessed + 60; }, std::chrono::seconds(5)));
+    dev.close();
+    worker.stop();
+    EXPECT_EQ(dev.bufferStats().allocations, warm);
+}
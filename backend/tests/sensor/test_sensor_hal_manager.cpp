@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/Logger.h"
+#include "hal/HAL_Manager.h"
+#include "hal/SyntheticSensorDevice.h"
+
+using caldera::backend::common::Logger;
+using caldera::backend::hal::FrameSet;
+using caldera::backend::hal::HAL_Manager;
+using caldera::backend::hal::SyntheticSensorDevice;
+
+namespace {
+std::shared_ptr<spdlog::logger> testLogger(const char* name) {
+    if (!Logger::instance().isInitialized()) Logger::instance().initialize("logs/test/hal_manager.log");
+    return Logger::instance().get(name);
+}
+
+template <typename Pred>
+bool waitFor(Pred pred, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+std::unique_ptr<SyntheticSensorDevice> makeSynth(const std::string& id, double fps, SyntheticSensorDevice** raw = nullptr) {
+    SyntheticSensorDevice::Config cfg;
+    cfg.width = 16; cfg.height = 16; cfg.fps = fps; cfg.sensorId = id;
+    auto dev = std::make_unique<SyntheticSensorDevice>(cfg, testLogger("Test.HAL"));
+    if (raw) *raw = dev.get();
+    return dev;
+}
+
+struct SetRecord { size_t present; std::vector<std::string> ids; uint64_t spreadNs; };
+} // namespace
+
+TEST(HALManager, GroupsTwoSensorsIntoSynchronizedSets) {
+    HAL_Manager hal(testLogger("Test.HAL"));
+    ASSERT_EQ(hal.addDevice(makeSynth("SyncA", 60.0)), 0u);
+    ASSERT_EQ(hal.addDevice(makeSynth("SyncB", 60.0)), 1u);
+    std::mutex m;
+    std::vector<SetRecord> sets;
+    hal.setFrameSetCallback([&](const FrameSet& set) {
+        SetRecord r{set.present, {}, 0};
+        uint64_t lo = UINT64_MAX, hi = 0;
+        for (const auto& d : set.depth) {
+            r.ids.push_back(d ? d->sensorId : std::string());
+            if (d) { lo = std::min(lo, d->timestamp_ns); hi = std::max(hi, d->timestamp_ns); }
+        }
+        r.spreadNs = hi - lo;
+        std::lock_guard<std::mutex> lk(m);
+        sets.push_back(std::move(r));
+    });
+    ASSERT_TRUE(hal.start());
+    ASSERT_TRUE(waitFor([&] { return hal.stats().sets >= 40; }, std::chrono::seconds(5)));
+    const auto running = hal.stats();
+    hal.stop();
+
+    std::lock_guard<std::mutex> lk(m);
+    size_t complete = 0;
+    for (const auto& r : sets) {
+        if (r.present != 2) continue;
+        ++complete;
+        EXPECT_EQ(r.ids[0], "SyncA"); // slots follow addDevice order
+        EXPECT_EQ(r.ids[1], "SyncB");
+        // Synthetic timestamps are taken just before delivery, so they track arrival closely.
+        EXPECT_LE(r.spreadNs, hal.config().syncToleranceNs + 5'000'000ULL);
+    }
+    EXPECT_GE(complete * 10, sets.size() * 8); // >= 80% complete
+    ASSERT_EQ(running.devices.size(), 2u);
+    for (const auto& d : running.devices) {
+        EXPECT_GT(d.frames, 30u);
+        EXPECT_GT(d.fps, 40.0) << d.id;
+        EXPECT_LT(d.fps, 80.0) << d.id;
+        EXPECT_LT(d.jitterMs, 10.0) << d.id;
+        EXPECT_EQ(d.dropped, 0u);
+        EXPECT_TRUE(d.live);
+    }
+}
+
+TEST(HALManager, StopsWaitingForSilentDevice) {
+    HAL_Manager::Config cfg;
+    cfg.maxWaitNs = 20'000'000;
+    cfg.deviceTimeoutNs = 100'000'000;
+    HAL_Manager hal(testLogger("Test.HAL"), nullptr, cfg);
+    SyntheticSensorDevice* quitter = nullptr;
+    hal.addDevice(makeSynth("Steady", 60.0));
+    hal.addDevice(makeSynth("Quitter", 60.0, &quitter));
+    quitter->setStopAfter(10); // auto-pauses: the device stays open but goes silent
+    std::atomic<uint64_t> soloSets{0};
+    hal.setFrameSetCallback([&](const FrameSet& set) {
+        if (set.present == 1 && set.depth[0]) soloSets.fetch_add(1);
+    });
+    ASSERT_TRUE(hal.start());
+    ASSERT_TRUE(waitFor([&] { return soloSets.load() >= 20; }, std::chrono::seconds(5)));
+    const auto s = hal.stats();
+    hal.stop();
+
+    EXPECT_GT(s.partialSets, 0u);
+    EXPECT_GE(s.devices[1].missing, 20u);
+    EXPECT_EQ(s.devices[1].frames, 10u);
+    EXPECT_TRUE(s.devices[0].live);
+    EXPECT_FALSE(s.devices[1].live);
+}
+
+TEST(HALManager, SingleDeviceEmitsEveryFrameAsCompleteSet) {
+    HAL_Manager hal(testLogger("Test.HAL"));
+    SyntheticSensorDevice* dev = nullptr;
+    hal.addDevice(makeSynth("Solo", 120.0, &dev));
+    dev->setStopAfter(30);
+    std::atomic<uint64_t> lastId{0};
+    std::atomic<bool> ordered{true};
+    hal.setFrameSetCallback([&](const FrameSet& set) {
+        if (!set.complete() || set.id != lastId.load() + 1) ordered.store(false);
+        lastId.store(set.id);
+    });
+    ASSERT_TRUE(hal.start());
+    ASSERT_TRUE(waitFor([&] { return hal.stats().sets >= 30; }, std::chrono::seconds(5)));
+    hal.stop();
+    const auto s = hal.stats();
+    EXPECT_EQ(s.sets, 30u);
+    EXPECT_EQ(s.completeSets, 30u);
+    EXPECT_TRUE(ordered.load());
+}
@@ -1,15 +1,20 @@
 #include <gtest/gtest.h>
 #include "hal/SensorRecorder.h"
 #include "hal/MockSensorDevice.h"
+#include "hal/RecordingReader.h"
 #include "common/DataTypes.h"
 #include "common/Logger.h"
 #include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <vector>
 #include <atomic>
 #include <chrono>
 #include <thread>
 
 using caldera::backend::hal::SensorRecorder;
 using caldera::backend::hal::MockSensorDevice;
+using caldera::backend::hal::RecordingReader;
 using caldera::backend::common::RawDepthFrame;
 using caldera::backend::common::RawColorFrame;
 
@@ -68,6 +73,37 @@ protected:
         return frame;
     }
 
+    void recordFrames(int count, SensorRecorder::Options opts = SensorRecorder::Options{}) {
+        SensorRecorder recorder(test_filename_, opts);
+        ASSERT_TRUE(recorder.startRecording());
+        for (int i = 0; i < count; ++i) {
+            auto depth = createTestDepthFrame(i);
+            auto color = createTestColorFrame(i);
+            color.data.resize(color.data.size() - (i % 3)); // odd payload sizes exercise record padding
+            recorder.recordFrame(depth, color);
+        }
+        recorder.stopRecording();
+    }
+
+    // Legacy v1 writer (no padding, no trailing index) for backward-compatibility checks.
+    void writeV1File(int count) {
+        std::ofstream f(test_filename_, std::ios::binary);
+        const uint32_t header[8] = {0x4B494E54, 1, static_cast<uint32_t>(count), 0, 0, 0, 0, 0};
+        f.write(reinterpret_cast<const char*>(header), sizeof(header));
+        for (int i = 0; i < count; ++i) {
+            auto depth = createTestDepthFrame(i);
+            auto color = createTestColorFrame(i);
+            color.data.resize(color.data.size() - 1);
+            const uint32_t dh[3] = {32, 24, static_cast<uint32_t>(depth.data.size())};
+            const uint32_t ch[3] = {64, 48, static_cast<uint32_t>(color.data.size())};
+            f.write(reinterpret_cast<const char*>(&depth.timestamp_ns), sizeof(uint64_t));
+            f.write(reinterpret_cast<const char*>(dh), sizeof(dh));
+            f.write(reinterpret_cast<const char*>(depth.data.data()), depth.data.size() * sizeof(uint16_t));
+            f.write(reinterpret_cast<const char*>(ch), sizeof(ch));
+            f.write(reinterpret_cast<const char*>(color.data.data()), color.data.size());
+        }
+    }
+
     std::string test_filename_;
 };
 
@@ -149,4 +185,146 @@ TEST_F(SensorRecordingTest, RecorderStates) {
     // Stop recording
     recorder.stopRecording();
     EXPECT_FALSE(recorder.isRecording());
-}
\ No newline at end of file
+}
+
+TEST_F(SensorRecordingTest, V2IndexGivesRandomAccessZeroCopyViews) {
+    SensorRecorder::Options raw;
+    raw.depthCodec = caldera::backend::hal::DepthCodec::Raw; // views point at raw samples
+    recordFrames(7, raw);
+    RecordingReader reader;
+    ASSERT_TRUE(reader.open(test_filename_));
+    EXPECT_EQ(reader.version(), 2u);
+    EXPECT_TRUE(reader.hasStoredIndex());
+    ASSERT_EQ(reader.frameCount(), 7u);
+
+    for (size_t i : {size_t(6), size_t(0), size_t(3)}) { // out of order: O(1) seek via the index
+        auto v = reader.frame(i);
+        ASSERT_TRUE(v.has_value());
+        EXPECT_EQ(v->timestamp_ns, 1000000ULL * i);
+        EXPECT_EQ(v->depth_width, 32u);
+        EXPECT_EQ(v->depth_height, 24u);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(v->depth) % 4, 0u) << "v2 depth payloads are aligned";
+        EXPECT_EQ(v->depth[5], static_cast<uint16_t>(i * 100 + 5));
+        EXPECT_EQ(v->color_bytes, 64u * 48u * 4u - (i % 3));
+        EXPECT_EQ(v->color[1], static_cast<uint8_t>(i + 1));
+    }
+    EXPECT_FALSE(reader.frame(7).has_value());
+}
+
+TEST_F(SensorRecordingTest, V1FilesStillReadable) {
+    writeV1File(4);
+    RecordingReader reader;
+    ASSERT_TRUE(reader.open(test_filename_));
+    EXPECT_EQ(reader.version(), 1u);
+    EXPECT_FALSE(reader.hasStoredIndex());
+    ASSERT_EQ(reader.frameCount(), 4u);
+    RawDepthFrame depth;
+    RawColorFrame color;
+    ASSERT_TRUE(reader.copyFrame(3, depth, color));
+    EXPECT_EQ(depth.data, createTestDepthFrame(3).data);
+    EXPECT_EQ(color.data.size(), 64u * 48u * 4u - 1);
+    EXPECT_EQ(color.data[7], static_cast<uint8_t>(3 + 7));
+}
+
+TEST_F(SensorRecordingTest, UnfinalizedRecordingIsRecoveredByScan) {
+    recordFrames(3);
+    // Simulate a crash before stopRecording(): zero count/index and drop the trailing index.
+    const auto fullSize = std::filesystem::file_size(test_filename_);
+    {
+        std::fstream f(test_filename_, std::ios::binary | std::ios::in | std::ios::out);
+        const uint32_t zeros[3] = {0, 0, 0};
+        f.seekp(8);
+        f.write(reinterpret_cast<const char*>(zeros), sizeof(zeros));
+    }
+    std::filesystem::resize_file(test_filename_, fullSize - 3 * sizeof(caldera::backend::hal::recording::IndexEntry) - 10);
+    RecordingReader reader;
+    ASSERT_TRUE(reader.open(test_filename_));
+    EXPECT_FALSE(reader.hasStoredIndex());
+    EXPECT_EQ(reader.frameCount(), 2u); // last record is incomplete
+}
+
+TEST_F(SensorRecordingTest, MockPlaybackUsesPooledFramesAndSeeks) {
+    recordFrames(5);
+    MockSensorDevice mock(test_filename_);
+    ASSERT_TRUE(mock.open());
+    ASSERT_EQ(mock.getFrameCount(), 5u);
+    mock.setPlaybackFPS(1000.0);
+    mock.setPlaybackMode(MockSensorDevice::PlaybackMode::ONCE);
+    ASSERT_TRUE(mock.seekFrame(2));
+    EXPECT_FALSE(mock.seekFrame(5));
+
+    std::mutex m;
+    std::vector<uint64_t> timestamps;
+    std::atomic<bool> dataOk{true};
+    mock.setFrameHandleCallback([&](const caldera::backend::hal::RawDepthFrameHandle& depth,
+                                    const caldera::backend::hal::RawColorFrameHandle& color) {
+        const int n = static_cast<int>(depth->timestamp_ns / 1000000ULL);
+        if (depth->data != createTestDepthFrame(n).data || color->width != 64) dataOk.store(false);
+        std::lock_guard<std::mutex> lk(m);
+        timestamps.push_back(depth->timestamp_ns);
+    });
+    for (int i = 0; i < 200 && mock.isRunning(); ++i) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    mock.close();
+
+    std::lock_guard<std::mutex> lk(m);
+    EXPECT_EQ(timestamps, (std::vector<uint64_t>{2000000ULL, 3000000ULL, 4000000ULL}));
+    EXPECT_TRUE(dataOk.load());
+    EXPECT_LE(mock.bufferStats().allocations, 4u); // frames recycled through the pool
+}
+
+TEST_F(SensorRecordingTest, AsyncWriterCompressesDepthAndReportsStats) {
+    SensorRecorder::Options opts;
+    opts.async = true;
+    opts.depthCodec = caldera::backend::hal::DepthCodec::DeltaBitpack;
+    opts.queueDepth = 4;
+    SensorRecorder recorder(test_filename_, opts);
+    ASSERT_TRUE(recorder.startRecording());
+    for (int i = 0; i < 50; ++i) {
+        auto depth = createTestDepthFrame(i);
+        auto color = createTestColorFrame(i);
+        recorder.recordFrame(depth, color); // never blocks; may drop when the writer lags
+    }
+    recorder.stopRecording();
+
+    const auto s = recorder.stats();
+    EXPECT_EQ(s.submitted, 50u);
+    EXPECT_EQ(s.written + s.dropped, 50u);
+    EXPECT_GT(s.written, 0u);
+    EXPECT_EQ(s.queue_depth, 0u);
+    EXPECT_LE(s.max_queue_depth, 4u);
+    EXPECT_LT(s.depth_encoded_bytes, s.depth_raw_bytes);
+    EXPECT_EQ(recorder.getFrameCount(), s.written);
+
+    RecordingReader reader;
+    ASSERT_TRUE(reader.open(test_filename_));
+    EXPECT_EQ(reader.depthCodec(), caldera::backend::hal::DepthCodec::DeltaBitpack);
+    ASSERT_EQ(reader.frameCount(), s.written);
+    RawDepthFrame depth;
+    RawColorFrame color;
+    for (size_t i = 0; i < reader.frameCount(); ++i) {
+        ASSERT_TRUE(reader.copyFrame(i, depth, color));
+        const int n = static_cast<int>(depth.timestamp_ns / 1000000ULL);
+        EXPECT_EQ(depth.data, createTestDepthFrame(n).data);
+        EXPECT_EQ(color.data, createTestColorFrame(n).data);
+    }
+}
+
+TEST_F(SensorRecordingTest, SyncRawRecordingStillSupported) {
+    SensorRecorder::Options opts;
+    opts.async = false;
+    opts.depthCodec = caldera::backend::hal::DepthCodec::Raw;
+    SensorRecorder recorder(test_filename_, opts);
+    ASSERT_TRUE(recorder.startRecording());
+    for (int i = 0; i < 3; ++i) {
+        auto depth = createTestDepthFrame(i);
+        auto color = createTestColorFrame(i);
+        recorder.recordFrame(depth, color);
+        EXPECT_EQ(recorder.getFrameCount(), static_cast<size_t>(i + 1));
+    }
+    recorder.stopRecording();
+    EXPECT_EQ(recorder.stats().depth_encoded_bytes, recorder.stats().depth_raw_bytes);
+    RecordingReader reader;
+    ASSERT_TRUE(reader.open(test_filename_));
+    EXPECT_EQ(reader.depthCodec(), caldera::backend::hal::DepthCodec::Raw);
+    EXPECT_EQ(reader.frameCount(), 3u);
+}
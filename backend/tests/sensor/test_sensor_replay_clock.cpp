@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/Logger.h"
+#include "hal/MockSensorDevice.h"
+#include "hal/ReplayClock.h"
+#include "hal/SensorRecorder.h"
+#include "hal/SyntheticSensorDevice.h"
+#include "processing/ProcessingManager.h"
+#include "processing/ProcessingWorker.h"
+
+using caldera::backend::common::Logger;
+using caldera::backend::common::RawColorFrame;
+using caldera::backend::common::RawDepthFrame;
+using caldera::backend::hal::MockSensorDevice;
+using caldera::backend::hal::RawColorFrameHandle;
+using caldera::backend::hal::RawDepthFrameHandle;
+using caldera::backend::hal::ReplayClock;
+using caldera::backend::hal::SensorRecorder;
+using caldera::backend::hal::SyntheticSensorDevice;
+using caldera::backend::processing::ProcessingManager;
+using caldera::backend::processing::ProcessingWorker;
+
+namespace {
+std::shared_ptr<spdlog::logger> testLogger(const char* name) {
+    if (!Logger::instance().isInitialized()) Logger::instance().initialize("logs/test/replay_clock.log");
+    return Logger::instance().get(name);
+}
+
+template <typename Pred>
+bool waitFor(Pred pred, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+SyntheticSensorDevice::Config synthConfig(double fps) {
+    SyntheticSensorDevice::Config cfg;
+    cfg.width = 32; cfg.height = 24; cfg.fps = fps;
+    cfg.sensorId = "ReplayClockSynth";
+    return cfg;
+}
+} // namespace
+
+TEST(ReplayClock, SyntheticTimestampsFollowNominalPeriod) {
+    ReplayClock clock(ReplayClock::Mode::MaxRate);
+    clock.start(25.0, 1'000'000'000ULL);
+    EXPECT_EQ(clock.timestampNs(0), 1'000'000'000ULL);
+    EXPECT_EQ(clock.timestampNs(10), 1'000'000'000ULL + 10 * 40'000'000ULL);
+    for (int i = 0; i < 100; ++i) EXPECT_TRUE(clock.pace(true)); // never blocks
+    EXPECT_EQ(clock.stats().ticks, 100u);
+    clock.cancel();
+    EXPECT_FALSE(clock.pace(true));
+}
+
+TEST(ReplayClock, SyntheticDeviceRunsFasterThanRealTimeAtMaxRate) {
+    constexpr uint64_t kFrames = 300; // 10 s of capture at 30 fps
+    SyntheticSensorDevice dev(synthConfig(30.0), testLogger("Test.ReplayClock"));
+    dev.setReplayClock(std::make_shared<ReplayClock>(ReplayClock::Mode::MaxRate));
+    std::mutex m;
+    std::vector<uint64_t> stamps;
+    dev.setFrameCallback([&](const RawDepthFrame& d, const RawColorFrame&) {
+        std::lock_guard<std::mutex> lk(m);
+        stamps.push_back(d.timestamp_ns);
+    });
+    dev.setStopAfter(kFrames);
+    const auto t0 = std::chrono::steady_clock::now();
+    ASSERT_TRUE(dev.open());
+    ASSERT_TRUE(waitFor([&] { return dev.isPaused(); }, std::chrono::seconds(5)));
+    const auto elapsed = std::chrono::steady_clock::now() - t0;
+    dev.close();
+
+    ASSERT_EQ(stamps.size(), kFrames);
+    EXPECT_LT(elapsed, std::chrono::seconds(3));
+    const uint64_t period = 33'333'333ULL;
+    for (size_t i = 1; i < stamps.size(); ++i) {
+        const uint64_t dt = stamps[i] - stamps[i - 1];
+        EXPECT_GE(dt + 1, period);
+        EXPECT_LE(dt, period + 1);
+    }
+}
+
+TEST(ReplayClock, LockStepWaitsForEachFrameToBeAcknowledged) {
+    auto clock = std::make_shared<ReplayClock>(ReplayClock::Mode::LockStep);
+    SyntheticSensorDevice dev(synthConfig(1000.0), testLogger("Test.ReplayClock"));
+    dev.setReplayClock(clock);
+    std::atomic<uint64_t> emitted{0}, acked{0};
+    std::atomic<uint64_t> maxAhead{0};
+    dev.setFrameHandleCallback([&](const RawDepthFrameHandle&, const RawColorFrameHandle&) {
+        const uint64_t ahead = emitted.fetch_add(1) + 1 - acked.load();
+        uint64_t prev = maxAhead.load();
+        while (ahead > prev && !maxAhead.compare_exchange_weak(prev, ahead)) {}
+    });
+    std::atomic<bool> consuming{true};
+    std::thread consumer([&] {
+        while (consuming.load()) {
+            if (emitted.load() > acked.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2)); // slow "processing"
+                acked.fetch_add(1);
+                clock->frameDone();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    ASSERT_TRUE(dev.open());
+    ASSERT_TRUE(waitFor([&] { return acked.load() >= 20; }, std::chrono::seconds(5)));
+    dev.close();
+    consuming.store(false);
+    consumer.join();
+
+    EXPECT_EQ(maxAhead.load(), 1u);
+    EXPECT_EQ(clock->stats().lockstep_timeouts, 0u);
+}
+
+TEST(ReplayClock, LockStepWorkerProcessesEveryFrame) {
+    auto clock = std::make_shared<ReplayClock>(ReplayClock::Mode::LockStep);
+    auto log = testLogger("Test.ReplayClock");
+    auto processing = std::make_shared<ProcessingManager>(log, log);
+    ProcessingWorker worker(processing, ProcessingWorker::Config{}, log); // LatestWins: only lock-step prevents coalescing
+    worker.setFrameProcessedCallback([clock] { clock->frameDone(); });
+    auto* lane = worker.addLane("synth");
+    SyntheticSensorDevice dev(synthConfig(30.0), log);
+    dev.setReplayClock(clock);
+    dev.setFrameHandleCallback([&](const RawDepthFrameHandle& d, const RawColorFrameHandle&) { worker.submit(lane, d); });
+    dev.setStopAfter(60);
+    worker.start();
+    ASSERT_TRUE(dev.open());
+    ASSERT_TRUE(waitFor([&] { return worker.stats().processed >= 60; }, std::chrono::seconds(5)));
+    dev.close();
+    worker.stop();
+
+    const auto s = worker.stats();
+    EXPECT_EQ(s.processed, 60u);
+    EXPECT_EQ(s.coalesced, 0u);
+    EXPECT_EQ(clock->stats().lockstep_timeouts, 0u);
+}
+
+TEST(ReplayClock, MockPlaybackAtMaxRate) {
+    testLogger("Test.ReplayClock");
+    const std::string file = "test_replay_clock.dat";
+    {
+        SensorRecorder::Options opts;
+        opts.async = false; // keep every frame
+        SensorRecorder recorder(file, opts);
+        ASSERT_TRUE(recorder.startRecording());
+        for (int i = 0; i < 40; ++i) {
+            RawDepthFrame depth;
+            depth.sensorId = "TestSensor";
+            depth.timestamp_ns = 1'000'000ULL * i;
+            depth.width = 16; depth.height = 8;
+            depth.data.assign(16 * 8, static_cast<uint16_t>(1000 + i));
+            recorder.recordFrame(depth, RawColorFrame{});
+        }
+        recorder.stopRecording();
+    }
+    MockSensorDevice mock(file);
+    mock.setPlaybackFPS(5.0); // 8 s in real time
+    mock.setPlaybackMode(MockSensorDevice::PlaybackMode::ONCE);
+    mock.setReplayClock(std::make_shared<ReplayClock>(ReplayClock::Mode::MaxRate));
+    ASSERT_TRUE(mock.open());
+    std::atomic<int> frames{0};
+    std::atomic<uint64_t> lastTs{0};
+    const auto t0 = std::chrono::steady_clock::now();
+    mock.setFrameCallback([&](const RawDepthFrame& d, const RawColorFrame&) {
+        lastTs.store(d.timestamp_ns);
+        frames.fetch_add(1);
+    });
+    ASSERT_TRUE(waitFor([&] { return !mock.isRunning(); }, std::chrono::seconds(5)));
+    const auto elapsed = std::chrono::steady_clock::now() - t0;
+    mock.close();
+    std::filesystem::remove(file);
+
+    EXPECT_EQ(frames.load(), 40);
+    EXPECT_EQ(lastTs.load(), 39'000'000ULL); // recorded timestamps are replayed unchanged
+    EXPECT_LT(elapsed, std::chrono::seconds(2));
+}
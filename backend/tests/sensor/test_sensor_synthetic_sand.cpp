@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common/Logger.h"
+#include "hal/ReplayClock.h"
+#include "hal/SandSurfaceGenerator.h"
+#include "hal/SyntheticSensorDevice.h"
+
+using caldera::backend::common::Logger;
+using caldera::backend::common::RawColorFrame;
+using caldera::backend::common::RawDepthFrame;
+using caldera::backend::hal::ReplayClock;
+using caldera::backend::hal::SandSurfaceGenerator;
+using caldera::backend::hal::SyntheticSensorDevice;
+
+namespace {
+std::vector<uint16_t> render(SandSurfaceGenerator& gen, uint64_t frame) {
+    std::vector<uint16_t> out(static_cast<size_t>(gen.width()) * gen.height());
+    gen.generate(frame, out.data());
+    return out;
+}
+
+// Centroid of pixels closer than `threshold` (the hands); returns false if none.
+bool nearCentroid(const std::vector<uint16_t>& d, int w, uint16_t threshold, double& cx, double& cy) {
+    double sx = 0, sy = 0; size_t n = 0;
+    for (size_t i = 0; i < d.size(); ++i) {
+        if (d[i] != 0 && d[i] < threshold) { sx += static_cast<double>(i % w); sy += static_cast<double>(i / w); ++n; }
+    }
+    if (n == 0) return false;
+    cx = sx / n; cy = sy / n;
+    return true;
+}
+} // namespace
+
+TEST(SandSurfaceGenerator, OutputIndependentOfThreadCount) {
+    SandSurfaceGenerator::Config cfg;
+    cfg.threads = 1;
+    SandSurfaceGenerator single(640, 480, 30.0, cfg);
+    cfg.threads = 4;
+    SandSurfaceGenerator multi(640, 480, 30.0, cfg);
+    EXPECT_EQ(single.threadCount(), 1);
+    EXPECT_EQ(multi.threadCount(), 4);
+    for (uint64_t f : {0ull, 7ull, 100ull}) EXPECT_EQ(render(single, f), render(multi, f)) << "frame " << f;
+}
+
+TEST(SandSurfaceGenerator, NoiseDropoutsAndDepthRange) {
+    SandSurfaceGenerator::Config cfg;
+    cfg.hands = 0;
+    SandSurfaceGenerator gen(512, 424, 30.0, cfg);
+    const auto a = render(gen, 1);
+    const auto b = render(gen, 2);
+    size_t holes = 0, valid = 0;
+    double absDiff = 0.0;
+    uint16_t lo = 65535, hi = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i] == 0) { ++holes; continue; }
+        lo = std::min(lo, a[i]); hi = std::max(hi, a[i]);
+        if (b[i] == 0) continue;
+        absDiff += std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i]));
+        ++valid;
+    }
+    const double holeFraction = static_cast<double>(holes) / a.size();
+    EXPECT_GT(holeFraction, 0.001);
+    EXPECT_LT(holeFraction, 0.05);
+    // Dunes stay within base +/- amplitude (+ noise and tilt).
+    EXPECT_GT(lo, cfg.baseDepthMm - cfg.duneAmplitudeMm - 30.0f);
+    EXPECT_LT(hi, cfg.baseDepthMm + cfg.duneAmplitudeMm + 30.0f);
+    EXPECT_GT(hi - lo, cfg.duneAmplitudeMm); // the surface is not flat
+    // Temporal noise: a few millimetres frame to frame at ~1.1 m.
+    const double meanDiff = absDiff / static_cast<double>(valid);
+    EXPECT_GT(meanDiff, 0.5);
+    EXPECT_LT(meanDiff, 10.0);
+}
+
+TEST(SandSurfaceGenerator, HandsIntrudeAndMove) {
+    SandSurfaceGenerator::Config cfg;
+    cfg.hands = 1;
+    SandSurfaceGenerator gen(640, 480, 30.0, cfg);
+    const auto threshold = static_cast<uint16_t>(cfg.baseDepthMm - cfg.handHeightMm / 2);
+    double x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+    ASSERT_TRUE(nearCentroid(render(gen, 0), 640, threshold, x0, y0));
+    ASSERT_TRUE(nearCentroid(render(gen, 30), 640, threshold, x1, y1));
+    EXPECT_GT(std::hypot(x1 - x0, y1 - y0), 10.0);
+}
+
+TEST(SandSurfaceGenerator, SyntheticDeviceStreamsSandAt120Fps) {
+    if (!Logger::instance().isInitialized()) Logger::instance().initialize("logs/test/synthetic_sand.log");
+    SyntheticSensorDevice::Config cfg;
+    cfg.width = 512; cfg.height = 424; cfg.fps = 120.0;
+    cfg.pattern = SyntheticSensorDevice::Pattern::SAND;
+    cfg.sensorId = "SandSynth";
+    SyntheticSensorDevice dev(cfg, Logger::instance().get("Test.SyntheticSand"));
+    dev.setReplayClock(std::make_shared<ReplayClock>(ReplayClock::Mode::MaxRate));
+    std::atomic<int> frames{0};
+    std::atomic<bool> sized{true};
+    dev.setFrameCallback([&](const RawDepthFrame& d, const RawColorFrame&) {
+        if (d.width != 512 || d.height != 424 || d.data.size() != 512u * 424u) sized.store(false);
+        frames.fetch_add(1);
+    });
+    dev.setStopAfter(120);
+    const auto t0 = std::chrono::steady_clock::now();
+    ASSERT_TRUE(dev.open());
+    const auto deadline = t0 + std::chrono::seconds(10);
+    while (!dev.isPaused() && std::chrono::steady_clock::now() < deadline) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    dev.close();
+    EXPECT_EQ(frames.load(), 120);
+    EXPECT_TRUE(sized.load());
+    std::cout << "[SandSurface] 512x424 x120 frames in " << secs << " s (" << 120.0 / secs << " fps)" << std::endl;
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include "common/Logger.h"
+#include "common/DataTypes.h"
+#include "processing/ProcessingManager.h"
+#include "transport/SharedMemoryTransportServer.h"
+#include "transport/SharedMemoryReader.h"
+
+using caldera::backend::common::Logger;
+using caldera::backend::common::RawDepthFrame;
+using caldera::backend::common::WorldFrameHandle;
+using caldera::backend::common::WorldFrameSlot;
+using caldera::backend::common::WorldFrameSlotMeta;
+using caldera::backend::processing::ProcessingManager;
+using caldera::backend::transport::SharedMemoryTransportServer;
+using caldera::backend::transport::SharedMemoryReader;
+
+static void ensureLogger(){ if(!Logger::instance().isInitialized()) Logger::instance().initialize("logs/test/shm_direct_slot.log"); }
+
+TEST(SharedMemoryDirectSlot, AcquireWriteCommitIsVisibleToReader) {
+    ensureLogger();
+    SharedMemoryTransportServer::Config cfg; cfg.shm_name = "/caldera_worldframe_direct_slot"; cfg.max_width=64; cfg.max_height=64;
+    SharedMemoryTransportServer server(Logger::instance().get("Test.SHM.Direct"), cfg);
+    server.start();
+    SharedMemoryReader reader(Logger::instance().get("Test.SHM.Direct.Reader"));
+    ASSERT_TRUE(reader.open(cfg.shm_name, cfg.max_width, cfg.max_height));
+
+    EXPECT_FALSE(server.acquireWritableSlot(128, 8)); // over capacity -> dropped
+    WorldFrameSlot slot = server.acquireWritableSlot(32, 16);
+    ASSERT_TRUE(slot);
+    ASSERT_GE(slot.capacity, 32u*16u);
+    for(uint32_t i=0;i<32*16;++i) slot.data[i] = (float)i;
+    ASSERT_TRUE(server.commitWritableSlot(slot, WorldFrameSlotMeta{7, 1234, 32, 16, 32*16, 0}));
+    EXPECT_FALSE(server.commitWritableSlot(slot, WorldFrameSlotMeta{8, 1235, 32, 16, 32*16, 0})); // already committed
+
+    auto fv = reader.latest();
+    ASSERT_TRUE(fv.has_value());
+    EXPECT_EQ(fv->frame_id, 7u);
+    EXPECT_EQ(fv->width, 32u);
+    EXPECT_EQ(fv->float_count, 32u*16u);
+    EXPECT_EQ(fv->data[100], 100.0f);
+
+    // Abandoned slot leaves the previously published frame active.
+    WorldFrameSlot again = server.acquireWritableSlot(32, 16);
+    ASSERT_TRUE(again);
+    server.abandonWritableSlot(again);
+    fv = reader.latest();
+    ASSERT_TRUE(fv.has_value());
+    EXPECT_EQ(fv->frame_id, 7u);
+
+    auto st = server.snapshotStats();
+    EXPECT_EQ(st.frames_published, 1u);
+    EXPECT_EQ(st.frames_direct_published, 1u);
+    EXPECT_EQ(st.frames_dropped_capacity, 1u);
+    server.stop();
+}
+
+TEST(SharedMemoryDirectSlot, ProcessingFusesStraightIntoSharedMemory) {
+    ensureLogger();
+    SharedMemoryTransportServer::Config cfg; cfg.shm_name = "/caldera_worldframe_direct_fuse"; cfg.max_width=64; cfg.max_height=64;
+    auto server = std::make_shared<SharedMemoryTransportServer>(Logger::instance().get("Test.SHM.DirectFuse"), cfg);
+    server->start();
+    SharedMemoryReader reader(Logger::instance().get("Test.SHM.DirectFuse.Reader"));
+    ASSERT_TRUE(reader.open(cfg.shm_name, cfg.max_width, cfg.max_height));
+
+    ProcessingManager pm(Logger::instance().get("Test.SHM.DirectFuse.Proc"));
+    pm.setDirectPublishSink(server);
+    std::vector<float> observed;
+    pm.setWorldFrameHandleCallback([&](const WorldFrameHandle& h){ observed = h->heightMap.data; });
+
+    const uint32_t W=24, H=12;
+    for(int f=0; f<3; ++f){
+        RawDepthFrame raw; raw.sensorId="direct"; raw.width=W; raw.height=H; raw.timestamp_ns=100+f;
+        raw.data.assign((size_t)W*H, 1200);
+        for(size_t i=0;i<raw.data.size();i+=5) raw.data[i]=0; // invalid pixels -> NaN inside processing
+        pm.processRawDepthFrame(raw);
+    }
+
+    auto fv = reader.latest();
+    ASSERT_TRUE(fv.has_value());
+    EXPECT_EQ(fv->frame_id, 2u);
+    EXPECT_EQ(fv->width, W);
+    EXPECT_EQ(fv->height, H);
+    ASSERT_EQ(fv->float_count, W*H);
+    for(uint32_t i=0;i<fv->float_count;++i) ASSERT_TRUE(std::isfinite(fv->data[i])) << "i=" << i; // NaN folded to 0 during the write
+    EXPECT_EQ(fv->data[0], 0.0f);
+    ASSERT_EQ(observed.size(), (size_t)W*H);
+    EXPECT_EQ(std::memcmp(observed.data(), fv->data, observed.size()*sizeof(float)), 0);
+
+    auto st = server->snapshotStats();
+    EXPECT_EQ(st.frames_direct_published, 3u);
+    EXPECT_EQ(st.frames_published, 3u);
+    server->stop();
+}